@@ -72,7 +72,8 @@ enum class StructType
     D3D12DeviceExtendedDesc,
     D3D12ExperimentalFeaturesDesc,
     SlangSessionExtendedDesc,
-    RayTracingValidationDesc
+    RayTracingValidationDesc,
+    CPUDeviceExtendedDesc,
 };
 
 // TODO: Implementation or backend or something else?
@@ -362,6 +363,7 @@ enum class NativeHandleType
 
     Win32 = 0x00000001,
     FileDescriptor = 0x00000002,
+    HostPointer = 0x00000003,
 
     D3D12Device = 0x00020001,
     D3D12CommandQueue = 0x00020002,
@@ -520,6 +522,18 @@ struct BufferDesc
     const char* label = nullptr;
 };
 
+/// Called once a buffer created from host memory is destroyed.
+typedef void (*HostMemoryReleaseFunc)(void* userData);
+
+enum class FileMappingMode
+{
+    /// Pages are shared with the file, writing to the buffer is not allowed.
+    /// Buffers with `UnorderedAccess` or `CopyDestination` usage or `MemoryType::Upload` are rejected.
+    ReadOnly,
+    /// Pages are read from the file, written pages become private to the buffer and the file is not modified.
+    CopyOnWrite,
+};
+
 class IBuffer : public IResource
 {
     SLANG_COM_INTERFACE(0xf3eeb08f, 0xa0cc, 0x4eea, {0x93, 0xfd, 0x2a, 0xfe, 0x95, 0x1c, 0x7f, 0x63});
@@ -1559,6 +1573,21 @@ enum class QueryType
     AccelerationStructureCompactedSize,
     AccelerationStructureSerializedSize,
     AccelerationStructureCurrentSize,
+    // Statistics counters, currently only supported by the CPU device.
+    // `writeTimestamp` samples the running total of the counter, the difference between two samples
+    // gives the statistic of the commands executed in between.
+    /// Number of compute shader invocations.
+    ComputeShaderInvocations,
+    /// Number of compute thread groups.
+    ComputeThreadGroups,
+    /// Time spent executing compute dispatches, in ticks of `DeviceInfo::timestampFrequency`.
+    ComputeDispatchTime,
+    /// Time each worker thread spent executing tasks, in ticks of `DeviceInfo::timestampFrequency`.
+    /// Each sample writes one query per worker thread, starting at the written query index.
+    WorkerBusyTime,
+    /// Time each worker thread spent waiting for tasks while the device was executing parallel work,
+    /// in ticks of `DeviceInfo::timestampFrequency`. Sampled like `WorkerBusyTime`.
+    WorkerIdleTime,
 };
 
 struct QueryPoolDesc
@@ -1981,6 +2010,10 @@ public:
         {
             None = 0,
             AllowResizing = 0x1,
+            /// Command buffers created from the heap keep their commands after submission, see
+            /// `createCommandBuffer`. Only supported by immediate devices (CPU, D3D11), heap creation fails
+            /// with SLANG_E_NOT_AVAILABLE on other devices.
+            ReusableCommandBuffers = 0x2,
         };
     };
     struct Desc
@@ -2009,6 +2042,10 @@ public:
     // buffers must be closed before submission. The current D3D12 implementation has a limitation
     // that only one command buffer maybe recorded at a time. User must finish recording a command
     // buffer before creating another command buffer.
+    // If the heap was created with `Flags::ReusableCommandBuffers`, a closed command buffer can be
+    // submitted any number of times, and recording into it again starts a new command list. Data of
+    // the root objects returned by `bindPipeline` can be changed between submissions, once the
+    // previous submission has completed.
     virtual SLANG_NO_THROW Result SLANG_MCALL createCommandBuffer(ICommandBuffer** outCommandBuffer) = 0;
     inline ComPtr<ICommandBuffer> createCommandBuffer()
     {
@@ -2176,6 +2213,51 @@ struct DeviceInfo
     uint64_t timestampFrequency = 0;
 };
 
+struct DeviceMemoryStats
+{
+    /// Number of live allocations and the bytes allocated for them.
+    uint64_t allocationCount = 0;
+    uint64_t allocatedBytes = 0;
+    /// Largest value of `allocatedBytes` during the lifetime of the device.
+    uint64_t peakAllocatedBytes = 0;
+    /// Number of allocations made during the lifetime of the device.
+    uint64_t totalAllocationCount = 0;
+    /// Bytes of live allocations requested to be backed by huge pages.
+    uint64_t hugePageBytes = 0;
+};
+
+struct CommandStats
+{
+    /// Number of commands recorded into closed command buffers.
+    uint64_t recordedCommandCount = 0;
+    /// Number of state commands dropped during recording, because they would not change the bound state.
+    uint64_t elidedPipelineCount = 0;
+    uint64_t elidedRootObjectCount = 0;
+    uint64_t elidedViewportsCount = 0;
+    uint64_t elidedScissorRectsCount = 0;
+    uint64_t elidedVertexBuffersCount = 0;
+    uint64_t elidedIndexBufferCount = 0;
+    /// Number of root shader objects created for bound pipelines. Root objects recycled from the pool of a
+    /// transient heap are not counted.
+    uint64_t createdRootObjectCount = 0;
+};
+
+enum class MipFilter
+{
+    /// Average of the texels covered by each texel of the next level.
+    Box,
+    /// Kaiser-windowed sinc, keeps more detail than the box filter.
+    Kaiser,
+};
+
+struct GenerateMipsDesc
+{
+    /// The first mip level of the range is the source, the following levels of the range are generated from it.
+    /// Each level is filtered from the level before it.
+    SubresourceRange range = kEntireTexture;
+    MipFilter filter = MipFilter::Box;
+};
+
 enum class DebugMessageType
 {
     Info,
@@ -2669,4 +2751,101 @@ struct RayTracingValidationDesc
     bool enableRaytracingValidation = false;
 };
 
+typedef void* (*CPUAllocateFunc)(void* userData, size_t size, size_t alignment);
+typedef void (*CPUFreeFunc)(void* userData, void* data, size_t size);
+
+/// Order in which the CPU device visits the tiles of a compute dispatch.
+enum class CPUDispatchTileOrder
+{
+    /// Z-order curve, interleaving the bits of the tile coordinates.
+    Morton,
+    /// Hilbert curve, consecutive tiles are always neighbours.
+    Hilbert,
+};
+
+struct CPUDeviceExtendedDesc
+{
+    StructType structType = StructType::CPUDeviceExtendedDesc;
+    /// Number of threads used to execute compute dispatches (including the submitting thread).
+    /// 0 uses the number of hardware threads, 1 executes dispatches on the submitting thread only.
+    uint32_t workerThreadCount = 0;
+    /// Execute submitted command buffers on a dedicated executor thread, allowing the host to record
+    /// the next command buffer while the previous one runs.
+    /// Buffer mapping, query results and host pointers then return live memory without waiting for submitted
+    /// work, the host must call `ICommandQueue::waitOnHost` or wait on a fence before accessing them.
+    /// `ICommandQueue::waitForFenceValuesOnDevice` is only available with asynchronous submission.
+    bool asynchronousSubmit = false;
+    /// 2D and 3D textures with a width and height of at least this many texels are stored in a tiled
+    /// (Morton ordered) layout, which improves cache locality for kernels accessing texel neighbourhoods.
+    /// 0 disables tiling.
+    uint32_t textureTilingThreshold = 256;
+    /// 2D and 3D compute dispatches are split into tiles of this many thread groups along each axis, which are
+    /// passed to the kernel one at a time and visited in `dispatchTileOrder`, so that groups accessing
+    /// neighbouring data run close together in time. 0 visits the groups of each worker chunk in x-major order.
+    uint32_t dispatchTileSize = 8;
+    CPUDispatchTileOrder dispatchTileOrder = CPUDispatchTileOrder::Morton;
+    /// Custom allocation of buffer and texture memory. Memory must be aligned to `alignment`, which is at least 64.
+    /// When not set, the device allocates memory itself according to `hugePageThreshold` and `numaNode`.
+    CPUAllocateFunc allocateFunc = nullptr;
+    CPUFreeFunc freeFunc = nullptr;
+    void* allocatorUserData = nullptr;
+    /// Resources of at least this many bytes are allocated from huge pages where available (Linux: reserved
+    /// hugetlb pages, otherwise transparent huge pages). 0 disables huge pages.
+    size_t hugePageThreshold = 2 * 1024 * 1024;
+    /// NUMA node to place resources of 2 MiB or more on. -1 places pages on the node of the thread touching them
+    /// first (see `firstTouchLargeResources`).
+    int32_t numaNode = -1;
+    /// With `numaNode` set to -1, the worker threads touch every page of new resources of 2 MiB or more, so that
+    /// their pages are spread over the nodes the workers run on. This commits the whole resource on creation and
+    /// waits for running dispatches, so it is disabled by default.
+    bool firstTouchLargeResources = false;
+};
+
+/// Implemented by devices recording their own command lists (CPU, D3D11), obtained with `IDevice::queryInterface`.
+class IImmediateDevice : public ISlangUnknown
+{
+    SLANG_COM_INTERFACE(0x86dbb135, 0x0bd3, 0x40bb, {0x84, 0x47, 0x3c, 0x82, 0x60, 0xe8, 0xdd, 0x91});
+
+public:
+    /// Get statistics about the commands recorded during the lifetime of the device.
+    virtual SLANG_NO_THROW Result SLANG_MCALL getCommandStats(CommandStats* outStats) = 0;
+};
+
+/// Functionality specific to the CPU device, obtained with `IDevice::queryInterface`.
+class ICPUDevice : public ISlangUnknown
+{
+    SLANG_COM_INTERFACE(0xebf62a17, 0x05b5, 0x480c, {0x90, 0x02, 0x3d, 0x94, 0x31, 0x0b, 0xc6, 0x74});
+
+public:
+    /// Create a buffer using `desc.size` bytes of existing host memory at `data` without copying it.
+    /// `releaseFunc` is called with `releaseUserData` once the buffer is destroyed, it may be null if the
+    /// memory outlives the buffer.
+    virtual SLANG_NO_THROW Result SLANG_MCALL createBufferFromHostMemory(
+        const BufferDesc& desc,
+        void* data,
+        HostMemoryReleaseFunc releaseFunc,
+        void* releaseUserData,
+        IBuffer** outBuffer
+    ) = 0;
+
+    /// Create a buffer backed by a memory-mapped file, starting at `fileOffset`.
+    /// A `desc.size` of 0 maps the rest of the file.
+    virtual SLANG_NO_THROW Result SLANG_MCALL createBufferFromFile(
+        const BufferDesc& desc,
+        const char* path,
+        uint64_t fileOffset,
+        FileMappingMode mode,
+        IBuffer** outBuffer
+    ) = 0;
+
+    /// Get statistics about the memory allocated for resources.
+    virtual SLANG_NO_THROW Result SLANG_MCALL getMemoryStats(DeviceMemoryStats* outStats) = 0;
+
+    /// Generate mip levels of a texture from its previous levels on the host, see `GenerateMipsDesc`.
+    /// sRGB formats are filtered in linear space. Integer formats are not supported.
+    /// Like mapping a buffer, this does not wait for submitted work, with `asynchronousSubmit` the host must wait
+    /// for the commands accessing the texture to complete first.
+    virtual SLANG_NO_THROW Result SLANG_MCALL generateMips(ITexture* texture, const GenerateMipsDesc& desc) = 0;
+};
+
 } // namespace rhi
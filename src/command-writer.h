@@ -4,8 +4,12 @@
 
 #include "rhi-shared.h"
 
+#include "core/arena-allocator.h"
 #include "core/common.h"
 
+#include <algorithm>
+#include <new>
+#include <type_traits>
 #include <vector>
 
 namespace rhi {
@@ -26,227 +30,576 @@ enum class CommandName
     DrawIndexedInstanced,
     SetStencilReference,
     DispatchCompute,
+    DispatchComputeIndirect,
     UploadBufferData,
     CopyBuffer,
+    CopyTexture,
+    UploadTextureData,
+    ClearBuffer,
+    ClearTexture,
+    ResolveQuery,
     WriteTimestamp,
+    BuildAccelerationStructure,
+    CopyAccelerationStructure,
+    QueryAccelerationStructureProperties,
 };
 
-const uint8_t kMaxCommandOperands = 5;
 
-struct Command
+const Size kCommandDataAlignment = 8;
+
+/// Header of a recorded command. The arguments of the command, one of the structures in `commands`,
+/// directly follow the header.
+struct alignas(kCommandDataAlignment) CommandSlot
 {
     CommandName name;
-    uint32_t operands[kMaxCommandOperands];
-    Command() = default;
-    Command(CommandName inName)
-        : name(inName)
-    {
-    }
-    Command(CommandName inName, uint32_t op)
-        : name(inName)
-    {
-        operands[0] = op;
-    }
-    Command(CommandName inName, uint32_t op1, uint32_t op2)
-        : name(inName)
-    {
-        operands[0] = op1;
-        operands[1] = op2;
-    }
-    Command(CommandName inName, uint32_t op1, uint32_t op2, uint32_t op3)
-        : name(inName)
-    {
-        operands[0] = op1;
-        operands[1] = op2;
-        operands[2] = op3;
-    }
-    Command(CommandName inName, uint32_t op1, uint32_t op2, uint32_t op3, uint32_t op4)
-        : name(inName)
-    {
-        operands[0] = op1;
-        operands[1] = op2;
-        operands[2] = op3;
-        operands[3] = op4;
-    }
-    Command(CommandName inName, uint32_t op1, uint32_t op2, uint32_t op3, uint32_t op4, uint32_t op5)
-        : name(inName)
+
+    template<typename T>
+    const T& getArgs() const
     {
-        operands[0] = op1;
-        operands[1] = op2;
-        operands[2] = op3;
-        operands[3] = op4;
-        operands[4] = op5;
+        SLANG_RHI_ASSERT(name == T::kName);
+        return *reinterpret_cast<const T*>(this + 1);
     }
 };
 
+// Command arguments. Objects are retained by the `CommandWriter` and arrays point into its arena,
+// so commands can be replayed as long as the writer is not cleared.
+namespace commands {
+
+struct SetPipeline
+{
+    static const CommandName kName = CommandName::SetPipeline;
+    Pipeline* pipeline;
+};
+
+struct BindRootShaderObject
+{
+    static const CommandName kName = CommandName::BindRootShaderObject;
+    ShaderObjectBase* object;
+};
+
+struct BeginRenderPass
+{
+    static const CommandName kName = CommandName::BeginRenderPass;
+    RenderPassDesc desc;
+};
+
+struct EndRenderPass
+{
+    static const CommandName kName = CommandName::EndRenderPass;
+};
+
+struct SetViewports
+{
+    static const CommandName kName = CommandName::SetViewports;
+    GfxCount count;
+    const Viewport* viewports;
+};
+
+struct SetScissorRects
+{
+    static const CommandName kName = CommandName::SetScissorRects;
+    GfxCount count;
+    const ScissorRect* scissors;
+};
+
+struct SetVertexBuffers
+{
+    static const CommandName kName = CommandName::SetVertexBuffers;
+    GfxIndex startSlot;
+    GfxCount slotCount;
+    IBuffer* const* buffers;
+    const Offset* offsets;
+};
+
+struct SetIndexBuffer
+{
+    static const CommandName kName = CommandName::SetIndexBuffer;
+    Buffer* buffer;
+    IndexFormat indexFormat;
+    Offset offset;
+};
+
+struct Draw
+{
+    static const CommandName kName = CommandName::Draw;
+    GfxCount vertexCount;
+    GfxIndex startVertex;
+};
+
+struct DrawIndexed
+{
+    static const CommandName kName = CommandName::DrawIndexed;
+    GfxCount indexCount;
+    GfxIndex startIndex;
+    GfxIndex baseVertex;
+};
+
+struct DrawInstanced
+{
+    static const CommandName kName = CommandName::DrawInstanced;
+    GfxCount vertexCount;
+    GfxCount instanceCount;
+    GfxIndex startVertex;
+    GfxIndex startInstanceLocation;
+};
+
+struct DrawIndexedInstanced
+{
+    static const CommandName kName = CommandName::DrawIndexedInstanced;
+    GfxCount indexCount;
+    GfxCount instanceCount;
+    GfxIndex startIndexLocation;
+    GfxIndex baseVertexLocation;
+    GfxIndex startInstanceLocation;
+};
+
+struct SetStencilReference
+{
+    static const CommandName kName = CommandName::SetStencilReference;
+    uint32_t referenceValue;
+};
+
+struct DispatchCompute
+{
+    static const CommandName kName = CommandName::DispatchCompute;
+    int x;
+    int y;
+    int z;
+};
+
+struct DispatchComputeIndirect
+{
+    static const CommandName kName = CommandName::DispatchComputeIndirect;
+    Buffer* argBuffer;
+    Offset offset;
+};
+
+struct UploadBufferData
+{
+    static const CommandName kName = CommandName::UploadBufferData;
+    Buffer* buffer;
+    Offset offset;
+    Size size;
+    void* data;
+};
+
+struct CopyBuffer
+{
+    static const CommandName kName = CommandName::CopyBuffer;
+    Buffer* dst;
+    Offset dstOffset;
+    Buffer* src;
+    Offset srcOffset;
+    Size size;
+};
+
+struct CopyTexture
+{
+    static const CommandName kName = CommandName::CopyTexture;
+    Texture* dst;
+    SubresourceRange dstSubresource;
+    Offset3D dstOffset;
+    Texture* src;
+    SubresourceRange srcSubresource;
+    Offset3D srcOffset;
+    Extents extent;
+};
+
+struct UploadTextureData
+{
+    static const CommandName kName = CommandName::UploadTextureData;
+    Texture* dst;
+    SubresourceRange subresourceRange;
+    Offset3D offset;
+    Extents extent;
+    SubresourceData* subresourceData;
+    GfxCount subresourceDataCount;
+};
+
+struct ClearBuffer
+{
+    static const CommandName kName = CommandName::ClearBuffer;
+    Buffer* buffer;
+    BufferRange range;
+};
+
+struct ClearTexture
+{
+    static const CommandName kName = CommandName::ClearTexture;
+    Texture* texture;
+    ClearValue clearValue;
+    SubresourceRange subresourceRange;
+    bool clearDepth;
+    bool clearStencil;
+};
+
+struct ResolveQuery
+{
+    static const CommandName kName = CommandName::ResolveQuery;
+    QueryPool* queryPool;
+    GfxIndex index;
+    GfxCount count;
+    Buffer* buffer;
+    Offset offset;
+};
+
+struct WriteTimestamp
+{
+    static const CommandName kName = CommandName::WriteTimestamp;
+    QueryPool* queryPool;
+    GfxIndex index;
+};
+
+struct BuildAccelerationStructure
+{
+    static const CommandName kName = CommandName::BuildAccelerationStructure;
+    AccelerationStructureBuildDesc desc;
+    AccelerationStructure* dst;
+    AccelerationStructure* src;
+    GfxCount propertyQueryCount;
+    AccelerationStructureQueryDesc* queryDescs;
+};
+
+struct CopyAccelerationStructure
+{
+    static const CommandName kName = CommandName::CopyAccelerationStructure;
+    AccelerationStructure* dst;
+    AccelerationStructure* src;
+    AccelerationStructureCopyMode mode;
+};
+
+struct QueryAccelerationStructureProperties
+{
+    static const CommandName kName = CommandName::QueryAccelerationStructureProperties;
+    GfxCount accelerationStructureCount;
+    IAccelerationStructure* const* accelerationStructures;
+    GfxCount queryCount;
+    AccelerationStructureQueryDesc* queryDescs;
+};
+
+} // namespace commands
+
+/// Records commands as variable sized `CommandSlot`s allocated from an arena.
+/// The arena pages and the object table are kept by `clear`, so a writer that is reused for similar
+/// command lists stops allocating. Objects referenced by commands are retained once per command list.
+/// State commands that would not change the state set by earlier commands are dropped while recording.
 class CommandWriter
 {
 public:
-    std::vector<Command> m_commands;
-    std::vector<RefPtr<RefObject>> m_objects;
-    std::vector<uint8_t> m_data;
     bool m_hasWriteTimestamps = false;
 
 public:
+    CommandWriter() = default;
+    CommandWriter(const CommandWriter&) = delete;
+    CommandWriter& operator=(const CommandWriter&) = delete;
+
     void clear()
     {
         m_commands.clear();
-        for (auto& obj : m_objects)
-            obj = nullptr;
+        m_arena.reset();
         m_objects.clear();
-        m_data.clear();
+        std::fill(m_objectTable.begin(), m_objectTable.end(), nullptr);
+        m_lastRetainedObject = nullptr;
         m_hasWriteTimestamps = false;
+        m_stats = {};
+        invalidateState();
     }
 
-    // Copies user data into `m_data` buffer and returns the offset to retrieve the data.
-    Offset encodeData(const void* data, Size size)
-    {
-        Offset offset = (Offset)m_data.size();
-        m_data.resize(m_data.size() + size);
-        memcpy(m_data.data() + offset, data, size);
-        return offset;
-    }
+    /// Recorded commands in order. Slots are referenced from a separate array, so replaying does not chase pointers.
+    const std::vector<CommandSlot*>& getCommands() const { return m_commands; }
+    size_t getRetainedObjectCount() const { return m_objects.size(); }
 
-    Offset encodeObject(RefObject* obj)
+    /// Statistics of the commands recorded since the last `clear`.
+    CommandStats getStats() const
     {
-        Offset offset = (Offset)m_objects.size();
-        m_objects.push_back(obj);
-        return offset;
+        CommandStats stats = m_stats;
+        stats.recordedCommandCount = m_commands.size();
+        return stats;
     }
 
+    /// Keep `object` alive until the writer is cleared. Objects are only added to the table once.
     template<typename T>
-    T* getObject(uint32_t offset)
+    T* retain(T* object)
     {
-        return static_cast<T*>(m_objects[offset].Ptr());
+        if (object && object != m_lastRetainedObject)
+            retainObject(object);
+        return object;
     }
 
+    /// Copy `count` elements into the arena.
     template<typename T>
-    T* getData(Offset offset)
+    T* copyArray(const T* data, size_t count)
     {
-        return reinterpret_cast<T*>(m_data.data() + offset);
+        if (count == 0)
+            return nullptr;
+        T* result = m_arena.allocate<T>(count);
+        memcpy((void*)result, data, sizeof(T) * count);
+        return result;
     }
 
     void setPipeline(IPipeline* state)
     {
-        auto offset = encodeObject(checked_cast<Pipeline*>(state));
-        m_commands.push_back(Command(CommandName::SetPipeline, (uint32_t)offset));
+        auto pipeline = checked_cast<Pipeline*>(state);
+        if (pipeline == m_pipeline)
+        {
+            m_stats.elidedPipelineCount++;
+            return;
+        }
+        auto cmd = writeCommand<commands::SetPipeline>();
+        cmd->pipeline = retain(pipeline);
+        // The root object is specialized for the pipeline and vertex buffer strides come from its input layout.
+        m_pipeline = pipeline;
+        m_rootObject = nullptr;
+        m_vertexBuffers.clear();
     }
 
+    /// The root object is read when the command executes, binding it again is only needed after its
+    /// bindings were invalidated by another pipeline or render pass.
     void bindRootShaderObject(IShaderObject* object)
     {
-        auto rootOffset = encodeObject(checked_cast<ShaderObjectBase*>(object));
-        m_commands.push_back(Command(CommandName::BindRootShaderObject, (uint32_t)rootOffset));
+        auto rootObject = checked_cast<ShaderObjectBase*>(object);
+        if (rootObject == m_rootObject)
+        {
+            m_stats.elidedRootObjectCount++;
+            return;
+        }
+        auto cmd = writeCommand<commands::BindRootShaderObject>();
+        cmd->object = retain(rootObject);
+        m_rootObject = rootObject;
     }
 
     void uploadBufferData(IBuffer* buffer, Offset offset, Size size, void* data)
     {
-        auto bufferOffset = encodeObject(checked_cast<Buffer*>(buffer));
-        auto dataOffset = encodeData(data, size);
-        m_commands.push_back(Command(
-            CommandName::UploadBufferData,
-            (uint32_t)bufferOffset,
-            (uint32_t)offset,
-            (uint32_t)size,
-            (uint32_t)dataOffset
-        ));
+        auto cmd = writeCommand<commands::UploadBufferData>();
+        cmd->buffer = retain(checked_cast<Buffer*>(buffer));
+        cmd->offset = offset;
+        cmd->size = size;
+        cmd->data = copyArray((const uint8_t*)data, size);
     }
 
     void copyBuffer(IBuffer* dst, Offset dstOffset, IBuffer* src, Offset srcOffset, Size size)
     {
-        auto dstBuffer = encodeObject(checked_cast<Buffer*>(dst));
-        auto srcBuffer = encodeObject(checked_cast<Buffer*>(src));
-        m_commands.push_back(Command(
-            CommandName::CopyBuffer,
-            (uint32_t)dstBuffer,
-            (uint32_t)dstOffset,
-            (uint32_t)srcBuffer,
-            (uint32_t)srcOffset,
-            (uint32_t)size
-        ));
+        auto cmd = writeCommand<commands::CopyBuffer>();
+        cmd->dst = retain(checked_cast<Buffer*>(dst));
+        cmd->dstOffset = dstOffset;
+        cmd->src = retain(checked_cast<Buffer*>(src));
+        cmd->srcOffset = srcOffset;
+        cmd->size = size;
     }
 
-    void beginRenderPass(const RenderPassDesc& desc)
+    void copyTexture(
+        ITexture* dst,
+        SubresourceRange dstSubresource,
+        Offset3D dstOffset,
+        ITexture* src,
+        SubresourceRange srcSubresource,
+        Offset3D srcOffset,
+        Extents extent
+    )
+    {
+        auto cmd = writeCommand<commands::CopyTexture>();
+        cmd->dst = retain(checked_cast<Texture*>(dst));
+        cmd->dstSubresource = dstSubresource;
+        cmd->dstOffset = dstOffset;
+        cmd->src = retain(checked_cast<Texture*>(src));
+        cmd->srcSubresource = srcSubresource;
+        cmd->srcOffset = srcOffset;
+        cmd->extent = extent;
+    }
+
+    // The texel data is copied tightly packed into the arena.
+    void uploadTextureData(
+        ITexture* dst,
+        SubresourceRange subresourceRange,
+        Offset3D offset,
+        Extents extent,
+        SubresourceData* subresourceData,
+        GfxCount subresourceDataCount
+    )
     {
-        Offset colorAttachmentsOffset =
-            encodeData(desc.colorAttachments, sizeof(RenderPassColorAttachment) * desc.colorAttachmentCount);
-        Offset depthStencilAttachmentOffset = encodeData(
-            desc.depthStencilAttachment,
-            desc.depthStencilAttachment ? sizeof(RenderPassDepthStencilAttachment) : 0
-        );
-        Offset viewsOffset = 0;
-        for (uint32_t i = 0; i < desc.colorAttachmentCount; i++)
+        auto texture = checked_cast<Texture*>(dst);
+        const TextureDesc& desc = texture->m_desc;
+        const FormatInfo& formatInfo = getFormatInfo(desc.format);
+        GfxCount mipLevelCount =
+            std::max(1, std::min(subresourceRange.mipLevelCount, desc.mipLevelCount - subresourceRange.mipLevel));
+
+        auto cmd = writeCommand<commands::UploadTextureData>();
+        cmd->dst = retain(texture);
+        cmd->subresourceRange = subresourceRange;
+        cmd->offset = offset;
+        cmd->extent = extent;
+        cmd->subresourceData = m_arena.allocate<SubresourceData>(subresourceDataCount);
+        cmd->subresourceDataCount = subresourceDataCount;
+        for (GfxIndex i = 0; i < subresourceDataCount; i++)
         {
-            auto offset = encodeObject(checked_cast<TextureView*>(desc.colorAttachments[i].view));
-            if (i == 0)
-                viewsOffset = offset;
+            GfxIndex mipLevel = subresourceRange.mipLevel + i % mipLevelCount;
+            auto getSize = [&](GfxCount size, GfxCount textureSize, GfxIndex offset) -> GfxCount
+            {
+                if (size != kRemainingTextureSize)
+                    return size;
+                return std::max(0, std::max(1, textureSize >> mipLevel) - offset);
+            };
+            GfxCount width = getSize(extent.width, desc.size.width, offset.x);
+            GfxCount height = getSize(extent.height, desc.size.height, offset.y);
+            GfxCount depth = getSize(extent.depth, desc.size.depth, offset.z);
+            Size rowSize = (width + formatInfo.blockWidth - 1) / formatInfo.blockWidth * formatInfo.blockSizeInBytes;
+            GfxCount rowCount = (height + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
+
+            SubresourceData& packedData = cmd->subresourceData[i];
+            packedData.strideY = rowSize;
+            packedData.strideZ = rowSize * rowCount;
+            uint8_t* dstRow = (uint8_t*)m_arena.allocate(packedData.strideZ * depth, kCommandDataAlignment);
+            packedData.data = dstRow;
+            const uint8_t* srcLayer = (const uint8_t*)subresourceData[i].data;
+            for (GfxIndex z = 0; z < depth; z++)
+            {
+                const uint8_t* srcRow = srcLayer;
+                for (GfxIndex y = 0; y < rowCount; y++)
+                {
+                    memcpy(dstRow, srcRow, rowSize);
+                    dstRow += rowSize;
+                    srcRow += subresourceData[i].strideY;
+                }
+                srcLayer += subresourceData[i].strideZ;
+            }
         }
-        if (desc.depthStencilAttachment)
+    }
+
+    void clearBuffer(IBuffer* buffer, const BufferRange* range)
+    {
+        auto cmd = writeCommand<commands::ClearBuffer>();
+        cmd->buffer = retain(checked_cast<Buffer*>(buffer));
+        cmd->range = range ? *range : kEntireBuffer;
+    }
+
+    void clearTexture(
+        ITexture* texture,
+        const ClearValue& clearValue,
+        const SubresourceRange* subresourceRange,
+        bool clearDepth,
+        bool clearStencil
+    )
+    {
+        auto cmd = writeCommand<commands::ClearTexture>();
+        cmd->texture = retain(checked_cast<Texture*>(texture));
+        cmd->clearValue = clearValue;
+        cmd->subresourceRange = subresourceRange ? *subresourceRange : kEntireTexture;
+        cmd->clearDepth = clearDepth;
+        cmd->clearStencil = clearStencil;
+    }
+
+    void resolveQuery(IQueryPool* queryPool, GfxIndex index, GfxCount count, IBuffer* buffer, Offset offset)
+    {
+        auto cmd = writeCommand<commands::ResolveQuery>();
+        cmd->queryPool = retain(checked_cast<QueryPool*>(queryPool));
+        cmd->index = index;
+        cmd->count = count;
+        cmd->buffer = retain(checked_cast<Buffer*>(buffer));
+        cmd->offset = offset;
+    }
+
+    void beginRenderPass(const RenderPassDesc& desc)
+    {
+        auto cmd = writeCommand<commands::BeginRenderPass>();
+        cmd->desc.colorAttachmentCount = desc.colorAttachmentCount;
+        cmd->desc.colorAttachments = copyArray(desc.colorAttachments, desc.colorAttachmentCount);
+        cmd->desc.depthStencilAttachment =
+            desc.depthStencilAttachment ? copyArray(desc.depthStencilAttachment, 1) : nullptr;
+        for (GfxIndex i = 0; i < desc.colorAttachmentCount; i++)
         {
-            auto offset = encodeObject(checked_cast<TextureView*>(desc.depthStencilAttachment->view));
-            if (desc.colorAttachmentCount == 0)
-                viewsOffset = offset;
+            retain(checked_cast<TextureView*>(desc.colorAttachments[i].view));
+            retain(checked_cast<TextureView*>(desc.colorAttachments[i].resolveTarget));
         }
-        m_commands.push_back(Command(
-            CommandName::BeginRenderPass,
-            (uint32_t)desc.colorAttachmentCount,
-            (uint32_t)(desc.depthStencilAttachment ? 1 : 0),
-            (uint32_t)colorAttachmentsOffset,
-            (uint32_t)depthStencilAttachmentOffset,
-            (uint32_t)viewsOffset
-        ));
+        if (desc.depthStencilAttachment)
+            retain(checked_cast<TextureView*>(desc.depthStencilAttachment->view));
+        // Targets may reset the bound state with the render targets.
+        invalidateState();
     }
 
-    void endRenderPass() { m_commands.push_back(Command(CommandName::EndRenderPass)); }
+    void endRenderPass()
+    {
+        writeCommand<commands::EndRenderPass>();
+        invalidateState();
+    }
 
     void setViewports(GfxCount count, const Viewport* viewports)
     {
-        auto offset = encodeData(viewports, sizeof(Viewport) * count);
-        m_commands.push_back(Command(CommandName::SetViewports, (uint32_t)count, (uint32_t)offset));
+        if (count > 0 && m_viewports && m_viewports->count == count &&
+            memcmp(m_viewports->viewports, viewports, sizeof(Viewport) * count) == 0)
+        {
+            m_stats.elidedViewportsCount++;
+            return;
+        }
+        auto cmd = writeCommand<commands::SetViewports>();
+        cmd->count = count;
+        cmd->viewports = copyArray(viewports, count);
+        m_viewports = cmd;
     }
 
     void setScissorRects(GfxCount count, const ScissorRect* scissors)
     {
-        auto offset = encodeData(scissors, sizeof(ScissorRect) * count);
-        m_commands.push_back(Command(CommandName::SetScissorRects, (uint32_t)count, (uint32_t)offset));
+        if (count > 0 && m_scissorRects && m_scissorRects->count == count &&
+            memcmp(m_scissorRects->scissors, scissors, sizeof(ScissorRect) * count) == 0)
+        {
+            m_stats.elidedScissorRectsCount++;
+            return;
+        }
+        auto cmd = writeCommand<commands::SetScissorRects>();
+        cmd->count = count;
+        cmd->scissors = copyArray(scissors, count);
+        m_scissorRects = cmd;
     }
 
     void setVertexBuffers(GfxIndex startSlot, GfxCount slotCount, IBuffer* const* buffers, const Offset* offsets)
     {
-        Offset bufferOffset = 0;
-        for (GfxCount i = 0; i < slotCount; i++)
+        if (isVertexBufferRangeBound(startSlot, slotCount, buffers, offsets))
+        {
+            m_stats.elidedVertexBuffersCount++;
+            return;
+        }
+        auto cmd = writeCommand<commands::SetVertexBuffers>();
+        cmd->startSlot = startSlot;
+        cmd->slotCount = slotCount;
+        cmd->buffers = copyArray(buffers, slotCount);
+        cmd->offsets = copyArray(offsets, slotCount);
+        if (m_vertexBuffers.size() < size_t(startSlot + slotCount))
+            m_vertexBuffers.resize(startSlot + slotCount);
+        for (GfxIndex i = 0; i < slotCount; i++)
         {
-            auto offset = encodeObject(checked_cast<Buffer*>(buffers[i]));
-            if (i == 0)
-                bufferOffset = offset;
+            retain(checked_cast<Buffer*>(buffers[i]));
+            m_vertexBuffers[startSlot + i] = {true, buffers[i], offsets[i]};
         }
-        auto offsetsOffset = encodeData(offsets, sizeof(Size) * slotCount);
-        m_commands.push_back(Command(
-            CommandName::SetVertexBuffers,
-            (uint32_t)startSlot,
-            (uint32_t)slotCount,
-            (uint32_t)bufferOffset,
-            (uint32_t)offsetsOffset
-        ));
     }
 
     void setIndexBuffer(IBuffer* buffer, IndexFormat indexFormat, Offset offset)
     {
-        auto bufferOffset = encodeObject(checked_cast<Buffer*>(buffer));
-        m_commands.push_back(
-            Command(CommandName::SetIndexBuffer, (uint32_t)bufferOffset, (uint32_t)indexFormat, (uint32_t)offset)
-        );
+        auto bufferImpl = checked_cast<Buffer*>(buffer);
+        if (m_indexBuffer && m_indexBuffer->buffer == bufferImpl && m_indexBuffer->indexFormat == indexFormat &&
+            m_indexBuffer->offset == offset)
+        {
+            m_stats.elidedIndexBufferCount++;
+            return;
+        }
+        auto cmd = writeCommand<commands::SetIndexBuffer>();
+        cmd->buffer = retain(bufferImpl);
+        cmd->indexFormat = indexFormat;
+        cmd->offset = offset;
+        m_indexBuffer = cmd;
     }
 
     void draw(GfxCount vertexCount, GfxIndex startVertex)
     {
-        m_commands.push_back(Command(CommandName::Draw, (uint32_t)vertexCount, (uint32_t)startVertex));
+        auto cmd = writeCommand<commands::Draw>();
+        cmd->vertexCount = vertexCount;
+        cmd->startVertex = startVertex;
     }
 
     void drawIndexed(GfxCount indexCount, GfxIndex startIndex, GfxIndex baseVertex)
     {
-        m_commands.push_back(
-            Command(CommandName::DrawIndexed, (uint32_t)indexCount, (uint32_t)startIndex, (uint32_t)baseVertex)
-        );
+        auto cmd = writeCommand<commands::DrawIndexed>();
+        cmd->indexCount = indexCount;
+        cmd->startIndex = startIndex;
+        cmd->baseVertex = baseVertex;
     }
 
     void drawInstanced(
@@ -256,13 +609,11 @@ public:
         GfxIndex startInstanceLocation
     )
     {
-        m_commands.push_back(Command(
-            CommandName::DrawInstanced,
-            (uint32_t)vertexCount,
-            (uint32_t)instanceCount,
-            (uint32_t)startVertex,
-            (uint32_t)startInstanceLocation
-        ));
+        auto cmd = writeCommand<commands::DrawInstanced>();
+        cmd->vertexCount = vertexCount;
+        cmd->instanceCount = instanceCount;
+        cmd->startVertex = startVertex;
+        cmd->startInstanceLocation = startInstanceLocation;
     }
 
     void drawIndexedInstanced(
@@ -273,31 +624,239 @@ public:
         GfxIndex startInstanceLocation
     )
     {
-        m_commands.push_back(Command(
-            CommandName::DrawIndexedInstanced,
-            (uint32_t)indexCount,
-            (uint32_t)instanceCount,
-            (uint32_t)startIndexLocation,
-            (uint32_t)baseVertexLocation,
-            (uint32_t)startInstanceLocation
-        ));
+        auto cmd = writeCommand<commands::DrawIndexedInstanced>();
+        cmd->indexCount = indexCount;
+        cmd->instanceCount = instanceCount;
+        cmd->startIndexLocation = startIndexLocation;
+        cmd->baseVertexLocation = baseVertexLocation;
+        cmd->startInstanceLocation = startInstanceLocation;
     }
 
     void setStencilReference(uint32_t referenceValue)
     {
-        m_commands.push_back(Command(CommandName::SetStencilReference, referenceValue));
+        auto cmd = writeCommand<commands::SetStencilReference>();
+        cmd->referenceValue = referenceValue;
     }
 
     void dispatchCompute(int x, int y, int z)
     {
-        m_commands.push_back(Command(CommandName::DispatchCompute, (uint32_t)x, (uint32_t)y, (uint32_t)z));
+        auto cmd = writeCommand<commands::DispatchCompute>();
+        cmd->x = x;
+        cmd->y = y;
+        cmd->z = z;
+    }
+
+    void dispatchComputeIndirect(IBuffer* argBuffer, Offset offset)
+    {
+        auto cmd = writeCommand<commands::DispatchComputeIndirect>();
+        cmd->argBuffer = retain(checked_cast<Buffer*>(argBuffer));
+        cmd->offset = offset;
     }
 
     void writeTimestamp(IQueryPool* pool, GfxIndex index)
     {
-        auto poolOffset = encodeObject(checked_cast<QueryPool*>(pool));
-        m_commands.push_back(Command(CommandName::WriteTimestamp, (uint32_t)poolOffset, (uint32_t)index));
+        auto cmd = writeCommand<commands::WriteTimestamp>();
+        cmd->queryPool = retain(checked_cast<QueryPool*>(pool));
+        cmd->index = index;
         m_hasWriteTimestamps = true;
     }
+
+    void buildAccelerationStructure(
+        const AccelerationStructureBuildDesc& desc,
+        IAccelerationStructure* dst,
+        IAccelerationStructure* src,
+        GfxCount propertyQueryCount,
+        AccelerationStructureQueryDesc* queryDescs
+    )
+    {
+        auto cmd = writeCommand<commands::BuildAccelerationStructure>();
+        cmd->desc = desc;
+        cmd->desc.inputs = nullptr;
+        cmd->dst = retain(checked_cast<AccelerationStructure*>(dst));
+        cmd->src = retain(checked_cast<AccelerationStructure*>(src));
+        cmd->propertyQueryCount = propertyQueryCount;
+        cmd->queryDescs = copyQueryDescs(propertyQueryCount, queryDescs);
+        if (desc.inputCount == 0)
+            return;
+
+        // The build inputs and their buffer lists are copied, with their pointers referring to the copies.
+        switch ((AccelerationStructureBuildInputType&)desc.inputs[0])
+        {
+        case AccelerationStructureBuildInputType::Instances:
+        {
+            auto inputs = copyArray(
+                static_cast<const AccelerationStructureBuildInputInstances*>(desc.inputs),
+                desc.inputCount
+            );
+            for (GfxIndex i = 0; i < desc.inputCount; i++)
+                retain(checked_cast<Buffer*>(inputs[i].instanceBuffer.buffer));
+            cmd->desc.inputs = inputs;
+            break;
+        }
+        case AccelerationStructureBuildInputType::Triangles:
+        {
+            auto inputs = copyArray(
+                static_cast<const AccelerationStructureBuildInputTriangles*>(desc.inputs),
+                desc.inputCount
+            );
+            for (GfxIndex i = 0; i < desc.inputCount; i++)
+            {
+                inputs[i].vertexBuffers = copyArray(inputs[i].vertexBuffers, inputs[i].vertexBufferCount);
+                for (GfxIndex j = 0; j < inputs[i].vertexBufferCount; j++)
+                    retain(checked_cast<Buffer*>(inputs[i].vertexBuffers[j].buffer));
+                retain(checked_cast<Buffer*>(inputs[i].indexBuffer.buffer));
+                retain(checked_cast<Buffer*>(inputs[i].preTransformBuffer.buffer));
+            }
+            cmd->desc.inputs = inputs;
+            break;
+        }
+        case AccelerationStructureBuildInputType::ProceduralPrimitives:
+        {
+            auto inputs = copyArray(
+                static_cast<const AccelerationStructureBuildInputProceduralPrimitives*>(desc.inputs),
+                desc.inputCount
+            );
+            for (GfxIndex i = 0; i < desc.inputCount; i++)
+            {
+                inputs[i].aabbBuffers = copyArray(inputs[i].aabbBuffers, inputs[i].aabbBufferCount);
+                for (GfxIndex j = 0; j < inputs[i].aabbBufferCount; j++)
+                    retain(checked_cast<Buffer*>(inputs[i].aabbBuffers[j].buffer));
+            }
+            cmd->desc.inputs = inputs;
+            break;
+        }
+        }
+    }
+
+    void copyAccelerationStructure(
+        IAccelerationStructure* dst,
+        IAccelerationStructure* src,
+        AccelerationStructureCopyMode mode
+    )
+    {
+        auto cmd = writeCommand<commands::CopyAccelerationStructure>();
+        cmd->dst = retain(checked_cast<AccelerationStructure*>(dst));
+        cmd->src = retain(checked_cast<AccelerationStructure*>(src));
+        cmd->mode = mode;
+    }
+
+    void queryAccelerationStructureProperties(
+        GfxCount accelerationStructureCount,
+        IAccelerationStructure* const* accelerationStructures,
+        GfxCount queryCount,
+        AccelerationStructureQueryDesc* queryDescs
+    )
+    {
+        auto cmd = writeCommand<commands::QueryAccelerationStructureProperties>();
+        cmd->accelerationStructureCount = accelerationStructureCount;
+        cmd->accelerationStructures = copyArray(accelerationStructures, accelerationStructureCount);
+        for (GfxIndex i = 0; i < accelerationStructureCount; i++)
+            retain(checked_cast<AccelerationStructure*>(accelerationStructures[i]));
+        cmd->queryCount = queryCount;
+        cmd->queryDescs = copyQueryDescs(queryCount, queryDescs);
+    }
+
+private:
+    /// Allocate a command and append it to the command list, the arguments are filled in by the caller.
+    template<typename T>
+    T* writeCommand()
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Command arguments are never destroyed");
+        static_assert(alignof(T) <= alignof(CommandSlot), "Command arguments directly follow their slot");
+        auto slot = static_cast<CommandSlot*>(m_arena.allocate(sizeof(CommandSlot) + sizeof(T), alignof(CommandSlot)));
+        slot->name = T::kName;
+        m_commands.push_back(slot);
+        return new (slot + 1) T();
+    }
+
+    AccelerationStructureQueryDesc* copyQueryDescs(GfxCount queryCount, AccelerationStructureQueryDesc* queryDescs)
+    {
+        for (GfxIndex i = 0; i < queryCount; i++)
+            retain(checked_cast<QueryPool*>(queryDescs[i].queryPool));
+        return copyArray(queryDescs, queryCount);
+    }
+
+    void retainObject(RefObject* object)
+    {
+        m_lastRetainedObject = object;
+        if ((m_objects.size() + 1) * 2 > m_objectTable.size())
+            growObjectTable();
+        if (insertIntoObjectTable(object))
+            m_objects.push_back(object);
+    }
+
+    /// Forget the tracked state, so the next state commands are recorded whatever they set.
+    void invalidateState()
+    {
+        m_pipeline = nullptr;
+        m_rootObject = nullptr;
+        m_viewports = nullptr;
+        m_scissorRects = nullptr;
+        m_vertexBuffers.clear();
+        m_indexBuffer = nullptr;
+    }
+
+    bool isVertexBufferRangeBound(
+        GfxIndex startSlot,
+        GfxCount slotCount,
+        IBuffer* const* buffers,
+        const Offset* offsets
+    ) const
+    {
+        if (slotCount == 0 || m_vertexBuffers.size() < size_t(startSlot + slotCount))
+            return false;
+        for (GfxIndex i = 0; i < slotCount; i++)
+        {
+            const BoundVertexBuffer& bound = m_vertexBuffers[startSlot + i];
+            if (!bound.isSet || bound.buffer != buffers[i] || bound.offset != offsets[i])
+                return false;
+        }
+        return true;
+    }
+
+    /// Open addressing hash set over the retained objects, returns false if `object` is already in it.
+    bool insertIntoObjectTable(RefObject* object)
+    {
+        size_t mask = m_objectTable.size() - 1;
+        size_t index = ((uintptr_t(object) >> 4) * 0x9e3779b97f4a7c15ull) >> 32 & mask;
+        while (m_objectTable[index])
+        {
+            if (m_objectTable[index] == object)
+                return false;
+            index = (index + 1) & mask;
+        }
+        m_objectTable[index] = object;
+        return true;
+    }
+
+    void growObjectTable()
+    {
+        m_objectTable.assign(std::max<size_t>(64, m_objectTable.size() * 2), nullptr);
+        for (const auto& object : m_objects)
+            insertIntoObjectTable(object.Ptr());
+    }
+
+    ArenaAllocator m_arena;
+    std::vector<CommandSlot*> m_commands;
+    std::vector<RefPtr<RefObject>> m_objects;
+    std::vector<RefObject*> m_objectTable;
+    RefObject* m_lastRetainedObject = nullptr;
+
+    struct BoundVertexBuffer
+    {
+        bool isSet;
+        IBuffer* buffer;
+        Offset offset;
+    };
+
+    // State set by the recorded commands, null when unknown. Tracked objects are retained by the commands.
+    Pipeline* m_pipeline = nullptr;
+    ShaderObjectBase* m_rootObject = nullptr;
+    const commands::SetViewports* m_viewports = nullptr;
+    const commands::SetScissorRects* m_scissorRects = nullptr;
+    std::vector<BoundVertexBuffer> m_vertexBuffers;
+    const commands::SetIndexBuffer* m_indexBuffer = nullptr;
+    CommandStats m_stats;
 };
+
 } // namespace rhi
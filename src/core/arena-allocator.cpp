@@ -0,0 +1,45 @@
+#include "arena-allocator.h"
+
+#include <algorithm>
+
+namespace rhi {
+
+void ArenaAllocator::reset()
+{
+    m_pageIndex = 0;
+    m_current = m_pages.empty() ? nullptr : m_pages[0].data.get();
+    m_end = m_pages.empty() ? nullptr : m_current + m_pages[0].size;
+}
+
+size_t ArenaAllocator::getCapacity() const
+{
+    size_t capacity = 0;
+    for (const Page& page : m_pages)
+        capacity += page.size;
+    return capacity;
+}
+
+void* ArenaAllocator::allocateFromNextPage(size_t size, size_t alignment)
+{
+    size_t requiredSize = size + alignment - 1;
+    // The first page is in use once `m_current` is set, otherwise allocation starts at the current page.
+    size_t pageIndex = m_current ? m_pageIndex + 1 : m_pageIndex;
+    // Pages retained by `reset` are reused in order, a page too small for the allocation is replaced.
+    if (pageIndex < m_pages.size() && m_pages[pageIndex].size < requiredSize)
+        m_pages.erase(m_pages.begin() + pageIndex);
+    if (pageIndex >= m_pages.size() || m_pages[pageIndex].size < requiredSize)
+    {
+        size_t pageSize = std::max(m_pageSize, requiredSize);
+        Page page = {std::unique_ptr<uint8_t[]>(new uint8_t[pageSize]), pageSize};
+        m_pages.insert(m_pages.begin() + std::min(pageIndex, m_pages.size()), std::move(page));
+    }
+
+    m_pageIndex = pageIndex;
+    m_current = m_pages[pageIndex].data.get();
+    m_end = m_current + m_pages[pageIndex].size;
+    uintptr_t address = (uintptr_t(m_current) + alignment - 1) & ~uintptr_t(alignment - 1);
+    m_current = (uint8_t*)(address + size);
+    return (void*)address;
+}
+
+} // namespace rhi
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace rhi {
+
+/// Bump allocator handing out memory from a list of pages.
+/// Allocations are never freed individually and never move, `reset` makes all pages available again
+/// without releasing them, so a reused arena stops allocating once it reached its high water mark.
+class ArenaAllocator
+{
+public:
+    explicit ArenaAllocator(size_t pageSize = 64 * 1024)
+        : m_pageSize(pageSize)
+    {
+    }
+
+    ArenaAllocator(const ArenaAllocator&) = delete;
+    ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+    /// Allocate `size` bytes aligned to `alignment`, which must be a power of two.
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        uintptr_t address = (uintptr_t(m_current) + alignment - 1) & ~uintptr_t(alignment - 1);
+        if (m_current && address + size <= uintptr_t(m_end))
+        {
+            m_current = (uint8_t*)(address + size);
+            return (void*)address;
+        }
+        return allocateFromNextPage(size, alignment);
+    }
+
+    template<typename T>
+    T* allocate(size_t count = 1)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /// Make all pages available for new allocations, invalidating previous allocations.
+    void reset();
+
+    /// Total size of the pages owned by the arena.
+    size_t getCapacity() const;
+
+private:
+    struct Page
+    {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+
+    void* allocateFromNextPage(size_t size, size_t alignment);
+
+    size_t m_pageSize;
+    std::vector<Page> m_pages;
+    size_t m_pageIndex = 0;
+    uint8_t* m_current = nullptr;
+    uint8_t* m_end = nullptr;
+};
+
+} // namespace rhi
@@ -2,11 +2,18 @@
 
 #include "assert.h"
 
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+
 #if SLANG_WINDOWS_FAMILY
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #elif SLANG_LINUX_FAMILY || SLANG_APPLE_FAMILY
 #include <dlfcn.h>
+#include <stdlib.h>
+#include <unistd.h>
 #else
 #error "Unsupported platform"
 #endif
@@ -51,4 +58,124 @@ void* findSymbolAddressByName(SharedLibraryHandle handle, char const* name)
 #endif
 }
 
+namespace {
+
+/// Directory for temporary files of this process, created on first use and removed on exit once empty.
+struct PrivateTempDirectory
+{
+    std::mutex mutex;
+    std::filesystem::path path;
+
+    ~PrivateTempDirectory()
+    {
+        if (!path.empty())
+        {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    }
+
+    Result get(std::filesystem::path& outPath)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (path.empty())
+        {
+            std::error_code ec;
+            std::filesystem::path tempPath = std::filesystem::temp_directory_path(ec);
+            if (ec)
+                return SLANG_FAIL;
+#if SLANG_WINDOWS_FAMILY
+            // The user's temp directory is not accessible to other users, the name only needs to be unique.
+            for (uint32_t attempt = 0;; attempt++)
+            {
+                std::filesystem::path candidate = tempPath / ("slang-rhi-" + std::to_string(GetCurrentProcessId()) +
+                                                              "-" + std::to_string(attempt));
+                if (CreateDirectoryW(candidate.c_str(), nullptr))
+                {
+                    path = candidate;
+                    break;
+                }
+                if (GetLastError() != ERROR_ALREADY_EXISTS || attempt >= 100)
+                    return SLANG_FAIL;
+            }
+#else
+            // `mkdtemp` creates the directory with a unique name, accessible to the current user only.
+            std::string pattern = (tempPath / "slang-rhi-XXXXXX").string();
+            if (!mkdtemp(pattern.data()))
+                return SLANG_FAIL;
+            path = pattern;
+#endif
+        }
+        outPath = path;
+        return SLANG_OK;
+    }
+};
+
+PrivateTempDirectory s_privateTempDirectory;
+
+} // namespace
+
+Result writeTempFile(const void* data, size_t size, const char* suffix, std::string& outPath)
+{
+    std::filesystem::path directory;
+    SLANG_RETURN_ON_FAIL(s_privateTempDirectory.get(directory));
+
+#if SLANG_WINDOWS_FAMILY
+    static std::atomic<uint32_t> fileCounter = 0;
+    std::filesystem::path filePath;
+    HANDLE file = INVALID_HANDLE_VALUE;
+    while (file == INVALID_HANDLE_VALUE)
+    {
+        filePath = directory / ("file-" + std::to_string(fileCounter++) + suffix);
+        // `CREATE_NEW` fails instead of opening a file that already exists.
+        file = CreateFileW(filePath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE && GetLastError() != ERROR_FILE_EXISTS)
+            return SLANG_FAIL;
+    }
+    bool written = true;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (written && size > 0)
+    {
+        DWORD chunkSize = DWORD(size < 0x40000000 ? size : 0x40000000);
+        DWORD writtenSize = 0;
+        written = WriteFile(file, bytes, chunkSize, &writtenSize, nullptr) && writtenSize == chunkSize;
+        bytes += chunkSize;
+        size -= chunkSize;
+    }
+    written &= CloseHandle(file) != 0;
+    if (!written)
+    {
+        DeleteFileW(filePath.c_str());
+        return SLANG_FAIL;
+    }
+    outPath = filePath.string();
+#else
+    // `mkstemps` creates the file exclusively (`O_CREAT | O_EXCL`) with a unique name, readable by the user only.
+    std::string filePath = (directory / "file-XXXXXX").string() + suffix;
+    int fd = mkstemps(filePath.data(), int(strlen(suffix)));
+    if (fd < 0)
+        return SLANG_FAIL;
+    bool written = true;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (written && size > 0)
+    {
+        ssize_t writtenSize = write(fd, bytes, size);
+        written = writtenSize > 0;
+        if (written)
+        {
+            bytes += writtenSize;
+            size -= size_t(writtenSize);
+        }
+    }
+    written &= close(fd) == 0;
+    if (!written)
+    {
+        unlink(filePath.c_str());
+        return SLANG_FAIL;
+    }
+    outPath = filePath;
+#endif
+    return SLANG_OK;
+}
+
 } // namespace rhi
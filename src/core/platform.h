@@ -2,6 +2,8 @@
 
 #include <slang-rhi.h>
 
+#include <string>
+
 namespace rhi {
 
 using SharedLibraryHandle = void*;
@@ -13,4 +15,9 @@ void unloadSharedLibrary(SharedLibraryHandle handle);
 /// Return nullptr if object is not found.
 void* findSymbolAddressByName(SharedLibraryHandle handle, char const* name);
 
+/// Write `size` bytes of `data` to a newly created file with a unique name ending in `suffix`.
+/// The file is created exclusively in a temporary directory only accessible to the current user and process.
+/// If writing fails, the partially written file is removed.
+Result writeTempFile(const void* data, size_t size, const char* suffix, std::string& outPath);
+
 } // namespace rhi
@@ -4,6 +4,7 @@
 
 #include "assert.h"
 
+#include <atomic>
 #include <type_traits>
 
 #define SLANG_RHI_ENABLE_REF_OBJECT_TRACKING 0
@@ -47,11 +48,15 @@ struct RefObjectTracker
 
 namespace rhi {
 
-// Base class for all reference-counted objects
+// Base class for all reference-counted objects.
+// The reference count is atomic like the COM reference count of `ComObject`, which most of these objects also
+// carry: resources, programs and shader objects referenced by recorded commands are released by the thread
+// that executes or resets them, which is not the thread that recorded them. Increments are relaxed, so only
+// the final release pays for ordering.
 class SLANG_RHI_API RefObject
 {
 private:
-    UInt referenceCount;
+    std::atomic<UInt> referenceCount;
 
 public:
     RefObject()
@@ -70,19 +75,20 @@ public:
 
     virtual ~RefObject() { SLANG_RHI_UNTRACK_OBJECT(this); }
 
-    UInt addReference() { return ++referenceCount; }
+    UInt addReference() { return referenceCount.fetch_add(1, std::memory_order_relaxed) + 1; }
 
     UInt decreaseReference() { return --referenceCount; }
 
     UInt releaseReference()
     {
         SLANG_RHI_ASSERT(referenceCount != 0);
-        if (--referenceCount == 0)
+        UInt count = referenceCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        if (count == 0)
         {
             delete this;
             return 0;
         }
-        return referenceCount;
+        return count;
     }
 
     bool isUniquelyReferenced()
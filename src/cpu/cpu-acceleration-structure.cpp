@@ -0,0 +1,966 @@
+#include "cpu-acceleration-structure.h"
+#include "cpu-format-conversion.h"
+#include "cpu-thread-pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace rhi::cpu {
+
+namespace {
+
+// Relative costs of traversing a node and intersecting a primitive used by the surface area heuristic.
+const float kTraversalCost = 1.0f;
+const float kIntersectionCost = 1.0f;
+
+const uint32_t kMaxBinCount = 32;
+
+// Nodes with at least this many primitives are binned by all threads.
+const uint32_t kParallelBinningThreshold = 16 * 1024;
+
+// The top of the tree is split until the remaining subtrees are small enough to balance
+// the subtree builds across threads.
+const uint32_t kSubtreesPerThread = 8;
+const uint32_t kMinSubtreeSize = 256;
+
+// Number of primitives processed by a single task when loading and reordering primitives.
+const uint32_t kPrimitiveChunkSize = 4096;
+
+struct AABB
+{
+    float min[3];
+    float max[3];
+
+    static AABB empty()
+    {
+        const float inf = std::numeric_limits<float>::infinity();
+        return {{inf, inf, inf}, {-inf, -inf, -inf}};
+    }
+
+    static AABB point(const float p[3]) { return {{p[0], p[1], p[2]}, {p[0], p[1], p[2]}}; }
+
+    void grow(const float p[3])
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            min[i] = std::min(min[i], p[i]);
+            max[i] = std::max(max[i], p[i]);
+        }
+    }
+
+    void grow(const AABB& other)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            min[i] = std::min(min[i], other.min[i]);
+            max[i] = std::max(max[i], other.max[i]);
+        }
+    }
+
+    void growCentroid(const AABB& other)
+    {
+        float centroid[3];
+        other.getCentroid(centroid);
+        grow(centroid);
+    }
+
+    void getCentroid(float outCentroid[3]) const
+    {
+        for (int i = 0; i < 3; i++)
+            outCentroid[i] = (min[i] + max[i]) * 0.5f;
+    }
+
+    bool isFinite() const
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            if (!std::isfinite(min[i]) || !std::isfinite(max[i]))
+                return false;
+        }
+        return true;
+    }
+
+    float halfArea() const
+    {
+        float dx = max[0] - min[0];
+        float dy = max[1] - min[1];
+        float dz = max[2] - min[2];
+        if (dx < 0.f || dy < 0.f || dz < 0.f)
+            return 0.f;
+        return dx * dy + dy * dz + dz * dx;
+    }
+};
+
+// Primitives with non-finite bounds are inactive. They are kept in the tree as points at the origin
+// so that the primitive count stays stable across updates.
+inline AABB sanitizeBounds(const AABB& bounds)
+{
+    static const float kOrigin[3] = {0.f, 0.f, 0.f};
+    return bounds.isFinite() ? bounds : AABB::point(kOrigin);
+}
+
+struct PrimitiveRef
+{
+    AABB bounds;
+    uint32_t index;
+};
+
+struct BuildSettings
+{
+    uint32_t binCount;
+    uint32_t maxLeafSize;
+};
+
+BuildSettings getBuildSettings(AccelerationStructureBuildFlags flags)
+{
+    if (is_set(flags, AccelerationStructureBuildFlags::PreferFastTrace))
+        return {32, 2};
+    if (is_set(flags, AccelerationStructureBuildFlags::PreferFastBuild))
+        return {8, 8};
+    return {16, 4};
+}
+
+template<typename T>
+const T& getBuildInput(const AccelerationStructureBuildDesc& desc, GfxIndex index)
+{
+    return static_cast<const T*>(desc.inputs)[index];
+}
+
+uint32_t getTriangleCount(const AccelerationStructureBuildInputTriangles& triangles)
+{
+    return uint32_t((triangles.indexBuffer ? triangles.indexCount : triangles.vertexCount) / 3);
+}
+
+Result validateBuildDesc(
+    const AccelerationStructureBuildDesc& desc,
+    AccelerationStructureBuildInputType& outType,
+    uint32_t& outPrimitiveCount
+)
+{
+    if (desc.inputCount < 1)
+        return SLANG_E_INVALID_ARG;
+
+    AccelerationStructureBuildInputType type = (AccelerationStructureBuildInputType&)desc.inputs[0];
+    uint32_t primitiveCount = 0;
+    switch (type)
+    {
+    case AccelerationStructureBuildInputType::Instances:
+    {
+        if (desc.inputCount > 1)
+            return SLANG_E_INVALID_ARG;
+        const auto& instances = getBuildInput<AccelerationStructureBuildInputInstances>(desc, 0);
+        if (instances.instanceCount > 0 &&
+            (!instances.instanceBuffer || instances.instanceStride < sizeof(AccelerationStructureInstanceDescGeneric)))
+            return SLANG_E_INVALID_ARG;
+        primitiveCount = uint32_t(instances.instanceCount);
+        break;
+    }
+    case AccelerationStructureBuildInputType::Triangles:
+    {
+        for (GfxIndex i = 0; i < desc.inputCount; i++)
+        {
+            const auto& triangles = getBuildInput<AccelerationStructureBuildInputTriangles>(desc, i);
+            if (triangles.type != type || triangles.vertexBufferCount < 1 || !triangles.vertexBuffers[0])
+                return SLANG_E_INVALID_ARG;
+            const CPUFormatConversionInfo* vertexFormat = getFormatConversionInfo(triangles.vertexFormat);
+            if (!vertexFormat || vertexFormat->isInteger)
+                return SLANG_E_INVALID_ARG;
+            primitiveCount += getTriangleCount(triangles);
+        }
+        break;
+    }
+    case AccelerationStructureBuildInputType::ProceduralPrimitives:
+    {
+        for (GfxIndex i = 0; i < desc.inputCount; i++)
+        {
+            const auto& proceduralPrimitives =
+                getBuildInput<AccelerationStructureBuildInputProceduralPrimitives>(desc, i);
+            if (proceduralPrimitives.type != type || proceduralPrimitives.aabbBufferCount < 1 ||
+                !proceduralPrimitives.aabbBuffers[0])
+                return SLANG_E_INVALID_ARG;
+            primitiveCount += uint32_t(proceduralPrimitives.primitiveCount);
+        }
+        break;
+    }
+    default:
+        return SLANG_E_INVALID_ARG;
+    }
+
+    outType = type;
+    outPrimitiveCount = primitiveCount;
+    return SLANG_OK;
+}
+
+// Runs `func(begin, end)` on all threads for chunks of the range [0, count).
+template<typename F>
+void parallelForRange(ThreadPool* threadPool, uint32_t count, uint32_t chunkSize, const F& func)
+{
+    uint32_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    if (chunkCount <= 1)
+    {
+        if (count > 0)
+            func(0u, count);
+        return;
+    }
+    threadPool->parallelFor(
+        chunkCount,
+        [&](uint32_t chunkIndex)
+        {
+            uint32_t begin = chunkIndex * chunkSize;
+            func(begin, std::min(begin + chunkSize, count));
+        }
+    );
+}
+
+template<typename T>
+void reorder(ThreadPool* threadPool, std::vector<T>& items, const std::vector<uint32_t>& order)
+{
+    if (items.empty())
+        return;
+    std::vector<T> reordered(order.size());
+    parallelForRange(
+        threadPool,
+        uint32_t(order.size()),
+        kPrimitiveChunkSize,
+        [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+                reordered[i] = items[order[i]];
+        }
+    );
+    items.swap(reordered);
+}
+
+void invertTransform(const float m[3][4], float out[3][4])
+{
+    float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+    float det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+    if (det == 0.f)
+    {
+        ::memset(out, 0, sizeof(float) * 12);
+        return;
+    }
+    float invDet = 1.f / det;
+    out[0][0] = c00 * invDet;
+    out[1][0] = c01 * invDet;
+    out[2][0] = c02 * invDet;
+    out[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet;
+    out[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet;
+    out[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet;
+    out[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet;
+    out[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet;
+    out[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet;
+    for (int i = 0; i < 3; i++)
+        out[i][3] = -(out[i][0] * m[0][3] + out[i][1] * m[1][3] + out[i][2] * m[2][3]);
+}
+
+void transformPoint(const float m[3][4], const float p[3], float out[3])
+{
+    for (int i = 0; i < 3; i++)
+        out[i] = m[i][0] * p[0] + m[i][1] * p[1] + m[i][2] * p[2] + m[i][3];
+}
+
+void loadTriangles(
+    const AccelerationStructureBuildDesc& desc,
+    ThreadPool* threadPool,
+    std::vector<BVHTriangle>& outTriangles,
+    std::vector<AABB>& outBounds
+)
+{
+    for (GfxIndex geometryIndex = 0; geometryIndex < desc.inputCount; geometryIndex++)
+    {
+        const auto& input = getBuildInput<AccelerationStructureBuildInputTriangles>(desc, geometryIndex);
+        // Only the first motion key is used.
+        const uint8_t* vertexData = (const uint8_t*)input.vertexBuffers[0].getDeviceAddress();
+        const uint8_t* indexData = input.indexBuffer ? (const uint8_t*)input.indexBuffer.getDeviceAddress() : nullptr;
+        const float(*transform)[4] =
+            input.preTransformBuffer ? (const float(*)[4])input.preTransformBuffer.getDeviceAddress() : nullptr;
+        const CPUFormatConversionInfo* vertexFormat = getFormatConversionInfo(input.vertexFormat);
+        uint32_t vertexCount = uint32_t(input.vertexCount);
+        uint32_t triangleCount = getTriangleCount(input);
+
+        size_t base = outTriangles.size();
+        outTriangles.resize(base + triangleCount);
+        outBounds.resize(base + triangleCount);
+        parallelForRange(
+            threadPool,
+            triangleCount,
+            kPrimitiveChunkSize,
+            [&](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t primitiveIndex = begin; primitiveIndex < end; primitiveIndex++)
+                {
+                    BVHTriangle& triangle = outTriangles[base + primitiveIndex];
+                    triangle.geometryIndex = geometryIndex;
+                    triangle.primitiveIndex = primitiveIndex;
+                    AABB bounds = AABB::empty();
+                    for (uint32_t i = 0; i < 3; i++)
+                    {
+                        uint32_t index = primitiveIndex * 3 + i;
+                        if (indexData)
+                        {
+                            index = input.indexFormat == IndexFormat::UInt32 ? ((const uint32_t*)indexData)[index]
+                                                                             : ((const uint16_t*)indexData)[index];
+                        }
+                        float vertex[4] = {NAN, NAN, NAN, NAN};
+                        if (index < vertexCount)
+                            unpackTexel(vertexFormat, vertexData + index * input.vertexStride, vertex, sizeof(vertex));
+                        if (transform)
+                            transformPoint(transform, vertex, triangle.vertices[i]);
+                        else
+                            ::memcpy(triangle.vertices[i], vertex, sizeof(float) * 3);
+                        bounds.grow(triangle.vertices[i]);
+                    }
+                    outBounds[base + primitiveIndex] = sanitizeBounds(bounds);
+                }
+            }
+        );
+    }
+}
+
+void loadProceduralPrimitives(
+    const AccelerationStructureBuildDesc& desc,
+    ThreadPool* threadPool,
+    std::vector<BVHProceduralPrimitive>& outPrimitives,
+    std::vector<AABB>& outBounds
+)
+{
+    for (GfxIndex geometryIndex = 0; geometryIndex < desc.inputCount; geometryIndex++)
+    {
+        const auto& input = getBuildInput<AccelerationStructureBuildInputProceduralPrimitives>(desc, geometryIndex);
+        const uint8_t* aabbData = (const uint8_t*)input.aabbBuffers[0].getDeviceAddress();
+        uint32_t primitiveCount = uint32_t(input.primitiveCount);
+
+        size_t base = outPrimitives.size();
+        outPrimitives.resize(base + primitiveCount);
+        outBounds.resize(base + primitiveCount);
+        parallelForRange(
+            threadPool,
+            primitiveCount,
+            kPrimitiveChunkSize,
+            [&](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t primitiveIndex = begin; primitiveIndex < end; primitiveIndex++)
+                {
+                    AccelerationStructureAABB aabb;
+                    ::memcpy(&aabb, aabbData + primitiveIndex * input.aabbStride, sizeof(aabb));
+                    BVHProceduralPrimitive& primitive = outPrimitives[base + primitiveIndex];
+                    primitive.boundsMin[0] = aabb.minX;
+                    primitive.boundsMin[1] = aabb.minY;
+                    primitive.boundsMin[2] = aabb.minZ;
+                    primitive.boundsMax[0] = aabb.maxX;
+                    primitive.boundsMax[1] = aabb.maxY;
+                    primitive.boundsMax[2] = aabb.maxZ;
+                    primitive.geometryIndex = geometryIndex;
+                    primitive.primitiveIndex = primitiveIndex;
+                    AABB bounds = {
+                        {aabb.minX, aabb.minY, aabb.minZ},
+                        {aabb.maxX, aabb.maxY, aabb.maxZ},
+                    };
+                    outBounds[base + primitiveIndex] = sanitizeBounds(bounds);
+                }
+            }
+        );
+    }
+}
+
+void loadInstances(
+    const AccelerationStructureBuildDesc& desc,
+    ThreadPool* threadPool,
+    std::vector<BVHInstance>& outInstances,
+    std::vector<AABB>& outBounds
+)
+{
+    const auto& input = getBuildInput<AccelerationStructureBuildInputInstances>(desc, 0);
+    uint32_t instanceCount = uint32_t(input.instanceCount);
+    outInstances.resize(instanceCount);
+    outBounds.resize(instanceCount);
+    if (instanceCount == 0)
+        return;
+
+    const uint8_t* instanceData = (const uint8_t*)input.instanceBuffer.getDeviceAddress();
+    parallelForRange(
+        threadPool,
+        instanceCount,
+        kPrimitiveChunkSize,
+        [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t instanceIndex = begin; instanceIndex < end; instanceIndex++)
+            {
+                AccelerationStructureInstanceDescGeneric instanceDesc;
+                ::memcpy(&instanceDesc, instanceData + instanceIndex * input.instanceStride, sizeof(instanceDesc));
+                BVHInstance& instance = outInstances[instanceIndex];
+                ::memcpy(instance.transform, instanceDesc.transform, sizeof(instance.transform));
+                invertTransform(instance.transform, instance.inverseTransform);
+                instance.instanceIndex = instanceIndex;
+                instance.instanceID = instanceDesc.instanceID;
+                instance.instanceMask = instanceDesc.instanceMask;
+                instance.instanceContributionToHitGroupIndex = instanceDesc.instanceContributionToHitGroupIndex;
+                instance.flags = instanceDesc.flags;
+                instance.accelerationStructure = (AccelerationStructureImpl*)instanceDesc.accelerationStructure.value;
+
+                // Transform the corners of the bottom level root bounds into world space.
+                AABB bounds = AABB::empty();
+                AccelerationStructureImpl* blas = instance.accelerationStructure;
+                if (blas && !blas->m_nodes.empty())
+                {
+                    const BVHNode& root = blas->m_nodes[0];
+                    for (int corner = 0; corner < 8; corner++)
+                    {
+                        float p[3] = {
+                            (corner & 1) ? root.boundsMax[0] : root.boundsMin[0],
+                            (corner & 2) ? root.boundsMax[1] : root.boundsMin[1],
+                            (corner & 4) ? root.boundsMax[2] : root.boundsMin[2],
+                        };
+                        float q[3];
+                        transformPoint(instance.transform, p, q);
+                        bounds.grow(q);
+                    }
+                }
+                outBounds[instanceIndex] = sanitizeBounds(bounds);
+            }
+        }
+    );
+}
+
+struct Bin
+{
+    AABB bounds;
+    AABB centroidBounds;
+    uint32_t count;
+};
+
+struct BinSet
+{
+    Bin bins[3][kMaxBinCount];
+
+    void clear(uint32_t binCount)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            for (uint32_t i = 0; i < binCount; i++)
+                bins[axis][i] = {AABB::empty(), AABB::empty(), 0};
+        }
+    }
+
+    void merge(const BinSet& other, uint32_t binCount)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            for (uint32_t i = 0; i < binCount; i++)
+            {
+                bins[axis][i].bounds.grow(other.bins[axis][i].bounds);
+                bins[axis][i].centroidBounds.grow(other.bins[axis][i].centroidBounds);
+                bins[axis][i].count += other.bins[axis][i].count;
+            }
+        }
+    }
+};
+
+// Maps primitive centroids to bins along each axis.
+struct BinMapping
+{
+    float offset[3];
+    float scale[3];
+    uint32_t binCount;
+
+    BinMapping(const AABB& centroidBounds, uint32_t binCount)
+        : binCount(binCount)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+            offset[axis] = centroidBounds.min[axis];
+            scale[axis] = extent > 0.f ? float(binCount) / extent : 0.f;
+        }
+    }
+
+    bool isDegenerate() const { return scale[0] == 0.f && scale[1] == 0.f && scale[2] == 0.f; }
+
+    uint32_t getBin(const float centroid[3], int axis) const
+    {
+        uint32_t bin = uint32_t((centroid[axis] - offset[axis]) * scale[axis]);
+        return std::min(bin, binCount - 1);
+    }
+};
+
+struct BuildTask
+{
+    uint32_t nodeIndex;
+    uint32_t begin;
+    uint32_t end;
+    AABB bounds;
+    AABB centroidBounds;
+
+    uint32_t getCount() const { return end - begin; }
+};
+
+/// Top-down BVH builder using binned SAH.
+/// The top of the tree is built on the calling thread with parallel binning for large nodes,
+/// the remaining subtrees are built in parallel and appended to the node list afterwards.
+class BVHBuilder
+{
+public:
+    BVHBuilder(ThreadPool* threadPool, const BuildSettings& settings, std::vector<PrimitiveRef>& refs)
+        : m_threadPool(threadPool)
+        , m_settings(settings)
+        , m_refs(refs)
+    {
+    }
+
+    void build(std::vector<BVHNode>& outNodes)
+    {
+        outNodes.clear();
+        uint32_t count = uint32_t(m_refs.size());
+        if (count == 0)
+            return;
+
+        BuildTask root = {0, 0, count, AABB::empty(), AABB::empty()};
+        computeBounds(root);
+        outNodes.resize(1);
+
+        uint32_t subtreeSize = std::max(kMinSubtreeSize, count / (m_threadPool->getThreadCount() * kSubtreesPerThread));
+        std::vector<BuildTask> subtrees;
+        std::vector<BuildTask> stack = {root};
+        buildNodes(stack, outNodes, subtreeSize, &subtrees);
+
+        // Build the largest subtrees first for better load balancing.
+        std::sort(
+            subtrees.begin(),
+            subtrees.end(),
+            [](const BuildTask& a, const BuildTask& b) { return a.getCount() > b.getCount(); }
+        );
+        std::vector<std::vector<BVHNode>> subtreeNodes(subtrees.size());
+        m_threadPool->parallelFor(
+            uint32_t(subtrees.size()),
+            [&](uint32_t subtreeIndex)
+            {
+                BuildTask task = subtrees[subtreeIndex];
+                task.nodeIndex = 0;
+                std::vector<BVHNode>& nodes = subtreeNodes[subtreeIndex];
+                nodes.resize(1);
+                std::vector<BuildTask> subtreeStack = {task};
+                buildNodes(subtreeStack, nodes, 0, nullptr);
+            }
+        );
+
+        // Link the subtrees, the subtree root replaces the placeholder node and
+        // the remaining nodes are appended.
+        for (size_t i = 0; i < subtrees.size(); i++)
+        {
+            const std::vector<BVHNode>& nodes = subtreeNodes[i];
+            uint32_t base = uint32_t(outNodes.size()) - 1;
+            outNodes[subtrees[i].nodeIndex] = relocate(nodes[0], base);
+            for (size_t j = 1; j < nodes.size(); j++)
+                outNodes.push_back(relocate(nodes[j], base));
+        }
+    }
+
+private:
+    ThreadPool* m_threadPool;
+    BuildSettings m_settings;
+    std::vector<PrimitiveRef>& m_refs;
+
+    static BVHNode makeNode(const AABB& bounds, uint32_t childOrFirst, uint32_t primitiveCount)
+    {
+        return {
+            {bounds.min[0], bounds.min[1], bounds.min[2]},
+            childOrFirst,
+            {bounds.max[0], bounds.max[1], bounds.max[2]},
+            primitiveCount,
+        };
+    }
+
+    static BVHNode relocate(BVHNode node, uint32_t base)
+    {
+        if (!node.isLeaf())
+            node.childOrFirst += base;
+        return node;
+    }
+
+    void computeBounds(BuildTask& task)
+    {
+        task.bounds = AABB::empty();
+        task.centroidBounds = AABB::empty();
+        for (uint32_t i = task.begin; i < task.end; i++)
+        {
+            task.bounds.grow(m_refs[i].bounds);
+            task.centroidBounds.growCentroid(m_refs[i].bounds);
+        }
+    }
+
+    // Splits the tasks on `stack` until empty. Tasks with at most `subtreeSize` primitives are
+    // moved to `outSubtrees` instead if given.
+    void buildNodes(
+        std::vector<BuildTask>& stack,
+        std::vector<BVHNode>& nodes,
+        uint32_t subtreeSize,
+        std::vector<BuildTask>* outSubtrees
+    )
+    {
+        while (!stack.empty())
+        {
+            BuildTask task = stack.back();
+            stack.pop_back();
+            if (outSubtrees && task.getCount() <= subtreeSize)
+            {
+                outSubtrees->push_back(task);
+                continue;
+            }
+
+            BuildTask left;
+            BuildTask right;
+            bool parallel = outSubtrees && task.getCount() >= kParallelBinningThreshold;
+            if (!splitTask(task, left, right, parallel))
+            {
+                nodes[task.nodeIndex] = makeNode(task.bounds, task.begin, task.getCount());
+                continue;
+            }
+            left.nodeIndex = uint32_t(nodes.size());
+            right.nodeIndex = left.nodeIndex + 1;
+            nodes.resize(nodes.size() + 2);
+            nodes[task.nodeIndex] = makeNode(task.bounds, left.nodeIndex, 0);
+            stack.push_back(right);
+            stack.push_back(left);
+        }
+    }
+
+    void binPrimitives(uint32_t begin, uint32_t end, const BinMapping& mapping, BinSet& bins)
+    {
+        bins.clear(m_settings.binCount);
+        for (uint32_t i = begin; i < end; i++)
+        {
+            const AABB& bounds = m_refs[i].bounds;
+            float centroid[3];
+            bounds.getCentroid(centroid);
+            for (int axis = 0; axis < 3; axis++)
+            {
+                Bin& bin = bins.bins[axis][mapping.getBin(centroid, axis)];
+                bin.bounds.grow(bounds);
+                bin.centroidBounds.grow(centroid);
+                bin.count++;
+            }
+        }
+    }
+
+    void binPrimitivesParallel(const BuildTask& task, const BinMapping& mapping, BinSet& bins)
+    {
+        uint32_t count = task.getCount();
+        uint32_t chunkCount = std::min(m_threadPool->getThreadCount() * 2, count / (kParallelBinningThreshold / 4));
+        std::vector<BinSet> chunkBins(chunkCount);
+        m_threadPool->parallelFor(
+            chunkCount,
+            [&](uint32_t chunkIndex)
+            {
+                uint32_t begin = task.begin + uint32_t(uint64_t(count) * chunkIndex / chunkCount);
+                uint32_t end = task.begin + uint32_t(uint64_t(count) * (chunkIndex + 1) / chunkCount);
+                binPrimitives(begin, end, mapping, chunkBins[chunkIndex]);
+            }
+        );
+        bins.clear(m_settings.binCount);
+        for (const BinSet& chunk : chunkBins)
+            bins.merge(chunk, m_settings.binCount);
+    }
+
+    bool splitTask(const BuildTask& task, BuildTask& outLeft, BuildTask& outRight, bool parallel)
+    {
+        uint32_t count = task.getCount();
+        if (count <= 1)
+            return false;
+
+        BinMapping mapping(task.centroidBounds, m_settings.binCount);
+        if (!mapping.isDegenerate())
+        {
+            BinSet bins;
+            if (parallel)
+                binPrimitivesParallel(task, mapping, bins);
+            else
+                binPrimitives(task.begin, task.end, mapping, bins);
+
+            // Sweep the split planes between bins along each axis.
+            int bestAxis = -1;
+            uint32_t bestBin = 0;
+            float bestCost = std::numeric_limits<float>::infinity();
+            for (int axis = 0; axis < 3; axis++)
+            {
+                if (mapping.scale[axis] == 0.f)
+                    continue;
+                const Bin* axisBins = bins.bins[axis];
+                float rightCosts[kMaxBinCount];
+                AABB rightBounds = AABB::empty();
+                uint32_t rightCount = 0;
+                for (uint32_t i = m_settings.binCount - 1; i > 0; i--)
+                {
+                    rightBounds.grow(axisBins[i].bounds);
+                    rightCount += axisBins[i].count;
+                    rightCosts[i] = rightCount > 0 ? rightBounds.halfArea() * rightCount : -1.f;
+                }
+                AABB leftBounds = AABB::empty();
+                uint32_t leftCount = 0;
+                for (uint32_t i = 1; i < m_settings.binCount; i++)
+                {
+                    leftBounds.grow(axisBins[i - 1].bounds);
+                    leftCount += axisBins[i - 1].count;
+                    if (leftCount == 0 || rightCosts[i] < 0.f)
+                        continue;
+                    float cost = leftBounds.halfArea() * leftCount + rightCosts[i];
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestBin = i;
+                    }
+                }
+            }
+
+            if (bestAxis >= 0)
+            {
+                float area = task.bounds.halfArea();
+                float splitCost =
+                    kTraversalCost + kIntersectionCost * (area > 0.f ? bestCost / area : float(count));
+                float leafCost = kIntersectionCost * count;
+                if (count <= m_settings.maxLeafSize && leafCost <= splitCost)
+                    return false;
+
+                outLeft = {0, task.begin, task.begin, AABB::empty(), AABB::empty()};
+                outRight = {0, task.begin, task.end, AABB::empty(), AABB::empty()};
+                for (uint32_t i = 0; i < m_settings.binCount; i++)
+                {
+                    const Bin& bin = bins.bins[bestAxis][i];
+                    BuildTask& side = i < bestBin ? outLeft : outRight;
+                    side.bounds.grow(bin.bounds);
+                    side.centroidBounds.grow(bin.centroidBounds);
+                }
+                auto mid = std::partition(
+                    m_refs.begin() + task.begin,
+                    m_refs.begin() + task.end,
+                    [&](const PrimitiveRef& ref)
+                    {
+                        float centroid[3];
+                        ref.bounds.getCentroid(centroid);
+                        return mapping.getBin(centroid, bestAxis) < bestBin;
+                    }
+                );
+                outLeft.end = uint32_t(mid - m_refs.begin());
+                outRight.begin = outLeft.end;
+                return true;
+            }
+        }
+
+        if (count <= m_settings.maxLeafSize)
+            return false;
+
+        // All centroids coincide, split the primitives in half.
+        uint32_t mid = task.begin + count / 2;
+        outLeft = {0, task.begin, mid, AABB::empty(), AABB::empty()};
+        outRight = {0, mid, task.end, AABB::empty(), AABB::empty()};
+        computeBounds(outLeft);
+        computeBounds(outRight);
+        return true;
+    }
+};
+
+void refitNodes(std::vector<BVHNode>& nodes, const std::vector<AABB>& bounds)
+{
+    // Children are stored after their parents, so a reverse sweep visits children first.
+    for (size_t i = nodes.size(); i-- > 0;)
+    {
+        BVHNode& node = nodes[i];
+        AABB nodeBounds = AABB::empty();
+        if (node.isLeaf())
+        {
+            for (uint32_t j = 0; j < node.primitiveCount; j++)
+                nodeBounds.grow(bounds[node.childOrFirst + j]);
+        }
+        else
+        {
+            for (uint32_t j = 0; j < 2; j++)
+            {
+                const BVHNode& child = nodes[node.childOrFirst + j];
+                nodeBounds.grow(child.boundsMin);
+                nodeBounds.grow(child.boundsMax);
+            }
+        }
+        ::memcpy(node.boundsMin, nodeBounds.min, sizeof(node.boundsMin));
+        ::memcpy(node.boundsMax, nodeBounds.max, sizeof(node.boundsMax));
+    }
+}
+
+template<typename T>
+Size getVectorSize(const std::vector<T>& v)
+{
+    return v.size() * sizeof(T);
+}
+
+} // namespace
+
+Result AccelerationStructureImpl::build(
+    const AccelerationStructureBuildDesc& desc,
+    AccelerationStructureImpl* src,
+    ThreadPool* threadPool
+)
+{
+    AccelerationStructureBuildInputType type;
+    uint32_t primitiveCount;
+    SLANG_RETURN_ON_FAIL(validateBuildDesc(desc, type, primitiveCount));
+
+    // Load the primitives in input order.
+    std::vector<BVHTriangle> triangles;
+    std::vector<BVHProceduralPrimitive> proceduralPrimitives;
+    std::vector<BVHInstance> instances;
+    std::vector<AABB> bounds;
+    bounds.reserve(primitiveCount);
+    std::vector<AccelerationStructureGeometryFlags> geometryFlags;
+    switch (type)
+    {
+    case AccelerationStructureBuildInputType::Instances:
+        loadInstances(desc, threadPool, instances, bounds);
+        break;
+    case AccelerationStructureBuildInputType::Triangles:
+        triangles.reserve(primitiveCount);
+        loadTriangles(desc, threadPool, triangles, bounds);
+        for (GfxIndex i = 0; i < desc.inputCount; i++)
+            geometryFlags.push_back(getBuildInput<AccelerationStructureBuildInputTriangles>(desc, i).flags);
+        break;
+    case AccelerationStructureBuildInputType::ProceduralPrimitives:
+        proceduralPrimitives.reserve(primitiveCount);
+        loadProceduralPrimitives(desc, threadPool, proceduralPrimitives, bounds);
+        for (GfxIndex i = 0; i < desc.inputCount; i++)
+            geometryFlags.push_back(
+                getBuildInput<AccelerationStructureBuildInputProceduralPrimitives>(desc, i).flags
+            );
+        break;
+    }
+
+    // Updates keep the topology of the source and only refit the node bounds.
+    // Sources built without `AllowUpdate` or from different inputs are rebuilt instead.
+    bool refit = desc.mode == AccelerationStructureBuildMode::Update && src && src->m_type == type &&
+                 src->m_primitiveOrder.size() == primitiveCount;
+    std::vector<uint32_t> order;
+    if (refit)
+    {
+        if (src != this)
+            m_nodes = src->m_nodes;
+        order = src->m_primitiveOrder;
+    }
+    else
+    {
+        std::vector<PrimitiveRef> refs(primitiveCount);
+        for (uint32_t i = 0; i < primitiveCount; i++)
+            refs[i] = {bounds[i], i};
+        BVHBuilder builder(threadPool, getBuildSettings(desc.flags), refs);
+        builder.build(m_nodes);
+        order.resize(primitiveCount);
+        for (uint32_t i = 0; i < primitiveCount; i++)
+            order[i] = refs[i].index;
+    }
+
+    // Store the primitives in leaf order.
+    reorder(threadPool, triangles, order);
+    reorder(threadPool, proceduralPrimitives, order);
+    reorder(threadPool, instances, order);
+    if (refit)
+    {
+        reorder(threadPool, bounds, order);
+        refitNodes(m_nodes, bounds);
+    }
+
+    m_type = type;
+    m_triangles.swap(triangles);
+    m_proceduralPrimitives.swap(proceduralPrimitives);
+    m_instances.swap(instances);
+    m_geometryFlags.swap(geometryFlags);
+    if (refit || is_set(desc.flags, AccelerationStructureBuildFlags::AllowUpdate))
+        m_primitiveOrder.swap(order);
+    else
+        m_primitiveOrder.clear();
+
+    buildWideBVH();
+
+    return SLANG_OK;
+}
+
+void AccelerationStructureImpl::copyFrom(AccelerationStructureImpl* src, AccelerationStructureCopyMode mode)
+{
+    if (src == this)
+        return;
+    m_type = src->m_type;
+    m_nodes = src->m_nodes;
+    m_triangles = src->m_triangles;
+    m_proceduralPrimitives = src->m_proceduralPrimitives;
+    m_instances = src->m_instances;
+    m_geometryFlags = src->m_geometryFlags;
+    m_primitiveOrder = src->m_primitiveOrder;
+    m_wideNodes = src->m_wideNodes;
+    m_trianglePackets = src->m_trianglePackets;
+    if (mode == AccelerationStructureCopyMode::Compact)
+    {
+        m_nodes.shrink_to_fit();
+        m_triangles.shrink_to_fit();
+        m_proceduralPrimitives.shrink_to_fit();
+        m_instances.shrink_to_fit();
+        m_wideNodes.shrink_to_fit();
+        m_trianglePackets.shrink_to_fit();
+    }
+}
+
+Size AccelerationStructureImpl::getUsedSize() const
+{
+    return getVectorSize(m_nodes) + getVectorSize(m_triangles) + getVectorSize(m_proceduralPrimitives) +
+           getVectorSize(m_instances) + getVectorSize(m_geometryFlags) + getVectorSize(m_primitiveOrder) +
+           getVectorSize(m_wideNodes) + getVectorSize(m_trianglePackets);
+}
+
+Result AccelerationStructureImpl::getNativeHandle(NativeHandle* outHandle)
+{
+    *outHandle = {};
+    return SLANG_E_NOT_AVAILABLE;
+}
+
+AccelerationStructureHandle AccelerationStructureImpl::getHandle()
+{
+    return AccelerationStructureHandle{uint64_t(this)};
+}
+
+DeviceAddress AccelerationStructureImpl::getDeviceAddress()
+{
+    // Kernels access acceleration structures through the prelude interface.
+    return DeviceAddress(static_cast<slang_prelude::IRaytracingAccelerationStructure*>(this));
+}
+
+Result getAccelerationStructureSizes(const AccelerationStructureBuildDesc& desc, AccelerationStructureSizes* outSizes)
+{
+    AccelerationStructureBuildInputType type;
+    uint32_t primitiveCount;
+    SLANG_RETURN_ON_FAIL(validateBuildDesc(desc, type, primitiveCount));
+
+    // Each primitive adds at most one 4-wide node and, for triangles, one triangle packet.
+    Size primitiveSize = sizeof(BVH4Node);
+    switch (type)
+    {
+    case AccelerationStructureBuildInputType::Instances:
+        primitiveSize += sizeof(BVHInstance);
+        break;
+    case AccelerationStructureBuildInputType::Triangles:
+        primitiveSize += sizeof(BVHTriangle) + sizeof(BVHTrianglePacket);
+        break;
+    case AccelerationStructureBuildInputType::ProceduralPrimitives:
+        primitiveSize += sizeof(BVHProceduralPrimitive);
+        break;
+    }
+    if (is_set(desc.flags, AccelerationStructureBuildFlags::AllowUpdate))
+        primitiveSize += sizeof(uint32_t);
+
+    // A binary tree with single primitive leaves has at most 2n-1 nodes.
+    Size maxNodeCount = primitiveCount > 0 ? Size(primitiveCount) * 2 - 1 : 0;
+    outSizes->accelerationStructureSize = maxNodeCount * sizeof(BVHNode) + primitiveCount * primitiveSize +
+                                          desc.inputCount * sizeof(AccelerationStructureGeometryFlags);
+    outSizes->scratchSize = primitiveCount * (sizeof(PrimitiveRef) + sizeof(AABB) + sizeof(uint32_t));
+    outSizes->updateScratchSize = primitiveCount * (sizeof(AABB) + sizeof(uint32_t));
+    return SLANG_OK;
+}
+
+} // namespace rhi::cpu
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "cpu-base.h"
+
+#include <vector>
+
+namespace rhi::cpu {
+
+class ThreadPool;
+
+/// BVH node. Inner nodes reference two adjacent child nodes starting at `childOrFirst`,
+/// leaves reference `primitiveCount` consecutive primitives starting at `childOrFirst`.
+/// Child nodes are always stored after their parent.
+struct BVHNode
+{
+    float boundsMin[3];
+    uint32_t childOrFirst;
+    float boundsMax[3];
+    uint32_t primitiveCount;
+
+    bool isLeaf() const { return primitiveCount != 0; }
+};
+
+struct BVHTriangle
+{
+    float vertices[3][3];
+    uint32_t geometryIndex;
+    uint32_t primitiveIndex;
+};
+
+struct BVHProceduralPrimitive
+{
+    float boundsMin[3];
+    float boundsMax[3];
+    uint32_t geometryIndex;
+    uint32_t primitiveIndex;
+};
+
+struct BVHInstance
+{
+    float transform[3][4];
+    float inverseTransform[3][4];
+    uint32_t instanceIndex;
+    uint32_t instanceID;
+    uint32_t instanceMask;
+    uint32_t instanceContributionToHitGroupIndex;
+    AccelerationStructureInstanceFlags flags;
+    AccelerationStructureImpl* accelerationStructure;
+};
+
+/// 4-wide BVH node used for traversal, the child bounds are stored in SoA layout so that a ray
+/// is tested against all children at once. `bounds[0]` holds the minimum and `bounds[1]` the
+/// maximum corners, unused child slots have inverted bounds and are never hit.
+struct BVH4Node
+{
+    float bounds[2][3][4];
+    /// Child node index for inner children, first primitive for leaves.
+    /// Triangle leaves reference triangle packets instead of triangles.
+    uint32_t children[4];
+    /// Number of primitives in leaf children, 0 for inner children.
+    uint32_t counts[4];
+};
+
+/// Four triangles in SoA layout, tested against a ray at once.
+struct BVHTrianglePacket
+{
+    float v0[3][4];
+    float e1[3][4];
+    float e2[3][4];
+    /// Index into the triangle list, `kInvalidTriangle` for unused lanes.
+    uint32_t triangles[4];
+
+    static const uint32_t kInvalidTriangle = ~0u;
+};
+
+class AccelerationStructureImpl : public AccelerationStructure, public slang_prelude::IRaytracingAccelerationStructure
+{
+public:
+    AccelerationStructureBuildInputType m_type = AccelerationStructureBuildInputType::Triangles;
+    std::vector<BVHNode> m_nodes;
+    /// Primitives in leaf order, only the list matching `m_type` is used.
+    std::vector<BVHTriangle> m_triangles;
+    std::vector<BVHProceduralPrimitive> m_proceduralPrimitives;
+    std::vector<BVHInstance> m_instances;
+    std::vector<AccelerationStructureGeometryFlags> m_geometryFlags;
+    /// Maps leaf order to input order, only kept for structures built with `AllowUpdate`.
+    std::vector<uint32_t> m_primitiveOrder;
+    /// Traversal tree collapsed from `m_nodes`.
+    std::vector<BVH4Node> m_wideNodes;
+    std::vector<BVHTrianglePacket> m_trianglePackets;
+
+public:
+    AccelerationStructureImpl(const AccelerationStructureDesc& desc)
+        : AccelerationStructure(desc)
+    {
+    }
+
+    /// Build from `desc`, or refit the topology of `src` to the new inputs in `Update` mode.
+    Result build(const AccelerationStructureBuildDesc& desc, AccelerationStructureImpl* src, ThreadPool* threadPool);
+
+    void copyFrom(AccelerationStructureImpl* src, AccelerationStructureCopyMode mode);
+
+    /// Memory used by the built structure in bytes.
+    Size getUsedSize() const;
+
+    /// Collapse the binary tree into the 4-wide traversal tree.
+    void buildWideBVH();
+
+    // IRaytracingAccelerationStructure implementation
+    virtual bool TraceRay(
+        const slang_prelude::RayDesc& ray,
+        uint32_t rayFlags,
+        uint32_t instanceInclusionMask,
+        slang_prelude::RayHit* outHit
+    ) override;
+
+    // IAccelerationStructure implementation
+    virtual SLANG_NO_THROW Result SLANG_MCALL getNativeHandle(NativeHandle* outHandle) override;
+    virtual SLANG_NO_THROW AccelerationStructureHandle SLANG_MCALL getHandle() override;
+    virtual SLANG_NO_THROW DeviceAddress SLANG_MCALL getDeviceAddress() override;
+};
+
+Result getAccelerationStructureSizes(const AccelerationStructureBuildDesc& desc, AccelerationStructureSizes* outSizes);
+
+} // namespace rhi::cpu
@@ -0,0 +1,234 @@
+#include "cpu-allocator.h"
+#include "cpu-thread-pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#if SLANG_WINDOWS_FAMILY
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#if SLANG_LINUX_FAMILY
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace rhi::cpu {
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+MemoryAllocator::MemoryAllocator(const CPUDeviceExtendedDesc& desc, ThreadPool* threadPool)
+    : m_allocateFunc(desc.allocateFunc)
+    , m_freeFunc(desc.freeFunc)
+    , m_userData(desc.allocatorUserData)
+    , m_hugePageThreshold(desc.hugePageThreshold)
+    , m_numaNode(desc.numaNode)
+    , m_firstTouch(desc.firstTouchLargeResources && desc.numaNode < 0)
+    , m_threadPool(threadPool)
+{
+    // A custom allocator needs both functions.
+    if (!m_allocateFunc || !m_freeFunc)
+    {
+        m_allocateFunc = nullptr;
+        m_freeFunc = nullptr;
+    }
+}
+
+void* MemoryAllocator::allocate(size_t size)
+{
+    size = std::max(size, size_t(1));
+
+    void* data = nullptr;
+    if (m_allocateFunc)
+    {
+        data = m_allocateFunc(m_userData, size, kMinAlignment);
+    }
+    else if (size >= kLargeAllocationSize)
+    {
+        data = allocateLarge(size);
+    }
+    else
+    {
+#if SLANG_WINDOWS_FAMILY
+        data = _aligned_malloc(size, kMinAlignment);
+#else
+        if (posix_memalign(&data, kMinAlignment, size) != 0)
+            data = nullptr;
+#endif
+    }
+    if (!data)
+        return nullptr;
+
+    m_allocationCount++;
+    m_totalAllocationCount++;
+    if (usesHugePages(size))
+        m_hugePageBytes += size;
+    uint64_t allocatedBytes = m_allocatedBytes += size;
+    uint64_t peak = m_peakAllocatedBytes.load();
+    while (allocatedBytes > peak && !m_peakAllocatedBytes.compare_exchange_weak(peak, allocatedBytes))
+    {
+    }
+    return data;
+}
+
+void MemoryAllocator::free(void* data, size_t size)
+{
+    if (!data)
+        return;
+    size = std::max(size, size_t(1));
+
+    m_allocationCount--;
+    m_allocatedBytes -= size;
+    if (usesHugePages(size))
+        m_hugePageBytes -= size;
+    if (m_freeFunc)
+    {
+        m_freeFunc(m_userData, data, size);
+    }
+    else if (size >= kLargeAllocationSize)
+    {
+        freeLarge(data, size);
+    }
+    else
+    {
+#if SLANG_WINDOWS_FAMILY
+        _aligned_free(data);
+#else
+        ::free(data);
+#endif
+    }
+}
+
+bool MemoryAllocator::usesHugePages(size_t size) const
+{
+#if SLANG_WINDOWS_FAMILY
+    // Large pages require the lock memory privilege, allocations use regular pages.
+    SLANG_UNUSED(size);
+    return false;
+#else
+    return !m_allocateFunc && size >= kLargeAllocationSize && m_hugePageThreshold != 0 && size >= m_hugePageThreshold;
+#endif
+}
+
+void MemoryAllocator::getStats(DeviceMemoryStats& outStats) const
+{
+    outStats.allocationCount = m_allocationCount;
+    outStats.allocatedBytes = m_allocatedBytes;
+    outStats.peakAllocatedBytes = m_peakAllocatedBytes;
+    outStats.totalAllocationCount = m_totalAllocationCount;
+    outStats.hugePageBytes = m_hugePageBytes;
+}
+
+// Large allocations are mapped in multiples of the huge page size, so that `freeLarge` can unmap them
+// without knowing whether huge pages were used.
+void* MemoryAllocator::allocateLarge(size_t size)
+{
+    bool hugePages = usesHugePages(size);
+    size_t mappedSize = alignUp(size, kLargeAllocationSize);
+
+#if SLANG_WINDOWS_FAMILY
+    SLANG_UNUSED(hugePages);
+    void* data = nullptr;
+    if (m_numaNode >= 0)
+    {
+        data = VirtualAllocExNuma(
+            GetCurrentProcess(),
+            nullptr,
+            mappedSize,
+            MEM_RESERVE | MEM_COMMIT,
+            PAGE_READWRITE,
+            DWORD(m_numaNode)
+        );
+    }
+    if (!data)
+        data = VirtualAlloc(nullptr, mappedSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!data)
+        return nullptr;
+#else
+    void* data = nullptr;
+#if defined(MAP_HUGETLB)
+    // Reserved huge pages are used when available, mapping fails quickly otherwise.
+    if (hugePages)
+    {
+        data = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data == MAP_FAILED)
+            data = nullptr;
+    }
+#endif
+    if (!data)
+    {
+        // Over-allocate to align the mapping to the huge page size, which is required for transparent huge pages.
+        size_t reservedSize = mappedSize + kLargeAllocationSize;
+        void* reserved = mmap(nullptr, reservedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (reserved == MAP_FAILED)
+            return nullptr;
+        uintptr_t start = alignUp(uintptr_t(reserved), kLargeAllocationSize);
+        size_t headSize = start - uintptr_t(reserved);
+        if (headSize != 0)
+            munmap(reserved, headSize);
+        size_t tailSize = reservedSize - headSize - mappedSize;
+        if (tailSize != 0)
+            munmap((void*)(start + mappedSize), tailSize);
+        data = (void*)start;
+#if defined(MADV_HUGEPAGE)
+        if (hugePages)
+            madvise(data, mappedSize, MADV_HUGEPAGE);
+#endif
+    }
+
+#if SLANG_LINUX_FAMILY && defined(SYS_mbind)
+    if (m_numaNode >= 0 && m_numaNode < 64)
+    {
+        // MPOL_BIND, pages are allocated on the node on first touch.
+        const int kMpolBind = 2;
+        unsigned long nodeMask = 1ul << m_numaNode;
+        syscall(SYS_mbind, data, mappedSize, kMpolBind, &nodeMask, sizeof(nodeMask) * 8, 0);
+    }
+#endif
+#endif
+
+    if (m_firstTouch)
+        touchPages(data, mappedSize);
+    return data;
+}
+
+void MemoryAllocator::freeLarge(void* data, size_t size)
+{
+#if SLANG_WINDOWS_FAMILY
+    SLANG_UNUSED(size);
+    VirtualFree(data, 0, MEM_RELEASE);
+#else
+    munmap(data, alignUp(size, kLargeAllocationSize));
+#endif
+}
+
+void MemoryAllocator::touchPages(void* data, size_t size)
+{
+    if (!m_threadPool || m_threadPool->getThreadCount() <= 1)
+        return;
+#if SLANG_WINDOWS_FAMILY
+    size_t pageSize = 4096;
+#else
+    size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+#endif
+    // Contiguous ranges per task, matching how dispatches distribute neighbouring thread groups.
+    uint32_t taskCount = uint32_t(std::min(size / kLargeAllocationSize, size_t(m_threadPool->getThreadCount())));
+    size_t taskSize = alignUp(size / taskCount, kLargeAllocationSize);
+    m_threadPool->parallelFor(
+        taskCount,
+        [&](uint32_t taskIndex)
+        {
+            size_t begin = taskIndex * taskSize;
+            size_t end = std::min(size, begin + taskSize);
+            for (size_t offset = begin; offset < end; offset += pageSize)
+                ((volatile uint8_t*)data)[offset] = 0;
+        }
+    );
+}
+
+} // namespace rhi::cpu
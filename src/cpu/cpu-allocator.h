@@ -0,0 +1,59 @@
+#pragma once
+
+#include <slang-rhi.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace rhi::cpu {
+
+class ThreadPool;
+
+/// Allocates the memory of buffers and textures.
+/// All allocations are aligned to at least `kMinAlignment` bytes, allocations of `kLargeAllocationSize` or
+/// more are mapped directly from the OS, which allows backing them by huge pages and placing them on a NUMA node.
+/// Shared by the device and its resources, resources may outlive the device.
+class MemoryAllocator
+{
+public:
+    static const size_t kMinAlignment = 64;
+    static const size_t kLargeAllocationSize = 2 * 1024 * 1024;
+
+    MemoryAllocator(const CPUDeviceExtendedDesc& desc, ThreadPool* threadPool);
+
+    /// Allocate `size` bytes. Returns nullptr if out of memory.
+    void* allocate(size_t size);
+
+    /// Free memory returned by `allocate` with the same `size`.
+    void free(void* data, size_t size);
+
+    void getStats(DeviceMemoryStats& outStats) const;
+
+private:
+    bool usesHugePages(size_t size) const;
+
+    void* allocateLarge(size_t size);
+    void freeLarge(void* data, size_t size);
+
+    /// Write to every page of a new allocation from the worker threads, so that with a first-touch
+    /// NUMA policy pages end up on the nodes of the workers that process neighbouring data.
+    void touchPages(void* data, size_t size);
+
+    CPUAllocateFunc m_allocateFunc;
+    CPUFreeFunc m_freeFunc;
+    void* m_userData;
+    size_t m_hugePageThreshold;
+    int32_t m_numaNode;
+    bool m_firstTouch;
+    /// Only used while allocating, which happens on calls to the device.
+    ThreadPool* m_threadPool;
+
+    std::atomic<uint64_t> m_allocationCount{0};
+    std::atomic<uint64_t> m_allocatedBytes{0};
+    std::atomic<uint64_t> m_peakAllocatedBytes{0};
+    std::atomic<uint64_t> m_totalAllocationCount{0};
+    std::atomic<uint64_t> m_hugePageBytes{0};
+};
+
+} // namespace rhi::cpu
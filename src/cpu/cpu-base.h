@@ -27,8 +27,12 @@ class MutableShaderObjectImpl;
 class EntryPointShaderObjectImpl;
 class RootShaderObjectImpl;
 class ShaderProgramImpl;
+struct KernelLibrary;
 class ComputePipelineImpl;
 class QueryPoolImpl;
+class SamplerImpl;
+class FenceImpl;
+class AccelerationStructureImpl;
 class DeviceImpl;
 
 } // namespace rhi::cpu
@@ -1,29 +1,182 @@
 #include "cpu-buffer.h"
 
+#if SLANG_WINDOWS_FAMILY
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace rhi::cpu {
 
 BufferImpl::~BufferImpl()
 {
-    if (m_data)
+    if (m_mappedView)
+    {
+#if SLANG_WINDOWS_FAMILY
+        UnmapViewOfFile(m_mappedView);
+#else
+        munmap(m_mappedView, m_mappedViewSize);
+#endif
+    }
+    else if (m_isExternalMemory)
     {
-        free(m_data);
+        if (m_releaseFunc)
+            m_releaseFunc(m_releaseUserData);
+    }
+    else if (m_allocator)
+    {
+        m_allocator->free(m_data, m_desc.size);
     }
 }
 
-Result BufferImpl::init()
+Result BufferImpl::init(std::shared_ptr<MemoryAllocator> allocator)
 {
-    m_data = malloc(m_desc.size);
+    m_data = allocator->allocate(m_desc.size);
     if (!m_data)
         return SLANG_E_OUT_OF_MEMORY;
+    m_allocator = std::move(allocator);
+    return SLANG_OK;
+}
+
+Result BufferImpl::initFromHostMemory(void* data, HostMemoryReleaseFunc releaseFunc, void* releaseUserData)
+{
+    if (!data)
+        return SLANG_E_INVALID_ARG;
+    m_data = data;
+    m_isExternalMemory = true;
+    m_releaseFunc = releaseFunc;
+    m_releaseUserData = releaseUserData;
     return SLANG_OK;
 }
 
+Result BufferImpl::initFromFile(const char* path, uint64_t fileOffset, FileMappingMode mode)
+{
+    if (!path)
+        return SLANG_E_INVALID_ARG;
+
+#if SLANG_WINDOWS_FAMILY
+    HANDLE file = CreateFileA(
+        path,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE)
+        return SLANG_E_NOT_FOUND;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return SLANG_FAIL;
+    }
+    uint64_t size = uint64_t(fileSize.QuadPart);
+#else
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+        return SLANG_E_NOT_FOUND;
+    struct stat fileStat;
+    if (fstat(file, &fileStat) != 0)
+    {
+        close(file);
+        return SLANG_FAIL;
+    }
+    uint64_t size = uint64_t(fileStat.st_size);
+#endif
+
+    // The range must lie within the file, mapping past its end faults on access.
+    Result result = SLANG_OK;
+    if (fileOffset > size || m_desc.size > size - fileOffset)
+        result = SLANG_E_INVALID_ARG;
+    else if (m_desc.size == 0)
+        m_desc.size = size - fileOffset;
+    if (SLANG_SUCCEEDED(result) && m_desc.size == 0)
+        result = SLANG_E_INVALID_ARG;
+
+    // Views must start at a multiple of the allocation granularity.
+#if SLANG_WINDOWS_FAMILY
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    uint64_t granularity = systemInfo.dwAllocationGranularity;
+#else
+    uint64_t granularity = uint64_t(sysconf(_SC_PAGESIZE));
+#endif
+    uint64_t viewOffset = fileOffset - fileOffset % granularity;
+    size_t viewSize = size_t(fileOffset - viewOffset + m_desc.size);
+
+    if (SLANG_SUCCEEDED(result))
+    {
+#if SLANG_WINDOWS_FAMILY
+        HANDLE mapping = CreateFileMappingA(
+            file,
+            nullptr,
+            mode == FileMappingMode::CopyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY,
+            0,
+            0,
+            nullptr
+        );
+        if (mapping)
+        {
+            m_mappedView = MapViewOfFile(
+                mapping,
+                mode == FileMappingMode::CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ,
+                DWORD(viewOffset >> 32),
+                DWORD(viewOffset & 0xffffffff),
+                viewSize
+            );
+            // The view keeps the mapping alive.
+            CloseHandle(mapping);
+        }
+#else
+        void* view = mmap(
+            nullptr,
+            viewSize,
+            mode == FileMappingMode::CopyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ,
+            MAP_PRIVATE,
+            file,
+            off_t(viewOffset)
+        );
+        m_mappedView = view == MAP_FAILED ? nullptr : view;
+#endif
+        if (m_mappedView)
+        {
+            m_mappedViewSize = viewSize;
+            m_data = (uint8_t*)m_mappedView + (fileOffset - viewOffset);
+            m_isExternalMemory = true;
+        }
+        else
+        {
+            result = SLANG_E_OUT_OF_MEMORY;
+        }
+    }
+
+#if SLANG_WINDOWS_FAMILY
+    CloseHandle(file);
+#else
+    close(file);
+#endif
+    return result;
+}
+
 Result BufferImpl::setData(size_t offset, size_t size, void const* data)
 {
     memcpy((char*)m_data + offset, data, size);
     return SLANG_OK;
 }
 
+Result BufferImpl::getNativeHandle(NativeHandle* outHandle)
+{
+    outHandle->type = NativeHandleType::HostPointer;
+    outHandle->value = (uint64_t)m_data;
+    return SLANG_OK;
+}
+
 DeviceAddress BufferImpl::getDeviceAddress()
 {
     return (DeviceAddress)m_data;
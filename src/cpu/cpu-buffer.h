@@ -1,7 +1,10 @@
 #pragma once
 
+#include "cpu-allocator.h"
 #include "cpu-base.h"
 
+#include <memory>
+
 namespace rhi::cpu {
 
 class BufferImpl : public Buffer
@@ -14,11 +17,28 @@ public:
 
     ~BufferImpl();
 
-    Result init();
+    Result init(std::shared_ptr<MemoryAllocator> allocator);
+    /// Use existing host memory, `releaseFunc` is called on destruction.
+    Result initFromHostMemory(void* data, HostMemoryReleaseFunc releaseFunc, void* releaseUserData);
+    /// Map `path` starting at `fileOffset`, a zero `m_desc.size` is set to the remaining file size.
+    Result initFromFile(const char* path, uint64_t fileOffset, FileMappingMode mode);
 
     Result setData(size_t offset, size_t size, void const* data);
 
     void* m_data = nullptr;
+    /// Allocator of `m_data` for buffers owning their memory.
+    std::shared_ptr<MemoryAllocator> m_allocator;
+
+    /// Set for buffers using host memory they do not own.
+    bool m_isExternalMemory = false;
+    HostMemoryReleaseFunc m_releaseFunc = nullptr;
+    void* m_releaseUserData = nullptr;
+
+    /// Start and size of the file mapping, `m_data` is offset within it to the requested file offset.
+    void* m_mappedView = nullptr;
+    size_t m_mappedViewSize = 0;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getNativeHandle(NativeHandle* outHandle) override;
 
     virtual SLANG_NO_THROW DeviceAddress SLANG_MCALL getDeviceAddress() override;
 
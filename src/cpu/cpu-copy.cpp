@@ -0,0 +1,170 @@
+#include "cpu-copy.h"
+#include "cpu-simd.h"
+#include "cpu-thread-pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace rhi::cpu {
+
+static const size_t kVectorSize = 16;
+static const size_t kCacheLineSize = 64;
+/// Longest repetition period of a fill pattern that is stored with vectors.
+static const size_t kMaxFillPeriod = 64;
+
+void parallelForRanges(
+    ThreadPool* threadPool,
+    size_t count,
+    size_t bytesPerItem,
+    const std::function<void(size_t begin, size_t end)>& func
+)
+{
+    if (count == 0)
+        return;
+    size_t taskCount = 1;
+    if (threadPool)
+    {
+        size_t totalSize = count * std::max(bytesPerItem, size_t(1));
+        taskCount = std::min(size_t(threadPool->getThreadCount()), totalSize / kParallelCopyBlockSize);
+        taskCount = std::min(taskCount, count);
+    }
+    if (taskCount <= 1)
+    {
+        func(0, count);
+        return;
+    }
+    size_t itemsPerTask = (count + taskCount - 1) / taskCount;
+    threadPool->parallelFor(
+        uint32_t(taskCount),
+        [&](uint32_t taskIndex)
+        {
+            size_t begin = taskIndex * itemsPerTask;
+            size_t end = std::min(count, begin + itemsPerTask);
+            if (begin < end)
+                func(begin, end);
+        }
+    );
+}
+
+void copyMemory(ThreadPool* threadPool, void* dst, const void* src, size_t size)
+{
+    // The C library already switches to non-temporal stores for copies exceeding the caches,
+    // each thread copies a contiguous range with it.
+    size_t lineCount = (size + kCacheLineSize - 1) / kCacheLineSize;
+    parallelForRanges(
+        threadPool,
+        lineCount,
+        kCacheLineSize,
+        [&](size_t begin, size_t end)
+        {
+            size_t offset = begin * kCacheLineSize;
+            size_t rangeSize = std::min(size, end * kCacheLineSize) - offset;
+            memcpy((uint8_t*)dst + offset, (const uint8_t*)src + offset, rangeSize);
+        }
+    );
+}
+
+/// Store `size` bytes, a multiple of `period`, repeating the `period` bytes at `vectors`.
+/// `dst` must be aligned to the vector size.
+static void storeVectors(uint8_t* dst, size_t size, const uint8_t* vectors, size_t period, bool nonTemporal)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    const size_t kMaxVectorCount = kMaxFillPeriod / kVectorSize;
+    __m128i v[kMaxVectorCount];
+    size_t vectorCount = period / kVectorSize;
+    for (size_t i = 0; i < vectorCount; i++)
+        v[i] = _mm_loadu_si128((const __m128i*)(vectors + i * kVectorSize));
+    if (nonTemporal)
+    {
+        for (size_t offset = 0; offset < size; offset += period)
+            for (size_t i = 0; i < vectorCount; i++)
+                _mm_stream_si128((__m128i*)(dst + offset + i * kVectorSize), v[i]);
+        // Non-temporal stores are weakly ordered, make them visible before the command completes.
+        _mm_sfence();
+    }
+    else
+    {
+        for (size_t offset = 0; offset < size; offset += period)
+            for (size_t i = 0; i < vectorCount; i++)
+                _mm_store_si128((__m128i*)(dst + offset + i * kVectorSize), v[i]);
+    }
+#else
+    SLANG_UNUSED(nonTemporal);
+    for (size_t offset = 0; offset < size; offset += period)
+        memcpy(dst + offset, vectors, period);
+#endif
+}
+
+/// Fill a range starting at the beginning of the pattern.
+/// `line` holds the pattern repeated over two periods.
+static void fillRange(uint8_t* dst, size_t size, const uint8_t* line, size_t period, bool nonTemporal)
+{
+    // Store up to the first aligned vector, the pattern then continues at the same phase.
+    size_t head = std::min(size, (kVectorSize - uintptr_t(dst) % kVectorSize) % kVectorSize);
+    memcpy(dst, line, head);
+    dst += head;
+    size -= head;
+    const uint8_t* vectors = line + head;
+    size_t bodySize = size / period * period;
+    storeVectors(dst, bodySize, vectors, period, nonTemporal);
+    memcpy(dst + bodySize, vectors, size - bodySize);
+}
+
+static size_t gcd(size_t a, size_t b)
+{
+    while (b != 0)
+    {
+        size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+void fillMemory(ThreadPool* threadPool, void* dst, size_t size, const void* pattern, size_t patternSize)
+{
+    if (size == 0 || patternSize == 0)
+        return;
+
+    // The pattern repeats at the least common multiple of its size and the vector size.
+    size_t period = patternSize / gcd(patternSize, kVectorSize) * kVectorSize;
+    if (period > kMaxFillPeriod)
+    {
+        // Uncommon pattern sizes, double the filled range until done.
+        uint8_t* out = (uint8_t*)dst;
+        size_t filled = std::min(size, patternSize);
+        memcpy(out, pattern, filled);
+        while (filled < size)
+        {
+            size_t count = std::min(filled, size - filled);
+            memcpy(out + filled, out, count);
+            filled += count;
+        }
+        return;
+    }
+    // Store whole cache lines per iteration where the period allows it.
+    if (kCacheLineSize % period == 0)
+        period = kCacheLineSize;
+
+    uint8_t line[2 * kMaxFillPeriod];
+    for (size_t offset = 0; offset < 2 * period; offset += patternSize)
+        memcpy(line + offset, pattern, patternSize);
+
+    bool nonTemporal = size >= kNonTemporalFillSize;
+    // Blocks start at the beginning of the pattern.
+    size_t blockSize = period * 1024;
+    size_t blockCount = (size + blockSize - 1) / blockSize;
+    parallelForRanges(
+        threadPool,
+        blockCount,
+        blockSize,
+        [&](size_t begin, size_t end)
+        {
+            size_t offset = begin * blockSize;
+            size_t rangeSize = std::min(size, end * blockSize) - offset;
+            fillRange((uint8_t*)dst + offset, rangeSize, line, period, nonTemporal);
+        }
+    );
+}
+
+} // namespace rhi::cpu
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace rhi::cpu {
+
+class ThreadPool;
+
+/// Minimum number of bytes processed by each worker thread, smaller operations run on the calling thread.
+static const size_t kParallelCopyBlockSize = 1024 * 1024;
+
+/// Fills of at least this size use non-temporal stores, which bypass the caches instead of
+/// evicting their contents for data that is not read back soon.
+static const size_t kNonTemporalFillSize = 4 * 1024 * 1024;
+
+/// Call `func` for contiguous ranges covering [0, count), split across the threads of `threadPool`
+/// once every thread gets at least `kParallelCopyBlockSize` bytes to process.
+void parallelForRanges(
+    ThreadPool* threadPool,
+    size_t count,
+    size_t bytesPerItem,
+    const std::function<void(size_t begin, size_t end)>& func
+);
+
+/// Copy `size` bytes between non-overlapping ranges, large copies are split across the worker threads.
+void copyMemory(ThreadPool* threadPool, void* dst, const void* src, size_t size);
+
+/// Fill `size` bytes with repetitions of a `patternSize` byte pattern.
+/// Large fills are split across the worker threads and use non-temporal stores.
+void fillMemory(ThreadPool* threadPool, void* dst, size_t size, const void* pattern, size_t patternSize);
+
+} // namespace rhi::cpu
@@ -1,25 +1,44 @@
 #include "cpu-device.h"
 
+#include "cpu-acceleration-structure.h"
 #include "cpu-buffer.h"
+#include "cpu-copy.h"
+#include "cpu-fence.h"
+#include "cpu-mip-generator.h"
 #include "cpu-pipeline.h"
 #include "cpu-query.h"
+#include "cpu-sampler.h"
 #include "cpu-shader-object.h"
 #include "cpu-shader-program.h"
 #include "cpu-texture.h"
 #include "cpu-texture-view.h"
 
+#include <algorithm>
 #include <chrono>
 
 namespace rhi::cpu {
 
+// Number of chunks a dispatch is split into per worker thread.
+static const uint32_t kDispatchChunksPerThread = 4;
+
 DeviceImpl::~DeviceImpl()
 {
+    m_queue->shutdown();
     m_currentPipeline = nullptr;
     m_currentRootObject = nullptr;
+    m_threadPool.reset();
 }
 
 Result DeviceImpl::initialize(const DeviceDesc& desc)
 {
+    for (GfxIndex i = 0; i < desc.extendedDescCount; i++)
+    {
+        StructType stype;
+        memcpy(&stype, desc.extendedDescs[i], sizeof(stype));
+        if (stype == StructType::CPUDeviceExtendedDesc)
+            memcpy(&m_extendedDesc, desc.extendedDescs[i], sizeof(m_extendedDesc));
+    }
+
     SLANG_RETURN_ON_FAIL(slangContext.initialize(
         desc.slang,
         desc.extendedDescCount,
@@ -46,6 +65,15 @@ Result DeviceImpl::initialize(const DeviceDesc& desc)
         m_features.push_back("has-ptr");
     }
 
+    // Acceleration structures are built and traced on the host through `IRaytracingAccelerationStructure`.
+    // "ray-tracing", "ray-query" and "wave-ops" are not advertised, as Slang cannot generate C++ for TraceRay,
+    // RayQuery or wave operations.
+    m_features.push_back("acceleration-structure");
+
+    m_threadPool = std::make_unique<ThreadPool>(m_extendedDesc.workerThreadCount);
+    m_allocator = std::make_shared<MemoryAllocator>(m_extendedDesc, m_threadPool.get());
+    m_asyncSubmit = m_extendedDesc.asynchronousSubmit;
+
     return SLANG_OK;
 }
 
@@ -53,7 +81,10 @@ Result DeviceImpl::createTexture(const TextureDesc& desc, const SubresourceData*
 {
     TextureDesc srcDesc = fixupTextureDesc(desc);
     RefPtr<TextureImpl> texture = new TextureImpl(srcDesc);
-    SLANG_RETURN_ON_FAIL(texture->init(initData));
+    uint32_t tilingThreshold = m_extendedDesc.textureTilingThreshold;
+    texture->m_isTiled = tilingThreshold != 0 && uint32_t(srcDesc.size.width) >= tilingThreshold &&
+                         uint32_t(srcDesc.size.height) >= tilingThreshold;
+    SLANG_RETURN_ON_FAIL(texture->init(m_allocator, initData));
 
     returnComPtr(outTexture, texture);
     return SLANG_OK;
@@ -63,7 +94,7 @@ Result DeviceImpl::createBuffer(const BufferDesc& descIn, const void* initData,
 {
     auto desc = fixupBufferDesc(descIn);
     RefPtr<BufferImpl> buffer = new BufferImpl(desc);
-    SLANG_RETURN_ON_FAIL(buffer->init());
+    SLANG_RETURN_ON_FAIL(buffer->init(m_allocator));
     if (initData)
     {
         SLANG_RETURN_ON_FAIL(buffer->setData(0, desc.size, initData));
@@ -72,6 +103,66 @@ Result DeviceImpl::createBuffer(const BufferDesc& descIn, const void* initData,
     return SLANG_OK;
 }
 
+Result DeviceImpl::queryInterface(SlangUUID const& uuid, void** outObject)
+{
+    if (uuid == GUID::IID_ICPUDevice)
+    {
+        *outObject = static_cast<ICPUDevice*>(this);
+        addRef();
+        return SLANG_OK;
+    }
+    return ImmediateComputeDeviceBase::queryInterface(uuid, outObject);
+}
+
+Result DeviceImpl::getMemoryStats(DeviceMemoryStats* outStats)
+{
+    m_allocator->getStats(*outStats);
+    return SLANG_OK;
+}
+
+Result DeviceImpl::createBufferFromNativeHandle(NativeHandle handle, const BufferDesc& srcDesc, IBuffer** outBuffer)
+{
+    if (handle.type != NativeHandleType::HostPointer)
+        return SLANG_E_INVALID_ARG;
+    return createBufferFromHostMemory(srcDesc, (void*)handle.value, nullptr, nullptr, outBuffer);
+}
+
+Result DeviceImpl::createBufferFromHostMemory(
+    const BufferDesc& descIn,
+    void* data,
+    HostMemoryReleaseFunc releaseFunc,
+    void* releaseUserData,
+    IBuffer** outBuffer
+)
+{
+    auto desc = fixupBufferDesc(descIn);
+    RefPtr<BufferImpl> buffer = new BufferImpl(desc);
+    SLANG_RETURN_ON_FAIL(buffer->initFromHostMemory(data, releaseFunc, releaseUserData));
+    returnComPtr(outBuffer, buffer);
+    return SLANG_OK;
+}
+
+Result DeviceImpl::createBufferFromFile(
+    const BufferDesc& descIn,
+    const char* path,
+    uint64_t fileOffset,
+    FileMappingMode mode,
+    IBuffer** outBuffer
+)
+{
+    // Read-only mappings fault on the first write, including writes through `map()` of upload buffers.
+    if (mode == FileMappingMode::ReadOnly &&
+        (is_set(descIn.usage, BufferUsage::UnorderedAccess) || is_set(descIn.usage, BufferUsage::CopyDestination) ||
+         descIn.memoryType == MemoryType::Upload))
+        return SLANG_E_INVALID_ARG;
+
+    auto desc = fixupBufferDesc(descIn);
+    RefPtr<BufferImpl> buffer = new BufferImpl(desc);
+    SLANG_RETURN_ON_FAIL(buffer->initFromFile(path, fileOffset, mode));
+    returnComPtr(outBuffer, buffer);
+    return SLANG_OK;
+}
+
 Result DeviceImpl::createTextureView(ITexture* texture, const TextureViewDesc& desc, ITextureView** outView)
 {
     RefPtr<TextureViewImpl> view = new TextureViewImpl(desc);
@@ -83,6 +174,41 @@ Result DeviceImpl::createTextureView(ITexture* texture, const TextureViewDesc& d
     return SLANG_OK;
 }
 
+Result DeviceImpl::readTexture(ITexture* texture, ISlangBlob** outBlob, Size* outRowPitch, Size* outPixelSize)
+{
+    // Make sure work writing to the texture has completed.
+    m_queue->waitForIdle();
+
+    auto textureImpl = checked_cast<TextureImpl*>(texture);
+    auto& mipLevel = textureImpl->m_mipLevels[0];
+    size_t pixelSize = textureImpl->m_texelSize;
+    size_t rowPitch = mipLevel.extents[0] * pixelSize;
+    size_t rowCount = size_t(mipLevel.extents[1]) * mipLevel.extents[2];
+
+    auto blob = OwnedBlob::create(rowPitch * rowCount);
+    uint8_t* dst = (uint8_t*)blob->getBufferPointer();
+    const uint8_t* src = (const uint8_t*)textureImpl->m_data + mipLevel.offset;
+    for (int32_t z = 0; z < mipLevel.extents[2]; ++z)
+    {
+        for (int32_t y = 0; y < mipLevel.extents[1]; ++y)
+        {
+            textureImpl->readRow(mipLevel, src, y, z, dst);
+            dst += rowPitch;
+        }
+    }
+
+    *outRowPitch = rowPitch;
+    *outPixelSize = pixelSize;
+
+    returnComPtr(outBlob, blob);
+    return SLANG_OK;
+}
+
+Result DeviceImpl::generateMips(ITexture* texture, const GenerateMipsDesc& desc)
+{
+    return cpu::generateMips(m_threadPool.get(), checked_cast<TextureImpl*>(texture), desc);
+}
+
 Result DeviceImpl::createShaderObjectLayout(
     slang::ISession* session,
     slang::TypeLayoutReflection* typeLayout,
@@ -122,18 +248,25 @@ Result DeviceImpl::createRootShaderObject(IShaderProgram* program, ShaderObjectB
     auto cpuProgram = checked_cast<ShaderProgramImpl*>(program);
     auto cpuProgramLayout = cpuProgram->layout;
 
+    std::lock_guard<std::recursive_mutex> lock(m_slangMutex);
     RefPtr<RootShaderObjectImpl> result = new RootShaderObjectImpl();
     SLANG_RETURN_ON_FAIL(result->init(this, cpuProgramLayout));
     returnRefPtrMove(outObject, result);
     return SLANG_OK;
 }
 
+Result DeviceImpl::resetRootShaderObject(ShaderObjectBase* object)
+{
+    return checked_cast<RootShaderObjectImpl*>(object)->reset();
+}
+
 Result DeviceImpl::createShaderProgram(
     const ShaderProgramDesc& desc,
     IShaderProgram** outProgram,
     ISlangBlob** outDiagnosticBlob
 )
 {
+    std::lock_guard<std::recursive_mutex> lock(m_slangMutex);
     RefPtr<ShaderProgramImpl> cpuProgram = new ShaderProgramImpl();
     cpuProgram->init(desc);
     auto slangGlobalScope = cpuProgram->linkedProgram;
@@ -164,8 +297,42 @@ Result DeviceImpl::createQueryPool(const QueryPoolDesc& desc, IQueryPool** outPo
 
 void DeviceImpl::writeTimestamp(IQueryPool* pool, GfxIndex index)
 {
-    checked_cast<QueryPoolImpl*>(pool)->m_queries[index] =
-        std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    auto poolImpl = checked_cast<QueryPoolImpl*>(pool);
+    if (!poolImpl->isRangeValid(index, 1))
+    {
+        handleMessage(DebugMessageType::Error, DebugMessageSource::Driver, "Query index out of pool bounds");
+        return;
+    }
+    std::vector<uint64_t>& queries = poolImpl->m_queries;
+    switch (poolImpl->m_desc.type)
+    {
+    case QueryType::ComputeShaderInvocations:
+        queries[index] = m_computeShaderInvocations;
+        break;
+    case QueryType::ComputeThreadGroups:
+        queries[index] = m_computeThreadGroups;
+        break;
+    case QueryType::ComputeDispatchTime:
+        queries[index] = m_computeDispatchTime;
+        break;
+    case QueryType::WorkerBusyTime:
+    case QueryType::WorkerIdleTime:
+    {
+        // One query per worker thread, as many as fit into the pool.
+        uint64_t activeTime = m_threadPool->getActiveTime();
+        uint32_t threadCount = std::min(m_threadPool->getThreadCount(), uint32_t(queries.size() - index));
+        for (uint32_t i = 0; i < threadCount; i++)
+        {
+            uint64_t busyTime = m_threadPool->getBusyTime(i);
+            queries[index + i] =
+                poolImpl->m_desc.type == QueryType::WorkerBusyTime ? busyTime : activeTime - busyTime;
+        }
+        break;
+    }
+    default:
+        queries[index] = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+        break;
+    }
 }
 
 const DeviceInfo& DeviceImpl::getDeviceInfo() const
@@ -175,11 +342,74 @@ const DeviceInfo& DeviceImpl::getDeviceInfo() const
 
 Result DeviceImpl::createSampler(SamplerDesc const& desc, ISampler** outSampler)
 {
-    SLANG_UNUSED(desc);
-    *outSampler = nullptr;
+    RefPtr<SamplerImpl> sampler = new SamplerImpl(desc);
+    SLANG_RETURN_ON_FAIL(sampler->init());
+    returnComPtr(outSampler, sampler);
+    return SLANG_OK;
+}
+
+Result DeviceImpl::createFence(const FenceDesc& desc, IFence** outFence)
+{
+    RefPtr<FenceImpl> fence = new FenceImpl();
+    SLANG_RETURN_ON_FAIL(fence->init(this, desc));
+    returnComPtr(outFence, fence);
+    return SLANG_OK;
+}
+
+Result DeviceImpl::getAccelerationStructureSizes(
+    const AccelerationStructureBuildDesc& desc,
+    AccelerationStructureSizes* outSizes
+)
+{
+    return cpu::getAccelerationStructureSizes(desc, outSizes);
+}
+
+Result DeviceImpl::createAccelerationStructure(
+    const AccelerationStructureDesc& desc,
+    IAccelerationStructure** outAccelerationStructure
+)
+{
+    RefPtr<AccelerationStructureImpl> result = new AccelerationStructureImpl(desc);
+    returnComPtr(outAccelerationStructure, result);
     return SLANG_OK;
 }
 
+Result DeviceImpl::waitForFences(
+    GfxCount fenceCount,
+    IFence** fences,
+    uint64_t* fenceValues,
+    bool waitForAll,
+    uint64_t timeout
+)
+{
+    auto isSignaled = [&]()
+    {
+        for (GfxIndex i = 0; i < fenceCount; i++)
+        {
+            bool signaled = checked_cast<FenceImpl*>(fences[i])->m_value >= fenceValues[i];
+            if (signaled && !waitForAll)
+                return true;
+            if (!signaled && waitForAll)
+                return false;
+        }
+        return waitForAll || fenceCount == 0;
+    };
+
+    std::unique_lock<std::mutex> lock(m_fenceMutex);
+    if (timeout == kTimeoutInfinite)
+    {
+        m_fenceCondition.wait(lock, isSignaled);
+        return SLANG_OK;
+    }
+    return m_fenceCondition.wait_for(lock, std::chrono::nanoseconds(timeout), isSignaled) ? SLANG_OK
+                                                                                         : SLANG_E_TIME_OUT;
+}
+
+void DeviceImpl::signalFence(IFence* fence, uint64_t value)
+{
+    fence->setCurrentValue(value);
+}
+
 void* DeviceImpl::map(IBuffer* buffer, MapFlavor flavor)
 {
     SLANG_UNUSED(flavor);
@@ -204,58 +434,684 @@ void DeviceImpl::bindRootShaderObject(IShaderObject* object)
     m_currentRootObject = checked_cast<RootShaderObjectImpl*>(object);
 }
 
+Result DeviceImpl::getKernelLibrary(ShaderProgramImpl* program, int entryPointIndex, KernelLibrary*& outLibrary)
+{
+    // Kernels are compiled on first dispatch, possibly on the queue's executor thread.
+    std::lock_guard<std::recursive_mutex> lock(m_slangMutex);
+    if (program->m_kernelLibraries.size() <= size_t(entryPointIndex))
+        program->m_kernelLibraries.resize(entryPointIndex + 1);
+    std::unique_ptr<KernelLibrary>& library = program->m_kernelLibraries[entryPointIndex];
+    if (!library)
+    {
+        auto newLibrary = std::make_unique<KernelLibrary>();
+        int targetIndex = 0;
+
+        ComPtr<ISlangBlob> diagnostics;
+        Result compileResult;
+        if (persistentShaderCache)
+        {
+            // Fetch the compiled kernel library from the shader cache, so that a warm cache skips
+            // compiling with the downstream C++ compiler entirely.
+            ComPtr<ISlangBlob> code;
+            compileResult = getEntryPointCodeFromShaderCache(
+                program->slangGlobalScope,
+                entryPointIndex,
+                targetIndex,
+                code.writeRef(),
+                diagnostics.writeRef()
+            );
+            if (SLANG_SUCCEEDED(compileResult))
+                compileResult = newLibrary->load(code);
+        }
+        else
+        {
+            compileResult = program->slangGlobalScope->getEntryPointHostCallable(
+                entryPointIndex,
+                targetIndex,
+                newLibrary->sharedLibrary.writeRef(),
+                diagnostics.writeRef()
+            );
+        }
+        if (diagnostics)
+        {
+            handleMessage(
+                compileResult == SLANG_OK ? DebugMessageType::Warning : DebugMessageType::Error,
+                DebugMessageSource::Slang,
+                (char*)diagnostics->getBufferPointer()
+            );
+        }
+        SLANG_RETURN_ON_FAIL(compileResult);
+        library = std::move(newLibrary);
+    }
+    outLibrary = library.get();
+    return SLANG_OK;
+}
+
+Result DeviceImpl::getComputeFunc(
+    ShaderProgramImpl* program,
+    const char* entryPointName,
+    slang_prelude::ComputeFunc& outFunc
+)
+{
+    if (!program->m_computeFunc)
+    {
+        KernelLibrary* library = nullptr;
+        SLANG_RETURN_ON_FAIL(getKernelLibrary(program, 0, library));
+        program->m_computeFunc = (slang_prelude::ComputeFunc)library->findSymbolAddressByName(entryPointName);
+        if (!program->m_computeFunc)
+            return SLANG_FAIL;
+    }
+    outFunc = program->m_computeFunc;
+    return SLANG_OK;
+}
+
+// Splits a grid into boxes, preferring splits along the outer axes so that each chunk covers
+// contiguous rows. Uses a few chunks per thread to allow for load balancing.
+template<typename F>
+static void parallelForGrid(ThreadPool* threadPool, const uint32_t extents[3], const F& func)
+{
+    uint32_t targetChunkCount = threadPool->getThreadCount() * kDispatchChunksPerThread;
+    uint32_t splits[3];
+    splits[2] = std::min<uint32_t>(extents[2], targetChunkCount);
+    targetChunkCount = (targetChunkCount + splits[2] - 1) / splits[2];
+    splits[1] = std::min<uint32_t>(extents[1], targetChunkCount);
+    targetChunkCount = (targetChunkCount + splits[1] - 1) / splits[1];
+    splits[0] = std::min<uint32_t>(extents[0], targetChunkCount);
+
+    threadPool->parallelFor(
+        splits[0] * splits[1] * splits[2],
+        [&](uint32_t chunkIndex)
+        {
+            uint32_t chunkCoord[3] = {
+                chunkIndex % splits[0],
+                (chunkIndex / splits[0]) % splits[1],
+                chunkIndex / (splits[0] * splits[1]),
+            };
+            uint32_t start[3];
+            uint32_t end[3];
+            for (int axis = 0; axis < 3; axis++)
+            {
+                start[axis] = uint32_t(uint64_t(extents[axis]) * chunkCoord[axis] / splits[axis]);
+                end[axis] = uint32_t(uint64_t(extents[axis]) * (chunkCoord[axis] + 1) / splits[axis]);
+            }
+            func(start, end);
+        }
+    );
+}
+
+/// Position of a tile along the Z-order curve.
+static uint64_t getMortonIndex(const uint32_t coords[3], int dimensionCount, int bitCount)
+{
+    uint64_t index = 0;
+    for (int bit = bitCount - 1; bit >= 0; bit--)
+        for (int axis = dimensionCount - 1; axis >= 0; axis--)
+            index = (index << 1) | ((coords[axis] >> bit) & 1);
+    return index;
+}
+
+/// Position of a tile along the Hilbert curve, see J. Skilling, "Programming the Hilbert curve" (2004).
+static uint64_t getHilbertIndex(const uint32_t coords[3], int dimensionCount, int bitCount)
+{
+    uint32_t x[3] = {coords[0], coords[1], coords[2]};
+    // Undo the excess work of the inverse transform.
+    for (uint32_t q = 1u << (bitCount - 1); q > 1; q >>= 1)
+    {
+        uint32_t p = q - 1;
+        for (int i = 0; i < dimensionCount; i++)
+        {
+            if (x[i] & q)
+            {
+                x[0] ^= p;
+            }
+            else
+            {
+                uint32_t t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+    // Gray encode.
+    for (int i = 1; i < dimensionCount; i++)
+        x[i] ^= x[i - 1];
+    uint32_t t = 0;
+    for (uint32_t q = 1u << (bitCount - 1); q > 1; q >>= 1)
+    {
+        if (x[dimensionCount - 1] & q)
+            t ^= q - 1;
+    }
+    for (int i = 0; i < dimensionCount; i++)
+        x[i] ^= t;
+    uint64_t index = 0;
+    for (int bit = bitCount - 1; bit >= 0; bit--)
+        for (int i = 0; i < dimensionCount; i++)
+            index = (index << 1) | ((x[i] >> bit) & 1);
+    return index;
+}
+
+const std::vector<uint32_t>& DeviceImpl::getDispatchTileOrder(const uint32_t tileCounts[3])
+{
+    if (std::equal(tileCounts, tileCounts + 3, m_dispatchTileCounts))
+        return m_dispatchTileOrder;
+    std::copy(tileCounts, tileCounts + 3, m_dispatchTileCounts);
+
+    int dimensionCount = tileCounts[2] > 1 ? 3 : 2;
+    int bitCount = 1;
+    while ((1u << bitCount) < std::max({tileCounts[0], tileCounts[1], tileCounts[2]}))
+        bitCount++;
+    std::vector<std::pair<uint64_t, uint32_t>> tiles;
+    tiles.reserve(size_t(tileCounts[0]) * tileCounts[1] * tileCounts[2]);
+    for (uint32_t z = 0; z < tileCounts[2]; z++)
+    {
+        for (uint32_t y = 0; y < tileCounts[1]; y++)
+        {
+            for (uint32_t x = 0; x < tileCounts[0]; x++)
+            {
+                uint32_t coords[3] = {x, y, z};
+                uint64_t index = m_extendedDesc.dispatchTileOrder == CPUDispatchTileOrder::Hilbert
+                                     ? getHilbertIndex(coords, dimensionCount, bitCount)
+                                     : getMortonIndex(coords, dimensionCount, bitCount);
+                tiles.push_back({index, uint32_t(tiles.size())});
+            }
+        }
+    }
+    std::sort(tiles.begin(), tiles.end());
+    m_dispatchTileOrder.resize(tiles.size());
+    for (size_t i = 0; i < tiles.size(); i++)
+        m_dispatchTileOrder[i] = tiles[i].second;
+    return m_dispatchTileOrder;
+}
+
+// Splits a grid into tiles visited in `tileOrder`. Each chunk covers a contiguous section of the curve,
+// which keeps the tiles of a chunk close together.
+template<typename F>
+static void parallelForTiles(
+    ThreadPool* threadPool,
+    const uint32_t extents[3],
+    const uint32_t tileSize[3],
+    const uint32_t tileCounts[3],
+    const std::vector<uint32_t>& tileOrder,
+    const F& func
+)
+{
+    uint32_t tileCount = uint32_t(tileOrder.size());
+    uint32_t chunkCount = std::min(tileCount, threadPool->getThreadCount() * kDispatchChunksPerThread);
+    threadPool->parallelFor(
+        chunkCount,
+        [&](uint32_t chunkIndex)
+        {
+            uint32_t chunkBegin = uint32_t(uint64_t(tileCount) * chunkIndex / chunkCount);
+            uint32_t chunkEnd = uint32_t(uint64_t(tileCount) * (chunkIndex + 1) / chunkCount);
+            for (uint32_t i = chunkBegin; i < chunkEnd; i++)
+            {
+                uint32_t tileCoord[3] = {
+                    tileOrder[i] % tileCounts[0],
+                    (tileOrder[i] / tileCounts[0]) % tileCounts[1],
+                    tileOrder[i] / (tileCounts[0] * tileCounts[1]),
+                };
+                uint32_t start[3];
+                uint32_t end[3];
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    start[axis] = tileCoord[axis] * tileSize[axis];
+                    end[axis] = std::min(extents[axis], start[axis] + tileSize[axis]);
+                }
+                func(start, end);
+            }
+        }
+    );
+}
+
 void DeviceImpl::dispatchCompute(int x, int y, int z)
 {
     int entryPointIndex = 0;
-    int targetIndex = 0;
 
     // Specialize the compute kernel based on the shader object bindings.
     RefPtr<Pipeline> newPipeline;
     maybeSpecializePipeline(m_currentPipeline, m_currentRootObject, newPipeline);
     m_currentPipeline = newPipeline;
 
-    auto program = m_currentPipeline->m_program.get();
+    auto program = checked_cast<ShaderProgramImpl*>(m_currentPipeline->m_program.get());
     auto entryPointLayout = m_currentRootObject->getLayout()->getEntryPoint(entryPointIndex);
     auto entryPointName = entryPointLayout->getEntryPointName();
 
     auto entryPointObject = m_currentRootObject->getEntryPoint(entryPointIndex);
 
-    ComPtr<ISlangSharedLibrary> sharedLibrary;
-    ComPtr<ISlangBlob> diagnostics;
-    auto compileResult =
-        program->slangGlobalScope
-            ->getEntryPointHostCallable(entryPointIndex, targetIndex, sharedLibrary.writeRef(), diagnostics.writeRef());
-    if (diagnostics)
+    slang_prelude::ComputeFunc func = nullptr;
+    if (SLANG_FAILED(getComputeFunc(program, entryPointName, func)))
+        return;
+
+    auto globalParamsData = m_currentRootObject->getDataBuffer();
+    auto entryPointParamsData = entryPointObject->getDataBuffer();
+
+    if (x <= 0 || y <= 0 || z <= 0)
+        return;
+
+    uint32_t extents[3] = {uint32_t(x), uint32_t(y), uint32_t(z)};
+    UInt groupSize[3];
+    m_currentRootObject->getLayout()->getKernelThreadGroupSize(entryPointIndex, groupSize);
+
+    // Visit 2D and 3D grids tile by tile, each tile is passed to the kernel as a separate group range.
+    // Tiles shrink for small grids so that there are enough of them to keep all threads busy.
+    uint32_t tileSize[3] = {1, 1, 1};
+    uint32_t tileCounts[3] = {1, 1, 1};
+    bool isTiled = m_extendedDesc.dispatchTileSize > 0 && (extents[1] > 1 || extents[2] > 1);
+    if (isTiled)
     {
-        handleMessage(
-            compileResult == SLANG_OK ? DebugMessageType::Warning : DebugMessageType::Error,
-            DebugMessageSource::Slang,
-            (char*)diagnostics->getBufferPointer()
-        );
+        uint32_t targetTileCount = m_threadPool->getThreadCount() * kDispatchChunksPerThread;
+        for (uint32_t edge = m_extendedDesc.dispatchTileSize; edge > 0; edge /= 2)
+        {
+            for (int axis = 0; axis < 3; axis++)
+            {
+                tileSize[axis] = axis < 2 || extents[2] > 1 ? edge : 1;
+                tileCounts[axis] = (extents[axis] + tileSize[axis] - 1) / tileSize[axis];
+            }
+            if (tileCounts[0] * tileCounts[1] * tileCounts[2] >= targetTileCount)
+                break;
+        }
+        isTiled = tileCounts[0] * tileCounts[1] * tileCounts[2] > 1;
     }
-    if (SLANG_FAILED(compileResult))
-        return;
+    auto forEachRange = [&](const auto& func)
+    {
+        if (isTiled)
+            parallelForTiles(m_threadPool.get(), extents, tileSize, tileCounts, getDispatchTileOrder(tileCounts), func);
+        else
+            parallelForGrid(m_threadPool.get(), extents, func);
+    };
 
-    auto func = (slang_prelude::ComputeFunc)sharedLibrary->findSymbolAddressByName(entryPointName);
+    auto startTime = std::chrono::high_resolution_clock::now();
+    forEachRange(
+        [&](const uint32_t start[3], const uint32_t end[3])
+        {
+            slang_prelude::ComputeVaryingInput varyingInput;
+            varyingInput.startGroupID.x = start[0];
+            varyingInput.startGroupID.y = start[1];
+            varyingInput.startGroupID.z = start[2];
+            varyingInput.endGroupID.x = end[0];
+            varyingInput.endGroupID.y = end[1];
+            varyingInput.endGroupID.z = end[2];
+            func(&varyingInput, entryPointParamsData, globalParamsData);
+        }
+    );
 
-    slang_prelude::ComputeVaryingInput varyingInput;
-    varyingInput.startGroupID.x = 0;
-    varyingInput.startGroupID.y = 0;
-    varyingInput.startGroupID.z = 0;
-    varyingInput.endGroupID.x = x;
-    varyingInput.endGroupID.y = y;
-    varyingInput.endGroupID.z = z;
+    uint64_t groupCount = uint64_t(x) * uint64_t(y) * uint64_t(z);
+    m_computeThreadGroups += groupCount;
+    m_computeShaderInvocations += groupCount * groupSize[0] * groupSize[1] * groupSize[2];
+    auto dispatchTime = std::chrono::high_resolution_clock::now() - startTime;
+    m_computeDispatchTime += std::chrono::duration_cast<std::chrono::nanoseconds>(dispatchTime).count();
+}
 
-    auto globalParamsData = m_currentRootObject->getDataBuffer();
-    auto entryPointParamsData = entryPointObject->getDataBuffer();
-    func(&varyingInput, entryPointParamsData, globalParamsData);
+void DeviceImpl::dispatchComputeIndirect(IBuffer* argBuffer, Offset offset)
+{
+    // The arguments are read when the command executes, so that earlier dispatches of the same
+    // command buffer can produce them without a round trip through the host.
+    auto bufferImpl = checked_cast<BufferImpl*>(argBuffer);
+    if (offset > bufferImpl->m_desc.size || bufferImpl->m_desc.size - offset < sizeof(IndirectDispatchArguments))
+    {
+        handleMessage(DebugMessageType::Error, DebugMessageSource::Driver, "Indirect arguments out of buffer bounds");
+        return;
+    }
+    IndirectDispatchArguments args;
+    memcpy(&args, (const uint8_t*)bufferImpl->m_data + offset, sizeof(args));
+    dispatchCompute(args.ThreadGroupCountX, args.ThreadGroupCountY, args.ThreadGroupCountZ);
 }
 
 void DeviceImpl::copyBuffer(IBuffer* dst, size_t dstOffset, IBuffer* src, size_t srcOffset, size_t size)
 {
     auto dstImpl = checked_cast<BufferImpl*>(dst);
     auto srcImpl = checked_cast<BufferImpl*>(src);
-    memcpy((uint8_t*)dstImpl->m_data + dstOffset, (uint8_t*)srcImpl->m_data + srcOffset, size);
+    uint8_t* dstData = (uint8_t*)dstImpl->m_data + dstOffset;
+    const uint8_t* srcData = (const uint8_t*)srcImpl->m_data + srcOffset;
+    // Overlapping ranges within a buffer can't be split across threads.
+    if (dstData < srcData + size && srcData < dstData + size)
+        memmove(dstData, srcData, size);
+    else
+        copyMemory(m_threadPool.get(), dstData, srcData, size);
+}
+
+void DeviceImpl::uploadBufferData(IBuffer* dst, size_t offset, size_t size, void* data)
+{
+    auto dstImpl = checked_cast<BufferImpl*>(dst);
+    copyMemory(m_threadPool.get(), (uint8_t*)dstImpl->m_data + offset, data, size);
+}
+
+/// Clamp a subresource range to the mip levels and array elements of `texture`.
+static SubresourceRange clampSubresourceRange(TextureImpl* texture, SubresourceRange range)
+{
+    GfxCount mipLevelCount = (GfxCount)texture->m_mipLevels.size();
+    range.mipLevel = std::min(range.mipLevel, mipLevelCount);
+    range.mipLevelCount = std::min(range.mipLevelCount, mipLevelCount - range.mipLevel);
+    range.baseArrayLayer = std::min(range.baseArrayLayer, texture->m_effectiveArrayElementCount);
+    range.layerCount = std::min(range.layerCount, texture->m_effectiveArrayElementCount - range.baseArrayLayer);
+    return range;
+}
+
+/// Size of a region along `axis` of a mip level, resolving `kRemainingTextureSize` and clamping to the level.
+static int32_t getRegionSize(GfxCount extent, const TextureImpl::MipLevel& level, int axis, int32_t offset)
+{
+    int32_t available = std::max(0, level.extents[axis] - offset);
+    return extent == kRemainingTextureSize ? available : std::min(int32_t(extent), available);
+}
+
+void DeviceImpl::copyTexture(
+    ITexture* dst,
+    SubresourceRange dstSubresource,
+    Offset3D dstOffset,
+    ITexture* src,
+    SubresourceRange srcSubresource,
+    Offset3D srcOffset,
+    Extents extent
+)
+{
+    auto dstImpl = checked_cast<TextureImpl*>(dst);
+    auto srcImpl = checked_cast<TextureImpl*>(src);
+    if (dstImpl->m_texelSize != srcImpl->m_texelSize)
+    {
+        handleMessage(
+            DebugMessageType::Error,
+            DebugMessageSource::Driver,
+            "copyTexture requires textures with the same texel size"
+        );
+        return;
+    }
+
+    // Empty subresource ranges copy the entire texture.
+    if (dstSubresource.layerCount == 0 && dstSubresource.mipLevelCount == 0 && srcSubresource.layerCount == 0 &&
+        srcSubresource.mipLevelCount == 0)
+    {
+        dstSubresource = kEntireTexture;
+        srcSubresource = kEntireTexture;
+        dstOffset = {};
+        srcOffset = {};
+        extent = {kRemainingTextureSize, kRemainingTextureSize, kRemainingTextureSize};
+    }
+    dstSubresource = clampSubresourceRange(dstImpl, dstSubresource);
+    srcSubresource = clampSubresourceRange(srcImpl, srcSubresource);
+    GfxCount layerCount = std::min(dstSubresource.layerCount, srcSubresource.layerCount);
+    GfxCount mipLevelCount = std::min(dstSubresource.mipLevelCount, srcSubresource.mipLevelCount);
+
+    size_t texelSize = dstImpl->m_texelSize;
+    bool isTiled = dstImpl->m_isTiled || srcImpl->m_isTiled;
+    for (GfxIndex layer = 0; layer < layerCount; layer++)
+    {
+        for (GfxIndex mip = 0; mip < mipLevelCount; mip++)
+        {
+            const auto& dstLevel = dstImpl->m_mipLevels[dstSubresource.mipLevel + mip];
+            const auto& srcLevel = srcImpl->m_mipLevels[srcSubresource.mipLevel + mip];
+            int32_t dstPos[3] = {dstOffset.x, dstOffset.y, dstOffset.z};
+            int32_t srcPos[3] = {srcOffset.x, srcOffset.y, srcOffset.z};
+            GfxCount extents[3] = {extent.width, extent.height, extent.depth};
+            int32_t size[3];
+            for (int axis = 0; axis < 3; axis++)
+            {
+                size[axis] = std::min(
+                    getRegionSize(extents[axis], srcLevel, axis, srcPos[axis]),
+                    getRegionSize(kRemainingTextureSize, dstLevel, axis, dstPos[axis])
+                );
+            }
+            if (size[0] <= 0 || size[1] <= 0 || size[2] <= 0)
+                continue;
+
+            uint8_t* dstElement = (uint8_t*)dstImpl->m_data + dstLevel.offset +
+                                  dstLevel.strides[3] * (dstSubresource.baseArrayLayer + layer);
+            const uint8_t* srcElement = (const uint8_t*)srcImpl->m_data + srcLevel.offset +
+                                        srcLevel.strides[3] * (srcSubresource.baseArrayLayer + layer);
+            size_t rowSize = size[0] * texelSize;
+
+            // Linear textures store full rows contiguously, whole slices are copied at once.
+            bool fullRows = !isTiled && size[0] == dstLevel.extents[0] && size[0] == srcLevel.extents[0];
+            if (fullRows && size[1] == dstLevel.extents[1] && size[1] == srcLevel.extents[1])
+            {
+                copyMemory(
+                    m_threadPool.get(),
+                    dstElement + dstImpl->getTexelOffset(dstLevel, 0, 0, dstPos[2]),
+                    srcElement + srcImpl->getTexelOffset(srcLevel, 0, 0, srcPos[2]),
+                    rowSize * size[1] * size[2]
+                );
+                continue;
+            }
+
+            parallelForRanges(
+                m_threadPool.get(),
+                size_t(size[1]) * size[2],
+                rowSize,
+                [&](size_t begin, size_t end)
+                {
+                    std::vector<uint8_t> row(dstImpl->m_isTiled && srcImpl->m_isTiled ? rowSize : 0);
+                    size_t index = begin;
+                    while (index < end)
+                    {
+                        int32_t y = int32_t(index % size[1]);
+                        int32_t z = int32_t(index / size[1]);
+                        int32_t dy = dstPos[1] + y, dz = dstPos[2] + z;
+                        int32_t sy = srcPos[1] + y, sz = srcPos[2] + z;
+                        if (fullRows)
+                        {
+                            // Consecutive rows of a slice are contiguous.
+                            size_t rowCount = std::min(end - index, size_t(size[1] - y));
+                            memcpy(
+                                dstElement + dstImpl->getTexelOffset(dstLevel, 0, dy, dz),
+                                srcElement + srcImpl->getTexelOffset(srcLevel, 0, sy, sz),
+                                rowSize * rowCount
+                            );
+                            index += rowCount;
+                            continue;
+                        }
+                        if (!dstImpl->m_isTiled)
+                        {
+                            uint8_t* dstRow = dstElement + dstImpl->getTexelOffset(dstLevel, dstPos[0], dy, dz);
+                            srcImpl->readTexels(srcLevel, srcElement, srcPos[0], sy, sz, size[0], dstRow);
+                        }
+                        else if (!srcImpl->m_isTiled)
+                        {
+                            const uint8_t* srcRow = srcElement + srcImpl->getTexelOffset(srcLevel, srcPos[0], sy, sz);
+                            dstImpl->writeTexels(dstLevel, dstElement, dstPos[0], dy, dz, size[0], srcRow);
+                        }
+                        else
+                        {
+                            srcImpl->readTexels(srcLevel, srcElement, srcPos[0], sy, sz, size[0], row.data());
+                            dstImpl->writeTexels(dstLevel, dstElement, dstPos[0], dy, dz, size[0], row.data());
+                        }
+                        index++;
+                    }
+                }
+            );
+        }
+    }
+}
+
+void DeviceImpl::uploadTextureData(
+    ITexture* dst,
+    SubresourceRange subresourceRange,
+    Offset3D offset,
+    Extents extent,
+    SubresourceData* subresourceData,
+    GfxCount subresourceDataCount
+)
+{
+    auto texture = checked_cast<TextureImpl*>(dst);
+    SubresourceRange range = clampSubresourceRange(texture, subresourceRange);
+    if (range.mipLevelCount <= 0)
+        return;
+
+    // Subresources are ordered by array layer, then by mip level.
+    for (GfxIndex i = 0; i < subresourceDataCount; i++)
+    {
+        GfxIndex layer = range.baseArrayLayer + i / range.mipLevelCount;
+        GfxIndex mip = range.mipLevel + i % range.mipLevelCount;
+        if (layer >= texture->m_effectiveArrayElementCount)
+            break;
+        const auto& level = texture->m_mipLevels[mip];
+        int32_t pos[3] = {offset.x, offset.y, offset.z};
+        int32_t size[3] = {
+            getRegionSize(extent.width, level, 0, pos[0]),
+            getRegionSize(extent.height, level, 1, pos[1]),
+            getRegionSize(extent.depth, level, 2, pos[2]),
+        };
+        if (size[0] <= 0 || size[1] <= 0 || size[2] <= 0)
+            continue;
+
+        uint8_t* element = (uint8_t*)texture->m_data + level.offset + level.strides[3] * layer;
+        const SubresourceData& data = subresourceData[i];
+        parallelForRanges(
+            m_threadPool.get(),
+            size_t(size[1]) * size[2],
+            size_t(size[0]) * texture->m_texelSize,
+            [&](size_t begin, size_t end)
+            {
+                for (size_t index = begin; index < end; index++)
+                {
+                    int32_t y = int32_t(index % size[1]);
+                    int32_t z = int32_t(index / size[1]);
+                    const uint8_t* srcRow = (const uint8_t*)data.data + data.strideZ * z + data.strideY * y;
+                    texture->writeTexels(level, element, pos[0], pos[1] + y, pos[2] + z, size[0], srcRow);
+                }
+            }
+        );
+    }
+}
+
+void DeviceImpl::clearBuffer(IBuffer* buffer, const BufferRange& range)
+{
+    auto bufferImpl = checked_cast<BufferImpl*>(buffer);
+    Size bufferSize = bufferImpl->m_desc.size;
+    if (range.offset >= bufferSize)
+        return;
+    Size size = std::min(range.size, bufferSize - range.offset);
+    const uint32_t zero = 0;
+    fillMemory(m_threadPool.get(), (uint8_t*)bufferImpl->m_data + range.offset, size, &zero, sizeof(zero));
+}
+
+void DeviceImpl::clearTexture(
+    ITexture* texture,
+    const ClearValue& clearValue,
+    const SubresourceRange& subresourceRange,
+    bool clearDepth,
+    bool clearStencil
+)
+{
+    auto textureImpl = checked_cast<TextureImpl*>(texture);
+    SubresourceRange range = clampSubresourceRange(textureImpl, subresourceRange);
+    size_t texelSize = textureImpl->m_texelSize;
+    uint8_t texel[16] = {};
+    SLANG_RHI_ASSERT(texelSize <= sizeof(texel));
+
+    // Bytes of each texel written by the clear.
+    size_t writeBegin = 0;
+    size_t writeEnd = texelSize;
+    Format format = textureImpl->getFormat();
+    if (isDepthFormat(format))
+    {
+        float components[4] = {clearValue.depthStencil.depth, 0.0f, 0.0f, 1.0f};
+        textureImpl->m_formatInfo->pack(components, texel, 1);
+        if (format == Format::D32_FLOAT_S8_UINT)
+        {
+            // The stencil value is stored in the byte following the depth value.
+            texel[4] = uint8_t(clearValue.depthStencil.stencil);
+            writeBegin = clearDepth ? 0 : 4;
+            writeEnd = clearStencil ? 5 : 4;
+        }
+        else if (!clearDepth)
+        {
+            return;
+        }
+    }
+    else
+    {
+        textureImpl->m_formatInfo->pack(clearValue.color.uintValues, texel, 1);
+    }
+    if (writeBegin >= writeEnd)
+        return;
+
+    // Subresources are cleared as a whole, so the array elements of a mip level form a single range.
+    bool partialTexels = writeBegin != 0 || writeEnd != texelSize;
+    for (GfxIndex mip = range.mipLevel; mip < range.mipLevel + range.mipLevelCount; mip++)
+    {
+        const auto& level = textureImpl->m_mipLevels[mip];
+        uint8_t* data = (uint8_t*)textureImpl->m_data + level.offset + level.strides[3] * range.baseArrayLayer;
+        size_t size = size_t(level.strides[3]) * range.layerCount;
+        if (!partialTexels)
+        {
+            fillMemory(m_threadPool.get(), data, size, texel, texelSize);
+            continue;
+        }
+        for (size_t offset = 0; offset < size; offset += texelSize)
+            memcpy(data + offset + writeBegin, texel + writeBegin, writeEnd - writeBegin);
+    }
+}
+
+void DeviceImpl::resolveQuery(IQueryPool* queryPool, GfxIndex index, GfxCount count, IBuffer* buffer, Offset offset)
+{
+    auto poolImpl = checked_cast<QueryPoolImpl*>(queryPool);
+    auto bufferImpl = checked_cast<BufferImpl*>(buffer);
+    if (!poolImpl->isRangeValid(index, count))
+    {
+        handleMessage(DebugMessageType::Error, DebugMessageSource::Driver, "Resolved queries out of pool bounds");
+        return;
+    }
+    if (offset > bufferImpl->m_desc.size || (bufferImpl->m_desc.size - offset) / sizeof(uint64_t) < size_t(count))
+    {
+        handleMessage(DebugMessageType::Error, DebugMessageSource::Driver, "Resolved queries out of buffer bounds");
+        return;
+    }
+    memcpy((uint8_t*)bufferImpl->m_data + offset, poolImpl->m_queries.data() + index, sizeof(uint64_t) * count);
+}
+
+void DeviceImpl::buildAccelerationStructure(
+    const AccelerationStructureBuildDesc& desc,
+    IAccelerationStructure* dst,
+    IAccelerationStructure* src,
+    GfxCount propertyQueryCount,
+    AccelerationStructureQueryDesc* queryDescs
+)
+{
+    auto dstImpl = checked_cast<AccelerationStructureImpl*>(dst);
+    auto srcImpl = checked_cast<AccelerationStructureImpl*>(src);
+    if (SLANG_FAILED(dstImpl->build(desc, srcImpl, m_threadPool.get())))
+    {
+        handleMessage(DebugMessageType::Error, DebugMessageSource::Driver, "Invalid acceleration structure inputs");
+        return;
+    }
+    queryAccelerationStructureProperties(1, &dst, propertyQueryCount, queryDescs);
+}
+
+void DeviceImpl::copyAccelerationStructure(
+    IAccelerationStructure* dst,
+    IAccelerationStructure* src,
+    AccelerationStructureCopyMode mode
+)
+{
+    auto dstImpl = checked_cast<AccelerationStructureImpl*>(dst);
+    auto srcImpl = checked_cast<AccelerationStructureImpl*>(src);
+    dstImpl->copyFrom(srcImpl, mode);
+}
+
+void DeviceImpl::queryAccelerationStructureProperties(
+    GfxCount accelerationStructureCount,
+    IAccelerationStructure* const* accelerationStructures,
+    GfxCount queryCount,
+    AccelerationStructureQueryDesc* queryDescs
+)
+{
+    for (GfxIndex i = 0; i < queryCount; i++)
+    {
+        auto pool = checked_cast<QueryPoolImpl*>(queryDescs[i].queryPool);
+        for (GfxIndex j = 0; j < accelerationStructureCount; j++)
+        {
+            auto accelerationStructure = checked_cast<AccelerationStructureImpl*>(accelerationStructures[j]);
+            uint64_t value = 0;
+            switch (queryDescs[i].queryType)
+            {
+            case QueryType::AccelerationStructureCompactedSize:
+            case QueryType::AccelerationStructureCurrentSize:
+                value = accelerationStructure->getUsedSize();
+                break;
+            default:
+                break;
+            }
+            pool->m_queries[queryDescs[i].firstQueryIndex + j] = value;
+        }
+    }
 }
 
 } // namespace rhi::cpu
@@ -1,16 +1,26 @@
 #pragma once
 
+#include "cpu-allocator.h"
 #include "cpu-base.h"
 #include "cpu-pipeline.h"
 #include "cpu-shader-object.h"
+#include "cpu-thread-pool.h"
+
+#include <condition_variable>
+#include <mutex>
 
 namespace rhi::cpu {
 
-class DeviceImpl : public ImmediateComputeDeviceBase
+class DeviceImpl : public ImmediateComputeDeviceBase, public ICPUDevice
 {
 public:
     ~DeviceImpl();
 
+    virtual SLANG_NO_THROW Result SLANG_MCALL queryInterface(SlangUUID const& uuid, void** outObject) override;
+
+    virtual SLANG_NO_THROW uint32_t SLANG_MCALL addRef() override { return ImmediateComputeDeviceBase::addRef(); }
+    virtual SLANG_NO_THROW uint32_t SLANG_MCALL release() override { return ImmediateComputeDeviceBase::release(); }
+
     virtual SLANG_NO_THROW Result SLANG_MCALL initialize(const DeviceDesc& desc) override;
 
     virtual SLANG_NO_THROW Result SLANG_MCALL
@@ -19,9 +29,35 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL
     createBuffer(const BufferDesc& descIn, const void* initData, IBuffer** outBuffer) override;
 
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    createBufferFromNativeHandle(NativeHandle handle, const BufferDesc& srcDesc, IBuffer** outBuffer) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL createBufferFromHostMemory(
+        const BufferDesc& desc,
+        void* data,
+        HostMemoryReleaseFunc releaseFunc,
+        void* releaseUserData,
+        IBuffer** outBuffer
+    ) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL createBufferFromFile(
+        const BufferDesc& desc,
+        const char* path,
+        uint64_t fileOffset,
+        FileMappingMode mode,
+        IBuffer** outBuffer
+    ) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getMemoryStats(DeviceMemoryStats* outStats) override;
+
     virtual SLANG_NO_THROW Result SLANG_MCALL
     createTextureView(ITexture* inTexture, const TextureViewDesc& desc, ITextureView** outView) override;
 
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    readTexture(ITexture* texture, ISlangBlob** outBlob, Size* outRowPitch, Size* outPixelSize) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL generateMips(ITexture* texture, const GenerateMipsDesc& desc) override;
+
     virtual Result createShaderObjectLayout(
         slang::ISession* session,
         slang::TypeLayoutReflection* typeLayout,
@@ -33,6 +69,7 @@ public:
     virtual Result createMutableShaderObject(ShaderObjectLayout* layout, IShaderObject** outObject) override;
 
     virtual Result createRootShaderObject(IShaderProgram* program, ShaderObjectBase** outObject) override;
+    virtual Result resetRootShaderObject(ShaderObjectBase* object) override;
 
     virtual SLANG_NO_THROW Result SLANG_MCALL createShaderProgram(
         const ShaderProgramDesc& desc,
@@ -51,15 +88,54 @@ public:
 
     virtual SLANG_NO_THROW Result SLANG_MCALL createSampler(SamplerDesc const& desc, ISampler** outSampler) override;
 
+    virtual SLANG_NO_THROW Result SLANG_MCALL createFence(const FenceDesc& desc, IFence** outFence) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getAccelerationStructureSizes(
+        const AccelerationStructureBuildDesc& desc,
+        AccelerationStructureSizes* outSizes
+    ) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL createAccelerationStructure(
+        const AccelerationStructureDesc& desc,
+        IAccelerationStructure** outAccelerationStructure
+    ) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL
+    waitForFences(GfxCount fenceCount, IFence** fences, uint64_t* fenceValues, bool waitForAll, uint64_t timeout)
+        override;
+
+    virtual void signalFence(IFence* fence, uint64_t value) override;
+
     virtual void submitGpuWork() override {}
     virtual void waitForGpu() override {}
     virtual void* map(IBuffer* buffer, MapFlavor flavor) override;
     virtual void unmap(IBuffer* buffer, size_t offsetWritten, size_t sizeWritten) override;
 
+public:
+    // Guards the values of all fences created by this device.
+    std::mutex m_fenceMutex;
+    std::condition_variable m_fenceCondition;
+
 private:
     RefPtr<Pipeline> m_currentPipeline = nullptr;
     RefPtr<RootShaderObjectImpl> m_currentRootObject = nullptr;
     DeviceInfo m_info;
+    CPUDeviceExtendedDesc m_extendedDesc;
+    std::unique_ptr<ThreadPool> m_threadPool;
+    /// Shared with buffers and textures, which free their memory with it.
+    std::shared_ptr<MemoryAllocator> m_allocator;
+
+    // Visiting order of the tiles of the last tiled dispatch, for its counts of tiles along each axis.
+    uint32_t m_dispatchTileCounts[3] = {0, 0, 0};
+    std::vector<uint32_t> m_dispatchTileOrder;
+
+    /// Get the indices of the tiles of a dispatch in the order they are visited.
+    const std::vector<uint32_t>& getDispatchTileOrder(const uint32_t tileCounts[3]);
+
+    // Running totals sampled by statistics queries, only accessed while executing commands.
+    uint64_t m_computeShaderInvocations = 0;
+    uint64_t m_computeThreadGroups = 0;
+    uint64_t m_computeDispatchTime = 0;
 
     virtual void setPipeline(IPipeline* state) override;
 
@@ -67,7 +143,68 @@ private:
 
     virtual void dispatchCompute(int x, int y, int z) override;
 
+    virtual void dispatchComputeIndirect(IBuffer* argBuffer, Offset offset) override;
+
+    Result getKernelLibrary(ShaderProgramImpl* program, int entryPointIndex, KernelLibrary*& outLibrary);
+
+    Result getComputeFunc(ShaderProgramImpl* program, const char* entryPointName, slang_prelude::ComputeFunc& outFunc);
+
     virtual void copyBuffer(IBuffer* dst, size_t dstOffset, IBuffer* src, size_t srcOffset, size_t size) override;
+
+    virtual void uploadBufferData(IBuffer* dst, size_t offset, size_t size, void* data) override;
+
+    virtual void copyTexture(
+        ITexture* dst,
+        SubresourceRange dstSubresource,
+        Offset3D dstOffset,
+        ITexture* src,
+        SubresourceRange srcSubresource,
+        Offset3D srcOffset,
+        Extents extent
+    ) override;
+
+    virtual void uploadTextureData(
+        ITexture* dst,
+        SubresourceRange subresourceRange,
+        Offset3D offset,
+        Extents extent,
+        SubresourceData* subresourceData,
+        GfxCount subresourceDataCount
+    ) override;
+
+    virtual void clearBuffer(IBuffer* buffer, const BufferRange& range) override;
+
+    virtual void clearTexture(
+        ITexture* texture,
+        const ClearValue& clearValue,
+        const SubresourceRange& subresourceRange,
+        bool clearDepth,
+        bool clearStencil
+    ) override;
+
+    virtual void resolveQuery(IQueryPool* queryPool, GfxIndex index, GfxCount count, IBuffer* buffer, Offset offset)
+        override;
+
+    virtual void buildAccelerationStructure(
+        const AccelerationStructureBuildDesc& desc,
+        IAccelerationStructure* dst,
+        IAccelerationStructure* src,
+        GfxCount propertyQueryCount,
+        AccelerationStructureQueryDesc* queryDescs
+    ) override;
+
+    virtual void copyAccelerationStructure(
+        IAccelerationStructure* dst,
+        IAccelerationStructure* src,
+        AccelerationStructureCopyMode mode
+    ) override;
+
+    virtual void queryAccelerationStructureProperties(
+        GfxCount accelerationStructureCount,
+        IAccelerationStructure* const* accelerationStructures,
+        GfxCount queryCount,
+        AccelerationStructureQueryDesc* queryDescs
+    ) override;
 };
 
 } // namespace rhi::cpu
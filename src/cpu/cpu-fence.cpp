@@ -0,0 +1,44 @@
+#include "cpu-fence.h"
+#include "cpu-device.h"
+
+namespace rhi::cpu {
+
+Result FenceImpl::init(DeviceImpl* device, const FenceDesc& desc)
+{
+    if (desc.isShared)
+        return SLANG_E_NOT_AVAILABLE;
+    m_device = device;
+    m_value = desc.initialValue;
+    return SLANG_OK;
+}
+
+Result FenceImpl::getCurrentValue(uint64_t* outValue)
+{
+    std::lock_guard<std::mutex> lock(m_device->m_fenceMutex);
+    *outValue = m_value;
+    return SLANG_OK;
+}
+
+Result FenceImpl::setCurrentValue(uint64_t value)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_device->m_fenceMutex);
+        m_value = value;
+    }
+    m_device->m_fenceCondition.notify_all();
+    return SLANG_OK;
+}
+
+Result FenceImpl::getNativeHandle(NativeHandle* outHandle)
+{
+    *outHandle = {};
+    return SLANG_E_NOT_AVAILABLE;
+}
+
+Result FenceImpl::getSharedHandle(NativeHandle* outHandle)
+{
+    *outHandle = {};
+    return SLANG_E_NOT_AVAILABLE;
+}
+
+} // namespace rhi::cpu
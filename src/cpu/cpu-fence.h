@@ -0,0 +1,24 @@
+#pragma once
+
+#include "cpu-base.h"
+
+namespace rhi::cpu {
+
+class FenceImpl : public Fence
+{
+public:
+    RefPtr<DeviceImpl> m_device;
+    uint64_t m_value = 0;
+
+    Result init(DeviceImpl* device, const FenceDesc& desc);
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getCurrentValue(uint64_t* outValue) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL setCurrentValue(uint64_t value) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getNativeHandle(NativeHandle* outHandle) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getSharedHandle(NativeHandle* outHandle) override;
+};
+
+} // namespace rhi::cpu
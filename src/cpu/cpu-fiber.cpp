@@ -0,0 +1,323 @@
+#include "cpu-fiber.h"
+
+#include <new>
+
+#if defined(_WIN32)
+#define SLANG_RHI_FIBER_WIN32 1
+#include <windows.h>
+#elif defined(__x86_64__) || defined(__aarch64__)
+#define SLANG_RHI_FIBER_ASM 1
+#else
+#define SLANG_RHI_FIBER_UCONTEXT 1
+#include <ucontext.h>
+#endif
+
+#if !SLANG_RHI_FIBER_WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if SLANG_RHI_FIBER_ASM
+
+#if defined(__APPLE__)
+#define SLANG_RHI_FIBER_SYMBOL(name) "_" name
+#define SLANG_RHI_FIBER_GLOBAL(name) ".globl _" name "\n.private_extern _" name "\n"
+#else
+#define SLANG_RHI_FIBER_SYMBOL(name) name
+#define SLANG_RHI_FIBER_GLOBAL(name) ".globl " name "\n.hidden " name "\n"
+#endif
+
+// Saves the callee-saved registers on the current stack, stores the stack pointer to `*fromStack`
+// and restores the registers from `toStack`.
+extern "C" void slang_rhi_cpu_fiber_switch(void** fromStack, void* toStack);
+// Initial return address of a fiber, calls the entry function stored in a callee-saved register.
+extern "C" void slang_rhi_cpu_fiber_start();
+
+#if defined(__x86_64__)
+// System V ABI: rbx, rbp, r12-r15, MXCSR and the x87 control word are callee-saved.
+asm(".text\n"
+    ".p2align 4\n" SLANG_RHI_FIBER_GLOBAL("slang_rhi_cpu_fiber_switch")
+    SLANG_RHI_FIBER_SYMBOL("slang_rhi_cpu_fiber_switch") ":\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".p2align 4\n" SLANG_RHI_FIBER_GLOBAL("slang_rhi_cpu_fiber_start")
+    SLANG_RHI_FIBER_SYMBOL("slang_rhi_cpu_fiber_start") ":\n"
+    "    movq %rbx, %rdi\n"
+    "    andq $-16, %rsp\n"
+    "    callq *%r12\n"
+    "    ud2\n");
+#elif defined(__aarch64__)
+// AAPCS64: x19-x29, the link register and the low halves of v8-v15 are callee-saved.
+asm(".text\n"
+    ".p2align 2\n" SLANG_RHI_FIBER_GLOBAL("slang_rhi_cpu_fiber_switch")
+    SLANG_RHI_FIBER_SYMBOL("slang_rhi_cpu_fiber_switch") ":\n"
+    "    sub sp, sp, #160\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mov x2, sp\n"
+    "    str x2, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    add sp, sp, #160\n"
+    "    ret\n"
+    ".p2align 2\n" SLANG_RHI_FIBER_GLOBAL("slang_rhi_cpu_fiber_start")
+    SLANG_RHI_FIBER_SYMBOL("slang_rhi_cpu_fiber_start") ":\n"
+    "    mov x0, x19\n"
+    "    blr x20\n"
+    "    brk #0\n");
+#endif
+
+#endif // SLANG_RHI_FIBER_ASM
+
+namespace rhi::cpu {
+
+enum class FiberState
+{
+    Ready,
+    Waiting,
+    Done,
+};
+
+#if !SLANG_RHI_FIBER_WIN32
+// Fiber stack with an inaccessible guard page below it, so that a stack overflow faults instead of
+// silently overwriting the stack of another fiber. Windows fibers get a guard page from CreateFiber.
+class FiberStack
+{
+public:
+    FiberStack() = default;
+    FiberStack(const FiberStack&) = delete;
+    FiberStack& operator=(const FiberStack&) = delete;
+
+    ~FiberStack()
+    {
+        if (m_mapping)
+            munmap(m_mapping, m_mappingSize);
+    }
+
+    void allocate(size_t size)
+    {
+        size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+        m_size = (size + pageSize - 1) & ~(pageSize - 1);
+        m_mappingSize = pageSize + m_size;
+        void* mapping = mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED)
+            throw std::bad_alloc();
+        m_mapping = static_cast<uint8_t*>(mapping);
+        mprotect(m_mapping, pageSize, PROT_NONE);
+    }
+
+    /// Lowest usable address of the stack.
+    uint8_t* getBase() const { return m_mapping + (m_mappingSize - m_size); }
+    /// End of the stack, where it starts growing down from.
+    uint8_t* getTop() const { return m_mapping + m_mappingSize; }
+    size_t getSize() const { return m_size; }
+
+private:
+    uint8_t* m_mapping = nullptr;
+    size_t m_mappingSize = 0;
+    size_t m_size = 0;
+};
+#endif
+
+struct ThreadGroupScheduler::Fiber
+{
+    ThreadGroupScheduler* scheduler = nullptr;
+    uint32_t threadIndex = 0;
+    FiberState state = FiberState::Ready;
+#if SLANG_RHI_FIBER_WIN32
+    LPVOID handle = nullptr;
+#elif SLANG_RHI_FIBER_ASM
+    void* stackPointer = nullptr;
+    FiberStack stack;
+#elif SLANG_RHI_FIBER_UCONTEXT
+    ucontext_t context;
+    FiberStack stack;
+#endif
+};
+
+ThreadGroupScheduler::ThreadGroupScheduler(uint32_t threadCount, size_t groupSharedMemorySize, size_t stackSize)
+    : m_threadCount(threadCount)
+{
+    if (groupSharedMemorySize)
+        m_groupSharedMemory.reset(new uint8_t[groupSharedMemorySize]);
+
+    m_mainFiber = std::make_unique<Fiber>();
+    m_fibers.resize(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++)
+    {
+        auto fiber = std::make_unique<Fiber>();
+        fiber->scheduler = this;
+        fiber->threadIndex = i;
+#if SLANG_RHI_FIBER_WIN32
+        fiber->handle = CreateFiber(stackSize, [](LPVOID fiber) { fiberMain(fiber); }, fiber.get());
+#elif SLANG_RHI_FIBER_ASM
+        // Build an initial frame for `slang_rhi_cpu_fiber_switch` returning into `slang_rhi_cpu_fiber_start`.
+        fiber->stack.allocate(stackSize);
+        uintptr_t* sp = (uintptr_t*)(uintptr_t(fiber->stack.getTop()) & ~uintptr_t(15));
+#if defined(__x86_64__)
+        *--sp = 0;
+        *--sp = uintptr_t(&slang_rhi_cpu_fiber_start);
+        *--sp = 0;                        // rbp
+        *--sp = uintptr_t(fiber.get());   // rbx
+        *--sp = uintptr_t(&fiberMain);    // r12
+        *--sp = 0;                        // r13
+        *--sp = 0;                        // r14
+        *--sp = 0;                        // r15
+        *--sp = uintptr_t(0x037f) << 32 | uintptr_t(0x1f80); // default x87 control word and MXCSR
+#else
+        sp -= 20;
+        for (int j = 0; j < 20; j++)
+            sp[j] = 0;
+        sp[0] = uintptr_t(fiber.get());  // x19
+        sp[1] = uintptr_t(&fiberMain);   // x20
+        sp[11] = uintptr_t(&slang_rhi_cpu_fiber_start); // x30
+#endif
+        fiber->stackPointer = sp;
+#elif SLANG_RHI_FIBER_UCONTEXT
+        fiber->stack.allocate(stackSize);
+        getcontext(&fiber->context);
+        fiber->context.uc_stack.ss_sp = fiber->stack.getBase();
+        fiber->context.uc_stack.ss_size = fiber->stack.getSize();
+        fiber->context.uc_link = nullptr;
+        // makecontext only passes int arguments, the fiber pointer is split into two halves.
+        void (*entry)(unsigned int, unsigned int) = [](unsigned int high, unsigned int low)
+        { fiberMain((void*)((uintptr_t(high) << 16 << 16) | uintptr_t(low))); };
+        uintptr_t fiberBits = uintptr_t(fiber.get());
+        makecontext(
+            &fiber->context,
+            (void (*)())entry,
+            2,
+            (unsigned int)(fiberBits >> 16 >> 16),
+            (unsigned int)(fiberBits & 0xffffffffu)
+        );
+#endif
+        m_fibers[i] = std::move(fiber);
+    }
+}
+
+ThreadGroupScheduler::~ThreadGroupScheduler()
+{
+#if SLANG_RHI_FIBER_WIN32
+    for (const auto& fiber : m_fibers)
+        DeleteFiber(fiber->handle);
+#endif
+}
+
+void ThreadGroupScheduler::run(ThreadFunc func, void* userData)
+{
+    m_func = func;
+    m_userData = userData;
+
+#if SLANG_RHI_FIBER_WIN32
+    bool convertedThread = !IsThreadAFiber();
+    m_mainFiber->handle = convertedThread ? ConvertThreadToFiber(nullptr) : GetCurrentFiber();
+#endif
+
+    for (const auto& fiber : m_fibers)
+        fiber->state = FiberState::Ready;
+    m_runningThreadCount = m_threadCount;
+
+    // Each pass runs the threads in order up to their next barrier, a thread reaching the barrier
+    // or finishing switches directly to the next thread and the last one returns here.
+    while (m_runningThreadCount > 0)
+    {
+        switchFiber(m_mainFiber.get(), getNextFiber(nullptr));
+        // Threads that finished without reaching the barrier are treated as having arrived,
+        // which avoids a deadlock for barriers in divergent control flow.
+        for (const auto& fiber : m_fibers)
+        {
+            if (fiber->state == FiberState::Waiting)
+                fiber->state = FiberState::Ready;
+        }
+    }
+
+#if SLANG_RHI_FIBER_WIN32
+    if (convertedThread)
+        ConvertFiberToThread();
+#endif
+}
+
+void ThreadGroupScheduler::barrier()
+{
+    Fiber* fiber = m_currentFiber;
+    fiber->state = FiberState::Waiting;
+    switchFiber(fiber, getNextFiber(fiber));
+}
+
+ThreadGroupScheduler::Fiber* ThreadGroupScheduler::getNextFiber(Fiber* current)
+{
+    for (uint32_t i = current ? current->threadIndex + 1 : 0; i < m_threadCount; i++)
+    {
+        if (m_fibers[i]->state == FiberState::Ready)
+        {
+            m_currentFiber = m_fibers[i].get();
+            return m_currentFiber;
+        }
+    }
+    m_currentFiber = nullptr;
+    return m_mainFiber.get();
+}
+
+void ThreadGroupScheduler::fiberMain(void* fiberPtr)
+{
+    Fiber* fiber = static_cast<Fiber*>(fiberPtr);
+    ThreadGroupScheduler* scheduler = fiber->scheduler;
+    // Fibers are reused for the following groups, a finished fiber restarts from here when resumed.
+    while (true)
+    {
+        scheduler->m_func(scheduler->m_userData, fiber->threadIndex);
+        fiber->state = FiberState::Done;
+        scheduler->m_runningThreadCount--;
+        switchFiber(fiber, scheduler->getNextFiber(fiber));
+    }
+}
+
+void ThreadGroupScheduler::switchFiber(Fiber* from, Fiber* to)
+{
+#if SLANG_RHI_FIBER_WIN32
+    (void)from;
+    SwitchToFiber(to->handle);
+#elif SLANG_RHI_FIBER_ASM
+    slang_rhi_cpu_fiber_switch(&from->stackPointer, to->stackPointer);
+#elif SLANG_RHI_FIBER_UCONTEXT
+    swapcontext(&from->context, &to->context);
+#endif
+}
+
+} // namespace rhi::cpu
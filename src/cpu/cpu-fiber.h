@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace rhi::cpu {
+
+/// Runs the threads of a compute thread group as fibers on the calling thread.
+/// A thread calling `barrier` is suspended and the next thread of the group is resumed, once all
+/// threads reached the barrier they continue in order. A barrier therefore costs a user mode context
+/// switch per thread instead of an OS synchronization.
+/// Fibers and their stacks are created once and reused for every group run by the scheduler,
+/// a scheduler must only be used by one OS thread at a time.
+/// The CPU device does not run dispatches on it yet, as Slang does not emit per-thread entry points
+/// with group barriers for the CPU target.
+class ThreadGroupScheduler
+{
+public:
+    using ThreadFunc = void (*)(void* userData, uint32_t threadIndex);
+
+    static const size_t kDefaultStackSize = 64 * 1024;
+
+    /// Create a scheduler for groups of `threadCount` threads sharing `groupSharedMemorySize` bytes.
+    ThreadGroupScheduler(uint32_t threadCount, size_t groupSharedMemorySize, size_t stackSize = kDefaultStackSize);
+    ~ThreadGroupScheduler();
+
+    uint32_t getThreadCount() const { return m_threadCount; }
+
+    /// Groupshared memory of the current group. The contents are undefined at the start of a group.
+    void* getGroupSharedMemory() const { return m_groupSharedMemory.get(); }
+
+    /// Run `func` for all threads of a group and return once every thread has finished.
+    void run(ThreadFunc func, void* userData);
+
+    /// Wait until all threads of the group reached the barrier. Must be called from a thread of the group.
+    void barrier();
+
+private:
+    struct Fiber;
+
+    static void fiberMain(void* fiber);
+    static void switchFiber(Fiber* from, Fiber* to);
+
+    /// Next thread to run in the current pass after `current`, the main fiber at the end of the pass.
+    Fiber* getNextFiber(Fiber* current);
+
+    uint32_t m_threadCount;
+    std::vector<std::unique_ptr<Fiber>> m_fibers;
+    std::unique_ptr<uint8_t[]> m_groupSharedMemory;
+    /// Context of the thread calling `run`.
+    std::unique_ptr<Fiber> m_mainFiber;
+    Fiber* m_currentFiber = nullptr;
+    uint32_t m_runningThreadCount = 0;
+    ThreadFunc m_func = nullptr;
+    void* m_userData = nullptr;
+};
+
+} // namespace rhi::cpu
@@ -0,0 +1,673 @@
+#include "cpu-format-conversion.h"
+#include "cpu-simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rhi::cpu {
+
+namespace {
+
+inline uint32_t floatToBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float clampUnorm(float value)
+{
+    // Also maps NaN to 0.
+    return value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+}
+
+inline float clampSnorm(float value)
+{
+    return value > -1.0f ? (value < 1.0f ? value : 1.0f) : -1.0f;
+}
+
+inline uint32_t floatToUnorm(float value, uint32_t maxValue)
+{
+    return uint32_t(clampUnorm(value) * float(maxValue) + 0.5f);
+}
+
+inline int32_t floatToSnorm(float value, int32_t maxValue)
+{
+    float scaled = clampSnorm(value) * float(maxValue);
+    return int32_t(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+uint16_t floatToHalf(float value)
+{
+    uint32_t bits = floatToBits(value);
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    // Inf/NaN
+    if (exponent == 0xff)
+        return uint16_t(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+
+    int32_t halfExponent = int32_t(exponent) - 127 + 15;
+    if (halfExponent >= 0x1f)
+        return uint16_t(sign | 0x7c00);
+
+    uint32_t half;
+    uint32_t shift;
+    if (halfExponent <= 0)
+    {
+        // Denormal or zero.
+        if (halfExponent < -10)
+            return uint16_t(sign);
+        mantissa |= 0x800000;
+        shift = uint32_t(14 - halfExponent);
+        half = mantissa >> shift;
+    }
+    else
+    {
+        shift = 13;
+        half = (uint32_t(halfExponent) << 10) | (mantissa >> shift);
+    }
+
+    // Round to nearest even, a carry correctly propagates into the exponent.
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half & 1)))
+        half++;
+    return uint16_t(sign | half);
+}
+
+// Unsigned floats with a 5 bit exponent as used by R11G11B10_FLOAT.
+inline float smallFloatToFloat(uint32_t bits, uint32_t mantissaBits)
+{
+    uint32_t exponent = bits >> mantissaBits;
+    uint32_t mantissa = bits & ((1u << mantissaBits) - 1);
+    return math::halfToFloat(uint16_t((exponent << 10) | (mantissa << (10 - mantissaBits))));
+}
+
+inline uint32_t floatToSmallFloat(float value, uint32_t mantissaBits)
+{
+    if (value != value)
+        return (0x1fu << mantissaBits) | 1;
+    if (value <= 0.0f)
+        return 0;
+    return uint32_t(floatToHalf(value)) >> (10 - mantissaBits);
+}
+
+struct SrgbTable
+{
+    SrgbTable()
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            float c = i / 255.0f;
+            toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+    }
+    float toLinear[256];
+};
+
+const SrgbTable& getSrgbTable()
+{
+    static const SrgbTable table;
+    return table;
+}
+
+inline float linearToSrgb(float c)
+{
+    c = clampUnorm(c);
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+//
+// Texel codecs.
+// Each codec converts a single texel between its storage representation and
+// 4 components of 32 bits. The span functions below instantiate the codecs in
+// tight loops, so there is no indirect call per texel.
+//
+
+template<int N>
+struct Float32Codec
+{
+    static constexpr uint32_t kTexelSize = 4 * N;
+    static constexpr bool kIsInteger = false;
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        if (N == 4)
+        {
+            memcpy(dst, src, 16);
+            return;
+        }
+        float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        memcpy(temp, src, kTexelSize);
+        memcpy(dst, temp, sizeof(temp));
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst) { memcpy(dst, src, kTexelSize); }
+};
+
+// Depth formats with a 32-bit float followed by 32 bits of stencil or padding.
+// Only the depth value is converted.
+struct Float32X32Codec
+{
+    static constexpr uint32_t kTexelSize = 8;
+    static constexpr bool kIsInteger = false;
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        memcpy(temp, src, 4);
+        memcpy(dst, temp, sizeof(temp));
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst)
+    {
+        memcpy(dst, src, 4);
+        memset(dst + 4, 0, 4);
+    }
+};
+
+template<int N>
+struct Float16Codec
+{
+    static constexpr uint32_t kTexelSize = 2 * N;
+    static constexpr bool kIsInteger = false;
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        uint16_t input[N];
+        memcpy(input, src, kTexelSize);
+        float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        for (int i = 0; i < N; ++i)
+            temp[i] = math::halfToFloat(input[i]);
+        memcpy(dst, temp, sizeof(temp));
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst)
+    {
+        float input[4];
+        memcpy(input, src, sizeof(input));
+        uint16_t output[N];
+        for (int i = 0; i < N; ++i)
+            output[i] = floatToHalf(input[i]);
+        memcpy(dst, output, kTexelSize);
+    }
+};
+
+// Integer (and typeless) formats, signed components are sign extended.
+template<typename T, int N>
+struct IntCodec
+{
+    static constexpr uint32_t kTexelSize = sizeof(T) * N;
+    static constexpr bool kIsInteger = true;
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        T input[N];
+        memcpy(input, src, kTexelSize);
+        uint32_t temp[4] = {0, 0, 0, 1};
+        for (int i = 0; i < N; ++i)
+            temp[i] = uint32_t(input[i]);
+        memcpy(dst, temp, sizeof(temp));
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst)
+    {
+        T output[N];
+        for (int i = 0; i < N; ++i)
+            output[i] = T(src[i]);
+        memcpy(dst, output, kTexelSize);
+    }
+};
+
+template<typename T, int N>
+struct UnormCodec
+{
+    static constexpr uint32_t kTexelSize = sizeof(T) * N;
+    static constexpr bool kIsInteger = false;
+    static constexpr uint32_t kMaxValue = (1u << (8 * sizeof(T))) - 1;
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        if (sizeof(T) == 1 && N == 4)
+        {
+            simd::store((float*)dst, simd::mul(simd::loadU8x4(src), simd::splat(1.0f / 255.0f)));
+            return;
+        }
+        T input[N];
+        memcpy(input, src, kTexelSize);
+        float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        for (int i = 0; i < N; ++i)
+            temp[i] = input[i] * (1.0f / kMaxValue);
+        memcpy(dst, temp, sizeof(temp));
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst)
+    {
+        if (sizeof(T) == 1 && N == 4)
+        {
+            simd::float4v v = simd::clamp(simd::load((const float*)src), simd::splat(0.0f), simd::splat(1.0f));
+            simd::storeU8x4(dst, simd::mul(v, simd::splat(255.0f)));
+            return;
+        }
+        float input[4];
+        memcpy(input, src, sizeof(input));
+        T output[N];
+        for (int i = 0; i < N; ++i)
+            output[i] = T(floatToUnorm(input[i], kMaxValue));
+        memcpy(dst, output, kTexelSize);
+    }
+};
+
+template<typename T, int N>
+struct SnormCodec
+{
+    static constexpr uint32_t kTexelSize = sizeof(T) * N;
+    static constexpr bool kIsInteger = false;
+    static constexpr int32_t kMaxValue = (1 << (8 * sizeof(T) - 1)) - 1;
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        T input[N];
+        memcpy(input, src, kTexelSize);
+        float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        for (int i = 0; i < N; ++i)
+            temp[i] = std::max(input[i] * (1.0f / kMaxValue), -1.0f);
+        memcpy(dst, temp, sizeof(temp));
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst)
+    {
+        float input[4];
+        memcpy(input, src, sizeof(input));
+        T output[N];
+        for (int i = 0; i < N; ++i)
+            output[i] = T(floatToSnorm(input[i], kMaxValue));
+        memcpy(dst, output, kTexelSize);
+    }
+};
+
+// 8-bit normalized RGBA/BGRA formats with optional sRGB encoding and ignored alpha.
+template<bool kBGRA, bool kSRGB, bool kOpaque>
+struct Unorm8x4Codec
+{
+    static constexpr uint32_t kTexelSize = 4;
+    static constexpr bool kIsInteger = false;
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        float temp[4];
+        if (kSRGB)
+        {
+            const SrgbTable& table = getSrgbTable();
+            for (int i = 0; i < 3; ++i)
+                temp[i] = table.toLinear[src[i]];
+            temp[3] = src[3] * (1.0f / 255.0f);
+        }
+        else
+        {
+            simd::store(temp, simd::mul(simd::loadU8x4(src), simd::splat(1.0f / 255.0f)));
+        }
+        if (kBGRA)
+            std::swap(temp[0], temp[2]);
+        if (kOpaque)
+            temp[3] = 1.0f;
+        memcpy(dst, temp, sizeof(temp));
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst)
+    {
+        float temp[4];
+        memcpy(temp, src, sizeof(temp));
+        if (kBGRA)
+            std::swap(temp[0], temp[2]);
+        if (kSRGB)
+        {
+            for (int i = 0; i < 3; ++i)
+                temp[i] = linearToSrgb(temp[i]);
+        }
+        if (kOpaque)
+            temp[3] = 1.0f;
+        simd::float4v v = simd::clamp(simd::load(temp), simd::splat(0.0f), simd::splat(1.0f));
+        simd::storeU8x4(dst, simd::mul(v, simd::splat(255.0f)));
+    }
+};
+
+// Packed normalized formats, with bit fields laid out B, G, R, A starting at the least significant bit.
+template<uint32_t kBBits, uint32_t kGBits, uint32_t kRBits, uint32_t kABits>
+struct PackedBGRAUnormCodec
+{
+    static constexpr uint32_t kTexelSize = 2;
+    static constexpr bool kIsInteger = false;
+
+    static float getField(uint32_t bits, uint32_t offset, uint32_t count)
+    {
+        uint32_t maxValue = (1u << count) - 1;
+        return float((bits >> offset) & maxValue) / float(maxValue);
+    }
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        uint16_t bits;
+        memcpy(&bits, src, sizeof(bits));
+        float temp[4];
+        temp[2] = getField(bits, 0, kBBits);
+        temp[1] = getField(bits, kBBits, kGBits);
+        temp[0] = getField(bits, kBBits + kGBits, kRBits);
+        temp[3] = kABits ? getField(bits, kBBits + kGBits + kRBits, kABits) : 1.0f;
+        memcpy(dst, temp, sizeof(temp));
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst)
+    {
+        float input[4];
+        memcpy(input, src, sizeof(input));
+        uint32_t bits = floatToUnorm(input[2], (1u << kBBits) - 1);
+        bits |= floatToUnorm(input[1], (1u << kGBits) - 1) << kBBits;
+        bits |= floatToUnorm(input[0], (1u << kRBits) - 1) << (kBBits + kGBits);
+        if (kABits)
+            bits |= floatToUnorm(input[3], (1u << kABits) - 1) << (kBBits + kGBits + kRBits);
+        uint16_t output = uint16_t(bits);
+        memcpy(dst, &output, sizeof(output));
+    }
+};
+
+template<bool kInteger>
+struct R10G10B10A2Codec
+{
+    static constexpr uint32_t kTexelSize = 4;
+    static constexpr bool kIsInteger = kInteger;
+    static constexpr uint32_t kMaxValues[4] = {0x3ff, 0x3ff, 0x3ff, 0x3};
+    static constexpr uint32_t kOffsets[4] = {0, 10, 20, 30};
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        uint32_t bits;
+        memcpy(&bits, src, sizeof(bits));
+        for (int i = 0; i < 4; ++i)
+        {
+            uint32_t value = (bits >> kOffsets[i]) & kMaxValues[i];
+            if (kInteger)
+            {
+                dst[i] = value;
+            }
+            else
+            {
+                float f = float(value) / float(kMaxValues[i]);
+                memcpy(dst + i, &f, sizeof(f));
+            }
+        }
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst)
+    {
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            uint32_t value;
+            if (kInteger)
+            {
+                value = std::min(src[i], kMaxValues[i]);
+            }
+            else
+            {
+                float f;
+                memcpy(&f, src + i, sizeof(f));
+                value = floatToUnorm(f, kMaxValues[i]);
+            }
+            bits |= value << kOffsets[i];
+        }
+        memcpy(dst, &bits, sizeof(bits));
+    }
+};
+
+struct R11G11B10FloatCodec
+{
+    static constexpr uint32_t kTexelSize = 4;
+    static constexpr bool kIsInteger = false;
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        uint32_t bits;
+        memcpy(&bits, src, sizeof(bits));
+        float temp[4];
+        temp[0] = smallFloatToFloat(bits & 0x7ff, 6);
+        temp[1] = smallFloatToFloat((bits >> 11) & 0x7ff, 6);
+        temp[2] = smallFloatToFloat(bits >> 22, 5);
+        temp[3] = 1.0f;
+        memcpy(dst, temp, sizeof(temp));
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst)
+    {
+        float input[4];
+        memcpy(input, src, sizeof(input));
+        uint32_t bits = floatToSmallFloat(input[0], 6);
+        bits |= floatToSmallFloat(input[1], 6) << 11;
+        bits |= floatToSmallFloat(input[2], 5) << 22;
+        memcpy(dst, &bits, sizeof(bits));
+    }
+};
+
+struct R9G9B9E5Codec
+{
+    static constexpr uint32_t kTexelSize = 4;
+    static constexpr bool kIsInteger = false;
+    static constexpr int32_t kMantissaBits = 9;
+    static constexpr int32_t kExponentBias = 15;
+
+    static void unpack(const uint8_t* src, uint32_t* dst)
+    {
+        uint32_t bits;
+        memcpy(&bits, src, sizeof(bits));
+        float scale = std::ldexp(1.0f, int32_t(bits >> 27) - kExponentBias - kMantissaBits);
+        float temp[4];
+        temp[0] = float(bits & 0x1ff) * scale;
+        temp[1] = float((bits >> 9) & 0x1ff) * scale;
+        temp[2] = float((bits >> 18) & 0x1ff) * scale;
+        temp[3] = 1.0f;
+        memcpy(dst, temp, sizeof(temp));
+    }
+
+    static void pack(const uint32_t* src, uint8_t* dst)
+    {
+        // Largest representable value: (2^9 - 1) / 2^9 * 2^(31 - 15).
+        const float kMaxValue = 65408.0f;
+        float input[3];
+        memcpy(input, src, sizeof(input));
+        for (int i = 0; i < 3; ++i)
+            input[i] = input[i] > 0.0f ? std::min(input[i], kMaxValue) : 0.0f;
+
+        float maxComponent = std::max(input[0], std::max(input[1], input[2]));
+        if (maxComponent == 0.0f)
+        {
+            memset(dst, 0, kTexelSize);
+            return;
+        }
+
+        int32_t exponent;
+        std::frexp(maxComponent, &exponent);
+        int32_t sharedExponent = std::max(exponent, -kExponentBias) + kExponentBias;
+        float scale = std::ldexp(1.0f, sharedExponent - kExponentBias - kMantissaBits);
+        if (uint32_t(maxComponent / scale + 0.5f) == (1u << kMantissaBits))
+        {
+            scale *= 2.0f;
+            sharedExponent++;
+        }
+
+        uint32_t bits = uint32_t(sharedExponent) << 27;
+        for (int i = 0; i < 3; ++i)
+            bits |= std::min(uint32_t(input[i] / scale + 0.5f), 0x1ffu) << (9 * i);
+        memcpy(dst, &bits, sizeof(bits));
+    }
+};
+
+template<typename Codec>
+void unpackSpan(const void* texels, void* outComponents, size_t count)
+{
+    const uint8_t* src = (const uint8_t*)texels;
+    uint32_t* dst = (uint32_t*)outComponents;
+    for (size_t i = 0; i < count; ++i, src += Codec::kTexelSize, dst += 4)
+        Codec::unpack(src, dst);
+}
+
+template<typename Codec>
+void packSpan(const void* components, void* outTexels, size_t count)
+{
+    const uint32_t* src = (const uint32_t*)components;
+    uint8_t* dst = (uint8_t*)outTexels;
+    for (size_t i = 0; i < count; ++i, src += 4, dst += Codec::kTexelSize)
+        Codec::pack(src, dst);
+}
+
+struct FormatConversionMap
+{
+    FormatConversionMap()
+    {
+        memset(m_infos, 0, sizeof(m_infos));
+
+        set<IntCodec<uint32_t, 4>>(Format::R32G32B32A32_TYPELESS);
+        set<IntCodec<uint32_t, 3>>(Format::R32G32B32_TYPELESS);
+        set<IntCodec<uint32_t, 2>>(Format::R32G32_TYPELESS);
+        set<IntCodec<uint32_t, 1>>(Format::R32_TYPELESS);
+
+        set<IntCodec<uint16_t, 4>>(Format::R16G16B16A16_TYPELESS);
+        set<IntCodec<uint16_t, 2>>(Format::R16G16_TYPELESS);
+        set<IntCodec<uint16_t, 1>>(Format::R16_TYPELESS);
+
+        set<IntCodec<uint8_t, 4>>(Format::R8G8B8A8_TYPELESS);
+        set<IntCodec<uint8_t, 2>>(Format::R8G8_TYPELESS);
+        set<IntCodec<uint8_t, 1>>(Format::R8_TYPELESS);
+        set<IntCodec<uint8_t, 4>>(Format::B8G8R8A8_TYPELESS);
+
+        set<Float32Codec<4>>(Format::R32G32B32A32_FLOAT);
+        set<Float32Codec<3>>(Format::R32G32B32_FLOAT);
+        set<Float32Codec<2>>(Format::R32G32_FLOAT);
+        set<Float32Codec<1>>(Format::R32_FLOAT);
+
+        set<Float16Codec<4>>(Format::R16G16B16A16_FLOAT);
+        set<Float16Codec<2>>(Format::R16G16_FLOAT);
+        set<Float16Codec<1>>(Format::R16_FLOAT);
+
+        set<IntCodec<uint32_t, 4>>(Format::R32G32B32A32_UINT);
+        set<IntCodec<uint32_t, 3>>(Format::R32G32B32_UINT);
+        set<IntCodec<uint32_t, 2>>(Format::R32G32_UINT);
+        set<IntCodec<uint32_t, 1>>(Format::R32_UINT);
+
+        set<IntCodec<uint16_t, 4>>(Format::R16G16B16A16_UINT);
+        set<IntCodec<uint16_t, 2>>(Format::R16G16_UINT);
+        set<IntCodec<uint16_t, 1>>(Format::R16_UINT);
+
+        set<IntCodec<uint8_t, 4>>(Format::R8G8B8A8_UINT);
+        set<IntCodec<uint8_t, 2>>(Format::R8G8_UINT);
+        set<IntCodec<uint8_t, 1>>(Format::R8_UINT);
+
+        set<IntCodec<int32_t, 4>>(Format::R32G32B32A32_SINT);
+        set<IntCodec<int32_t, 3>>(Format::R32G32B32_SINT);
+        set<IntCodec<int32_t, 2>>(Format::R32G32_SINT);
+        set<IntCodec<int32_t, 1>>(Format::R32_SINT);
+
+        set<IntCodec<int16_t, 4>>(Format::R16G16B16A16_SINT);
+        set<IntCodec<int16_t, 2>>(Format::R16G16_SINT);
+        set<IntCodec<int16_t, 1>>(Format::R16_SINT);
+
+        set<IntCodec<int8_t, 4>>(Format::R8G8B8A8_SINT);
+        set<IntCodec<int8_t, 2>>(Format::R8G8_SINT);
+        set<IntCodec<int8_t, 1>>(Format::R8_SINT);
+
+        set<UnormCodec<uint16_t, 4>>(Format::R16G16B16A16_UNORM);
+        set<UnormCodec<uint16_t, 2>>(Format::R16G16_UNORM);
+        set<UnormCodec<uint16_t, 1>>(Format::R16_UNORM);
+
+        set<UnormCodec<uint8_t, 4>>(Format::R8G8B8A8_UNORM);
+        set<Unorm8x4Codec<false, true, false>>(Format::R8G8B8A8_UNORM_SRGB);
+        set<UnormCodec<uint8_t, 2>>(Format::R8G8_UNORM);
+        set<UnormCodec<uint8_t, 1>>(Format::R8_UNORM);
+        set<Unorm8x4Codec<true, false, false>>(Format::B8G8R8A8_UNORM);
+        set<Unorm8x4Codec<true, true, false>>(Format::B8G8R8A8_UNORM_SRGB);
+        set<Unorm8x4Codec<true, false, true>>(Format::B8G8R8X8_UNORM);
+        set<Unorm8x4Codec<true, true, true>>(Format::B8G8R8X8_UNORM_SRGB);
+
+        set<SnormCodec<int16_t, 4>>(Format::R16G16B16A16_SNORM);
+        set<SnormCodec<int16_t, 2>>(Format::R16G16_SNORM);
+        set<SnormCodec<int16_t, 1>>(Format::R16_SNORM);
+
+        set<SnormCodec<int8_t, 4>>(Format::R8G8B8A8_SNORM);
+        set<SnormCodec<int8_t, 2>>(Format::R8G8_SNORM);
+        set<SnormCodec<int8_t, 1>>(Format::R8_SNORM);
+
+        set<Float32Codec<1>>(Format::D32_FLOAT);
+        set<UnormCodec<uint16_t, 1>>(Format::D16_UNORM);
+        set<Float32X32Codec>(Format::D32_FLOAT_S8_UINT);
+        set<Float32X32Codec>(Format::R32_FLOAT_X32_TYPELESS);
+
+        set<PackedBGRAUnormCodec<4, 4, 4, 4>>(Format::B4G4R4A4_UNORM);
+        set<PackedBGRAUnormCodec<5, 6, 5, 0>>(Format::B5G6R5_UNORM);
+        set<PackedBGRAUnormCodec<5, 5, 5, 1>>(Format::B5G5R5A1_UNORM);
+
+        set<R9G9B9E5Codec>(Format::R9G9B9E5_SHAREDEXP);
+        set<R10G10B10A2Codec<true>>(Format::R10G10B10A2_TYPELESS);
+        set<R10G10B10A2Codec<false>>(Format::R10G10B10A2_UNORM);
+        set<R10G10B10A2Codec<true>>(Format::R10G10B10A2_UINT);
+        set<R11G11B10FloatCodec>(Format::R11G11B10_FLOAT);
+
+        // 64-bit integers are exposed as two 32-bit components (low, high).
+        set<IntCodec<uint32_t, 2>>(Format::R64_UINT);
+        set<IntCodec<uint32_t, 2>>(Format::R64_SINT);
+    }
+
+    template<typename Codec>
+    void set(Format format)
+    {
+        auto& info = m_infos[Index(format)];
+        info.unpack = &unpackSpan<Codec>;
+        info.pack = &packSpan<Codec>;
+        info.texelSize = Codec::kTexelSize;
+        info.isInteger = Codec::kIsInteger;
+    }
+
+    CPUFormatConversionInfo m_infos[Index(Format::_Count)];
+};
+
+const FormatConversionMap s_formatConversionMap;
+
+} // namespace
+
+const CPUFormatConversionInfo* getFormatConversionInfo(Format format)
+{
+    const CPUFormatConversionInfo& info = s_formatConversionMap.m_infos[Index(format)];
+    return info.unpack ? &info : nullptr;
+}
+
+void convertTexels(
+    const CPUFormatConversionInfo* srcInfo,
+    const void* src,
+    const CPUFormatConversionInfo* dstInfo,
+    void* dst,
+    size_t count
+)
+{
+    if (srcInfo == dstInfo)
+    {
+        memcpy(dst, src, count * srcInfo->texelSize);
+        return;
+    }
+
+    // Convert in chunks that fit in L1.
+    const size_t kChunkSize = 256;
+    uint32_t components[kChunkSize * 4];
+    const uint8_t* srcPtr = (const uint8_t*)src;
+    uint8_t* dstPtr = (uint8_t*)dst;
+    while (count > 0)
+    {
+        size_t chunk = std::min(count, kChunkSize);
+        srcInfo->unpack(srcPtr, components, chunk);
+        dstInfo->pack(components, dstPtr, chunk);
+        srcPtr += chunk * srcInfo->texelSize;
+        dstPtr += chunk * dstInfo->texelSize;
+        count -= chunk;
+    }
+}
+
+} // namespace rhi::cpu
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "cpu-base.h"
+
+namespace rhi::cpu {
+
+/// Converts `count` consecutive texels from their storage representation into 4 components of 32 bits each.
+/// Float and normalized formats produce floats, integer and typeless formats produce 32-bit integers.
+/// Components not present in the format are set to (0, 0, 0, 1).
+typedef void (*CPUTexelUnpackFunc)(const void* texels, void* outComponents, size_t count);
+
+/// Converts `count` texels given as 4 components of 32 bits each into their storage representation.
+typedef void (*CPUTexelPackFunc)(const void* components, void* outTexels, size_t count);
+
+struct CPUFormatConversionInfo
+{
+    CPUTexelUnpackFunc unpack;
+    CPUTexelPackFunc pack;
+    uint32_t texelSize;
+    /// Components are 32-bit integers rather than floats.
+    bool isInteger;
+};
+
+/// Returns the conversion functions for `format`, or nullptr for formats that are not supported
+/// (block compressed formats).
+const CPUFormatConversionInfo* getFormatConversionInfo(Format format);
+
+/// Unpack a single texel and write the first `outSize` bytes of its components.
+inline void unpackTexel(const CPUFormatConversionInfo* info, const void* texel, void* outData, size_t outSize)
+{
+    uint32_t temp[4];
+    info->unpack(texel, temp, 1);
+    memcpy(outData, temp, outSize < sizeof(temp) ? outSize : sizeof(temp));
+}
+
+/// Convert `count` texels between two formats by going through the unpacked representation.
+void convertTexels(
+    const CPUFormatConversionInfo* srcInfo,
+    const void* src,
+    const CPUFormatConversionInfo* dstInfo,
+    void* dst,
+    size_t count
+);
+
+} // namespace rhi::cpu
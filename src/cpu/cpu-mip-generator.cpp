@@ -0,0 +1,251 @@
+#include "cpu-mip-generator.h"
+#include "cpu-copy.h"
+#include "cpu-simd.h"
+#include "cpu-texture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace rhi::cpu {
+
+/// Half width of the Kaiser filter, in texels of the generated level.
+static const double kKaiserWidth = 3.0;
+static const double kKaiserAlpha = 4.0;
+
+namespace {
+
+struct FilterTap
+{
+    int32_t index;
+    float weight;
+};
+
+/// Taps of a 1D filter resampling the texels of a level along one axis to the next level.
+/// The taps of texel i of the next level are `taps[offsets[i]]` up to `taps[offsets[i + 1]]`.
+struct AxisFilter
+{
+    std::vector<uint32_t> offsets;
+    std::vector<FilterTap> taps;
+    uint32_t maxTapCount = 0;
+};
+
+/// Row of a source level filtered along x, kept for the neighbouring rows of the generated level.
+struct FilteredRow
+{
+    int32_t layer = -1;
+    int32_t y = 0;
+    int32_t z = 0;
+    std::vector<float> texels;
+};
+
+} // namespace
+
+/// Zeroth order modified Bessel function of the first kind.
+static double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x * 0.5;
+    for (int k = 1; k < 64 && term > sum * 1e-12; k++)
+    {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+    }
+    return sum;
+}
+
+static double kaiser(double x)
+{
+    if (std::abs(x) >= kKaiserWidth)
+        return 0.0;
+    const double kPi = 3.14159265358979323846;
+    double sinc = x == 0.0 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+    double t = x / kKaiserWidth;
+    return sinc * besselI0(kKaiserAlpha * std::sqrt(1.0 - t * t)) / besselI0(kKaiserAlpha);
+}
+
+static AxisFilter createAxisFilter(int32_t srcExtent, int32_t dstExtent, MipFilter filter)
+{
+    AxisFilter result;
+    double scale = double(srcExtent) / dstExtent;
+    for (int32_t i = 0; i < dstExtent; i++)
+    {
+        size_t first = result.taps.size();
+        auto addTap = [&](int32_t index, double weight)
+        {
+            // Taps outside of the level are clamped to the edge texel and merged.
+            index = std::clamp(index, 0, srcExtent - 1);
+            if (result.taps.size() > first && result.taps.back().index == index)
+                result.taps.back().weight += float(weight);
+            else
+                result.taps.push_back({index, float(weight)});
+        };
+
+        if (srcExtent == dstExtent)
+        {
+            addTap(i, 1.0);
+        }
+        else if (filter == MipFilter::Kaiser)
+        {
+            double center = (i + 0.5) * scale;
+            double support = kKaiserWidth * scale;
+            int32_t end = int32_t(std::ceil(center + support));
+            for (int32_t j = int32_t(std::floor(center - support)); j <= end; j++)
+            {
+                double weight = kaiser((j + 0.5 - center) / scale);
+                if (weight != 0.0)
+                    addTap(j, weight);
+            }
+        }
+        else
+        {
+            // Weight the source texels by how much of them is covered, which handles odd extents.
+            double begin = i * scale;
+            double end = (i + 1) * scale;
+            for (int32_t j = int32_t(std::floor(begin)); j < int32_t(std::ceil(end)); j++)
+            {
+                double weight = std::min(end, j + 1.0) - std::max(begin, double(j));
+                if (weight > 0.0)
+                    addTap(j, weight);
+            }
+        }
+
+        float sum = 0.0f;
+        for (size_t t = first; t < result.taps.size(); t++)
+            sum += result.taps[t].weight;
+        for (size_t t = first; t < result.taps.size(); t++)
+            result.taps[t].weight /= sum;
+        result.offsets.push_back(uint32_t(first));
+        result.maxTapCount = std::max(result.maxTapCount, uint32_t(result.taps.size() - first));
+    }
+    result.offsets.push_back(uint32_t(result.taps.size()));
+    return result;
+}
+
+/// Filter a row of unpacked texels along x.
+static void filterRow(const AxisFilter& axis, const float* src, float* dst, int32_t dstExtent)
+{
+    for (int32_t i = 0; i < dstExtent; i++)
+    {
+        simd::float4v sum = simd::splat(0.0f);
+        for (uint32_t t = axis.offsets[i]; t < axis.offsets[i + 1]; t++)
+        {
+            const FilterTap& tap = axis.taps[t];
+            sum = simd::madd(simd::splat(tap.weight), simd::load(src + 4 * tap.index), sum);
+        }
+        simd::store(dst + 4 * i, sum);
+    }
+}
+
+/// Add a weighted row of unpacked texels to `dst`.
+static void accumulateRow(const float* src, float weight, float* dst, int32_t extent)
+{
+    simd::float4v w = simd::splat(weight);
+    for (int32_t i = 0; i < extent; i++)
+        simd::store(dst + 4 * i, simd::madd(w, simd::load(src + 4 * i), simd::load(dst + 4 * i)));
+}
+
+/// Generate level `srcMipLevel + 1` of the array layers [baseLayer, baseLayer + layerCount) from `srcMipLevel`.
+static void generateMipLevel(
+    ThreadPool* threadPool,
+    TextureImpl* texture,
+    GfxIndex srcMipLevel,
+    GfxIndex baseLayer,
+    GfxCount layerCount,
+    MipFilter filter
+)
+{
+    const TextureImpl::MipLevel& srcLevel = texture->m_mipLevels[srcMipLevel];
+    const TextureImpl::MipLevel& dstLevel = texture->m_mipLevels[srcMipLevel + 1];
+    const CPUFormatConversionInfo* formatInfo = texture->m_formatInfo;
+    uint8_t* data = (uint8_t*)texture->m_data;
+
+    AxisFilter axes[3];
+    for (int axis = 0; axis < 3; axis++)
+        axes[axis] = createAxisFilter(srcLevel.extents[axis], dstLevel.extents[axis], filter);
+
+    int32_t srcWidth = srcLevel.extents[0];
+    int32_t dstWidth = dstLevel.extents[0];
+    size_t rowsPerLayer = size_t(dstLevel.extents[1]) * dstLevel.extents[2];
+    size_t filteredRowCount = size_t(axes[1].maxTapCount) * axes[2].maxTapCount;
+    size_t bytesPerRow = filteredRowCount * srcWidth * 4 * sizeof(float);
+
+    parallelForRanges(
+        threadPool,
+        rowsPerLayer * layerCount,
+        bytesPerRow,
+        [&](size_t begin, size_t end)
+        {
+            std::vector<uint8_t> texels(size_t(std::max(srcWidth, dstWidth)) * texture->m_texelSize);
+            std::vector<float> srcRow(size_t(srcWidth) * 4);
+            std::vector<float> dstRow(size_t(dstWidth) * 4);
+            // Neighbouring rows share most of their source rows, which are only filtered along x once.
+            std::vector<FilteredRow> filteredRows(filteredRowCount);
+            size_t nextFilteredRow = 0;
+            auto getFilteredRow = [&](int32_t layer, int32_t y, int32_t z) -> const float*
+            {
+                for (const FilteredRow& row : filteredRows)
+                {
+                    if (row.layer == layer && row.y == y && row.z == z)
+                        return row.texels.data();
+                }
+                FilteredRow& row = filteredRows[nextFilteredRow];
+                nextFilteredRow = (nextFilteredRow + 1) % filteredRows.size();
+                row.layer = layer;
+                row.y = y;
+                row.z = z;
+                row.texels.resize(dstRow.size());
+                const uint8_t* srcData = data + srcLevel.offset + srcLevel.strides[3] * layer;
+                texture->readRow(srcLevel, srcData, y, z, texels.data());
+                formatInfo->unpack(texels.data(), srcRow.data(), srcWidth);
+                filterRow(axes[0], srcRow.data(), row.texels.data(), dstWidth);
+                return row.texels.data();
+            };
+
+            for (size_t rowIndex = begin; rowIndex < end; rowIndex++)
+            {
+                int32_t layer = baseLayer + int32_t(rowIndex / rowsPerLayer);
+                int32_t y = int32_t(rowIndex % rowsPerLayer % dstLevel.extents[1]);
+                int32_t z = int32_t(rowIndex % rowsPerLayer / dstLevel.extents[1]);
+                std::fill(dstRow.begin(), dstRow.end(), 0.0f);
+                for (uint32_t zt = axes[2].offsets[z]; zt < axes[2].offsets[z + 1]; zt++)
+                {
+                    const FilterTap& zTap = axes[2].taps[zt];
+                    for (uint32_t yt = axes[1].offsets[y]; yt < axes[1].offsets[y + 1]; yt++)
+                    {
+                        const FilterTap& yTap = axes[1].taps[yt];
+                        const float* row = getFilteredRow(layer, yTap.index, zTap.index);
+                        accumulateRow(row, zTap.weight * yTap.weight, dstRow.data(), dstWidth);
+                    }
+                }
+                formatInfo->pack(dstRow.data(), texels.data(), dstWidth);
+                uint8_t* dstData = data + dstLevel.offset + dstLevel.strides[3] * layer;
+                texture->writeRow(dstLevel, dstData, y, z, texels.data());
+            }
+        }
+    );
+}
+
+Result generateMips(ThreadPool* threadPool, TextureImpl* texture, const GenerateMipsDesc& desc)
+{
+    // Integer formats cannot be averaged.
+    if (!texture->m_isFilterable)
+        return SLANG_E_INVALID_ARG;
+
+    GfxCount mipLevelCount = GfxCount(texture->m_mipLevels.size());
+    GfxCount layerCount = texture->m_effectiveArrayElementCount;
+    const SubresourceRange& range = desc.range;
+    if (range.mipLevel < 0 || range.mipLevel >= mipLevelCount || range.baseArrayLayer < 0 ||
+        range.baseArrayLayer >= layerCount)
+        return SLANG_E_INVALID_ARG;
+    GfxIndex endMipLevel = range.mipLevel + std::min(range.mipLevelCount, mipLevelCount - range.mipLevel);
+    layerCount = std::min(range.layerCount, layerCount - range.baseArrayLayer);
+
+    // Levels depend on the previous level, the rows of a level are generated in parallel.
+    for (GfxIndex mipLevel = range.mipLevel; mipLevel + 1 < endMipLevel; mipLevel++)
+        generateMipLevel(threadPool, texture, mipLevel, range.baseArrayLayer, layerCount, desc.filter);
+    return SLANG_OK;
+}
+
+} // namespace rhi::cpu
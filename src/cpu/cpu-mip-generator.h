@@ -0,0 +1,14 @@
+#pragma once
+
+#include "cpu-base.h"
+
+namespace rhi::cpu {
+
+class TextureImpl;
+class ThreadPool;
+
+/// Generate the mip levels of a texture described by `desc`, each level filtered from the level before it.
+/// The rows of each level are split across the worker threads.
+Result generateMips(ThreadPool* threadPool, TextureImpl* texture, const GenerateMipsDesc& desc);
+
+} // namespace rhi::cpu
@@ -4,12 +4,15 @@ namespace rhi::cpu {
 
 Result QueryPoolImpl::init(const QueryPoolDesc& desc)
 {
+    m_desc = desc;
     m_queries.resize(desc.count);
     return SLANG_OK;
 }
 
 Result QueryPoolImpl::getResult(GfxIndex queryIndex, GfxCount count, uint64_t* data)
 {
+    if (!isRangeValid(queryIndex, count))
+        return SLANG_E_INVALID_ARG;
     for (GfxCount i = 0; i < count; i++)
     {
         data[i] = m_queries[queryIndex + i];
@@ -9,6 +9,14 @@ class QueryPoolImpl : public QueryPool
 public:
     std::vector<uint64_t> m_queries;
     Result init(const QueryPoolDesc& desc);
+
+    /// Whether `count` queries starting at `index` are inside the pool.
+    bool isRangeValid(GfxIndex index, GfxCount count) const
+    {
+        return index >= 0 && count >= 0 && size_t(index) <= m_queries.size() &&
+               size_t(count) <= m_queries.size() - size_t(index);
+    }
+
     virtual SLANG_NO_THROW Result SLANG_MCALL getResult(GfxIndex queryIndex, GfxCount count, uint64_t* data) override;
 };
 
@@ -0,0 +1,650 @@
+#include "cpu-acceleration-structure.h"
+#include "cpu-simd.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace rhi::cpu {
+
+namespace {
+
+const float kInfinity = std::numeric_limits<float>::infinity();
+
+// Direction components are kept away from zero so that the slab test never computes 0 * inf.
+const float kMinDirection = 1e-20f;
+
+// Scale applied to the far slab distances to compensate for rounding errors (Ize 2013), so that rays
+// grazing a tight box are not missed.
+const float kFarScale = 1.0f + 6.0f * std::numeric_limits<float>::epsilon() * 0.5f;
+
+// Subtrees with at most this many primitives are collapsed into a single leaf, which fills a whole
+// triangle packet.
+const uint32_t kWideLeafSize = 4;
+
+// Traversal stack entries that fit without a heap allocation.
+const uint32_t kInlineStackSize = 64;
+
+float halfArea(const BVHNode& node)
+{
+    float dx = node.boundsMax[0] - node.boundsMin[0];
+    float dy = node.boundsMax[1] - node.boundsMin[1];
+    float dz = node.boundsMax[2] - node.boundsMin[2];
+    return dx * dy + dy * dz + dz * dx;
+}
+
+void transformPoint(const float m[3][4], const float p[3], float out[3])
+{
+    for (int i = 0; i < 3; i++)
+        out[i] = m[i][0] * p[0] + m[i][1] * p[1] + m[i][2] * p[2] + m[i][3];
+}
+
+void transformVector(const float m[3][4], const float v[3], float out[3])
+{
+    for (int i = 0; i < 3; i++)
+        out[i] = m[i][0] * v[0] + m[i][1] * v[1] + m[i][2] * v[2];
+}
+
+struct TraversalRay
+{
+    float origin[3];
+    float direction[3];
+    float invDirection[3];
+    // Index into `BVH4Node::bounds` of the plane that is entered first along each axis.
+    int nearPlane[3];
+    float tMin;
+    simd::float4v origin4[3];
+    simd::float4v direction4[3];
+    simd::float4v invDirection4[3];
+};
+
+void initTraversalRay(TraversalRay& ray, const float origin[3], const float direction[3], float tMin)
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float d = direction[axis];
+        if (std::fabs(d) < kMinDirection)
+            d = d < 0.f ? -kMinDirection : kMinDirection;
+        ray.origin[axis] = origin[axis];
+        ray.direction[axis] = direction[axis];
+        ray.invDirection[axis] = 1.f / d;
+        ray.nearPlane[axis] = ray.invDirection[axis] < 0.f ? 1 : 0;
+        ray.origin4[axis] = simd::splat(origin[axis]);
+        ray.direction4[axis] = simd::splat(direction[axis]);
+        ray.invDirection4[axis] = simd::splat(ray.invDirection[axis]);
+    }
+    ray.tMin = tMin;
+}
+
+struct TraversalHit
+{
+    float t;
+    float u;
+    float v;
+    bool found;
+    bool isTriangle;
+    bool frontFace;
+    uint32_t geometryIndex;
+    uint32_t primitiveIndex;
+    const BVHInstance* instance;
+};
+
+struct TraversalState
+{
+    uint32_t rayFlags;
+    uint32_t instanceInclusionMask;
+    TraversalHit hit;
+};
+
+struct StackEntry
+{
+    uint32_t index;
+    // Primitive count for leaves, 0 for inner nodes.
+    uint32_t count;
+    float tNear;
+};
+
+class TraversalStack
+{
+public:
+    bool empty() const { return m_size == 0; }
+
+    void push(const StackEntry& entry)
+    {
+        if (m_size < kInlineStackSize)
+            m_entries[m_size] = entry;
+        else
+            m_overflow.push_back(entry);
+        m_size++;
+    }
+
+    StackEntry pop()
+    {
+        m_size--;
+        if (m_size < kInlineStackSize)
+            return m_entries[m_size];
+        StackEntry entry = m_overflow.back();
+        m_overflow.pop_back();
+        return entry;
+    }
+
+private:
+    StackEntry m_entries[kInlineStackSize];
+    std::vector<StackEntry> m_overflow;
+    uint32_t m_size = 0;
+};
+
+// Tests the ray against the four child boxes of `node`, returns a mask of the children hit
+// within [tMin, tFar] and writes their entry distances to `outNear`.
+inline int intersectNode(const BVH4Node& node, const TraversalRay& ray, float tFar, float outNear[4])
+{
+    simd::float4v tNear4 = simd::splat(ray.tMin);
+    simd::float4v tFar4 = simd::splat(tFar);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        int nearPlane = ray.nearPlane[axis];
+        simd::float4v t0 = simd::mul(
+            simd::sub(simd::load(node.bounds[nearPlane][axis]), ray.origin4[axis]),
+            ray.invDirection4[axis]
+        );
+        simd::float4v t1 = simd::mul(
+            simd::sub(simd::load(node.bounds[1 - nearPlane][axis]), ray.origin4[axis]),
+            ray.invDirection4[axis]
+        );
+        tNear4 = simd::max(tNear4, t0);
+        tFar4 = simd::min(tFar4, simd::mul(t1, simd::splat(kFarScale)));
+    }
+    simd::store(outNear, tNear4);
+    return simd::lessEqualMask(tNear4, tFar4);
+}
+
+bool isOpaque(
+    const AccelerationStructureImpl* accelerationStructure,
+    uint32_t geometryIndex,
+    const BVHInstance* instance,
+    uint32_t rayFlags
+)
+{
+    if (rayFlags & slang_prelude::RAY_FLAG_FORCE_OPAQUE)
+        return true;
+    if (rayFlags & slang_prelude::RAY_FLAG_FORCE_NON_OPAQUE)
+        return false;
+    if (instance && is_set(instance->flags, AccelerationStructureInstanceFlags::ForceOpaque))
+        return true;
+    if (instance && is_set(instance->flags, AccelerationStructureInstanceFlags::NoOpaque))
+        return false;
+    return is_set(accelerationStructure->m_geometryFlags[geometryIndex], AccelerationStructureGeometryFlags::Opaque);
+}
+
+bool isCulledByOpacity(
+    const AccelerationStructureImpl* accelerationStructure,
+    uint32_t geometryIndex,
+    const BVHInstance* instance,
+    uint32_t rayFlags
+)
+{
+    if (!(rayFlags & (slang_prelude::RAY_FLAG_CULL_OPAQUE | slang_prelude::RAY_FLAG_CULL_NON_OPAQUE)))
+        return false;
+    bool opaque = isOpaque(accelerationStructure, geometryIndex, instance, rayFlags);
+    return (rayFlags & (opaque ? slang_prelude::RAY_FLAG_CULL_OPAQUE : slang_prelude::RAY_FLAG_CULL_NON_OPAQUE)) != 0;
+}
+
+// Intersects the triangle packets [first, first + count), returns true if the search should end.
+bool intersectTriangles(
+    const AccelerationStructureImpl* accelerationStructure,
+    uint32_t first,
+    uint32_t count,
+    const TraversalRay& ray,
+    TraversalState& state,
+    const BVHInstance* instance
+)
+{
+    uint32_t rayFlags = state.rayFlags;
+    bool cullingEnabled =
+        !(instance && is_set(instance->flags, AccelerationStructureInstanceFlags::TriangleFacingCullDisable));
+    bool counterClockwise =
+        instance && is_set(instance->flags, AccelerationStructureInstanceFlags::TriangleFrontCounterClockwise);
+
+    for (uint32_t packetIndex = first; packetIndex < first + count; packetIndex++)
+    {
+        const BVHTrianglePacket& packet = accelerationStructure->m_trianglePackets[packetIndex];
+        simd::float4v e1[3];
+        simd::float4v e2[3];
+        simd::float4v s[3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            e1[axis] = simd::load(packet.e1[axis]);
+            e2[axis] = simd::load(packet.e2[axis]);
+            s[axis] = simd::sub(ray.origin4[axis], simd::load(packet.v0[axis]));
+        }
+        const simd::float4v* d = ray.direction4;
+
+        // Moeller-Trumbore on four triangles at once.
+        simd::float4v p[3] = {
+            simd::sub(simd::mul(d[1], e2[2]), simd::mul(d[2], e2[1])),
+            simd::sub(simd::mul(d[2], e2[0]), simd::mul(d[0], e2[2])),
+            simd::sub(simd::mul(d[0], e2[1]), simd::mul(d[1], e2[0])),
+        };
+        simd::float4v q[3] = {
+            simd::sub(simd::mul(s[1], e1[2]), simd::mul(s[2], e1[1])),
+            simd::sub(simd::mul(s[2], e1[0]), simd::mul(s[0], e1[2])),
+            simd::sub(simd::mul(s[0], e1[1]), simd::mul(s[1], e1[0])),
+        };
+        simd::float4v det = simd::madd(e1[0], p[0], simd::madd(e1[1], p[1], simd::mul(e1[2], p[2])));
+        simd::float4v invDet = simd::div(simd::splat(1.f), det);
+        simd::float4v u = simd::mul(simd::madd(s[0], p[0], simd::madd(s[1], p[1], simd::mul(s[2], p[2]))), invDet);
+        simd::float4v v = simd::mul(simd::madd(d[0], q[0], simd::madd(d[1], q[1], simd::mul(d[2], q[2]))), invDet);
+        simd::float4v t = simd::mul(simd::madd(e2[0], q[0], simd::madd(e2[1], q[1], simd::mul(e2[2], q[2]))), invDet);
+
+        float dets[4];
+        float us[4];
+        float vs[4];
+        float ts[4];
+        simd::store(dets, det);
+        simd::store(us, u);
+        simd::store(vs, v);
+        simd::store(ts, t);
+
+        for (int lane = 0; lane < 4; lane++)
+        {
+            uint32_t triangleIndex = packet.triangles[lane];
+            if (triangleIndex == BVHTrianglePacket::kInvalidTriangle)
+                break;
+            // Written so that NaNs from degenerate or inactive triangles are rejected.
+            if (!(us[lane] >= 0.f && vs[lane] >= 0.f && us[lane] + vs[lane] <= 1.f && ts[lane] >= ray.tMin &&
+                  ts[lane] < state.hit.t))
+                continue;
+
+            const BVHTriangle& triangle = accelerationStructure->m_triangles[triangleIndex];
+            bool frontFace = (dets[lane] > 0.f) != counterClockwise;
+            if (cullingEnabled)
+            {
+                if ((rayFlags & slang_prelude::RAY_FLAG_CULL_BACK_FACING_TRIANGLES) && !frontFace)
+                    continue;
+                if ((rayFlags & slang_prelude::RAY_FLAG_CULL_FRONT_FACING_TRIANGLES) && frontFace)
+                    continue;
+            }
+            if (isCulledByOpacity(accelerationStructure, triangle.geometryIndex, instance, rayFlags))
+                continue;
+
+            TraversalHit& hit = state.hit;
+            hit.t = ts[lane];
+            hit.u = us[lane];
+            hit.v = vs[lane];
+            hit.found = true;
+            hit.isTriangle = true;
+            hit.frontFace = frontFace;
+            hit.geometryIndex = triangle.geometryIndex;
+            hit.primitiveIndex = triangle.primitiveIndex;
+            hit.instance = instance;
+            if (rayFlags & slang_prelude::RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH)
+                return true;
+        }
+    }
+    return false;
+}
+
+bool intersectProceduralPrimitives(
+    const AccelerationStructureImpl* accelerationStructure,
+    uint32_t first,
+    uint32_t count,
+    const TraversalRay& ray,
+    TraversalState& state,
+    const BVHInstance* instance
+)
+{
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        const BVHProceduralPrimitive& primitive = accelerationStructure->m_proceduralPrimitives[i];
+        const float* bounds[2] = {primitive.boundsMin, primitive.boundsMax};
+        float tNear = ray.tMin;
+        float tFar = state.hit.t;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            int nearPlane = ray.nearPlane[axis];
+            float t0 = (bounds[nearPlane][axis] - ray.origin[axis]) * ray.invDirection[axis];
+            float t1 = (bounds[1 - nearPlane][axis] - ray.origin[axis]) * ray.invDirection[axis] * kFarScale;
+            tNear = t0 > tNear ? t0 : tNear;
+            tFar = t1 < tFar ? t1 : tFar;
+        }
+        if (!(tNear <= tFar) || !(tNear < state.hit.t))
+            continue;
+        if (isCulledByOpacity(accelerationStructure, primitive.geometryIndex, instance, state.rayFlags))
+            continue;
+
+        TraversalHit& hit = state.hit;
+        hit.t = tNear;
+        hit.u = 0.f;
+        hit.v = 0.f;
+        hit.found = true;
+        hit.isTriangle = false;
+        hit.frontFace = false;
+        hit.geometryIndex = primitive.geometryIndex;
+        hit.primitiveIndex = primitive.primitiveIndex;
+        hit.instance = instance;
+        if (state.rayFlags & slang_prelude::RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH)
+            return true;
+    }
+    return false;
+}
+
+bool traverse(
+    const AccelerationStructureImpl* accelerationStructure,
+    const TraversalRay& ray,
+    TraversalState& state,
+    const BVHInstance* instance
+);
+
+bool intersectInstances(
+    const AccelerationStructureImpl* accelerationStructure,
+    uint32_t first,
+    uint32_t count,
+    const TraversalRay& ray,
+    TraversalState& state
+)
+{
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        const BVHInstance& instance = accelerationStructure->m_instances[i];
+        if ((instance.instanceMask & state.instanceInclusionMask) == 0)
+            continue;
+        const AccelerationStructureImpl* blas = instance.accelerationStructure;
+        if (!blas || blas->m_type == AccelerationStructureBuildInputType::Instances)
+            continue;
+
+        // Object space distances match world space ones, as the direction is not normalized.
+        float origin[3];
+        float direction[3];
+        transformPoint(instance.inverseTransform, ray.origin, origin);
+        transformVector(instance.inverseTransform, ray.direction, direction);
+        TraversalRay objectRay;
+        initTraversalRay(objectRay, origin, direction, ray.tMin);
+        if (traverse(blas, objectRay, state, &instance))
+            return true;
+    }
+    return false;
+}
+
+// Traverses the tree front to back, returns true if the search should end.
+bool traverse(
+    const AccelerationStructureImpl* accelerationStructure,
+    const TraversalRay& ray,
+    TraversalState& state,
+    const BVHInstance* instance
+)
+{
+    if (accelerationStructure->m_wideNodes.empty())
+        return false;
+    switch (accelerationStructure->m_type)
+    {
+    case AccelerationStructureBuildInputType::Triangles:
+        if (state.rayFlags & slang_prelude::RAY_FLAG_SKIP_TRIANGLES)
+            return false;
+        break;
+    case AccelerationStructureBuildInputType::ProceduralPrimitives:
+        if (state.rayFlags & slang_prelude::RAY_FLAG_SKIP_PROCEDURAL_PRIMITIVES)
+            return false;
+        break;
+    default:
+        break;
+    }
+
+    TraversalStack stack;
+    stack.push({0, 0, ray.tMin});
+    while (!stack.empty())
+    {
+        StackEntry entry = stack.pop();
+        if (entry.tNear > state.hit.t)
+            continue;
+
+        if (entry.count != 0)
+        {
+            bool done = false;
+            switch (accelerationStructure->m_type)
+            {
+            case AccelerationStructureBuildInputType::Triangles:
+                done = intersectTriangles(accelerationStructure, entry.index, entry.count, ray, state, instance);
+                break;
+            case AccelerationStructureBuildInputType::ProceduralPrimitives:
+                done = intersectProceduralPrimitives(
+                    accelerationStructure,
+                    entry.index,
+                    entry.count,
+                    ray,
+                    state,
+                    instance
+                );
+                break;
+            case AccelerationStructureBuildInputType::Instances:
+                done = intersectInstances(accelerationStructure, entry.index, entry.count, ray, state);
+                break;
+            }
+            if (done)
+                return true;
+            continue;
+        }
+
+        const BVH4Node& node = accelerationStructure->m_wideNodes[entry.index];
+        float tNear[4];
+        int mask = intersectNode(node, ray, state.hit.t, tNear);
+        if (mask == 0)
+            continue;
+
+        // Sort the children that were hit far to near, so that the nearest one is popped first.
+        StackEntry children[4];
+        int childCount = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            if (!(mask & (1 << i)))
+                continue;
+            StackEntry child = {node.children[i], node.counts[i], tNear[i]};
+            int j = childCount++;
+            for (; j > 0 && children[j - 1].tNear < child.tNear; j--)
+                children[j] = children[j - 1];
+            children[j] = child;
+        }
+        for (int i = 0; i < childCount; i++)
+            stack.push(children[i]);
+    }
+    return false;
+}
+
+} // namespace
+
+void AccelerationStructureImpl::buildWideBVH()
+{
+    m_wideNodes.clear();
+    m_trianglePackets.clear();
+    if (m_nodes.empty())
+        return;
+
+    // Subtrees cover consecutive primitives, compute their ranges bottom up.
+    std::vector<uint32_t> subtreeFirst(m_nodes.size());
+    std::vector<uint32_t> subtreeCount(m_nodes.size());
+    for (size_t i = m_nodes.size(); i-- > 0;)
+    {
+        const BVHNode& node = m_nodes[i];
+        if (node.isLeaf())
+        {
+            subtreeFirst[i] = node.childOrFirst;
+            subtreeCount[i] = node.primitiveCount;
+        }
+        else
+        {
+            subtreeFirst[i] = subtreeFirst[node.childOrFirst];
+            subtreeCount[i] = subtreeCount[node.childOrFirst] + subtreeCount[node.childOrFirst + 1];
+        }
+    }
+    auto isWideLeaf = [&](uint32_t index) { return m_nodes[index].isLeaf() || subtreeCount[index] <= kWideLeafSize; };
+
+    bool packTriangles = m_type == AccelerationStructureBuildInputType::Triangles;
+    auto addLeaf = [&](uint32_t index, uint32_t& outFirst, uint32_t& outCount)
+    {
+        uint32_t first = subtreeFirst[index];
+        uint32_t count = subtreeCount[index];
+        if (!packTriangles)
+        {
+            outFirst = first;
+            outCount = count;
+            return;
+        }
+        outFirst = uint32_t(m_trianglePackets.size());
+        for (uint32_t begin = 0; begin < count; begin += 4)
+        {
+            BVHTrianglePacket packet = {};
+            for (uint32_t lane = 0; lane < 4; lane++)
+            {
+                if (begin + lane >= count)
+                {
+                    packet.triangles[lane] = BVHTrianglePacket::kInvalidTriangle;
+                    continue;
+                }
+                uint32_t triangleIndex = first + begin + lane;
+                const BVHTriangle& triangle = m_triangles[triangleIndex];
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    packet.v0[axis][lane] = triangle.vertices[0][axis];
+                    packet.e1[axis][lane] = triangle.vertices[1][axis] - triangle.vertices[0][axis];
+                    packet.e2[axis][lane] = triangle.vertices[2][axis] - triangle.vertices[0][axis];
+                }
+                packet.triangles[lane] = triangleIndex;
+            }
+            m_trianglePackets.push_back(packet);
+        }
+        outCount = uint32_t(m_trianglePackets.size()) - outFirst;
+    };
+
+    struct PendingNode
+    {
+        uint32_t binaryIndex;
+        uint32_t wideIndex;
+    };
+    std::vector<PendingNode> stack = {{0, 0}};
+    m_wideNodes.resize(1);
+    while (!stack.empty())
+    {
+        PendingNode pending = stack.back();
+        stack.pop_back();
+
+        // Collect up to four children by repeatedly opening the largest inner child.
+        uint32_t slots[4];
+        uint32_t slotCount = 0;
+        if (isWideLeaf(pending.binaryIndex))
+        {
+            slots[slotCount++] = pending.binaryIndex;
+        }
+        else
+        {
+            const BVHNode& binaryNode = m_nodes[pending.binaryIndex];
+            slots[slotCount++] = binaryNode.childOrFirst;
+            slots[slotCount++] = binaryNode.childOrFirst + 1;
+            while (slotCount < 4)
+            {
+                int largest = -1;
+                float largestArea = -1.f;
+                for (uint32_t i = 0; i < slotCount; i++)
+                {
+                    if (!isWideLeaf(slots[i]) && halfArea(m_nodes[slots[i]]) > largestArea)
+                    {
+                        largest = int(i);
+                        largestArea = halfArea(m_nodes[slots[i]]);
+                    }
+                }
+                if (largest < 0)
+                    break;
+                uint32_t opened = m_nodes[slots[largest]].childOrFirst;
+                slots[largest] = opened;
+                slots[slotCount++] = opened + 1;
+            }
+        }
+
+        BVH4Node wideNode = {};
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            if (i >= slotCount)
+            {
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    wideNode.bounds[0][axis][i] = kInfinity;
+                    wideNode.bounds[1][axis][i] = -kInfinity;
+                }
+                continue;
+            }
+            const BVHNode& child = m_nodes[slots[i]];
+            for (int axis = 0; axis < 3; axis++)
+            {
+                wideNode.bounds[0][axis][i] = child.boundsMin[axis];
+                wideNode.bounds[1][axis][i] = child.boundsMax[axis];
+            }
+            if (isWideLeaf(slots[i]))
+            {
+                addLeaf(slots[i], wideNode.children[i], wideNode.counts[i]);
+            }
+            else
+            {
+                wideNode.children[i] = uint32_t(m_wideNodes.size());
+                wideNode.counts[i] = 0;
+                m_wideNodes.emplace_back();
+                stack.push_back({slots[i], wideNode.children[i]});
+            }
+        }
+        m_wideNodes[pending.wideIndex] = wideNode;
+    }
+}
+
+bool AccelerationStructureImpl::TraceRay(
+    const slang_prelude::RayDesc& ray,
+    uint32_t rayFlags,
+    uint32_t instanceInclusionMask,
+    slang_prelude::RayHit* outHit
+)
+{
+    TraversalState state = {};
+    state.rayFlags = rayFlags;
+    state.instanceInclusionMask = instanceInclusionMask;
+    state.hit.t = ray.TMax;
+
+    TraversalRay traversalRay;
+    initTraversalRay(traversalRay, &ray.Origin.x, &ray.Direction.x, ray.TMin);
+    traverse(this, traversalRay, state, nullptr);
+    if (!state.hit.found)
+        return false;
+
+    const TraversalHit& hit = state.hit;
+    outHit->t = hit.t;
+    outHit->barycentrics = slang_prelude::float2(hit.u, hit.v);
+    if (hit.isTriangle)
+    {
+        outHit->hitKind =
+            hit.frontFace ? slang_prelude::HIT_KIND_TRIANGLE_FRONT_FACE : slang_prelude::HIT_KIND_TRIANGLE_BACK_FACE;
+    }
+    else
+    {
+        outHit->hitKind = 0;
+    }
+    outHit->geometryIndex = hit.geometryIndex;
+    outHit->primitiveIndex = hit.primitiveIndex;
+    if (hit.instance)
+    {
+        outHit->instanceIndex = hit.instance->instanceIndex;
+        outHit->instanceID = hit.instance->instanceID;
+        outHit->instanceContributionToHitGroupIndex = hit.instance->instanceContributionToHitGroupIndex;
+        ::memcpy(outHit->objectToWorld, hit.instance->transform, sizeof(outHit->objectToWorld));
+        ::memcpy(outHit->worldToObject, hit.instance->inverseTransform, sizeof(outHit->worldToObject));
+    }
+    else
+    {
+        static const float kIdentity[3][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}};
+        outHit->instanceIndex = 0;
+        outHit->instanceID = 0;
+        outHit->instanceContributionToHitGroupIndex = 0;
+        ::memcpy(outHit->objectToWorld, kIdentity, sizeof(outHit->objectToWorld));
+        ::memcpy(outHit->worldToObject, kIdentity, sizeof(outHit->worldToObject));
+    }
+    transformPoint(outHit->worldToObject, &ray.Origin.x, &outHit->objectRayOrigin.x);
+    transformVector(outHit->worldToObject, &ray.Direction.x, &outHit->objectRayDirection.x);
+    return true;
+}
+
+} // namespace rhi::cpu
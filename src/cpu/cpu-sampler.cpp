@@ -0,0 +1,24 @@
+#include "cpu-sampler.h"
+
+namespace rhi::cpu {
+
+Result SamplerImpl::init()
+{
+    m_state.minLinear = m_desc.minFilter == TextureFilteringMode::Linear;
+    m_state.magLinear = m_desc.magFilter == TextureFilteringMode::Linear;
+    m_state.mipLinear = m_desc.mipFilter == TextureFilteringMode::Linear;
+    // Comparison sampling is not supported, fall back to regular filtering.
+    m_state.reductionOp =
+        m_desc.reductionOp == TextureReductionOp::Comparison ? TextureReductionOp::Average : m_desc.reductionOp;
+    m_state.addressModes[0] = m_desc.addressU;
+    m_state.addressModes[1] = m_desc.addressV;
+    m_state.addressModes[2] = m_desc.addressW;
+    m_state.mipLODBias = m_desc.mipLODBias;
+    m_state.minLOD = m_desc.minLOD;
+    m_state.maxLOD = m_desc.maxLOD;
+    for (int i = 0; i < 4; i++)
+        m_state.borderColor[i] = m_desc.borderColor[i];
+    return SLANG_OK;
+}
+
+} // namespace rhi::cpu
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "cpu-base.h"
+
+namespace rhi::cpu {
+
+/// Sampler state in the form consumed by the texture sampling kernels.
+/// A pointer to this is what kernels receive as `SamplerState`.
+struct CPUSamplerState
+{
+    bool minLinear = false;
+    bool magLinear = false;
+    bool mipLinear = false;
+    TextureReductionOp reductionOp = TextureReductionOp::Average;
+    TextureAddressingMode addressModes[3] = {
+        TextureAddressingMode::ClampToEdge,
+        TextureAddressingMode::ClampToEdge,
+        TextureAddressingMode::ClampToEdge,
+    };
+    float mipLODBias = 0.0f;
+    float minLOD = 0.0f;
+    float maxLOD = 1000.0f;
+    float borderColor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+/// State used when sampling without a bound sampler.
+static const CPUSamplerState kDefaultSamplerState = {};
+
+class SamplerImpl : public Sampler
+{
+public:
+    CPUSamplerState m_state;
+
+    SamplerImpl(const SamplerDesc& desc)
+        : Sampler(desc)
+    {
+    }
+
+    Result init();
+
+    slang_prelude::ISampler* getPreludeSampler() { return reinterpret_cast<slang_prelude::ISampler*>(&m_state); }
+};
+
+} // namespace rhi::cpu
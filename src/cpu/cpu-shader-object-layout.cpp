@@ -78,6 +78,7 @@ ShaderObjectLayoutImpl::ShaderObjectLayoutImpl(
         bindingRangeInfo.count = count;
         bindingRangeInfo.baseIndex = baseIndex;
         bindingRangeInfo.uniformOffset = uniformOffset;
+        bindingRangeInfo.uniformSize = slangLeafTypeLayout->getSize();
         bindingRangeInfo.subObjectIndex = subObjectIndex;
         bindingRangeInfo.isSpecializable = m_elementTypeLayout->isBindingRangeSpecializable(r);
         m_bindingRanges.push_back(bindingRangeInfo);
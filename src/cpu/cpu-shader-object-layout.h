@@ -25,6 +25,7 @@ struct BindingRangeInfo
     // range index and array index.
     //
     Index uniformOffset; // Uniform offset for a resource typed field.
+    size_t uniformSize;  // Uniform size of a single binding of the range.
 
     bool isSpecializable;
 };
@@ -1,9 +1,13 @@
 #include "cpu-shader-object.h"
+#include "cpu-acceleration-structure.h"
 #include "cpu-device.h"
 #include "cpu-buffer.h"
+#include "cpu-sampler.h"
 #include "cpu-texture-view.h"
 #include "cpu-shader-object-layout.h"
 
+#include <algorithm>
+
 namespace rhi::cpu {
 
 Index CPUShaderObjectData::getCount()
@@ -76,6 +80,7 @@ Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* typeLayou
     // and not just the number of resource/sub-object ranges.
     //
     m_resources.resize(typeLayout->getResourceCount());
+    m_counterResources.resize(typeLayout->getResourceCount());
     m_objects.resize(typeLayout->getSubObjectCount());
 
     for (auto subObjectRange : getLayout()->subObjectRanges)
@@ -108,8 +113,59 @@ Result ShaderObjectImpl::init(IDevice* device, ShaderObjectLayoutImpl* typeLayou
             offset.bindingArrayIndex = (GfxIndex)i;
 
             SLANG_RETURN_ON_FAIL(setObject(offset, subObject));
+            m_defaultSubObjects.push_back({offset, subObject});
+        }
+    }
+    return SLANG_OK;
+}
+
+Result ShaderObjectImpl::reset()
+{
+    auto layout = getLayout();
+    size_t uniformSize = layout->getElementTypeLayout()->getSize();
+    m_data.setCount(uniformSize);
+    std::fill(m_data.m_ordinaryData.begin(), m_data.m_ordinaryData.end(), 0);
+    std::fill(m_resources.begin(), m_resources.end(), nullptr);
+    std::fill(m_counterResources.begin(), m_counterResources.end(), nullptr);
+
+    // Cached specializations are kept across resets. They are only invalidated when a change that affects the
+    // specialization arguments is undone, like an existential value or a specialization argument set before.
+    bool dirty = m_structuredBufferSpecializationArgs.getCount() != 0;
+    for (auto& args : m_userProvidedSpecializationArgs)
+    {
+        if (args)
+            dirty = true;
+    }
+    m_userProvidedSpecializationArgs.clear();
+    m_structuredBufferSpecializationArgs.clear();
+
+    // Objects set by the application are released. The objects created by `init` are reused, binding them again
+    // restores their data pointers and only invalidates cached specializations if they had been replaced.
+    if (layout->getContainerType() != ShaderObjectContainerType::None)
+    {
+        for (Index i = 0; i < (Index)m_objects.size(); i++)
+            dirty |= setSubObject(i, nullptr) && layout->mayHaveSpecializationArgs();
+        m_objects.resize(layout->getSubObjectCount());
+    }
+    else
+    {
+        // Only existential ranges have no default objects.
+        for (const auto& subObjectRange : layout->subObjectRanges)
+        {
+            if (subObjectRange.layout)
+                continue;
+            auto& bindingRange = layout->m_bindingRanges[subObjectRange.bindingRangeIndex];
+            for (Index i = 0; i < bindingRange.count; i++)
+                dirty |= setSubObject(bindingRange.subObjectIndex + i, nullptr);
         }
     }
+    if (dirty)
+        markSpecializationDirty();
+    for (DefaultSubObject& subObject : m_defaultSubObjects)
+    {
+        SLANG_RETURN_ON_FAIL(subObject.object->reset());
+        SLANG_RETURN_ON_FAIL(setObject(subObject.offset, subObject.object));
+    }
     return SLANG_OK;
 }
 
@@ -155,6 +211,7 @@ Result ShaderObjectImpl::setBinding(ShaderOffset const& offset, Binding binding)
     switch (binding.type)
     {
     case BindingType::Buffer:
+    case BindingType::BufferWithCounter:
     {
         BufferImpl* buffer = checked_cast<BufferImpl*>(binding.resource.get());
         const BufferDesc& desc = buffer->m_desc;
@@ -172,6 +229,19 @@ Result ShaderObjectImpl::setBinding(ShaderOffset const& offset, Binding binding)
         auto sizeOffset = offset;
         sizeOffset.uniformOffset += sizeof(dataPtr);
         SLANG_RETURN_ON_FAIL(setData(sizeOffset, &size, sizeof(size)));
+
+        // Append/consume buffers are followed by a pointer to the counter, see AppendStructuredBuffer
+        // in the prelude. Bindings without room for it in their own slot only get the element buffer.
+        if (binding.type == BindingType::BufferWithCounter)
+        {
+            BufferImpl* counterBuffer = checked_cast<BufferImpl*>(binding.resource2.get());
+            m_counterResources[viewIndex] = counterBuffer;
+            void* counterPtr = counterBuffer ? counterBuffer->m_data : nullptr;
+            auto counterOffset = offset;
+            counterOffset.uniformOffset += sizeof(dataPtr) + sizeof(size);
+            if (sizeof(dataPtr) + sizeof(size) + sizeof(counterPtr) <= bindingRange.uniformSize)
+                SLANG_RETURN_ON_FAIL(setData(counterOffset, &counterPtr, sizeof(counterPtr)));
+        }
         break;
     }
     case BindingType::Texture:
@@ -189,6 +259,10 @@ Result ShaderObjectImpl::setBinding(ShaderOffset const& offset, Binding binding)
     }
     case BindingType::Sampler:
     {
+        auto sampler = checked_cast<SamplerImpl*>(binding.resource.get());
+        m_resources[viewIndex] = sampler;
+        slang_prelude::ISampler* samplerObj = sampler->getPreludeSampler();
+        SLANG_RETURN_ON_FAIL(setData(offset, &samplerObj, sizeof(samplerObj)));
         break;
     }
     case BindingType::CombinedTextureSampler:
@@ -197,6 +271,10 @@ Result ShaderObjectImpl::setBinding(ShaderOffset const& offset, Binding binding)
     }
     case BindingType::AccelerationStructure:
     {
+        auto accelerationStructure = checked_cast<AccelerationStructureImpl*>(binding.resource.get());
+        m_resources[viewIndex] = accelerationStructure;
+        slang_prelude::RaytracingAccelerationStructure accelerationStructureObj = {accelerationStructure};
+        SLANG_RETURN_ON_FAIL(setData(offset, &accelerationStructureObj, sizeof(accelerationStructureObj)));
         break;
     }
     }
@@ -261,6 +339,14 @@ Result RootShaderObjectImpl::init(IDevice* device, RootShaderObjectLayoutImpl* p
     return SLANG_OK;
 }
 
+Result RootShaderObjectImpl::reset()
+{
+    SLANG_RETURN_ON_FAIL(ShaderObjectImpl::reset());
+    for (auto& entryPoint : m_entryPoints)
+        SLANG_RETURN_ON_FAIL(entryPoint->reset());
+    return SLANG_OK;
+}
+
 RootShaderObjectLayoutImpl* RootShaderObjectImpl::getLayout()
 {
     return checked_cast<RootShaderObjectLayoutImpl*>(m_layout.Ptr());
@@ -33,9 +33,14 @@ class ShaderObjectImpl : public ShaderObjectBaseImpl<ShaderObjectImpl, ShaderObj
 
 public:
     std::vector<RefPtr<Resource>> m_resources;
+    /// Counter buffers of append/consume buffer bindings.
+    std::vector<RefPtr<Resource>> m_counterResources;
 
     virtual SLANG_NO_THROW Result SLANG_MCALL init(IDevice* device, ShaderObjectLayoutImpl* typeLayout);
 
+    /// Restore the state after `init`, keeping the allocated storage and sub-objects.
+    Result reset();
+
     virtual SLANG_NO_THROW GfxCount SLANG_MCALL getEntryPointCount() override;
     virtual SLANG_NO_THROW Result SLANG_MCALL getEntryPoint(GfxIndex index, IShaderObject** outEntryPoint) override;
 
@@ -49,6 +54,16 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL setBinding(ShaderOffset const& offset, Binding binding) override;
 
     uint8_t* getDataBuffer();
+
+private:
+    struct DefaultSubObject
+    {
+        ShaderOffset offset;
+        RefPtr<ShaderObjectImpl> object;
+    };
+
+    /// Sub-objects created by `init`, bound again by `reset`.
+    std::vector<DefaultSubObject> m_defaultSubObjects;
 };
 
 class MutableShaderObjectImpl : public MutableShaderObject<MutableShaderObjectImpl, ShaderObjectLayoutImpl>
@@ -70,6 +85,8 @@ public:
     Result init(IDevice* device, RootShaderObjectLayoutImpl* programLayout);
     using ShaderObjectImpl::init;
 
+    Result reset();
+
     RootShaderObjectLayoutImpl* getLayout();
 
     EntryPointShaderObjectImpl* getEntryPoint(Index index);
@@ -77,6 +94,7 @@ public:
 
     virtual SLANG_NO_THROW GfxCount SLANG_MCALL getEntryPointCount() override;
     virtual SLANG_NO_THROW Result SLANG_MCALL getEntryPoint(GfxIndex index, IShaderObject** outEntryPoint) override;
+    virtual ShaderObjectBase* getEntryPointObject(GfxIndex index) override { return m_entryPoints[index]; }
     virtual Result collectSpecializationArgs(ExtendedShaderObjectTypeList& args) override;
 };
 
@@ -0,0 +1,42 @@
+#include "cpu-shader-program.h"
+
+#include <filesystem>
+
+namespace rhi::cpu {
+
+KernelLibrary::~KernelLibrary()
+{
+    if (handle)
+        unloadSharedLibrary(handle);
+    if (!path.empty())
+    {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+}
+
+Result KernelLibrary::load(ISlangBlob* code)
+{
+#if SLANG_WINDOWS_FAMILY
+    static const char* kLibraryExtension = ".dll";
+#elif SLANG_APPLE_FAMILY
+    static const char* kLibraryExtension = ".dylib";
+#else
+    static const char* kLibraryExtension = ".so";
+#endif
+    // Shared libraries can only be loaded from files, so write the code to a new temporary file.
+    SLANG_RETURN_ON_FAIL(writeTempFile(code->getBufferPointer(), code->getBufferSize(), kLibraryExtension, path));
+
+    return loadSharedLibrary(path.c_str(), handle);
+}
+
+void* KernelLibrary::findSymbolAddressByName(const char* name)
+{
+    if (handle)
+        return rhi::findSymbolAddressByName(handle, name);
+    if (sharedLibrary)
+        return sharedLibrary->findSymbolAddressByName(name);
+    return nullptr;
+}
+
+} // namespace rhi::cpu
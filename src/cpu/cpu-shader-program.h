@@ -3,14 +3,39 @@
 #include "cpu-base.h"
 #include "cpu-shader-object-layout.h"
 
+#include "core/platform.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace rhi::cpu {
 
+/// Host-callable library compiled for a single entry point.
+struct KernelLibrary
+{
+    ComPtr<ISlangSharedLibrary> sharedLibrary;
+
+    // Library loaded from binary code (e.g. from the persistent shader cache).
+    SharedLibraryHandle handle = nullptr;
+    std::string path;
+
+    ~KernelLibrary();
+
+    /// Load the library from its binary representation.
+    Result load(ISlangBlob* code);
+
+    void* findSymbolAddressByName(const char* name);
+};
+
 class ShaderProgramImpl : public ShaderProgram
 {
 public:
     RefPtr<RootShaderObjectLayoutImpl> layout;
 
-    ~ShaderProgramImpl() {}
+    // Kernel libraries indexed by entry point, compiled on first use and kept alive with the program.
+    std::vector<std::unique_ptr<KernelLibrary>> m_kernelLibraries;
+    slang_prelude::ComputeFunc m_computeFunc = nullptr;
 };
 
 } // namespace rhi::cpu
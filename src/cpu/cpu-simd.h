@@ -0,0 +1,217 @@
+#pragma once
+
+// Minimal 4-wide float vector used by the CPU backend kernels.
+// Maps to SSE on x86, NEON on ARM64 and plain scalar code elsewhere.
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SLANG_RHI_CPU_SIMD_SSE 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SLANG_RHI_CPU_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace rhi::cpu::simd {
+
+struct float4v
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    __m128 v;
+#elif SLANG_RHI_CPU_SIMD_NEON
+    float32x4_t v;
+#else
+    float v[4];
+#endif
+};
+
+inline float4v load(const float* p)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    return {_mm_loadu_ps(p)};
+#elif SLANG_RHI_CPU_SIMD_NEON
+    return {vld1q_f32(p)};
+#else
+    return {{p[0], p[1], p[2], p[3]}};
+#endif
+}
+
+inline void store(float* p, float4v a)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    _mm_storeu_ps(p, a.v);
+#elif SLANG_RHI_CPU_SIMD_NEON
+    vst1q_f32(p, a.v);
+#else
+    for (int i = 0; i < 4; i++)
+        p[i] = a.v[i];
+#endif
+}
+
+inline float4v splat(float s)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    return {_mm_set1_ps(s)};
+#elif SLANG_RHI_CPU_SIMD_NEON
+    return {vdupq_n_f32(s)};
+#else
+    return {{s, s, s, s}};
+#endif
+}
+
+inline float4v add(float4v a, float4v b)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    return {_mm_add_ps(a.v, b.v)};
+#elif SLANG_RHI_CPU_SIMD_NEON
+    return {vaddq_f32(a.v, b.v)};
+#else
+    return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+#endif
+}
+
+inline float4v sub(float4v a, float4v b)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    return {_mm_sub_ps(a.v, b.v)};
+#elif SLANG_RHI_CPU_SIMD_NEON
+    return {vsubq_f32(a.v, b.v)};
+#else
+    return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+#endif
+}
+
+inline float4v mul(float4v a, float4v b)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    return {_mm_mul_ps(a.v, b.v)};
+#elif SLANG_RHI_CPU_SIMD_NEON
+    return {vmulq_f32(a.v, b.v)};
+#else
+    return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+#endif
+}
+
+inline float4v div(float4v a, float4v b)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    return {_mm_div_ps(a.v, b.v)};
+#elif SLANG_RHI_CPU_SIMD_NEON
+    return {vdivq_f32(a.v, b.v)};
+#else
+    return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}};
+#endif
+}
+
+/// Returns a * b + c.
+inline float4v madd(float4v a, float4v b, float4v c)
+{
+#if SLANG_RHI_CPU_SIMD_NEON
+    return {vmlaq_f32(c.v, a.v, b.v)};
+#else
+    return add(mul(a, b), c);
+#endif
+}
+
+inline float4v min(float4v a, float4v b)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    return {_mm_min_ps(a.v, b.v)};
+#elif SLANG_RHI_CPU_SIMD_NEON
+    return {vminq_f32(a.v, b.v)};
+#else
+    float4v r;
+    for (int i = 0; i < 4; i++)
+        r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+    return r;
+#endif
+}
+
+inline float4v max(float4v a, float4v b)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    return {_mm_max_ps(a.v, b.v)};
+#elif SLANG_RHI_CPU_SIMD_NEON
+    return {vmaxq_f32(a.v, b.v)};
+#else
+    float4v r;
+    for (int i = 0; i < 4; i++)
+        r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+    return r;
+#endif
+}
+
+/// Returns a 4-bit mask with bit i set if a[i] <= b[i]. Lanes containing NaN compare false.
+inline int lessEqualMask(float4v a, float4v b)
+{
+#if SLANG_RHI_CPU_SIMD_SSE
+    return _mm_movemask_ps(_mm_cmple_ps(a.v, b.v));
+#elif SLANG_RHI_CPU_SIMD_NEON
+    static const uint32_t kLaneBits[4] = {1, 2, 4, 8};
+    return int(vaddvq_u32(vandq_u32(vcleq_f32(a.v, b.v), vld1q_u32(kLaneBits))));
+#else
+    int mask = 0;
+    for (int i = 0; i < 4; i++)
+        mask |= (a.v[i] <= b.v[i]) ? (1 << i) : 0;
+    return mask;
+#endif
+}
+
+/// Linear interpolation between a and b.
+inline float4v lerp(float4v a, float4v b, float t)
+{
+    return madd(sub(b, a), splat(t), a);
+}
+
+inline float4v clamp(float4v a, float4v lo, float4v hi)
+{
+    return min(max(a, lo), hi);
+}
+
+/// Loads 4 bytes and converts them to floats in [0, 255].
+inline float4v loadU8x4(const uint8_t* p)
+{
+    uint32_t bits;
+    memcpy(&bits, p, sizeof(bits));
+#if SLANG_RHI_CPU_SIMD_SSE
+    __m128i zero = _mm_setzero_si128();
+    __m128i x = _mm_cvtsi32_si128(int(bits));
+    x = _mm_unpacklo_epi8(x, zero);
+    x = _mm_unpacklo_epi16(x, zero);
+    return {_mm_cvtepi32_ps(x)};
+#elif SLANG_RHI_CPU_SIMD_NEON
+    uint16x8_t x = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bits)));
+    return {vcvtq_f32_u32(vmovl_u16(vget_low_u16(x)))};
+#else
+    return {{float(bits & 0xff), float((bits >> 8) & 0xff), float((bits >> 16) & 0xff), float(bits >> 24)}};
+#endif
+}
+
+/// Rounds 4 floats to the nearest integer and stores them as saturated bytes.
+inline void storeU8x4(uint8_t* p, float4v a)
+{
+    uint32_t bits;
+#if SLANG_RHI_CPU_SIMD_SSE
+    __m128i x = _mm_cvtps_epi32(a.v);
+    x = _mm_packs_epi32(x, x);
+    x = _mm_packus_epi16(x, x);
+    bits = uint32_t(_mm_cvtsi128_si32(x));
+#elif SLANG_RHI_CPU_SIMD_NEON
+    uint32x4_t x = vcvtq_u32_f32(vaddq_f32(a.v, vdupq_n_f32(0.5f)));
+    uint16x4_t h = vqmovn_u32(x);
+    uint8x8_t b = vqmovn_u16(vcombine_u16(h, h));
+    bits = vget_lane_u32(vreinterpret_u32_u8(b), 0);
+#else
+    bits = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        float v = a.v[i] < 0.0f ? 0.0f : (a.v[i] > 255.0f ? 255.0f : a.v[i]);
+        bits |= uint32_t(v + 0.5f) << (i * 8);
+    }
+#endif
+    memcpy(p, &bits, sizeof(bits));
+}
+
+} // namespace rhi::cpu::simd
@@ -1,5 +1,9 @@
 #include "cpu-texture-view.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 namespace rhi::cpu {
 
 slang_prelude::TextureDimensions TextureViewImpl::GetDimensions(int mipLevel)
@@ -24,7 +28,7 @@ void TextureViewImpl::Load(const int32_t* texelCoords, void* outData, size_t dat
 {
     void* texelPtr = _getTexelPtr(texelCoords);
 
-    m_texture->m_formatInfo->unpackFunc(texelPtr, outData, dataSize);
+    unpackTexel(m_texture->m_formatInfo, texelPtr, outData, dataSize);
 }
 
 void TextureViewImpl::Sample(
@@ -50,20 +54,14 @@ void TextureViewImpl::SampleLevel(
     size_t dataSize
 )
 {
+    const CPUSamplerState& state =
+        samplerState.state ? *reinterpret_cast<const CPUSamplerState*>(samplerState.state) : kDefaultSamplerState;
+
     TextureImpl* texture = m_texture;
     auto baseShape = texture->m_baseShape;
     auto& desc = texture->_getDesc();
-    int32_t rank = baseShape->rank;
     int32_t baseCoordCount = baseShape->baseCoordCount;
 
-    int32_t integerMipLevel = int32_t(level + 0.5f);
-    if (integerMipLevel >= desc.mipLevelCount)
-        integerMipLevel = desc.mipLevelCount - 1;
-    if (integerMipLevel < 0)
-        integerMipLevel = 0;
-
-    auto& mipLevelInfo = texture->m_mipLevels[integerMipLevel];
-
     bool isArray = (desc.arrayLength > 1) || (desc.type == rhi::TextureType::TextureCube);
     int32_t effectiveArrayElementCount = texture->m_effectiveArrayElementCount;
     int32_t coordIndex = baseCoordCount;
@@ -75,31 +73,44 @@ void TextureViewImpl::SampleLevel(
     if (elementIndex < 0)
         elementIndex = 0;
 
-    // Note: for now we are just going to do nearest-neighbor sampling
-    //
-    int64_t texelOffset = mipLevelInfo.offset;
-    texelOffset += elementIndex * mipLevelInfo.strides[3];
-    for (int32_t axis = 0; axis < rank; ++axis)
-    {
-        int32_t extent = mipLevelInfo.extents[axis];
-
-        float coord = coords[axis];
-
-        // TODO: deal with wrap/clamp/repeat if `coord < 0` or `coord > 1`
-
-        int32_t integerCoord = int32_t(coord * (extent - 1) + 0.5f);
-
-        if (integerCoord >= extent)
-            integerCoord = extent - 1;
-        if (integerCoord < 0)
-            integerCoord = 0;
+    float maxLevel = float(desc.mipLevelCount - 1);
+    float lod = level + state.mipLODBias;
+    lod = std::max(state.minLOD, std::min(state.maxLOD, lod));
+    lod = std::max(0.0f, std::min(maxLevel, lod));
 
-        texelOffset += integerCoord * mipLevelInfo.strides[axis];
+    if (!texture->m_isFilterable)
+    {
+        // Integer formats cannot be filtered, return the nearest texel as is.
+        int32_t mipLevel = int32_t(lod + 0.5f);
+        const void* texelPtr = _getFilterTexelPtr(state, mipLevel, elementIndex, coords);
+        if (texelPtr)
+            unpackTexel(m_texture->m_formatInfo, texelPtr, outData, dataSize);
+        else
+            memset(outData, 0, dataSize);
+        return;
     }
 
-    auto texelPtr = (char const*)texture->m_data + texelOffset;
+    bool linear = lod > 0.0f ? state.minLinear : state.magLinear;
+    simd::float4v result;
+    if (state.mipLinear)
+    {
+        int32_t mipLevel = int32_t(lod);
+        float t = lod - float(mipLevel);
+        result = _sampleMipLevel(state, mipLevel, elementIndex, coords, linear);
+        if (t > 0.0f && mipLevel + 1 < desc.mipLevelCount)
+        {
+            simd::float4v next = _sampleMipLevel(state, mipLevel + 1, elementIndex, coords, linear);
+            result = simd::lerp(result, next, t);
+        }
+    }
+    else
+    {
+        result = _sampleMipLevel(state, int32_t(lod + 0.5f), elementIndex, coords, linear);
+    }
 
-    m_texture->m_formatInfo->unpackFunc(texelPtr, outData, dataSize);
+    float temp[4];
+    simd::store(temp, result);
+    memcpy(outData, temp, std::min(dataSize, sizeof(temp)));
 }
 
 void* TextureViewImpl::refAt(const uint32_t* texelCoords)
@@ -141,8 +152,7 @@ void* TextureViewImpl::_getTexelPtr(int32_t const* texelCoords)
 
     auto& mipLevelInfo = texture->m_mipLevels[mipLevel];
 
-    int64_t texelOffset = mipLevelInfo.offset;
-    texelOffset += elementIndex * mipLevelInfo.strides[3];
+    int32_t coords[3] = {0, 0, 0};
     for (int32_t axis = 0; axis < rank; ++axis)
     {
         int32_t coord = texelCoords[axis];
@@ -151,10 +161,200 @@ void* TextureViewImpl::_getTexelPtr(int32_t const* texelCoords)
         if (coord < 0)
             coord = 0;
 
-        texelOffset += texelCoords[axis] * mipLevelInfo.strides[axis];
+        coords[axis] = coord;
     }
 
+    int64_t texelOffset = mipLevelInfo.offset;
+    texelOffset += elementIndex * mipLevelInfo.strides[3];
+    texelOffset += texture->getTexelOffset(mipLevelInfo, coords[0], coords[1], coords[2]);
+
     return (uint8_t*)texture->m_data + texelOffset;
 }
 
+namespace {
+
+// Applies the addressing mode to an integer texel coordinate.
+// Returns -1 if the texel lies outside of the texture and the border color should be used instead.
+inline int32_t applyAddressMode(TextureAddressingMode mode, int32_t coord, int32_t extent)
+{
+    if (coord >= 0 && coord < extent)
+        return coord;
+    switch (mode)
+    {
+    case TextureAddressingMode::Wrap:
+        coord %= extent;
+        return coord < 0 ? coord + extent : coord;
+    case TextureAddressingMode::ClampToBorder:
+        return -1;
+    case TextureAddressingMode::MirrorRepeat:
+    {
+        int32_t period = extent * 2;
+        coord %= period;
+        if (coord < 0)
+            coord += period;
+        return coord < extent ? coord : period - 1 - coord;
+    }
+    case TextureAddressingMode::MirrorOnce:
+        if (coord < 0)
+            coord = -coord - 1;
+        return coord < extent ? coord : extent - 1;
+    case TextureAddressingMode::ClampToEdge:
+    default:
+        return coord < 0 ? 0 : extent - 1;
+    }
+}
+
+// Texels (and their weights) contributing to a filtered sample along a single axis.
+struct AxisTaps
+{
+    int32_t coords[2];
+    float weights[2];
+    int32_t count;
+};
+
+void computeAxisTaps(TextureAddressingMode mode, float coord, int32_t extent, bool linear, AxisTaps& outTaps)
+{
+    // Keep the coordinate in a range that safely converts to an integer.
+    float texelCoord = std::max(-1e9f, std::min(1e9f, coord * float(extent)));
+    if (linear)
+    {
+        texelCoord -= 0.5f;
+        float base = std::floor(texelCoord);
+        float frac = texelCoord - base;
+        outTaps.coords[0] = applyAddressMode(mode, int32_t(base), extent);
+        outTaps.coords[1] = applyAddressMode(mode, int32_t(base) + 1, extent);
+        outTaps.weights[0] = 1.0f - frac;
+        outTaps.weights[1] = frac;
+        outTaps.count = 2;
+    }
+    else
+    {
+        outTaps.coords[0] = applyAddressMode(mode, int32_t(std::floor(texelCoord)), extent);
+        outTaps.weights[0] = 1.0f;
+        outTaps.count = 1;
+    }
+}
+
+} // namespace
+
+simd::float4v TextureViewImpl::_sampleMipLevel(
+    const CPUSamplerState& state,
+    int32_t mipLevel,
+    int32_t elementIndex,
+    const float* coords,
+    bool linear
+)
+{
+    TextureImpl* texture = m_texture;
+    int32_t rank = texture->m_baseShape->rank;
+    auto& mipLevelInfo = texture->m_mipLevels[mipLevel];
+
+    AxisTaps taps[3];
+    for (int32_t axis = 0; axis < 3; ++axis)
+    {
+        if (axis < rank)
+            computeAxisTaps(state.addressModes[axis], coords[axis], mipLevelInfo.extents[axis], linear, taps[axis]);
+        else
+            taps[axis] = {{0, 0}, {1.0f, 0.0f}, 1};
+    }
+
+    const char* basePtr = (const char*)texture->m_data + mipLevelInfo.offset + elementIndex * mipLevelInfo.strides[3];
+    auto unpack = texture->m_formatInfo->unpack;
+
+    simd::float4v result;
+    switch (state.reductionOp)
+    {
+    case TextureReductionOp::Minimum:
+        result = simd::splat(FLT_MAX);
+        break;
+    case TextureReductionOp::Maximum:
+        result = simd::splat(-FLT_MAX);
+        break;
+    default:
+        result = simd::splat(0.0f);
+        break;
+    }
+
+    for (int32_t z = 0; z < taps[2].count; ++z)
+    {
+        for (int32_t y = 0; y < taps[1].count; ++y)
+        {
+            int32_t cy = taps[1].coords[y];
+            int32_t cz = taps[2].coords[z];
+            bool rowValid = cy >= 0 && cz >= 0;
+
+            int64_t offsets[2] = {-1, -1};
+            for (int32_t x = 0; x < taps[0].count; ++x)
+            {
+                int32_t cx = taps[0].coords[x];
+                if (rowValid && cx >= 0)
+                    offsets[x] = texture->getTexelOffset(mipLevelInfo, cx, cy, cz);
+            }
+
+            // Taps that are adjacent in memory are unpacked as a single span.
+            float texels[2][4];
+            if (taps[0].count == 2 && offsets[0] >= 0 && offsets[1] == offsets[0] + mipLevelInfo.strides[0])
+            {
+                unpack(basePtr + offsets[0], texels, 2);
+            }
+            else
+            {
+                for (int32_t x = 0; x < taps[0].count; ++x)
+                {
+                    if (offsets[x] >= 0)
+                        unpack(basePtr + offsets[x], texels[x], 1);
+                    else
+                        memcpy(texels[x], state.borderColor, sizeof(texels[x]));
+                }
+            }
+
+            for (int32_t x = 0; x < taps[0].count; ++x)
+            {
+                float weight = taps[0].weights[x] * taps[1].weights[y] * taps[2].weights[z];
+                simd::float4v texel = simd::load(texels[x]);
+                switch (state.reductionOp)
+                {
+                case TextureReductionOp::Minimum:
+                    if (weight > 0.0f)
+                        result = simd::min(result, texel);
+                    break;
+                case TextureReductionOp::Maximum:
+                    if (weight > 0.0f)
+                        result = simd::max(result, texel);
+                    break;
+                default:
+                    result = simd::madd(texel, simd::splat(weight), result);
+                    break;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+const void* TextureViewImpl::_getFilterTexelPtr(
+    const CPUSamplerState& state,
+    int32_t mipLevel,
+    int32_t elementIndex,
+    const float* coords
+)
+{
+    TextureImpl* texture = m_texture;
+    int32_t rank = texture->m_baseShape->rank;
+    auto& mipLevelInfo = texture->m_mipLevels[mipLevel];
+
+    int32_t texelCoords[3] = {0, 0, 0};
+    for (int32_t axis = 0; axis < rank; ++axis)
+    {
+        AxisTaps taps;
+        computeAxisTaps(state.addressModes[axis], coords[axis], mipLevelInfo.extents[axis], false, taps);
+        if (taps.coords[0] < 0)
+            return nullptr;
+        texelCoords[axis] = taps.coords[0];
+    }
+    int64_t texelOffset = mipLevelInfo.offset + elementIndex * mipLevelInfo.strides[3];
+    texelOffset += texture->getTexelOffset(mipLevelInfo, texelCoords[0], texelCoords[1], texelCoords[2]);
+    return (const char*)texture->m_data + texelOffset;
+}
+
 } // namespace rhi::cpu
@@ -2,6 +2,8 @@
 
 #include "cpu-base.h"
 #include "cpu-buffer.h"
+#include "cpu-sampler.h"
+#include "cpu-simd.h"
 #include "cpu-texture.h"
 
 namespace rhi::cpu {
@@ -43,6 +45,21 @@ public:
     RefPtr<TextureImpl> m_texture;
 
     void* _getTexelPtr(int32_t const* texelCoords);
+
+    simd::float4v _sampleMipLevel(
+        const CPUSamplerState& state,
+        int32_t mipLevel,
+        int32_t elementIndex,
+        const float* coords,
+        bool linear
+    );
+
+    const void* _getFilterTexelPtr(
+        const CPUSamplerState& state,
+        int32_t mipLevel,
+        int32_t elementIndex,
+        const float* coords
+    );
 };
 
 } // namespace rhi::cpu
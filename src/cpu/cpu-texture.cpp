@@ -1,5 +1,7 @@
 #include "cpu-texture.h"
 
+#include <algorithm>
+
 namespace rhi::cpu {
 
 static CPUTextureBaseShapeInfo const* _getBaseShapeInfo(TextureType baseShape)
@@ -7,90 +9,13 @@ static CPUTextureBaseShapeInfo const* _getBaseShapeInfo(TextureType baseShape)
     return &kCPUTextureBaseShapeInfos[(int)baseShape];
 }
 
-template<int N>
-void _unpackFloatTexel(void const* texelData, void* outData, size_t outSize)
-{
-    auto input = (float const*)texelData;
-
-    float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
-    for (int i = 0; i < N; ++i)
-        temp[i] = input[i];
-
-    memcpy(outData, temp, outSize);
-}
-
-template<int N>
-void _unpackFloat16Texel(void const* texelData, void* outData, size_t outSize)
-{
-    auto input = (int16_t const*)texelData;
-
-    float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
-    for (int i = 0; i < N; ++i)
-        temp[i] = math::halfToFloat(input[i]);
-
-    memcpy(outData, temp, outSize);
-}
-
-static inline float _unpackUnorm8Value(uint8_t value)
-{
-    return value / 255.0f;
-}
-
-template<int N>
-void _unpackUnorm8Texel(void const* texelData, void* outData, size_t outSize)
-{
-    auto input = (uint8_t const*)texelData;
-
-    float temp[4] = {0.0f, 0.0f, 0.0f, 1.0f};
-    for (int i = 0; i < N; ++i)
-        temp[i] = _unpackUnorm8Value(input[i]);
-
-    memcpy(outData, temp, outSize);
-}
-
-void _unpackUnormBGRA8Texel(void const* texelData, void* outData, size_t outSize)
-{
-    auto input = (uint8_t const*)texelData;
-
-    float temp[4];
-    temp[0] = _unpackUnorm8Value(input[2]);
-    temp[1] = _unpackUnorm8Value(input[1]);
-    temp[2] = _unpackUnorm8Value(input[0]);
-    temp[3] = _unpackUnorm8Value(input[3]);
-
-    memcpy(outData, temp, outSize);
-}
-
-template<int N>
-void _unpackUInt16Texel(void const* texelData, void* outData, size_t outSize)
-{
-    auto input = (uint16_t const*)texelData;
-
-    uint32_t temp[4] = {0, 0, 0, 0};
-    for (int i = 0; i < N; ++i)
-        temp[i] = input[i];
-
-    memcpy(outData, temp, outSize);
-}
-
-template<int N>
-void _unpackUInt32Texel(void const* texelData, void* outData, size_t outSize)
-{
-    auto input = (uint32_t const*)texelData;
-
-    uint32_t temp[4] = {0, 0, 0, 0};
-    for (int i = 0; i < N; ++i)
-        temp[i] = input[i];
-
-    memcpy(outData, temp, outSize);
-}
-
 TextureImpl::~TextureImpl()
 {
-    free(m_data);
+    if (m_allocator)
+        m_allocator->free(m_data, m_dataSize);
 }
 
-Result TextureImpl::init(SubresourceData const* initData)
+Result TextureImpl::init(std::shared_ptr<MemoryAllocator> allocator, SubresourceData const* initData)
 {
     auto desc = m_desc;
 
@@ -117,10 +42,11 @@ Result TextureImpl::init(SubresourceData const* initData)
     if (!baseShapeInfo)
         return SLANG_FAIL;
 
-    auto formatInfo = _getFormatInfo(desc.format);
+    auto formatInfo = getFormatConversionInfo(desc.format);
     m_formatInfo = formatInfo;
     if (!formatInfo)
         return SLANG_FAIL;
+    m_isFilterable = !formatInfo->isInteger;
 
     int32_t rank = baseShapeInfo->rank;
     int32_t effectiveArrayElementCount = desc.arrayLength * baseShapeInfo->implicitArrayElementCount;
@@ -134,6 +60,17 @@ Result TextureImpl::init(SubresourceData const* initData)
     for (int32_t axis = rank; axis < kMaxRank; ++axis)
         extents[axis] = 1;
 
+    // Tiling only applies to 2D and 3D textures.
+    if (rank < 2)
+        m_isTiled = false;
+    if (m_isTiled)
+    {
+        int32_t shift = rank == 3 ? 2 : 3;
+        for (int32_t axis = 0; axis < rank; ++axis)
+            m_tileShifts[axis] = shift;
+        m_tileSize = int64_t(texelSize) << (shift * rank);
+    }
+
     int32_t levelCount = desc.mipLevelCount;
 
     m_mipLevels.resize(levelCount);
@@ -157,17 +94,32 @@ Result TextureImpl::init(SubresourceData const* initData)
             level.strides[axis] = level.strides[axis - 1] * level.extents[axis - 1];
         }
 
-        int64_t levelDataSize = texelSize;
-        levelDataSize *= effectiveArrayElementCount;
-        for (int32_t axis = 0; axis < rank; ++axis)
-            levelDataSize *= int64_t(level.extents[axis]);
+        if (m_isTiled)
+        {
+            int64_t tileCount = 1;
+            for (int32_t axis = 0; axis < kMaxRank; ++axis)
+            {
+                int32_t tileExtent = 1 << m_tileShifts[axis];
+                level.tileCounts[axis] = (level.extents[axis] + tileExtent - 1) >> m_tileShifts[axis];
+                tileCount *= level.tileCounts[axis];
+            }
+            level.strides[1] = 0;
+            level.strides[2] = 0;
+            level.strides[3] = tileCount * m_tileSize;
+        }
+
+        int64_t levelDataSize = level.strides[3] * effectiveArrayElementCount;
 
         level.offset = totalDataSize;
         totalDataSize += levelDataSize;
     }
 
-    void* textureData = malloc((size_t)totalDataSize);
+    void* textureData = allocator->allocate((size_t)totalDataSize);
+    if (!textureData)
+        return SLANG_E_OUT_OF_MEMORY;
     m_data = textureData;
+    m_dataSize = (size_t)totalDataSize;
+    m_allocator = std::move(allocator);
 
     if (initData)
     {
@@ -178,11 +130,8 @@ Result TextureImpl::init(SubresourceData const* initData)
             {
                 int32_t subresourceIndex = subresourceCounter++;
 
-                auto dstRowStride = m_mipLevels[mipLevel].strides[1];
-                auto dstLayerStride = m_mipLevels[mipLevel].strides[2];
-                auto dstArrayStride = m_mipLevels[mipLevel].strides[3];
-
-                auto textureRowSize = m_mipLevels[mipLevel].extents[0] * texelSize;
+                auto& level = m_mipLevels[mipLevel];
+                auto dstArrayStride = level.strides[3];
 
                 auto rowCount = m_mipLevels[mipLevel].extents[1];
                 auto depthLayerCount = m_mipLevels[mipLevel].extents[2];
@@ -191,27 +140,22 @@ Result TextureImpl::init(SubresourceData const* initData)
                 ptrdiff_t srcRowStride = ptrdiff_t(srcImage.strideY);
                 ptrdiff_t srcLayerStride = ptrdiff_t(srcImage.strideZ);
 
-                char* dstLevel = (char*)textureData + m_mipLevels[mipLevel].offset;
-                char* dstImage = dstLevel + dstArrayStride * arrayElementIndex;
+                uint8_t* dstLevel = (uint8_t*)textureData + level.offset;
+                uint8_t* dstImage = dstLevel + dstArrayStride * arrayElementIndex;
 
                 const char* srcLayer = (const char*)srcImage.data;
-                char* dstLayer = dstImage;
 
                 for (int32_t depthLayer = 0; depthLayer < depthLayerCount; ++depthLayer)
                 {
                     const char* srcRow = srcLayer;
-                    char* dstRow = dstLayer;
 
                     for (int32_t row = 0; row < rowCount; ++row)
                     {
-                        memcpy(dstRow, srcRow, textureRowSize);
-
+                        writeRow(level, dstImage, row, depthLayer, srcRow);
                         srcRow += srcRowStride;
-                        dstRow += dstRowStride;
                     }
 
                     srcLayer += srcLayerStride;
-                    dstLayer += dstLayerStride;
                 }
             }
         }
@@ -220,4 +164,71 @@ Result TextureImpl::init(SubresourceData const* initData)
     return SLANG_OK;
 }
 
+void TextureImpl::readTexels(
+    const MipLevel& level,
+    const uint8_t* elementData,
+    int32_t x,
+    int32_t y,
+    int32_t z,
+    int32_t count,
+    void* dst
+) const
+{
+    uint8_t* dstTexel = (uint8_t*)dst;
+    if (!m_isTiled)
+    {
+        memcpy(dstTexel, elementData + getTexelOffset(level, x, y, z), count * m_texelSize);
+        return;
+    }
+
+    // The texels of a row within a tile are the x bits of the Morton index.
+    int32_t tileMask = (1 << m_tileShifts[0]) - 1;
+    bool is3D = m_tileShifts[2] != 0;
+    int32_t end = x + count;
+    while (x < end)
+    {
+        const uint8_t* tileRow = elementData + getTexelOffset(level, x & ~tileMask, y, z);
+        int32_t tileEnd = std::min((x | tileMask) + 1, end);
+        for (; x < tileEnd; ++x)
+        {
+            uint32_t index = is3D ? _spreadBits3(x & tileMask) : _spreadBits2(x & tileMask);
+            memcpy(dstTexel, tileRow + index * m_texelSize, m_texelSize);
+            dstTexel += m_texelSize;
+        }
+    }
+}
+
+void TextureImpl::writeTexels(
+    const MipLevel& level,
+    uint8_t* elementData,
+    int32_t x,
+    int32_t y,
+    int32_t z,
+    int32_t count,
+    const void* src
+)
+{
+    const uint8_t* srcTexel = (const uint8_t*)src;
+    if (!m_isTiled)
+    {
+        memcpy(elementData + getTexelOffset(level, x, y, z), srcTexel, count * m_texelSize);
+        return;
+    }
+
+    int32_t tileMask = (1 << m_tileShifts[0]) - 1;
+    bool is3D = m_tileShifts[2] != 0;
+    int32_t end = x + count;
+    while (x < end)
+    {
+        uint8_t* tileRow = elementData + getTexelOffset(level, x & ~tileMask, y, z);
+        int32_t tileEnd = std::min((x | tileMask) + 1, end);
+        for (; x < tileEnd; ++x)
+        {
+            uint32_t index = is3D ? _spreadBits3(x & tileMask) : _spreadBits2(x & tileMask);
+            memcpy(tileRow + index * m_texelSize, srcTexel, m_texelSize);
+            srcTexel += m_texelSize;
+        }
+    }
+}
+
 } // namespace rhi::cpu
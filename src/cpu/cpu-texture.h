@@ -1,6 +1,10 @@
 #pragma once
 
+#include "cpu-allocator.h"
 #include "cpu-base.h"
+#include "cpu-format-conversion.h"
+
+#include <memory>
 
 namespace rhi::cpu {
 
@@ -20,72 +24,25 @@ static const CPUTextureBaseShapeInfo kCPUTextureBaseShapeInfos[] = {
 
 static CPUTextureBaseShapeInfo const* _getBaseShapeInfo(TextureType baseShape);
 
-typedef void (*CPUTextureUnpackFunc)(void const* texelData, void* outData, size_t outSize);
-
-struct CPUTextureFormatInfo
+/// Spread the low 8 bits of `v` so that there is one zero bit between each of them.
+inline uint32_t _spreadBits2(uint32_t v)
 {
-    CPUTextureUnpackFunc unpackFunc;
-};
-
-template<int N>
-void _unpackFloatTexel(void const* texelData, void* outData, size_t outSize);
-
-template<int N>
-void _unpackFloat16Texel(void const* texelData, void* outData, size_t outSize);
-
-static inline float _unpackUnorm8Value(uint8_t value);
-
-template<int N>
-void _unpackUnorm8Texel(void const* texelData, void* outData, size_t outSize);
-
-void _unpackUnormBGRA8Texel(void const* texelData, void* outData, size_t outSize);
-
-template<int N>
-void _unpackUInt16Texel(void const* texelData, void* outData, size_t outSize);
-
-template<int N>
-void _unpackUInt32Texel(void const* texelData, void* outData, size_t outSize);
-
-struct CPUFormatInfoMap
-{
-    CPUFormatInfoMap()
-    {
-        memset(m_infos, 0, sizeof(m_infos));
-
-        set(Format::R32G32B32A32_FLOAT, &_unpackFloatTexel<4>);
-        set(Format::R32G32B32_FLOAT, &_unpackFloatTexel<3>);
-
-        set(Format::R32G32_FLOAT, &_unpackFloatTexel<2>);
-        set(Format::R32_FLOAT, &_unpackFloatTexel<1>);
-
-        set(Format::R16G16B16A16_FLOAT, &_unpackFloat16Texel<4>);
-        set(Format::R16G16_FLOAT, &_unpackFloat16Texel<2>);
-        set(Format::R16_FLOAT, &_unpackFloat16Texel<1>);
-
-        set(Format::R8G8B8A8_UNORM, &_unpackUnorm8Texel<4>);
-        set(Format::B8G8R8A8_UNORM, &_unpackUnormBGRA8Texel);
-        set(Format::R16_UINT, &_unpackUInt16Texel<1>);
-        set(Format::R32_UINT, &_unpackUInt32Texel<1>);
-        set(Format::D32_FLOAT, &_unpackFloatTexel<1>);
-    }
-
-    void set(Format format, CPUTextureUnpackFunc func)
-    {
-        auto& info = m_infos[Index(format)];
-        info.unpackFunc = func;
-    }
-
-    SLANG_FORCE_INLINE const CPUTextureFormatInfo& get(Format format) const { return m_infos[Index(format)]; }
-
-    CPUTextureFormatInfo m_infos[Index(Format::_Count)];
-};
-
-static const CPUFormatInfoMap g_formatInfoMap;
+    v &= 0xff;
+    v = (v | (v << 4)) & 0x0f0f;
+    v = (v | (v << 2)) & 0x3333;
+    v = (v | (v << 1)) & 0x5555;
+    return v;
+}
 
-static CPUTextureFormatInfo const* _getFormatInfo(Format format)
+/// Spread the low 10 bits of `v` so that there are two zero bits between each of them.
+inline uint32_t _spreadBits3(uint32_t v)
 {
-    const CPUTextureFormatInfo& info = g_formatInfoMap.get(format);
-    return info.unpackFunc ? &info : nullptr;
+    v &= 0x3ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v << 8)) & 0x0300f00f;
+    v = (v | (v << 4)) & 0x030c30c3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
 }
 
 class TextureImpl : public Texture
@@ -103,25 +60,99 @@ public:
 
     ~TextureImpl();
 
-    Result init(SubresourceData const* initData);
+    Result init(std::shared_ptr<MemoryAllocator> allocator, SubresourceData const* initData);
+
+    struct MipLevel;
+
+    /// Byte offset of texel (x, y, z) relative to the start of an array element of a mip level.
+    int64_t getTexelOffset(const MipLevel& level, int32_t x, int32_t y, int32_t z) const
+    {
+        if (!m_isTiled)
+            return x * level.strides[0] + y * level.strides[1] + z * level.strides[2];
+
+        int64_t tileIndex = (int64_t(z >> m_tileShifts[2]) * level.tileCounts[1] + (y >> m_tileShifts[1])) *
+                                level.tileCounts[0] +
+                            (x >> m_tileShifts[0]);
+        return tileIndex * m_tileSize + _getTexelIndexInTile(x, y, z) * level.strides[0];
+    }
+
+    /// Copy `count` texels of row (y, z) of an array element of a mip level, starting at x, to linear memory.
+    void readTexels(
+        const MipLevel& level,
+        const uint8_t* elementData,
+        int32_t x,
+        int32_t y,
+        int32_t z,
+        int32_t count,
+        void* dst
+    ) const;
+
+    /// Copy `count` texels from linear memory to row (y, z) of an array element of a mip level, starting at x.
+    void writeTexels(
+        const MipLevel& level,
+        uint8_t* elementData,
+        int32_t x,
+        int32_t y,
+        int32_t z,
+        int32_t count,
+        const void* src
+    );
+
+    /// Copy the row of texels at (y, z) of an array element of a mip level to linear memory.
+    void readRow(const MipLevel& level, const uint8_t* elementData, int32_t y, int32_t z, void* dst) const
+    {
+        readTexels(level, elementData, 0, y, z, level.extents[0], dst);
+    }
+
+    /// Copy a row of texels from linear memory to row (y, z) of an array element of a mip level.
+    void writeRow(const MipLevel& level, uint8_t* elementData, int32_t y, int32_t z, const void* src)
+    {
+        writeTexels(level, elementData, 0, y, z, level.extents[0], src);
+    }
 
     TextureDesc const& _getDesc() { return m_desc; }
     Format getFormat() { return m_desc.format; }
     int32_t getRank() { return m_baseShape->rank; }
 
     CPUTextureBaseShapeInfo const* m_baseShape;
-    CPUTextureFormatInfo const* m_formatInfo;
+    CPUFormatConversionInfo const* m_formatInfo;
     int32_t m_effectiveArrayElementCount = 0;
     uint32_t m_texelSize = 0;
+    // Integer formats only support point sampling.
+    bool m_isFilterable = false;
+
+    // In the tiled layout each mip level is split into tiles (8x8 texels for 2D, 4x4x4 texels
+    // for 3D textures) stored one after another, with the texels of a tile in Morton order.
+    // Must be set before `init`. Texels should always be addressed through `getTexelOffset`.
+    bool m_isTiled = false;
+    int32_t m_tileShifts[kMaxRank] = {0, 0, 0};
+    int64_t m_tileSize = 0;
 
     struct MipLevel
     {
         int32_t extents[kMaxRank];
+        // Byte strides along each axis and between array elements.
+        // In the tiled layout only the texel size (0) and array element stride (3) are valid.
         int64_t strides[kMaxRank + 1];
+        // Number of tiles along each axis in the tiled layout.
+        int32_t tileCounts[kMaxRank];
         int64_t offset;
     };
     std::vector<MipLevel> m_mipLevels;
     void* m_data = nullptr;
+    size_t m_dataSize = 0;
+    std::shared_ptr<MemoryAllocator> m_allocator;
+
+private:
+    uint32_t _getTexelIndexInTile(int32_t x, int32_t y, int32_t z) const
+    {
+        uint32_t lx = uint32_t(x) & ((1u << m_tileShifts[0]) - 1);
+        uint32_t ly = uint32_t(y) & ((1u << m_tileShifts[1]) - 1);
+        if (m_tileShifts[2] == 0)
+            return _spreadBits2(lx) | (_spreadBits2(ly) << 1);
+        uint32_t lz = uint32_t(z) & ((1u << m_tileShifts[2]) - 1);
+        return _spreadBits3(lx) | (_spreadBits3(ly) << 1) | (_spreadBits3(lz) << 2);
+    }
 };
 
 } // namespace rhi::cpu
@@ -0,0 +1,145 @@
+#include "cpu-thread-pool.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace rhi::cpu {
+
+static uint64_t getTimeNanoseconds()
+{
+    auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    m_threadCount = threadCount;
+    m_queues = std::make_unique<TaskQueue[]>(m_threadCount);
+    // Queue 0 belongs to the thread calling parallelFor.
+    for (uint32_t i = 1; i < m_threadCount; i++)
+        m_threads.emplace_back([this, i]() { workerMain(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wakeCondition.notify_all();
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void ThreadPool::parallelFor(uint32_t taskCount, const TaskFunc& func)
+{
+    if (taskCount == 0)
+        return;
+
+    if (m_threads.empty() || taskCount == 1)
+    {
+        uint64_t startTime = getTimeNanoseconds();
+        for (uint32_t i = 0; i < taskCount; i++)
+            func(i);
+        uint64_t time = getTimeNanoseconds() - startTime;
+        m_queues[0].busyTime.fetch_add(time, std::memory_order_relaxed);
+        m_activeTime.fetch_add(time, std::memory_order_relaxed);
+        return;
+    }
+
+    std::lock_guard<std::mutex> dispatchLock(m_dispatchMutex);
+    uint64_t startTime = getTimeNanoseconds();
+
+    // Hand out contiguous blocks of tasks to each queue to keep neighbouring tasks on the same thread.
+    for (uint32_t queueIndex = 0; queueIndex < m_threadCount; queueIndex++)
+    {
+        uint32_t begin = uint32_t(uint64_t(taskCount) * queueIndex / m_threadCount);
+        uint32_t end = uint32_t(uint64_t(taskCount) * (queueIndex + 1) / m_threadCount);
+        TaskQueue& queue = m_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (uint32_t i = begin; i < end; i++)
+            queue.tasks.push_back(i);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_func = &func;
+        m_generation++;
+    }
+    m_wakeCondition.notify_all();
+
+    runTasks(0);
+
+    // All queues are drained at this point, wait for workers still executing tasks.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this]() { return m_activeWorkers == 0; });
+    m_func = nullptr;
+    m_activeTime.fetch_add(getTimeNanoseconds() - startTime, std::memory_order_relaxed);
+}
+
+void ThreadPool::workerMain(uint32_t queueIndex)
+{
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCondition.wait(lock, [&]() { return m_shutdown || m_generation != generation; });
+            if (m_shutdown)
+                return;
+            generation = m_generation;
+            // The job may already have completed before this worker woke up.
+            if (!m_func)
+                continue;
+            m_activeWorkers++;
+        }
+
+        runTasks(queueIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_activeWorkers == 0)
+                m_doneCondition.notify_all();
+        }
+    }
+}
+
+void ThreadPool::runTasks(uint32_t queueIndex)
+{
+    const TaskFunc& func = *m_func;
+    uint64_t startTime = getTimeNanoseconds();
+    uint32_t taskIndex;
+    while (popTask(queueIndex, taskIndex) || stealTask(queueIndex, taskIndex))
+        func(taskIndex);
+    m_queues[queueIndex].busyTime.fetch_add(getTimeNanoseconds() - startTime, std::memory_order_relaxed);
+}
+
+bool ThreadPool::popTask(uint32_t queueIndex, uint32_t& outTaskIndex)
+{
+    TaskQueue& queue = m_queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+    outTaskIndex = queue.tasks.front();
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool ThreadPool::stealTask(uint32_t queueIndex, uint32_t& outTaskIndex)
+{
+    for (uint32_t i = 1; i < m_threadCount; i++)
+    {
+        TaskQueue& queue = m_queues[(queueIndex + i) % m_threadCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+        outTaskIndex = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+    return false;
+}
+
+} // namespace rhi::cpu
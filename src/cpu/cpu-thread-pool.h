@@ -0,0 +1,76 @@
+#pragma once
+
+#include "cpu-base.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rhi::cpu {
+
+/// Persistent pool of worker threads executing indexed tasks.
+/// Each participating thread owns a task queue. Threads pop tasks from the front of their own
+/// queue and steal from the back of other queues once their own queue runs dry.
+/// The thread calling `parallelFor` participates in the work.
+class ThreadPool
+{
+public:
+    using TaskFunc = std::function<void(uint32_t taskIndex)>;
+
+    /// Create a pool with `threadCount` participating threads (including the calling thread).
+    /// A `threadCount` of 0 uses the number of hardware threads.
+    ThreadPool(uint32_t threadCount);
+    ~ThreadPool();
+
+    /// Number of threads participating in `parallelFor` (including the calling thread).
+    uint32_t getThreadCount() const { return m_threadCount; }
+
+    /// Execute `func` for every task index in [0, taskCount) and wait for completion.
+    void parallelFor(uint32_t taskCount, const TaskFunc& func);
+
+    /// Total time spent in `parallelFor`, in nanoseconds.
+    uint64_t getActiveTime() const { return m_activeTime.load(std::memory_order_relaxed); }
+
+    /// Time the thread with index `threadIndex` spent executing tasks, in nanoseconds.
+    /// Thread 0 is the thread calling `parallelFor`.
+    uint64_t getBusyTime(uint32_t threadIndex) const
+    {
+        return m_queues[threadIndex].busyTime.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<uint32_t> tasks;
+        std::atomic<uint64_t> busyTime{0};
+    };
+
+    void workerMain(uint32_t queueIndex);
+    void runTasks(uint32_t queueIndex);
+    bool popTask(uint32_t queueIndex, uint32_t& outTaskIndex);
+    bool stealTask(uint32_t queueIndex, uint32_t& outTaskIndex);
+
+    uint32_t m_threadCount = 1;
+    std::vector<std::thread> m_threads;
+    std::unique_ptr<TaskQueue[]> m_queues;
+    std::atomic<uint64_t> m_activeTime{0};
+
+    // Serializes concurrent calls to `parallelFor`.
+    std::mutex m_dispatchMutex;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_doneCondition;
+    const TaskFunc* m_func = nullptr;
+    uint64_t m_generation = 0;
+    uint32_t m_activeWorkers = 0;
+    bool m_shutdown = false;
+};
+
+} // namespace rhi::cpu
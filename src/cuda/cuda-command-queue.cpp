@@ -159,38 +159,40 @@ void CommandQueueImpl::writeTimestamp(IQueryPool* pool, SlangInt index)
 
 void CommandQueueImpl::execute(CommandBufferImpl* commandBuffer)
 {
-    for (auto& cmd : commandBuffer->m_commands)
+    for (const CommandSlot* slot : commandBuffer->getCommands())
     {
-        switch (cmd.name)
+        switch (slot->name)
         {
         case CommandName::SetPipeline:
-            setPipeline(commandBuffer->getObject<Pipeline>(cmd.operands[0]));
+            setPipeline(slot->getArgs<commands::SetPipeline>().pipeline);
             break;
         case CommandName::BindRootShaderObject:
-            bindRootShaderObject(commandBuffer->getObject<ShaderObjectBase>(cmd.operands[0]));
+            bindRootShaderObject(slot->getArgs<commands::BindRootShaderObject>().object);
             break;
         case CommandName::DispatchCompute:
-            dispatchCompute(int(cmd.operands[0]), int(cmd.operands[1]), int(cmd.operands[2]));
+        {
+            const auto& cmd = slot->getArgs<commands::DispatchCompute>();
+            dispatchCompute(cmd.x, cmd.y, cmd.z);
             break;
+        }
         case CommandName::CopyBuffer:
-            copyBuffer(
-                commandBuffer->getObject<Buffer>(cmd.operands[0]),
-                cmd.operands[1],
-                commandBuffer->getObject<Buffer>(cmd.operands[2]),
-                cmd.operands[3],
-                cmd.operands[4]
-            );
+        {
+            const auto& cmd = slot->getArgs<commands::CopyBuffer>();
+            copyBuffer(cmd.dst, cmd.dstOffset, cmd.src, cmd.srcOffset, cmd.size);
             break;
+        }
         case CommandName::UploadBufferData:
-            uploadBufferData(
-                commandBuffer->getObject<Buffer>(cmd.operands[0]),
-                cmd.operands[1],
-                cmd.operands[2],
-                commandBuffer->getData<uint8_t>(cmd.operands[3])
-            );
+        {
+            const auto& cmd = slot->getArgs<commands::UploadBufferData>();
+            uploadBufferData(cmd.buffer, cmd.offset, cmd.size, cmd.data);
             break;
+        }
         case CommandName::WriteTimestamp:
-            writeTimestamp(commandBuffer->getObject<QueryPool>(cmd.operands[0]), (SlangInt)cmd.operands[1]);
+        {
+            const auto& cmd = slot->getArgs<commands::WriteTimestamp>();
+            writeTimestamp(cmd.queryPool, (SlangInt)cmd.index);
+            break;
+        }
         }
     }
 }
@@ -1082,6 +1082,9 @@ Result DeviceImpl::createTransientResourceHeap(
     ITransientResourceHeap** outHeap
 )
 {
+    // Command buffers cannot be resubmitted.
+    if (desc.flags & ITransientResourceHeap::Flags::ReusableCommandBuffers)
+        return SLANG_E_NOT_AVAILABLE;
     RefPtr<TransientResourceHeapImpl> result = new TransientResourceHeapImpl();
     SLANG_RETURN_ON_FAIL(result->init(this, desc));
     returnComPtr(outHeap, result);
@@ -67,6 +67,7 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL init(IDevice* device, ShaderObjectLayoutImpl* typeLayout) override;
     virtual SLANG_NO_THROW GfxCount SLANG_MCALL getEntryPointCount() override;
     virtual SLANG_NO_THROW Result SLANG_MCALL getEntryPoint(GfxIndex index, IShaderObject** outEntryPoint) override;
+    virtual ShaderObjectBase* getEntryPointObject(GfxIndex index) override { return entryPointObjects[index]; }
     virtual Result collectSpecializationArgs(ExtendedShaderObjectTypeList& args) override;
 };
 
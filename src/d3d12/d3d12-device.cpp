@@ -839,6 +839,9 @@ Result DeviceImpl::createTransientResourceHeap(
     ITransientResourceHeap** outHeap
 )
 {
+    // Command buffers cannot be resubmitted.
+    if (desc.flags & ITransientResourceHeap::Flags::ReusableCommandBuffers)
+        return SLANG_E_NOT_AVAILABLE;
     RefPtr<TransientResourceHeapImpl> heap;
     SLANG_RETURN_ON_FAIL(createTransientResourceHeapImpl(
         desc.flags,
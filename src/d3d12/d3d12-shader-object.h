@@ -270,6 +270,7 @@ public:
 
     virtual SLANG_NO_THROW GfxCount SLANG_MCALL getEntryPointCount() override;
     virtual SLANG_NO_THROW Result SLANG_MCALL getEntryPoint(GfxIndex index, IShaderObject** outEntryPoint) override;
+    virtual ShaderObjectBase* getEntryPointObject(GfxIndex index) override { return m_entryPoints[index]; }
     virtual Result collectSpecializationArgs(ExtendedShaderObjectTypeList& args) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL
     copyFrom(IShaderObject* object, ITransientResourceHeap* transientHeap) override;
@@ -167,6 +167,9 @@ void DebugCommandBuffer::checkEncodersClosedBeforeNewEncoder()
 
 void DebugCommandBuffer::checkCommandBufferOpenWhenCreatingEncoder()
 {
+    // Reusable command buffers are recorded again after being closed.
+    if (isReusable)
+        isOpen = true;
     if (!isOpen)
     {
         RHI_VALIDATION_ERROR(
@@ -40,6 +40,7 @@ private:
 public:
     DebugRootShaderObject rootObject;
     bool isOpen = true;
+    bool isReusable = false;
 };
 
 } // namespace rhi::debug
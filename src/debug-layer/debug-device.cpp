@@ -30,6 +30,25 @@ Result DebugDevice::queryInterface(SlangUUID const& uuid, void** outObject) noex
         return SLANG_OK;
     }
 
+    if (uuid == GUID::IID_IImmediateDevice)
+    {
+        if (!m_baseImmediateDevice)
+            SLANG_RETURN_ON_FAIL(baseObject->queryInterface(uuid, (void**)m_baseImmediateDevice.writeRef()));
+        addRef();
+        *outObject = static_cast<IImmediateDevice*>(this);
+        return SLANG_OK;
+    }
+
+    // Buffers created through the CPU device interface need to be wrapped as well.
+    if (uuid == GUID::IID_ICPUDevice)
+    {
+        if (!m_baseCPUDevice)
+            SLANG_RETURN_ON_FAIL(baseObject->queryInterface(uuid, (void**)m_baseCPUDevice.writeRef()));
+        addRef();
+        *outObject = static_cast<ICPUDevice*>(this);
+        return SLANG_OK;
+    }
+
     // Fallback to trying to get the interface from the debugged object
     return baseObject->queryInterface(uuid, outObject);
 }
@@ -82,6 +101,7 @@ Result DebugDevice::createTransientResourceHeap(
     SLANG_RHI_API_FUNC;
 
     RefPtr<DebugTransientResourceHeap> outObject = new DebugTransientResourceHeap(ctx);
+    outObject->m_desc = desc;
     auto result = baseObject->createTransientResourceHeap(desc, outObject->baseObject.writeRef());
     if (SLANG_FAILED(result))
         return result;
@@ -186,6 +206,62 @@ Result DebugDevice::createBufferFromSharedHandle(NativeHandle handle, const Buff
     return result;
 }
 
+Result DebugDevice::createBufferFromHostMemory(
+    const BufferDesc& desc,
+    void* data,
+    HostMemoryReleaseFunc releaseFunc,
+    void* releaseUserData,
+    IBuffer** outBuffer
+)
+{
+    SLANG_RHI_API_FUNC;
+
+    RefPtr<DebugBuffer> outObject = new DebugBuffer(ctx);
+    auto result = m_baseCPUDevice->createBufferFromHostMemory(
+        desc,
+        data,
+        releaseFunc,
+        releaseUserData,
+        outObject->baseObject.writeRef()
+    );
+    if (SLANG_FAILED(result))
+        return result;
+    returnComPtr(outBuffer, outObject);
+    return result;
+}
+
+Result DebugDevice::createBufferFromFile(
+    const BufferDesc& desc,
+    const char* path,
+    uint64_t fileOffset,
+    FileMappingMode mode,
+    IBuffer** outBuffer
+)
+{
+    SLANG_RHI_API_FUNC;
+
+    RefPtr<DebugBuffer> outObject = new DebugBuffer(ctx);
+    auto result = m_baseCPUDevice->createBufferFromFile(desc, path, fileOffset, mode, outObject->baseObject.writeRef());
+    if (SLANG_FAILED(result))
+        return result;
+    returnComPtr(outBuffer, outObject);
+    return result;
+}
+
+Result DebugDevice::getMemoryStats(DeviceMemoryStats* outStats)
+{
+    SLANG_RHI_API_FUNC;
+
+    return m_baseCPUDevice->getMemoryStats(outStats);
+}
+
+Result DebugDevice::getCommandStats(CommandStats* outStats)
+{
+    SLANG_RHI_API_FUNC;
+
+    return m_baseImmediateDevice->getCommandStats(outStats);
+}
+
 Result DebugDevice::createSampler(SamplerDesc const& desc, ISampler** outSampler)
 {
     SLANG_RHI_API_FUNC;
@@ -519,6 +595,12 @@ Result DebugDevice::readBuffer(IBuffer* buffer, size_t offset, size_t size, ISla
     return baseObject->readBuffer(getInnerObj(buffer), offset, size, outBlob);
 }
 
+Result DebugDevice::generateMips(ITexture* texture, const GenerateMipsDesc& desc)
+{
+    SLANG_RHI_API_FUNC;
+    return m_baseCPUDevice->generateMips(getInnerObj(texture), desc);
+}
+
 const DeviceInfo& DebugDevice::getDeviceInfo() const
 {
     SLANG_RHI_API_FUNC;
@@ -4,7 +4,7 @@
 
 namespace rhi::debug {
 
-class DebugDevice : public DebugObject<IDevice>
+class DebugDevice : public DebugObject<IDevice>, public IImmediateDevice, public ICPUDevice
 {
 public:
     Result SLANG_MCALL queryInterface(SlangUUID const& uuid, void** outObject) noexcept override;
@@ -39,6 +39,25 @@ public:
     createBufferFromNativeHandle(NativeHandle handle, const BufferDesc& srcDesc, IBuffer** outBuffer) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL
     createBufferFromSharedHandle(NativeHandle handle, const BufferDesc& srcDesc, IBuffer** outBuffer) override;
+    // IImmediateDevice, forwarded to `m_baseImmediateDevice`.
+    virtual SLANG_NO_THROW Result SLANG_MCALL getCommandStats(CommandStats* outStats) override;
+    // ICPUDevice, forwarded to `m_baseCPUDevice`.
+    virtual SLANG_NO_THROW Result SLANG_MCALL createBufferFromHostMemory(
+        const BufferDesc& desc,
+        void* data,
+        HostMemoryReleaseFunc releaseFunc,
+        void* releaseUserData,
+        IBuffer** outBuffer
+    ) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL createBufferFromFile(
+        const BufferDesc& desc,
+        const char* path,
+        uint64_t fileOffset,
+        FileMappingMode mode,
+        IBuffer** outBuffer
+    ) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL getMemoryStats(DeviceMemoryStats* outStats) override;
+    virtual SLANG_NO_THROW Result SLANG_MCALL generateMips(ITexture* texture, const GenerateMipsDesc& desc) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL createSampler(SamplerDesc const& desc, ISampler** outSampler) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL
     createTextureView(ITexture* texture, const TextureViewDesc& desc, ITextureView** outView) override;
@@ -118,6 +137,8 @@ public:
 
 private:
     DebugContext m_ctx;
+    ComPtr<IImmediateDevice> m_baseImmediateDevice;
+    ComPtr<ICPUDevice> m_baseCPUDevice;
 };
 
 } // namespace rhi::debug
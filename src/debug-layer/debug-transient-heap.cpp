@@ -38,6 +38,7 @@ Result DebugTransientResourceHeap::createCommandBuffer(ICommandBuffer** outComma
     SLANG_RHI_API_FUNC;
     RefPtr<DebugCommandBuffer> outObject = new DebugCommandBuffer(ctx);
     outObject->m_transientHeap = this;
+    outObject->isReusable = (m_desc.flags & ITransientResourceHeap::Flags::ReusableCommandBuffers) != 0;
     auto result = baseObject->createCommandBuffer(outObject->baseObject.writeRef());
     if (SLANG_FAILED(result))
         return result;
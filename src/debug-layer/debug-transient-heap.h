@@ -13,6 +13,8 @@ public:
     SLANG_RHI_DEBUG_OBJECT_CONSTRUCTOR(DebugTransientResourceHeap);
 
 public:
+    ITransientResourceHeap::Desc m_desc = {};
+
     virtual SLANG_NO_THROW Result SLANG_MCALL queryInterface(SlangUUID const& uuid, void** outObject) override;
 
     virtual SLANG_NO_THROW Result SLANG_MCALL synchronizeAndReset() override;
@@ -4,12 +4,85 @@
 #include "simple-transient-resource-heap.h"
 
 #include "core/common.h"
-#include "core/short_vector.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace rhi {
 
 namespace {
 
+/// Root shader objects no longer referenced by any command buffer, kept per program.
+/// Objects are reset in place when they are returned, so `bindPipeline` does not allocate a new object tree.
+class RootShaderObjectPool : public RefObject
+{
+public:
+    struct Item
+    {
+        ShaderProgram* program;
+        RefPtr<ShaderObjectBase> object;
+    };
+
+    Result acquire(
+        ImmediateDevice* device,
+        ShaderProgram* program,
+        RefPtr<ShaderObjectBase>& outObject,
+        bool& outCreated
+    )
+    {
+        outCreated = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_freeObjects.find(program);
+            if (it != m_freeObjects.end() && !it->second.objects.empty())
+            {
+                outObject = std::move(it->second.objects.back());
+                it->second.objects.pop_back();
+                return SLANG_OK;
+            }
+        }
+        // Creating an object may build its layout through the Slang session shared by all recording threads.
+        std::lock_guard<std::recursive_mutex> lock(device->m_slangMutex);
+        SLANG_RETURN_ON_FAIL(device->createRootShaderObject(program, outObject.writeRef()));
+        outCreated = true;
+        return SLANG_OK;
+    }
+
+    /// Return objects acquired from the pool. Objects that cannot be reset are released.
+    void release(ImmediateDevice* device, std::vector<Item>& items)
+    {
+        for (Item& item : items)
+        {
+            if (SLANG_FAILED(device->resetRootShaderObject(item.object)))
+                item.object = nullptr;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Item& item : items)
+        {
+            if (!item.object)
+                continue;
+            FreeList& freeList = m_freeObjects[item.program];
+            freeList.program = item.program;
+            freeList.objects.push_back(std::move(item.object));
+        }
+        items.clear();
+    }
+
+private:
+    struct FreeList
+    {
+        // Keeps the program alive while it is used as a key.
+        RefPtr<ShaderProgram> program;
+        std::vector<RefPtr<ShaderObjectBase>> objects;
+    };
+
+    std::mutex m_mutex;
+    std::unordered_map<ShaderProgram*, FreeList> m_freeObjects;
+};
+
 class CommandBufferImpl : public ICommandBuffer, public ComObject
 {
 public:
@@ -27,14 +100,55 @@ public:
     RefPtr<ImmediateDevice> m_device;
     RefPtr<ShaderObjectBase> m_rootShaderObject;
     TransientResourceHeap* m_transientHeap;
+    /// Reusable command buffers keep their commands after execution, so they can be submitted again.
+    bool m_reusable = false;
+    bool m_closed = false;
+    RefPtr<RootShaderObjectPool> m_rootObjectPool;
+    /// Root objects referenced by the recorded commands, returned to the pool once they are no longer executed.
+    std::vector<RootShaderObjectPool::Item> m_rootObjects;
+    /// Root objects created since the last reset because the pool had none to recycle.
+    uint64_t m_createdRootObjectCount = 0;
+
+    ~CommandBufferImpl()
+    {
+        if (m_rootObjectPool)
+            m_rootObjectPool->release(m_device, m_rootObjects);
+    }
+
+    void init(ImmediateDevice* device, TransientResourceHeap* transientHeap, ITransientResourceHeap::Flags::Enum flags);
 
-    void init(ImmediateDevice* device, TransientResourceHeap* transientHeap)
+    void reset()
     {
-        m_device = device;
-        m_transientHeap = transientHeap;
+        m_rootShaderObject = nullptr;
+        m_rootObjectPool->release(m_device, m_rootObjects);
+        m_createdRootObjectCount = 0;
+        m_writer.clear();
     }
 
-    void reset() { m_writer.clear(); }
+    /// Make a root object for the program of `pipeline` the current root object.
+    Result acquireRootShaderObject(IPipeline* pipeline)
+    {
+        ShaderProgram* program = checked_cast<Pipeline*>(pipeline)->m_program;
+        bool created = false;
+        SLANG_RETURN_ON_FAIL(m_rootObjectPool->acquire(m_device, program, m_rootShaderObject, created));
+        m_rootObjects.push_back({program, m_rootShaderObject});
+        if (created)
+            m_createdRootObjectCount++;
+        return SLANG_OK;
+    }
+
+    /// Recording into a closed command buffer replaces its commands.
+    void beginRecording()
+    {
+        if (m_closed)
+        {
+            // A reusable command buffer may still be referenced by a pending submission.
+            if (m_reusable)
+                m_device->m_queue->waitForIdle();
+            reset();
+            m_closed = false;
+        }
+    }
 
     class PassEncoderImpl : public IPassEncoder
     {
@@ -136,14 +250,7 @@ public:
             Extents extent
         ) override
         {
-            SLANG_UNUSED(dst);
-            SLANG_UNUSED(dstSubresource);
-            SLANG_UNUSED(dstOffset);
-            SLANG_UNUSED(src);
-            SLANG_UNUSED(srcSubresource);
-            SLANG_UNUSED(srcOffset);
-            SLANG_UNUSED(extent);
-            SLANG_RHI_UNIMPLEMENTED("copyTexture");
+            m_writer->copyTexture(dst, dstSubresource, dstOffset, src, srcSubresource, srcOffset, extent);
         }
 
         virtual SLANG_NO_THROW void SLANG_MCALL uploadTextureData(
@@ -155,20 +262,12 @@ public:
             GfxCount subresourceDataCount
         ) override
         {
-            SLANG_UNUSED(dst);
-            SLANG_UNUSED(subresourceRange);
-            SLANG_UNUSED(offset);
-            SLANG_UNUSED(extend);
-            SLANG_UNUSED(subresourceData);
-            SLANG_UNUSED(subresourceDataCount);
-            SLANG_RHI_UNIMPLEMENTED("uploadTextureData");
+            m_writer->uploadTextureData(dst, subresourceRange, offset, extend, subresourceData, subresourceDataCount);
         }
 
         virtual SLANG_NO_THROW void SLANG_MCALL clearBuffer(IBuffer* buffer, const BufferRange* range) override
         {
-            SLANG_UNUSED(buffer);
-            SLANG_UNUSED(range);
-            SLANG_RHI_UNIMPLEMENTED("clearBuffer");
+            m_writer->clearBuffer(buffer, range);
         }
 
         virtual SLANG_NO_THROW void SLANG_MCALL clearTexture(
@@ -179,23 +278,13 @@ public:
             bool clearStencil
         ) override
         {
-            SLANG_UNUSED(texture);
-            SLANG_UNUSED(clearValue);
-            SLANG_UNUSED(subresourceRange);
-            SLANG_UNUSED(clearDepth);
-            SLANG_UNUSED(clearStencil);
-            SLANG_RHI_UNIMPLEMENTED("clearTexture");
+            m_writer->clearTexture(texture, clearValue, subresourceRange, clearDepth, clearStencil);
         }
 
         virtual SLANG_NO_THROW void SLANG_MCALL
         resolveQuery(IQueryPool* queryPool, GfxIndex index, GfxCount count, IBuffer* buffer, Offset offset) override
         {
-            SLANG_UNUSED(queryPool);
-            SLANG_UNUSED(index);
-            SLANG_UNUSED(count);
-            SLANG_UNUSED(buffer);
-            SLANG_UNUSED(offset);
-            SLANG_RHI_UNIMPLEMENTED("resolveQuery");
+            m_writer->resolveQuery(queryPool, index, count, buffer, offset);
         }
 
         virtual SLANG_NO_THROW void SLANG_MCALL copyTextureToBuffer(
@@ -225,6 +314,7 @@ public:
 
     virtual SLANG_NO_THROW Result SLANG_MCALL beginResourcePass(IResourcePassEncoder** outEncoder) override
     {
+        beginRecording();
         m_resourcePassEncoder.init(this);
         *outEncoder = &m_resourcePassEncoder;
         return SLANG_OK;
@@ -256,11 +346,7 @@ public:
         virtual SLANG_NO_THROW Result SLANG_MCALL bindPipeline(IPipeline* state, IShaderObject** outRootObject) override
         {
             m_writer->setPipeline(state);
-            auto stateImpl = checked_cast<Pipeline*>(state);
-            SLANG_RETURN_ON_FAIL(m_commandBuffer->m_device->createRootShaderObject(
-                stateImpl->m_program,
-                m_commandBuffer->m_rootShaderObject.writeRef()
-            ));
+            SLANG_RETURN_ON_FAIL(m_commandBuffer->acquireRootShaderObject(state));
             *outRootObject = m_commandBuffer->m_rootShaderObject.Ptr();
             return SLANG_OK;
         }
@@ -269,11 +355,7 @@ public:
         bindPipelineWithRootObject(IPipeline* state, IShaderObject* rootObject) override
         {
             m_writer->setPipeline(state);
-            auto stateImpl = checked_cast<Pipeline*>(state);
-            SLANG_RETURN_ON_FAIL(m_commandBuffer->m_device->createRootShaderObject(
-                stateImpl->m_program,
-                m_commandBuffer->m_rootShaderObject.writeRef()
-            ));
+            SLANG_RETURN_ON_FAIL(m_commandBuffer->acquireRootShaderObject(state));
             m_commandBuffer->m_rootShaderObject->copyFrom(rootObject, m_commandBuffer->m_transientHeap);
             return SLANG_OK;
         }
@@ -406,6 +488,7 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL
     beginRenderPass(const RenderPassDesc& desc, IRenderPassEncoder** outEncoder) override
     {
+        beginRecording();
         m_renderPassEncoder.init(this, desc);
         *outEncoder = &m_renderPassEncoder;
         return SLANG_OK;
@@ -431,11 +514,7 @@ public:
         virtual SLANG_NO_THROW Result SLANG_MCALL bindPipeline(IPipeline* state, IShaderObject** outRootObject) override
         {
             m_writer->setPipeline(state);
-            auto stateImpl = checked_cast<Pipeline*>(state);
-            SLANG_RETURN_ON_FAIL(m_commandBuffer->m_device->createRootShaderObject(
-                stateImpl->m_program,
-                m_commandBuffer->m_rootShaderObject.writeRef()
-            ));
+            SLANG_RETURN_ON_FAIL(m_commandBuffer->acquireRootShaderObject(state));
             *outRootObject = m_commandBuffer->m_rootShaderObject.Ptr();
             return SLANG_OK;
         }
@@ -444,11 +523,7 @@ public:
         bindPipelineWithRootObject(IPipeline* state, IShaderObject* rootObject) override
         {
             m_writer->setPipeline(state);
-            auto stateImpl = checked_cast<Pipeline*>(state);
-            SLANG_RETURN_ON_FAIL(m_commandBuffer->m_device->createRootShaderObject(
-                stateImpl->m_program,
-                m_commandBuffer->m_rootShaderObject.writeRef()
-            ));
+            SLANG_RETURN_ON_FAIL(m_commandBuffer->acquireRootShaderObject(state));
             m_commandBuffer->m_rootShaderObject->copyFrom(rootObject, m_commandBuffer->m_transientHeap);
             return SLANG_OK;
         }
@@ -462,25 +537,143 @@ public:
 
         virtual SLANG_NO_THROW Result SLANG_MCALL dispatchComputeIndirect(IBuffer* argBuffer, Offset offset) override
         {
-            SLANG_RHI_UNIMPLEMENTED("ImmediateRenderBase::dispatchComputeIndirect");
+            m_writer->bindRootShaderObject(m_commandBuffer->m_rootShaderObject);
+            m_writer->dispatchComputeIndirect(argBuffer, offset);
+            return SLANG_OK;
         }
     };
 
     ComputePassEncoderImpl m_computePassEncoder;
     virtual SLANG_NO_THROW Result SLANG_MCALL beginComputePass(IComputePassEncoder** outEncoder) override
     {
+        beginRecording();
         m_computePassEncoder.init(this);
         *outEncoder = &m_computePassEncoder;
         return SLANG_OK;
     }
 
+    class RayTracingPassEncoderImpl : public IRayTracingPassEncoder, public PassEncoderImpl
+    {
+    public:
+        SLANG_RHI_FORWARD_PASS_ENCODER_IMPL(PassEncoderImpl)
+        virtual void* getInterface(SlangUUID const& uuid) override
+        {
+            if (uuid == GUID::IID_IRayTracingPassEncoder || uuid == GUID::IID_IPassEncoder ||
+                uuid == ISlangUnknown::getTypeGuid())
+            {
+                return this;
+            }
+            return nullptr;
+        }
+
+    public:
+        virtual SLANG_NO_THROW void SLANG_MCALL end() override {}
+
+        virtual SLANG_NO_THROW void SLANG_MCALL buildAccelerationStructure(
+            const AccelerationStructureBuildDesc& desc,
+            IAccelerationStructure* dst,
+            IAccelerationStructure* src,
+            BufferWithOffset scratchBuffer,
+            GfxCount propertyQueryCount,
+            AccelerationStructureQueryDesc* queryDescs
+        ) override
+        {
+            // Immediate devices build into their own memory, the scratch buffer is not used.
+            SLANG_UNUSED(scratchBuffer);
+            m_writer->buildAccelerationStructure(desc, dst, src, propertyQueryCount, queryDescs);
+        }
+
+        virtual SLANG_NO_THROW void SLANG_MCALL copyAccelerationStructure(
+            IAccelerationStructure* dst,
+            IAccelerationStructure* src,
+            AccelerationStructureCopyMode mode
+        ) override
+        {
+            m_writer->copyAccelerationStructure(dst, src, mode);
+        }
+
+        virtual SLANG_NO_THROW void SLANG_MCALL queryAccelerationStructureProperties(
+            GfxCount accelerationStructureCount,
+            IAccelerationStructure* const* accelerationStructures,
+            GfxCount queryCount,
+            AccelerationStructureQueryDesc* queryDescs
+        ) override
+        {
+            m_writer->queryAccelerationStructureProperties(
+                accelerationStructureCount,
+                accelerationStructures,
+                queryCount,
+                queryDescs
+            );
+        }
+
+        virtual SLANG_NO_THROW void SLANG_MCALL
+        serializeAccelerationStructure(BufferWithOffset dst, IAccelerationStructure* src) override
+        {
+            SLANG_UNUSED(dst);
+            SLANG_UNUSED(src);
+            SLANG_RHI_UNIMPLEMENTED("serializeAccelerationStructure");
+        }
+
+        virtual SLANG_NO_THROW void SLANG_MCALL
+        deserializeAccelerationStructure(IAccelerationStructure* dst, BufferWithOffset src) override
+        {
+            SLANG_UNUSED(dst);
+            SLANG_UNUSED(src);
+            SLANG_RHI_UNIMPLEMENTED("deserializeAccelerationStructure");
+        }
+
+        virtual SLANG_NO_THROW Result SLANG_MCALL bindPipeline(IPipeline* state, IShaderObject** outRootObject) override
+        {
+            SLANG_UNUSED(state);
+            SLANG_UNUSED(outRootObject);
+            return SLANG_E_NOT_AVAILABLE;
+        }
+
+        virtual SLANG_NO_THROW Result SLANG_MCALL
+        bindPipelineWithRootObject(IPipeline* state, IShaderObject* rootObject) override
+        {
+            SLANG_UNUSED(state);
+            SLANG_UNUSED(rootObject);
+            return SLANG_E_NOT_AVAILABLE;
+        }
+
+        virtual SLANG_NO_THROW Result SLANG_MCALL dispatchRays(
+            GfxIndex rayGenShaderIndex,
+            IShaderTable* shaderTable,
+            GfxCount width,
+            GfxCount height,
+            GfxCount depth
+        ) override
+        {
+            SLANG_UNUSED(rayGenShaderIndex);
+            SLANG_UNUSED(shaderTable);
+            SLANG_UNUSED(width);
+            SLANG_UNUSED(height);
+            SLANG_UNUSED(depth);
+            return SLANG_E_NOT_AVAILABLE;
+        }
+    };
+
+    RayTracingPassEncoderImpl m_rayTracingPassEncoder;
     virtual SLANG_NO_THROW Result SLANG_MCALL beginRayTracingPass(IRayTracingPassEncoder** outEncoder) override
     {
-        *outEncoder = nullptr;
+        beginRecording();
+        m_rayTracingPassEncoder.init(this);
+        *outEncoder = &m_rayTracingPassEncoder;
         return SLANG_OK;
     }
 
-    virtual SLANG_NO_THROW void SLANG_MCALL close() override {}
+    virtual SLANG_NO_THROW void SLANG_MCALL close() override
+    {
+        if (!m_closed)
+        {
+            CommandStats stats = m_writer.getStats();
+            stats.createdRootObjectCount = m_createdRootObjectCount;
+            m_device->addCommandStats(stats);
+        }
+        m_closed = true;
+    }
 
     virtual SLANG_NO_THROW Result SLANG_MCALL getNativeHandle(NativeHandle* outHandle) override
     {
@@ -490,152 +683,380 @@ public:
 
     void execute()
     {
-        for (auto& cmd : m_writer.m_commands)
+        for (const CommandSlot* slot : m_writer.getCommands())
         {
-            auto name = cmd.name;
-            switch (name)
+            switch (slot->name)
             {
             case CommandName::SetPipeline:
-                m_device->setPipeline(m_writer.getObject<Pipeline>(cmd.operands[0]));
+                m_device->setPipeline(slot->getArgs<commands::SetPipeline>().pipeline);
                 break;
             case CommandName::BindRootShaderObject:
-                m_device->bindRootShaderObject(m_writer.getObject<ShaderObjectBase>(cmd.operands[0]));
+                m_device->bindRootShaderObject(slot->getArgs<commands::BindRootShaderObject>().object);
                 break;
             case CommandName::BeginRenderPass:
-            {
-                RenderPassDesc desc;
-                if (cmd.operands[0] > 0)
-                {
-                    desc.colorAttachments = m_writer.getData<RenderPassColorAttachment>(cmd.operands[2]);
-                    desc.colorAttachmentCount = cmd.operands[0];
-                }
-                if (cmd.operands[1] > 0)
-                {
-                    desc.depthStencilAttachment = m_writer.getData<RenderPassDepthStencilAttachment>(cmd.operands[3]);
-                }
-                m_device->beginRenderPass(desc);
+                m_device->beginRenderPass(slot->getArgs<commands::BeginRenderPass>().desc);
                 break;
-            }
             case CommandName::EndRenderPass:
                 m_device->endRenderPass();
                 break;
             case CommandName::SetViewports:
-                m_device->setViewports((UInt)cmd.operands[0], m_writer.getData<Viewport>(cmd.operands[1]));
+            {
+                const auto& cmd = slot->getArgs<commands::SetViewports>();
+                m_device->setViewports(cmd.count, cmd.viewports);
                 break;
+            }
             case CommandName::SetScissorRects:
-                m_device->setScissorRects((UInt)cmd.operands[0], m_writer.getData<ScissorRect>(cmd.operands[1]));
+            {
+                const auto& cmd = slot->getArgs<commands::SetScissorRects>();
+                m_device->setScissorRects(cmd.count, cmd.scissors);
                 break;
+            }
             case CommandName::SetVertexBuffers:
             {
-                short_vector<IBuffer*> buffers;
-                for (uint32_t i = 0; i < cmd.operands[1]; i++)
-                {
-                    buffers.push_back(m_writer.getObject<Buffer>(cmd.operands[2] + i));
-                }
-                m_device->setVertexBuffers(
-                    cmd.operands[0],
-                    cmd.operands[1],
-                    buffers.data(),
-                    m_writer.getData<Offset>(cmd.operands[3])
-                );
+                const auto& cmd = slot->getArgs<commands::SetVertexBuffers>();
+                m_device->setVertexBuffers(cmd.startSlot, cmd.slotCount, cmd.buffers, cmd.offsets);
+                break;
             }
-            break;
             case CommandName::SetIndexBuffer:
-                m_device->setIndexBuffer(
-                    m_writer.getObject<Buffer>(cmd.operands[0]),
-                    (IndexFormat)cmd.operands[1],
-                    (UInt)cmd.operands[2]
-                );
+            {
+                const auto& cmd = slot->getArgs<commands::SetIndexBuffer>();
+                m_device->setIndexBuffer(cmd.buffer, cmd.indexFormat, cmd.offset);
                 break;
+            }
             case CommandName::Draw:
-                m_device->draw(cmd.operands[0], cmd.operands[1]);
+            {
+                const auto& cmd = slot->getArgs<commands::Draw>();
+                m_device->draw(cmd.vertexCount, cmd.startVertex);
                 break;
+            }
             case CommandName::DrawIndexed:
-                m_device->drawIndexed(cmd.operands[0], cmd.operands[1], cmd.operands[2]);
+            {
+                const auto& cmd = slot->getArgs<commands::DrawIndexed>();
+                m_device->drawIndexed(cmd.indexCount, cmd.startIndex, cmd.baseVertex);
                 break;
+            }
             case CommandName::DrawInstanced:
-                m_device->drawInstanced(cmd.operands[0], cmd.operands[1], cmd.operands[2], cmd.operands[3]);
+            {
+                const auto& cmd = slot->getArgs<commands::DrawInstanced>();
+                m_device->drawInstanced(cmd.vertexCount, cmd.instanceCount, cmd.startVertex, cmd.startInstanceLocation);
                 break;
+            }
             case CommandName::DrawIndexedInstanced:
+            {
+                const auto& cmd = slot->getArgs<commands::DrawIndexedInstanced>();
                 m_device->drawIndexedInstanced(
-                    cmd.operands[0],
-                    cmd.operands[1],
-                    cmd.operands[2],
-                    cmd.operands[3],
-                    cmd.operands[4]
+                    cmd.indexCount,
+                    cmd.instanceCount,
+                    cmd.startIndexLocation,
+                    cmd.baseVertexLocation,
+                    cmd.startInstanceLocation
                 );
                 break;
+            }
             case CommandName::SetStencilReference:
-                m_device->setStencilReference(cmd.operands[0]);
+                m_device->setStencilReference(slot->getArgs<commands::SetStencilReference>().referenceValue);
                 break;
             case CommandName::DispatchCompute:
-                m_device->dispatchCompute(int(cmd.operands[0]), int(cmd.operands[1]), int(cmd.operands[2]));
+            {
+                const auto& cmd = slot->getArgs<commands::DispatchCompute>();
+                m_device->dispatchCompute(cmd.x, cmd.y, cmd.z);
+                break;
+            }
+            case CommandName::DispatchComputeIndirect:
+            {
+                const auto& cmd = slot->getArgs<commands::DispatchComputeIndirect>();
+                m_device->dispatchComputeIndirect(cmd.argBuffer, cmd.offset);
                 break;
+            }
             case CommandName::UploadBufferData:
-                m_device->uploadBufferData(
-                    m_writer.getObject<Buffer>(cmd.operands[0]),
-                    cmd.operands[1],
-                    cmd.operands[2],
-                    m_writer.getData<uint8_t>(cmd.operands[3])
-                );
+            {
+                const auto& cmd = slot->getArgs<commands::UploadBufferData>();
+                m_device->uploadBufferData(cmd.buffer, cmd.offset, cmd.size, cmd.data);
                 break;
+            }
             case CommandName::CopyBuffer:
-                m_device->copyBuffer(
-                    m_writer.getObject<Buffer>(cmd.operands[0]),
-                    cmd.operands[1],
-                    m_writer.getObject<Buffer>(cmd.operands[2]),
-                    cmd.operands[3],
-                    cmd.operands[4]
+            {
+                const auto& cmd = slot->getArgs<commands::CopyBuffer>();
+                m_device->copyBuffer(cmd.dst, cmd.dstOffset, cmd.src, cmd.srcOffset, cmd.size);
+                break;
+            }
+            case CommandName::CopyTexture:
+            {
+                const auto& cmd = slot->getArgs<commands::CopyTexture>();
+                m_device->copyTexture(
+                    cmd.dst,
+                    cmd.dstSubresource,
+                    cmd.dstOffset,
+                    cmd.src,
+                    cmd.srcSubresource,
+                    cmd.srcOffset,
+                    cmd.extent
+                );
+                break;
+            }
+            case CommandName::UploadTextureData:
+            {
+                const auto& cmd = slot->getArgs<commands::UploadTextureData>();
+                m_device->uploadTextureData(
+                    cmd.dst,
+                    cmd.subresourceRange,
+                    cmd.offset,
+                    cmd.extent,
+                    cmd.subresourceData,
+                    cmd.subresourceDataCount
+                );
+                break;
+            }
+            case CommandName::ClearBuffer:
+            {
+                const auto& cmd = slot->getArgs<commands::ClearBuffer>();
+                m_device->clearBuffer(cmd.buffer, cmd.range);
+                break;
+            }
+            case CommandName::ClearTexture:
+            {
+                const auto& cmd = slot->getArgs<commands::ClearTexture>();
+                m_device->clearTexture(
+                    cmd.texture,
+                    cmd.clearValue,
+                    cmd.subresourceRange,
+                    cmd.clearDepth,
+                    cmd.clearStencil
                 );
                 break;
+            }
+            case CommandName::ResolveQuery:
+            {
+                const auto& cmd = slot->getArgs<commands::ResolveQuery>();
+                m_device->resolveQuery(cmd.queryPool, cmd.index, cmd.count, cmd.buffer, cmd.offset);
+                break;
+            }
             case CommandName::WriteTimestamp:
-                m_device->writeTimestamp(m_writer.getObject<QueryPool>(cmd.operands[0]), (GfxIndex)cmd.operands[1]);
+            {
+                const auto& cmd = slot->getArgs<commands::WriteTimestamp>();
+                m_device->writeTimestamp(cmd.queryPool, cmd.index);
+                break;
+            }
+            case CommandName::BuildAccelerationStructure:
+            {
+                const auto& cmd = slot->getArgs<commands::BuildAccelerationStructure>();
+                m_device->buildAccelerationStructure(
+                    cmd.desc,
+                    cmd.dst,
+                    cmd.src,
+                    cmd.propertyQueryCount,
+                    cmd.queryDescs
+                );
+                break;
+            }
+            case CommandName::CopyAccelerationStructure:
+            {
+                const auto& cmd = slot->getArgs<commands::CopyAccelerationStructure>();
+                m_device->copyAccelerationStructure(cmd.dst, cmd.src, cmd.mode);
                 break;
+            }
+            case CommandName::QueryAccelerationStructureProperties:
+            {
+                const auto& cmd = slot->getArgs<commands::QueryAccelerationStructureProperties>();
+                m_device->queryAccelerationStructureProperties(
+                    cmd.accelerationStructureCount,
+                    cmd.accelerationStructures,
+                    cmd.queryCount,
+                    cmd.queryDescs
+                );
+                break;
+            }
             default:
                 SLANG_RHI_ASSERT_FAILURE("Unknown command");
                 break;
             }
         }
-        m_writer.clear();
+        if (!m_reusable)
+            reset();
     }
 };
 
+// Set on an executor thread that has been detached from its queue because it destroyed the device.
+static thread_local bool t_executorDetached = false;
+
 class CommandQueueImpl : public ImmediateCommandQueueBase
 {
 public:
+    struct Submission
+    {
+        std::vector<RefPtr<CommandBufferImpl>> commandBuffers;
+        ComPtr<IFence> fenceToSignal;
+        uint64_t valueToSignal = 0;
+        std::vector<ComPtr<IFence>> waitFences;
+        std::vector<uint64_t> waitValues;
+    };
+
+    std::thread m_executorThread;
+    std::mutex m_mutex;
+    // Serializes execution when submissions from several threads are executed on the submitting thread.
+    std::mutex m_executeMutex;
+    std::condition_variable m_workCondition;
+    std::condition_variable m_idleCondition;
+    std::deque<Submission> m_pendingSubmissions;
+    bool m_executing = false;
+    bool m_shutdown = false;
+
     CommandQueueImpl(ImmediateDevice* device, QueueType type)
         : ImmediateCommandQueueBase(device, type)
     {
     }
 
-    ~CommandQueueImpl() {}
+    ~CommandQueueImpl() { shutdown(); }
 
-    virtual SLANG_NO_THROW void SLANG_MCALL
-    submit(GfxCount count, ICommandBuffer* const* commandBuffers, IFence* fence, uint64_t valueToSignal) override
+    void execute(Submission& submission)
     {
-        // TODO: implement fence signal.
-        SLANG_RHI_ASSERT(fence == nullptr);
+        std::lock_guard<std::mutex> lock(m_executeMutex);
+        if (!submission.waitFences.empty())
+        {
+            std::vector<IFence*> fences;
+            for (auto& fence : submission.waitFences)
+                fences.push_back(fence.get());
+            Result result = m_device->waitForFences(
+                (GfxCount)fences.size(),
+                fences.data(),
+                submission.waitValues.data(),
+                true,
+                kTimeoutInfinite
+            );
+            // The submitting call has already returned, so the failure can only be reported.
+            if (SLANG_FAILED(result))
+                m_device->handleMessage(
+                    DebugMessageType::Error,
+                    DebugMessageSource::Layer,
+                    "Failed to wait for fences before executing submitted work"
+                );
+        }
 
-        CommandBufferInfo info = {};
-        for (GfxIndex i = 0; i < count; i++)
+        if (!submission.commandBuffers.empty())
         {
-            info.hasWriteTimestamps |=
-                checked_cast<CommandBufferImpl*>(commandBuffers[i])->m_writer.m_hasWriteTimestamps;
+            CommandBufferInfo info = {};
+            for (auto& commandBuffer : submission.commandBuffers)
+                info.hasWriteTimestamps |= commandBuffer->m_writer.m_hasWriteTimestamps;
+            m_device->beginCommandBuffer(info);
+            for (auto& commandBuffer : submission.commandBuffers)
+                commandBuffer->execute();
+            m_device->endCommandBuffer(info);
         }
-        m_device->beginCommandBuffer(info);
-        for (GfxIndex i = 0; i < count; i++)
+
+        if (submission.fenceToSignal)
+            m_device->signalFence(submission.fenceToSignal, submission.valueToSignal);
+    }
+
+    void enqueue(Submission&& submission)
+    {
+        if (!m_device->m_asyncSubmit)
+        {
+            execute(submission);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_executorThread.joinable())
+                m_executorThread = std::thread([this]() { executorMain(); });
+            m_pendingSubmissions.push_back(std::move(submission));
+        }
+        m_workCondition.notify_one();
+    }
+
+    void executorMain()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
         {
-            checked_cast<CommandBufferImpl*>(commandBuffers[i])->execute();
+            m_workCondition.wait(lock, [this]() { return m_shutdown || !m_pendingSubmissions.empty(); });
+            if (m_pendingSubmissions.empty())
+                return;
+            Submission submission = std::move(m_pendingSubmissions.front());
+            m_pendingSubmissions.pop_front();
+            m_executing = true;
+            lock.unlock();
+
+            execute(submission);
+
+            // Release the executed command buffers right away so they do not keep the device alive.
+            // This may release the last reference to the device, whose destruction detaches this thread,
+            // in which case the queue is gone and must not be touched anymore.
+            submission = Submission();
+            if (t_executorDetached)
+                return;
+
+            lock.lock();
+            m_executing = false;
+            if (m_pendingSubmissions.empty())
+                m_idleCondition.notify_all();
         }
-        m_device->endCommandBuffer(info);
     }
 
-    virtual SLANG_NO_THROW void SLANG_MCALL waitOnHost() override { m_device->waitForGpu(); }
+    virtual void waitForIdle() override
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idleCondition.wait(lock, [this]() { return m_pendingSubmissions.empty() && !m_executing; });
+    }
+
+    virtual void shutdown() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_executorThread.joinable())
+                return;
+            m_shutdown = true;
+        }
+        if (std::this_thread::get_id() == m_executorThread.get_id())
+        {
+            // The device is destroyed by the executor releasing an executed submission. Nothing is pending
+            // as pending submissions keep the device alive, so the executor can simply exit.
+            m_executorThread.detach();
+            t_executorDetached = true;
+            return;
+        }
+        // The executor drains all pending submissions before exiting.
+        m_workCondition.notify_one();
+        m_executorThread.join();
+        m_executorThread = std::thread();
+        m_shutdown = false;
+    }
+
+    virtual SLANG_NO_THROW void SLANG_MCALL
+    submit(GfxCount count, ICommandBuffer* const* commandBuffers, IFence* fence, uint64_t valueToSignal) override
+    {
+        Submission submission;
+        for (GfxIndex i = 0; i < count; i++)
+            submission.commandBuffers.push_back(checked_cast<CommandBufferImpl*>(commandBuffers[i]));
+        submission.fenceToSignal = fence;
+        submission.valueToSignal = valueToSignal;
+        enqueue(std::move(submission));
+    }
+
+    virtual SLANG_NO_THROW void SLANG_MCALL waitOnHost() override
+    {
+        waitForIdle();
+        m_device->waitForGpu();
+    }
 
     virtual SLANG_NO_THROW Result SLANG_MCALL
     waitForFenceValuesOnDevice(GfxCount fenceCount, IFence** fences, uint64_t* waitValues) override
     {
-        return SLANG_FAIL;
+        // Without an executor thread the wait would block the submitting thread, which is usually
+        // the one expected to signal the fences.
+        if (!m_device->m_asyncSubmit)
+            return SLANG_E_NOT_AVAILABLE;
+
+        // Command buffers are executed in submission order, so a device side wait
+        // blocks execution of all subsequently submitted work.
+        Submission submission;
+        for (GfxIndex i = 0; i < fenceCount; i++)
+        {
+            submission.waitFences.push_back(ComPtr<IFence>(fences[i]));
+            submission.waitValues.push_back(waitValues[i]);
+        }
+        enqueue(std::move(submission));
+        return SLANG_OK;
     }
 
     virtual SLANG_NO_THROW Result SLANG_MCALL getNativeHandle(NativeHandle* outHandle) override
@@ -644,7 +1065,23 @@ public:
     }
 };
 
-using TransientResourceHeapImpl = SimpleTransientResourceHeap<ImmediateDevice, CommandBufferImpl>;
+class TransientResourceHeapImpl : public SimpleTransientResourceHeap<ImmediateDevice, CommandBufferImpl>
+{
+public:
+    RefPtr<RootShaderObjectPool> m_rootObjectPool = new RootShaderObjectPool();
+};
+
+void CommandBufferImpl::init(
+    ImmediateDevice* device,
+    TransientResourceHeap* transientHeap,
+    ITransientResourceHeap::Flags::Enum flags
+)
+{
+    m_device = device;
+    m_transientHeap = transientHeap;
+    m_reusable = (flags & ITransientResourceHeap::Flags::ReusableCommandBuffers) != 0;
+    m_rootObjectPool = checked_cast<TransientResourceHeapImpl*>(transientHeap)->m_rootObjectPool;
+}
 
 } // namespace
 
@@ -653,6 +1090,17 @@ ImmediateDevice::ImmediateDevice()
     m_queue = new CommandQueueImpl(this, QueueType::Graphics);
 }
 
+Result ImmediateDevice::queryInterface(SlangUUID const& uuid, void** outObject)
+{
+    if (uuid == GUID::IID_IImmediateDevice)
+    {
+        *outObject = static_cast<IImmediateDevice*>(this);
+        addRef();
+        return SLANG_OK;
+    }
+    return Device::queryInterface(uuid, outObject);
+}
+
 Result ImmediateDevice::createTransientResourceHeap(
     const ITransientResourceHeap::Desc& desc,
     ITransientResourceHeap** outHeap
@@ -673,6 +1121,145 @@ Result ImmediateDevice::getQueue(QueueType type, ICommandQueue** outQueue)
     return SLANG_OK;
 }
 
+Result ImmediateDevice::resetRootShaderObject(ShaderObjectBase* object)
+{
+    SLANG_UNUSED(object);
+    return SLANG_E_NOT_AVAILABLE;
+}
+
+void ImmediateDevice::signalFence(IFence* fence, uint64_t value)
+{
+    SLANG_UNUSED(fence);
+    SLANG_UNUSED(value);
+    SLANG_RHI_UNIMPLEMENTED("signalFence");
+}
+
+void ImmediateDevice::buildAccelerationStructure(
+    const AccelerationStructureBuildDesc& desc,
+    IAccelerationStructure* dst,
+    IAccelerationStructure* src,
+    GfxCount propertyQueryCount,
+    AccelerationStructureQueryDesc* queryDescs
+)
+{
+    SLANG_UNUSED(desc);
+    SLANG_UNUSED(dst);
+    SLANG_UNUSED(src);
+    SLANG_UNUSED(propertyQueryCount);
+    SLANG_UNUSED(queryDescs);
+    SLANG_RHI_UNIMPLEMENTED("buildAccelerationStructure");
+}
+
+void ImmediateDevice::copyAccelerationStructure(
+    IAccelerationStructure* dst,
+    IAccelerationStructure* src,
+    AccelerationStructureCopyMode mode
+)
+{
+    SLANG_UNUSED(dst);
+    SLANG_UNUSED(src);
+    SLANG_UNUSED(mode);
+    SLANG_RHI_UNIMPLEMENTED("copyAccelerationStructure");
+}
+
+void ImmediateDevice::queryAccelerationStructureProperties(
+    GfxCount accelerationStructureCount,
+    IAccelerationStructure* const* accelerationStructures,
+    GfxCount queryCount,
+    AccelerationStructureQueryDesc* queryDescs
+)
+{
+    SLANG_UNUSED(accelerationStructureCount);
+    SLANG_UNUSED(accelerationStructures);
+    SLANG_UNUSED(queryCount);
+    SLANG_UNUSED(queryDescs);
+    SLANG_RHI_UNIMPLEMENTED("queryAccelerationStructureProperties");
+}
+
+void ImmediateDevice::dispatchComputeIndirect(IBuffer* argBuffer, Offset offset)
+{
+    SLANG_UNUSED(argBuffer);
+    SLANG_UNUSED(offset);
+    SLANG_RHI_UNIMPLEMENTED("dispatchComputeIndirect");
+}
+
+void ImmediateDevice::copyTexture(
+    ITexture* dst,
+    SubresourceRange dstSubresource,
+    Offset3D dstOffset,
+    ITexture* src,
+    SubresourceRange srcSubresource,
+    Offset3D srcOffset,
+    Extents extent
+)
+{
+    SLANG_UNUSED(dst);
+    SLANG_UNUSED(dstSubresource);
+    SLANG_UNUSED(dstOffset);
+    SLANG_UNUSED(src);
+    SLANG_UNUSED(srcSubresource);
+    SLANG_UNUSED(srcOffset);
+    SLANG_UNUSED(extent);
+    SLANG_RHI_UNIMPLEMENTED("copyTexture");
+}
+
+void ImmediateDevice::uploadTextureData(
+    ITexture* dst,
+    SubresourceRange subresourceRange,
+    Offset3D offset,
+    Extents extent,
+    SubresourceData* subresourceData,
+    GfxCount subresourceDataCount
+)
+{
+    SLANG_UNUSED(dst);
+    SLANG_UNUSED(subresourceRange);
+    SLANG_UNUSED(offset);
+    SLANG_UNUSED(extent);
+    SLANG_UNUSED(subresourceData);
+    SLANG_UNUSED(subresourceDataCount);
+    SLANG_RHI_UNIMPLEMENTED("uploadTextureData");
+}
+
+void ImmediateDevice::clearBuffer(IBuffer* buffer, const BufferRange& range)
+{
+    SLANG_UNUSED(buffer);
+    SLANG_UNUSED(range);
+    SLANG_RHI_UNIMPLEMENTED("clearBuffer");
+}
+
+void ImmediateDevice::clearTexture(
+    ITexture* texture,
+    const ClearValue& clearValue,
+    const SubresourceRange& subresourceRange,
+    bool clearDepth,
+    bool clearStencil
+)
+{
+    SLANG_UNUSED(texture);
+    SLANG_UNUSED(clearValue);
+    SLANG_UNUSED(subresourceRange);
+    SLANG_UNUSED(clearDepth);
+    SLANG_UNUSED(clearStencil);
+    SLANG_RHI_UNIMPLEMENTED("clearTexture");
+}
+
+void ImmediateDevice::resolveQuery(
+    IQueryPool* queryPool,
+    GfxIndex index,
+    GfxCount count,
+    IBuffer* buffer,
+    Offset offset
+)
+{
+    SLANG_UNUSED(queryPool);
+    SLANG_UNUSED(index);
+    SLANG_UNUSED(count);
+    SLANG_UNUSED(buffer);
+    SLANG_UNUSED(offset);
+    SLANG_RHI_UNIMPLEMENTED("resolveQuery");
+}
+
 void ImmediateDevice::uploadBufferData(IBuffer* dst, size_t offset, size_t size, void* data)
 {
     auto buffer = map(dst, MapFlavor::WriteDiscard);
@@ -682,6 +1269,9 @@ void ImmediateDevice::uploadBufferData(IBuffer* dst, size_t offset, size_t size,
 
 Result ImmediateDevice::readBuffer(IBuffer* buffer, size_t offset, size_t size, ISlangBlob** outBlob)
 {
+    // Make sure work writing to the buffer has completed.
+    m_queue->waitForIdle();
+
     auto blob = OwnedBlob::create(size);
     auto content = (uint8_t*)map(buffer, MapFlavor::HostRead);
     if (!content)
@@ -693,4 +1283,24 @@ Result ImmediateDevice::readBuffer(IBuffer* buffer, size_t offset, size_t size,
     return SLANG_OK;
 }
 
+Result ImmediateDevice::getCommandStats(CommandStats* outStats)
+{
+    std::lock_guard<std::mutex> lock(m_commandStatsMutex);
+    *outStats = m_commandStats;
+    return SLANG_OK;
+}
+
+void ImmediateDevice::addCommandStats(const CommandStats& stats)
+{
+    std::lock_guard<std::mutex> lock(m_commandStatsMutex);
+    m_commandStats.recordedCommandCount += stats.recordedCommandCount;
+    m_commandStats.elidedPipelineCount += stats.elidedPipelineCount;
+    m_commandStats.elidedRootObjectCount += stats.elidedRootObjectCount;
+    m_commandStats.elidedViewportsCount += stats.elidedViewportsCount;
+    m_commandStats.elidedScissorRectsCount += stats.elidedScissorRectsCount;
+    m_commandStats.elidedVertexBuffersCount += stats.elidedVertexBuffersCount;
+    m_commandStats.elidedIndexBufferCount += stats.elidedIndexBufferCount;
+    m_commandStats.createdRootObjectCount += stats.createdRootObjectCount;
+}
+
 } // namespace rhi
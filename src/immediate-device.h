@@ -5,6 +5,8 @@
 
 #include "rhi-shared.h"
 
+#include <mutex>
+
 namespace rhi {
 
 enum class MapFlavor
@@ -24,6 +26,13 @@ public:
         : CommandQueue(device, type)
     {
     }
+
+    /// Blocks until all submitted command buffers have been executed.
+    virtual void waitForIdle() = 0;
+
+    /// Drains pending work and stops the executor thread.
+    /// Must be called by the target device before it is destroyed.
+    virtual void shutdown() = 0;
 };
 
 struct CommandBufferInfo
@@ -31,11 +40,18 @@ struct CommandBufferInfo
     bool hasWriteTimestamps;
 };
 
-class ImmediateDevice : public Device
+class ImmediateDevice : public Device, public IImmediateDevice
 {
 public:
+    virtual SLANG_NO_THROW Result SLANG_MCALL queryInterface(SlangUUID const& uuid, void** outObject) override;
+
+    virtual SLANG_NO_THROW uint32_t SLANG_MCALL addRef() override { return Device::addRef(); }
+    virtual SLANG_NO_THROW uint32_t SLANG_MCALL release() override { return Device::release(); }
+
     // Immediate commands to be implemented by each target.
     virtual Result createRootShaderObject(IShaderProgram* program, ShaderObjectBase** outObject) = 0;
+    /// Restore an object made by `createRootShaderObject` to its initial state, so it can be reused.
+    virtual Result resetRootShaderObject(ShaderObjectBase* object);
     virtual void bindRootShaderObject(IShaderObject* rootObject) = 0;
     virtual void setPipeline(IPipeline* state) = 0;
     virtual void beginRenderPass(const RenderPassDesc& desc) = 0;
@@ -74,20 +90,80 @@ public:
     virtual void writeTimestamp(IQueryPool* pool, GfxIndex index) = 0;
     virtual void beginCommandBuffer(const CommandBufferInfo&) {}
     virtual void endCommandBuffer(const CommandBufferInfo&) {}
+    virtual void signalFence(IFence* fence, uint64_t value);
+    virtual void buildAccelerationStructure(
+        const AccelerationStructureBuildDesc& desc,
+        IAccelerationStructure* dst,
+        IAccelerationStructure* src,
+        GfxCount propertyQueryCount,
+        AccelerationStructureQueryDesc* queryDescs
+    );
+    virtual void copyAccelerationStructure(
+        IAccelerationStructure* dst,
+        IAccelerationStructure* src,
+        AccelerationStructureCopyMode mode
+    );
+    virtual void queryAccelerationStructureProperties(
+        GfxCount accelerationStructureCount,
+        IAccelerationStructure* const* accelerationStructures,
+        GfxCount queryCount,
+        AccelerationStructureQueryDesc* queryDescs
+    );
+    /// Dispatch with the `IndirectDispatchArguments` stored at `offset` in `argBuffer` when the command executes.
+    virtual void dispatchComputeIndirect(IBuffer* argBuffer, Offset offset);
+    virtual void copyTexture(
+        ITexture* dst,
+        SubresourceRange dstSubresource,
+        Offset3D dstOffset,
+        ITexture* src,
+        SubresourceRange srcSubresource,
+        Offset3D srcOffset,
+        Extents extent
+    );
+    virtual void uploadTextureData(
+        ITexture* dst,
+        SubresourceRange subresourceRange,
+        Offset3D offset,
+        Extents extent,
+        SubresourceData* subresourceData,
+        GfxCount subresourceDataCount
+    );
+    virtual void clearBuffer(IBuffer* buffer, const BufferRange& range);
+    virtual void clearTexture(
+        ITexture* texture,
+        const ClearValue& clearValue,
+        const SubresourceRange& subresourceRange,
+        bool clearDepth,
+        bool clearStencil
+    );
+    virtual void resolveQuery(IQueryPool* queryPool, GfxIndex index, GfxCount count, IBuffer* buffer, Offset offset);
 
 public:
     RefPtr<ImmediateCommandQueueBase> m_queue;
 
+    // When set, submitted command buffers are executed on a dedicated executor thread
+    // instead of the submitting thread. Targets enable this during initialization.
+    bool m_asyncSubmit = false;
+
     ImmediateDevice();
 
     virtual SLANG_NO_THROW Result SLANG_MCALL getQueue(QueueType type, ICommandQueue** outQueue) override;
     virtual SLANG_NO_THROW Result SLANG_MCALL
     createTransientResourceHeap(const ITransientResourceHeap::Desc& desc, ITransientResourceHeap** outHeap) override;
 
-    void uploadBufferData(IBuffer* dst, Offset offset, Size size, void* data);
+    virtual void uploadBufferData(IBuffer* dst, Offset offset, Size size, void* data);
 
     virtual SLANG_NO_THROW Result SLANG_MCALL
     readBuffer(IBuffer* buffer, Offset offset, Size size, ISlangBlob** outBlob) override;
+
+    virtual SLANG_NO_THROW Result SLANG_MCALL getCommandStats(CommandStats* outStats) override;
+
+    /// Add the statistics of a command buffer when it is closed.
+    void addCommandStats(const CommandStats& stats);
+
+private:
+    std::mutex m_commandStatsMutex;
+    CommandStats m_commandStats;
 };
 
 class ImmediateComputeDeviceBase : public ImmediateDevice
@@ -122,6 +122,10 @@ Result DeviceImpl::createTransientResourceHeap(
 {
     AUTORELEASEPOOL
 
+    // Command buffers cannot be resubmitted.
+    if (desc.flags & ITransientResourceHeap::Flags::ReusableCommandBuffers)
+        return SLANG_E_NOT_AVAILABLE;
+
     RefPtr<TransientResourceHeapImpl> result = new TransientResourceHeapImpl();
     SLANG_RETURN_ON_FAIL(result->init(desc, this));
     returnComPtr(outHeap, result);
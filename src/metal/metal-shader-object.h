@@ -139,6 +139,7 @@ public:
         returnComPtr(outEntryPoint, m_entryPoints[index]);
         return SLANG_OK;
     }
+    virtual ShaderObjectBase* getEntryPointObject(GfxIndex index) override { return m_entryPoints[index]; }
 
     virtual Result collectSpecializationArgs(ExtendedShaderObjectTypeList& args) override;
 
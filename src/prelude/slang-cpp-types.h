@@ -1,6 +1,12 @@
 #ifndef SLANG_PRELUDE_CPP_TYPES_H
 #define SLANG_PRELUDE_CPP_TYPES_H
 
+#include <string.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
 #ifdef SLANG_PRELUDE_NAMESPACE
 namespace SLANG_PRELUDE_NAMESPACE {
 #endif
@@ -27,6 +33,138 @@ typedef Vector<uint32_t, 4> uint4;
 // any special handling around such accesses.
 typedef size_t NonUniformResourceIndex;
 
+// ----------------------------- Atomics -----------------------------------------
+
+// Sequentially consistent atomic operations on plain memory, used by the Interlocked* functions.
+// Dispatches distribute thread groups over multiple threads, so memory written by several groups
+// must only be modified through these.
+
+#if defined(_MSC_VER) && !defined(__clang__)
+// Volatile accesses are not reordered by MSVC, a torn 64 bit load on x86 only costs an extra compare-exchange.
+template<typename T> SLANG_FORCE_INLINE T _slang_atomicLoadRelaxed(T* src) { return *(volatile T*)src; }
+SLANG_FORCE_INLINE uint32_t _slang_atomicCompareExchange(uint32_t* dest, uint32_t compare, uint32_t value) { return uint32_t(_InterlockedCompareExchange((volatile long*)dest, long(value), long(compare))); }
+SLANG_FORCE_INLINE uint64_t _slang_atomicCompareExchange(uint64_t* dest, uint64_t compare, uint64_t value) { return uint64_t(_InterlockedCompareExchange64((volatile __int64*)dest, __int64(value), __int64(compare))); }
+SLANG_FORCE_INLINE uint32_t _slang_atomicExchange(uint32_t* dest, uint32_t value) { return uint32_t(_InterlockedExchange((volatile long*)dest, long(value))); }
+SLANG_FORCE_INLINE uint64_t _slang_atomicExchange(uint64_t* dest, uint64_t value) { return uint64_t(_InterlockedExchange64((volatile __int64*)dest, __int64(value))); }
+SLANG_FORCE_INLINE uint32_t _slang_atomicFetchAdd(uint32_t* dest, uint32_t value) { return uint32_t(_InterlockedExchangeAdd((volatile long*)dest, long(value))); }
+SLANG_FORCE_INLINE uint64_t _slang_atomicFetchAdd(uint64_t* dest, uint64_t value) { return uint64_t(_InterlockedExchangeAdd64((volatile __int64*)dest, __int64(value))); }
+SLANG_FORCE_INLINE uint32_t _slang_atomicFetchAnd(uint32_t* dest, uint32_t value) { return uint32_t(_InterlockedAnd((volatile long*)dest, long(value))); }
+SLANG_FORCE_INLINE uint64_t _slang_atomicFetchAnd(uint64_t* dest, uint64_t value) { return uint64_t(_InterlockedAnd64((volatile __int64*)dest, __int64(value))); }
+SLANG_FORCE_INLINE uint32_t _slang_atomicFetchOr(uint32_t* dest, uint32_t value) { return uint32_t(_InterlockedOr((volatile long*)dest, long(value))); }
+SLANG_FORCE_INLINE uint64_t _slang_atomicFetchOr(uint64_t* dest, uint64_t value) { return uint64_t(_InterlockedOr64((volatile __int64*)dest, __int64(value))); }
+SLANG_FORCE_INLINE uint32_t _slang_atomicFetchXor(uint32_t* dest, uint32_t value) { return uint32_t(_InterlockedXor((volatile long*)dest, long(value))); }
+SLANG_FORCE_INLINE uint64_t _slang_atomicFetchXor(uint64_t* dest, uint64_t value) { return uint64_t(_InterlockedXor64((volatile __int64*)dest, __int64(value))); }
+#else
+template<typename T> SLANG_FORCE_INLINE T _slang_atomicLoadRelaxed(T* src) { return __atomic_load_n(src, __ATOMIC_RELAXED); }
+template<typename T>
+SLANG_FORCE_INLINE T _slang_atomicCompareExchange(T* dest, T compare, T value)
+{
+    __atomic_compare_exchange_n(dest, &compare, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return compare;
+}
+template<typename T> SLANG_FORCE_INLINE T _slang_atomicExchange(T* dest, T value) { return __atomic_exchange_n(dest, value, __ATOMIC_SEQ_CST); }
+template<typename T> SLANG_FORCE_INLINE T _slang_atomicFetchAdd(T* dest, T value) { return __atomic_fetch_add(dest, value, __ATOMIC_SEQ_CST); }
+template<typename T> SLANG_FORCE_INLINE T _slang_atomicFetchAnd(T* dest, T value) { return __atomic_fetch_and(dest, value, __ATOMIC_SEQ_CST); }
+template<typename T> SLANG_FORCE_INLINE T _slang_atomicFetchOr(T* dest, T value) { return __atomic_fetch_or(dest, value, __ATOMIC_SEQ_CST); }
+template<typename T> SLANG_FORCE_INLINE T _slang_atomicFetchXor(T* dest, T value) { return __atomic_fetch_xor(dest, value, __ATOMIC_SEQ_CST); }
+#endif
+
+// Maps a 32 or 64 bit type to the unsigned integer the atomic primitives operate on.
+template<int SIZE> struct _SlangAtomicBits;
+template<> struct _SlangAtomicBits<4> { typedef uint32_t Type; };
+template<> struct _SlangAtomicBits<8> { typedef uint64_t Type; };
+
+template<typename T>
+SLANG_FORCE_INLINE typename _SlangAtomicBits<sizeof(T)>::Type* _slang_atomicBitsPtr(T* dest)
+{
+    return reinterpret_cast<typename _SlangAtomicBits<sizeof(T)>::Type*>(dest);
+}
+
+template<typename T>
+SLANG_FORCE_INLINE T _slang_atomicFromBits(typename _SlangAtomicBits<sizeof(T)>::Type bits)
+{
+    T value;
+    memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+template<typename T>
+SLANG_FORCE_INLINE typename _SlangAtomicBits<sizeof(T)>::Type _slang_atomicToBits(T value)
+{
+    typename _SlangAtomicBits<sizeof(T)>::Type bits;
+    memcpy(&bits, &value, sizeof(T));
+    return bits;
+}
+
+// Applies `op` with a compare-exchange loop, for operations without a native primitive (min, max, float add).
+template<typename T, typename F>
+SLANG_FORCE_INLINE T _slang_atomicUpdate(T* dest, F op)
+{
+    auto bits = _slang_atomicBitsPtr(dest);
+    auto expected = _slang_atomicLoadRelaxed(bits);
+    while (true)
+    {
+        auto desired = _slang_atomicToBits(op(_slang_atomicFromBits<T>(expected)));
+        auto observed = _slang_atomicCompareExchange(bits, expected, desired);
+        if (observed == expected)
+            return _slang_atomicFromBits<T>(expected);
+        expected = observed;
+    }
+}
+
+// Integer add, and, or and xor have native primitives, signed values share the two's complement bits.
+#define SLANG_ATOMIC_INTEGER_OP(NAME, PRIMITIVE) \
+    template<typename T> \
+    SLANG_FORCE_INLINE T NAME(T* dest, T value) \
+    { \
+        return _slang_atomicFromBits<T>(PRIMITIVE(_slang_atomicBitsPtr(dest), _slang_atomicToBits(value))); \
+    }
+SLANG_ATOMIC_INTEGER_OP(_slang_atomicAddInteger, _slang_atomicFetchAdd)
+SLANG_ATOMIC_INTEGER_OP(_slang_atomicAnd, _slang_atomicFetchAnd)
+SLANG_ATOMIC_INTEGER_OP(_slang_atomicOr, _slang_atomicFetchOr)
+SLANG_ATOMIC_INTEGER_OP(_slang_atomicXor, _slang_atomicFetchXor)
+SLANG_ATOMIC_INTEGER_OP(_slang_atomicExchangeValue, _slang_atomicExchange)
+#undef SLANG_ATOMIC_INTEGER_OP
+
+SLANG_FORCE_INLINE int32_t _slang_atomicAdd(int32_t* dest, int32_t value) { return _slang_atomicAddInteger(dest, value); }
+SLANG_FORCE_INLINE uint32_t _slang_atomicAdd(uint32_t* dest, uint32_t value) { return _slang_atomicAddInteger(dest, value); }
+SLANG_FORCE_INLINE int64_t _slang_atomicAdd(int64_t* dest, int64_t value) { return _slang_atomicAddInteger(dest, value); }
+SLANG_FORCE_INLINE uint64_t _slang_atomicAdd(uint64_t* dest, uint64_t value) { return _slang_atomicAddInteger(dest, value); }
+SLANG_FORCE_INLINE float _slang_atomicAdd(float* dest, float value) { return _slang_atomicUpdate(dest, [value](float v) { return v + value; }); }
+SLANG_FORCE_INLINE double _slang_atomicAdd(double* dest, double value) { return _slang_atomicUpdate(dest, [value](double v) { return v + value; }); }
+
+template<typename T>
+SLANG_FORCE_INLINE T _slang_atomicMin(T* dest, T value) { return _slang_atomicUpdate(dest, [value](T v) { return value < v ? value : v; }); }
+template<typename T>
+SLANG_FORCE_INLINE T _slang_atomicMax(T* dest, T value) { return _slang_atomicUpdate(dest, [value](T v) { return v < value ? value : v; }); }
+
+template<typename T>
+SLANG_FORCE_INLINE T _slang_atomicCompareExchangeValue(T* dest, T compare, T value)
+{
+    return _slang_atomicFromBits<T>(_slang_atomicCompareExchange(_slang_atomicBitsPtr(dest), _slang_atomicToBits(compare), _slang_atomicToBits(value)));
+}
+
+// HLSL Interlocked* functions on memory locations, e.g. elements of a RWStructuredBuffer or groupshared variables.
+// The original value is optionally returned through `outOriginalValue`.
+
+#define SLANG_INTERLOCKED_OP(NAME, IMPL) \
+    template<typename T> SLANG_FORCE_INLINE void NAME(T& dest, T value) { IMPL(&dest, value); } \
+    template<typename T> SLANG_FORCE_INLINE void NAME(T& dest, T value, T* outOriginalValue) { *outOriginalValue = IMPL(&dest, value); }
+SLANG_INTERLOCKED_OP(InterlockedAdd, _slang_atomicAdd)
+SLANG_INTERLOCKED_OP(InterlockedMin, _slang_atomicMin)
+SLANG_INTERLOCKED_OP(InterlockedMax, _slang_atomicMax)
+SLANG_INTERLOCKED_OP(InterlockedAnd, _slang_atomicAnd)
+SLANG_INTERLOCKED_OP(InterlockedOr, _slang_atomicOr)
+SLANG_INTERLOCKED_OP(InterlockedXor, _slang_atomicXor)
+#undef SLANG_INTERLOCKED_OP
+
+template<typename T>
+SLANG_FORCE_INLINE void InterlockedExchange(T& dest, T value, T* outOriginalValue) { *outOriginalValue = _slang_atomicExchangeValue(&dest, value); }
+template<typename T>
+SLANG_FORCE_INLINE void InterlockedCompareExchange(T& dest, T compare, T value, T* outOriginalValue) { *outOriginalValue = _slang_atomicCompareExchangeValue(&dest, compare, value); }
+template<typename T>
+SLANG_FORCE_INLINE void InterlockedCompareStore(T& dest, T compare, T value) { _slang_atomicCompareExchangeValue(&dest, compare, value); }
+
 // ----------------------------- ResourceType -----------------------------------------
 
 // https://docs.microsoft.com/en-us/windows/win32/direct3dhlsl/sm5-object-structuredbuffer-getdimensions
@@ -54,6 +192,42 @@ struct StructuredBuffer
     size_t count;
 };
 
+// Append and consume buffers are bound with a counter buffer, `counter` points to its first uint.
+// Append increments the counter and writes the element at the previous count, Consume decrements it
+// and reads the element at the new count. The counter is shared by all threads of a dispatch.
+
+template <typename T>
+struct AppendStructuredBuffer
+{
+    void Append(const T& value) const
+    {
+        size_t index = _slang_atomicAdd(counter, 1u);
+        SLANG_BOUND_CHECK(index, count);
+        data[index] = value;
+    }
+    void GetDimensions(uint32_t* outNumStructs, uint32_t* outStride) { *outNumStructs = uint32_t(count); *outStride = uint32_t(sizeof(T)); }
+
+    T* data;
+    size_t count;
+    uint32_t* counter;
+};
+
+template <typename T>
+struct ConsumeStructuredBuffer
+{
+    T Consume() const
+    {
+        size_t index = _slang_atomicAdd(counter, ~0u) - 1u;
+        SLANG_BOUND_CHECK(index, count);
+        return data[index];
+    }
+    void GetDimensions(uint32_t* outNumStructs, uint32_t* outStride) { *outNumStructs = uint32_t(count); *outStride = uint32_t(sizeof(T)); }
+
+    T* data;
+    size_t count;
+    uint32_t* counter;
+};
+
 
 template <typename T>
 struct RWBuffer
@@ -116,7 +290,6 @@ struct ByteAddressBuffer
 };
 
 // https://docs.microsoft.com/en-us/windows/win32/direct3dhlsl/sm5-object-rwbyteaddressbuffer
-// Missing support for Atomic operations
 // Missing support for Load with status
 struct RWByteAddressBuffer
 {
@@ -188,6 +361,48 @@ struct RWByteAddressBuffer
         *(T*)(((char*)data) + index) = value;
     }
 
+    // Atomic operations, `index` is a byte offset aligned to the size of the operand.
+    // The 32 bit variants take uint or int operands, the 64 bit variants uint64_t or int64_t.
+#define SLANG_BYTE_ADDRESS_ATOMIC_OP(NAME, IMPL) \
+    template<typename T> void NAME(size_t index, T value) const { IMPL(_atomicPtr<T>(index), value); } \
+    template<typename T> void NAME(size_t index, T value, T* outOriginalValue) const { *outOriginalValue = IMPL(_atomicPtr<T>(index), value); }
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedAdd, _slang_atomicAdd)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedMin, _slang_atomicMin)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedMax, _slang_atomicMax)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedAnd, _slang_atomicAnd)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedOr, _slang_atomicOr)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedXor, _slang_atomicXor)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedAdd64, _slang_atomicAdd)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedMin64, _slang_atomicMin)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedMax64, _slang_atomicMax)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedAnd64, _slang_atomicAnd)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedOr64, _slang_atomicOr)
+    SLANG_BYTE_ADDRESS_ATOMIC_OP(InterlockedXor64, _slang_atomicXor)
+#undef SLANG_BYTE_ADDRESS_ATOMIC_OP
+
+    void InterlockedAddF32(size_t index, float value) const { _slang_atomicAdd(_atomicPtr<float>(index), value); }
+    void InterlockedAddF32(size_t index, float value, float* outOriginalValue) const { *outOriginalValue = _slang_atomicAdd(_atomicPtr<float>(index), value); }
+
+    template<typename T>
+    void InterlockedExchange(size_t index, T value, T* outOriginalValue) const { *outOriginalValue = _slang_atomicExchangeValue(_atomicPtr<T>(index), value); }
+    template<typename T>
+    void InterlockedExchange64(size_t index, T value, T* outOriginalValue) const { InterlockedExchange(index, value, outOriginalValue); }
+    template<typename T>
+    void InterlockedCompareExchange(size_t index, T compare, T value, T* outOriginalValue) const { *outOriginalValue = _slang_atomicCompareExchangeValue(_atomicPtr<T>(index), compare, value); }
+    template<typename T>
+    void InterlockedCompareExchange64(size_t index, T compare, T value, T* outOriginalValue) const { InterlockedCompareExchange(index, compare, value, outOriginalValue); }
+    template<typename T>
+    void InterlockedCompareStore(size_t index, T compare, T value) const { _slang_atomicCompareExchangeValue(_atomicPtr<T>(index), compare, value); }
+    template<typename T>
+    void InterlockedCompareStore64(size_t index, T compare, T value) const { InterlockedCompareStore(index, compare, value); }
+
+    template<typename T>
+    T* _atomicPtr(size_t index) const
+    {
+        SLANG_BOUND_CHECK_BYTE_ADDRESS(index, sizeof(T), sizeInBytes);
+        return (T*)(((char*)data) + index);
+    }
+
     uint32_t* data;
     size_t sizeInBytes; //< Must be multiple of 4
 };
@@ -923,6 +1138,66 @@ struct FeedbackTexture2DArray
     IFeedbackTexture* texture;
 };
 
+// ----------------------------- Ray tracing -----------------------------------------
+
+enum RAY_FLAG : uint32_t
+{
+    RAY_FLAG_NONE = 0x00,
+    RAY_FLAG_FORCE_OPAQUE = 0x01,
+    RAY_FLAG_FORCE_NON_OPAQUE = 0x02,
+    RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH = 0x04,
+    RAY_FLAG_SKIP_CLOSEST_HIT_SHADER = 0x08,
+    RAY_FLAG_CULL_BACK_FACING_TRIANGLES = 0x10,
+    RAY_FLAG_CULL_FRONT_FACING_TRIANGLES = 0x20,
+    RAY_FLAG_CULL_OPAQUE = 0x40,
+    RAY_FLAG_CULL_NON_OPAQUE = 0x80,
+    RAY_FLAG_SKIP_TRIANGLES = 0x100,
+    RAY_FLAG_SKIP_PROCEDURAL_PRIMITIVES = 0x200,
+};
+
+enum
+{
+    HIT_KIND_TRIANGLE_FRONT_FACE = 0xFE,
+    HIT_KIND_TRIANGLE_BACK_FACE = 0xFF,
+};
+
+struct RayDesc
+{
+    float3 Origin;
+    float TMin;
+    float3 Direction;
+    float TMax;
+};
+
+// Closest (or first accepted) intersection found by a ray traversal.
+struct RayHit
+{
+    float t;
+    float2 barycentrics;
+    uint32_t hitKind;
+    uint32_t instanceIndex;
+    uint32_t instanceID;
+    uint32_t instanceContributionToHitGroupIndex;
+    uint32_t geometryIndex;
+    uint32_t primitiveIndex;
+    float objectToWorld[3][4];
+    float worldToObject[3][4];
+    float3 objectRayOrigin;
+    float3 objectRayDirection;
+};
+
+// Any-hit and intersection shaders are not invoked by the traversal. Non-opaque triangles are
+// accepted like opaque ones and procedural primitives are hit where the ray enters their bounds.
+struct IRaytracingAccelerationStructure
+{
+    virtual bool TraceRay(const RayDesc& ray, uint32_t rayFlags, uint32_t instanceInclusionMask, RayHit* outHit) = 0;
+};
+
+struct RaytracingAccelerationStructure
+{
+    IRaytracingAccelerationStructure* accelerationStructure;
+};
+
 /* Varying input for Compute */
 
 /* Used when running a single thread */
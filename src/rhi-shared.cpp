@@ -28,6 +28,8 @@ const Guid GUID::IID_IBuffer = IBuffer::getTypeGuid();
 const Guid GUID::IID_ITexture = ITexture::getTypeGuid();
 const Guid GUID::IID_ITextureView = ITextureView::getTypeGuid();
 const Guid GUID::IID_IDevice = IDevice::getTypeGuid();
+const Guid GUID::IID_IImmediateDevice = IImmediateDevice::getTypeGuid();
+const Guid GUID::IID_ICPUDevice = ICPUDevice::getTypeGuid();
 const Guid GUID::IID_IPersistentShaderCache = IPersistentShaderCache::getTypeGuid();
 const Guid GUID::IID_IShaderObject = IShaderObject::getTypeGuid();
 
@@ -455,8 +457,14 @@ Result Device::getEntryPointCodeFromShaderCache(
 
 Result Device::queryInterface(SlangUUID const& uuid, void** outObject)
 {
-    *outObject = getInterface(uuid);
-    return SLANG_OK;
+    void* intf = getInterface(uuid);
+    if (intf)
+    {
+        addRef();
+        *outObject = intf;
+        return SLANG_OK;
+    }
+    return SLANG_E_NO_INTERFACE;
 }
 
 IDevice* Device::getInterface(const Guid& guid)
@@ -634,6 +642,7 @@ Result Device::createShaderObject2(
     IShaderObject** outObject
 )
 {
+    std::lock_guard<std::recursive_mutex> lock(m_slangMutex);
     RefPtr<ShaderObjectLayout> shaderObjectLayout;
     SLANG_RETURN_ON_FAIL(getShaderObjectLayout(slangSession, type, container, shaderObjectLayout.writeRef()));
     return createShaderObject(shaderObjectLayout, outObject);
@@ -655,6 +664,7 @@ Result Device::createMutableShaderObject2(
     IShaderObject** outObject
 )
 {
+    std::lock_guard<std::recursive_mutex> lock(m_slangMutex);
     RefPtr<ShaderObjectLayout> shaderObjectLayout;
     SLANG_RETURN_ON_FAIL(getShaderObjectLayout(slangSession, type, containerType, shaderObjectLayout.writeRef()));
     return createMutableShaderObject(shaderObjectLayout, outObject);
@@ -662,6 +672,7 @@ Result Device::createMutableShaderObject2(
 
 Result Device::createShaderObjectFromTypeLayout(slang::TypeLayoutReflection* typeLayout, IShaderObject** outObject)
 {
+    std::lock_guard<std::recursive_mutex> lock(m_slangMutex);
     RefPtr<ShaderObjectLayout> shaderObjectLayout;
     SLANG_RETURN_ON_FAIL(getShaderObjectLayout(slangContext.session, typeLayout, shaderObjectLayout.writeRef()));
     return createShaderObject(shaderObjectLayout, outObject);
@@ -672,6 +683,7 @@ Result Device::createMutableShaderObjectFromTypeLayout(
     IShaderObject** outObject
 )
 {
+    std::lock_guard<std::recursive_mutex> lock(m_slangMutex);
     RefPtr<ShaderObjectLayout> shaderObjectLayout;
     SLANG_RETURN_ON_FAIL(getShaderObjectLayout(slangContext.session, typeLayout, shaderObjectLayout.writeRef()));
     return createMutableShaderObject(shaderObjectLayout, outObject);
@@ -762,6 +774,7 @@ Result Device::getShaderObjectLayout(
     ShaderObjectLayout** outLayout
 )
 {
+    std::lock_guard<std::recursive_mutex> lock(m_slangMutex);
     switch (container)
     {
     case ShaderObjectContainerType::StructuredBuffer:
@@ -786,6 +799,7 @@ Result Device::getShaderObjectLayout(
     ShaderObjectLayout** outLayout
 )
 {
+    std::lock_guard<std::recursive_mutex> lock(m_slangMutex);
     RefPtr<ShaderObjectLayout> shaderObjectLayout;
     auto it = m_shaderObjectLayoutCache.find(typeLayout);
     if (it != m_shaderObjectLayoutCache.end())
@@ -852,6 +866,7 @@ ShaderComponentID ShaderCache::getComponentId(std::string_view name)
 
 ShaderComponentID ShaderCache::getComponentId(ComponentKey key)
 {
+    std::lock_guard<std::mutex> lock(componentIdsMutex);
     auto it = componentIds.find(key);
     if (it != componentIds.end())
         return it->second;
@@ -865,6 +880,38 @@ void ShaderCache::addSpecializedPipeline(PipelineKey key, RefPtr<Pipeline> speci
     specializedPipelines[key] = specializedPipeline;
 }
 
+// Whether a shader object of the given element type can contribute specialization arguments, i.e. whether
+// `collectSpecializationArgs` can return anything for it.
+static bool _mayHaveSpecializationArgs(slang::TypeLayoutReflection* typeLayout)
+{
+    if (typeLayout->getKind() == slang::TypeReflection::Kind::Interface)
+        return true;
+    for (SlangInt r = 0; r < typeLayout->getBindingRangeCount(); r++)
+    {
+        switch (typeLayout->getBindingRangeType(r))
+        {
+        case slang::BindingType::ExistentialValue:
+            return true;
+        case slang::BindingType::ParameterBlock:
+        case slang::BindingType::ConstantBuffer:
+        case slang::BindingType::RawBuffer:
+        case slang::BindingType::MutableRawBuffer:
+        {
+            if (typeLayout->isBindingRangeSpecializable(r))
+                return true;
+            auto leafTypeLayout = typeLayout->getBindingRangeLeafTypeLayout(r);
+            auto subElementTypeLayout = leafTypeLayout ? leafTypeLayout->getElementTypeLayout() : nullptr;
+            if (subElementTypeLayout && _mayHaveSpecializationArgs(subElementTypeLayout))
+                return true;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return false;
+}
+
 void ShaderObjectLayout::initBase(
     Device* device,
     slang::ISession* session,
@@ -875,6 +922,50 @@ void ShaderObjectLayout::initBase(
     m_slangSession = session;
     m_elementTypeLayout = elementTypeLayout;
     m_componentID = m_device->shaderCache.getComponentId(m_elementTypeLayout->getType());
+    m_mayHaveSpecializationArgs = _mayHaveSpecializationArgs(m_elementTypeLayout);
+}
+
+void ShaderObjectBase::markSpecializationDirty()
+{
+    static std::atomic<uint64_t> lastVersion = 0;
+    std::lock_guard<std::recursive_mutex> lock(getDevice()->m_slangMutex);
+    propagateSpecializationVersion(++lastVersion);
+}
+
+void ShaderObjectBase::propagateSpecializationVersion(uint64_t version)
+{
+    // An object bound several times into the same parent links to it once per binding.
+    if (m_specializationVersion == version)
+        return;
+    m_specializationVersion = version;
+    for (ShaderObjectBase* parent : m_specializationParents)
+        parent->propagateSpecializationVersion(version);
+}
+
+void ShaderObjectBase::relinkSpecializationParent(ShaderObjectBase* oldObject, ShaderObjectBase* newObject)
+{
+    std::lock_guard<std::recursive_mutex> lock(getDevice()->m_slangMutex);
+    if (newObject)
+        newObject->m_specializationParents.push_back(this);
+    if (oldObject)
+    {
+        auto& parents = oldObject->m_specializationParents;
+        auto it = std::find(parents.begin(), parents.end(), this);
+        if (it != parents.end())
+            parents.erase(it);
+    }
+}
+
+uint64_t ShaderObjectBase::getSpecializationSignature()
+{
+    uint64_t signature = m_specializationVersion;
+    GfxCount entryPointCount = getEntryPointCount();
+    for (GfxIndex i = 0; i < entryPointCount; i++)
+    {
+        if (ShaderObjectBase* entryPoint = getEntryPointObject(i))
+            signature = std::max(signature, entryPoint->m_specializationVersion);
+    }
+    return signature;
 }
 
 // Get the final type this shader object represents. If the shader object's type has existential fields,
@@ -886,8 +977,13 @@ Result ShaderObjectBase::getSpecializedShaderObjectType(ExtendedShaderObjectType
 
 Result ShaderObjectBase::_getSpecializedShaderObjectType(ExtendedShaderObjectType* outType)
 {
-    if (shaderObjectType.slangType)
+    uint64_t version = m_specializationVersion;
+    if (shaderObjectType.slangType && m_specializedTypeVersion == version)
+    {
         *outType = shaderObjectType;
+        return SLANG_OK;
+    }
+    std::lock_guard<std::recursive_mutex> lock(getDevice()->m_slangMutex);
     ExtendedShaderObjectTypeList specializationArgs;
     SLANG_RETURN_ON_FAIL(collectSpecializationArgs(specializationArgs));
     if (specializationArgs.getCount() == 0)
@@ -904,6 +1000,7 @@ Result ShaderObjectBase::_getSpecializedShaderObjectType(ExtendedShaderObjectTyp
         );
         shaderObjectType.componentID = getDevice()->shaderCache.getComponentId(shaderObjectType.slangType);
     }
+    m_specializedTypeVersion = version;
     *outType = shaderObjectType;
     return SLANG_OK;
 }
@@ -1106,11 +1203,24 @@ Result Device::maybeSpecializePipeline(
 {
     outNewPipeline = currentPipeline;
 
+    // Specialization compiles through the Slang session, which may run on a queue's executor thread
+    // while the host thread keeps creating shader objects.
+    std::lock_guard<std::recursive_mutex> lock(m_slangMutex);
+
     if (currentPipeline->m_unspecializedPipeline)
         currentPipeline = currentPipeline->m_unspecializedPipeline;
     // If the currently bound pipeline is specializable, we need to specialize it based on bound shader objects.
     if (currentPipeline->m_isSpecializable)
     {
+        // Reuse the pipeline specialized for this root object if no specialization argument changed since.
+        uint64_t signature = rootObject->getSpecializationSignature();
+        if (rootObject->m_specializedPipeline && rootObject->m_specializedPipelineSignature == signature &&
+            rootObject->m_specializationSourcePipeline.get() == static_cast<IPipeline*>(currentPipeline))
+        {
+            outNewPipeline = rootObject->m_specializedPipeline;
+            return SLANG_OK;
+        }
+
         specializationArgs.clear();
         SLANG_RETURN_ON_FAIL(rootObject->collectSpecializationArgs(specializationArgs));
 
@@ -1170,6 +1280,10 @@ Result Device::maybeSpecializePipeline(
             shaderCache.addSpecializedPipeline(pipelineKey, specializedPipeline);
         }
         outNewPipeline = specializedPipeline;
+
+        rootObject->m_specializationSourcePipeline = currentPipeline;
+        rootObject->m_specializedPipeline = specializedPipeline;
+        rootObject->m_specializedPipelineSignature = signature;
     }
     return SLANG_OK;
 }
@@ -9,8 +9,10 @@
 #include "core/common.h"
 #include "core/short_vector.h"
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -35,6 +37,8 @@ struct GUID
     static const Guid IID_ITextureView;
     static const Guid IID_IInputLayout;
     static const Guid IID_IDevice;
+    static const Guid IID_IImmediateDevice;
+    static const Guid IID_ICPUDevice;
     static const Guid IID_IPersistentShaderCache;
     static const Guid IID_IShaderObjectLayout;
     static const Guid IID_IShaderObject;
@@ -55,6 +59,7 @@ struct GUID
 };
 
 class Device;
+class Pipeline;
 
 // We use a `BreakableReference` to avoid the cyclic reference situation in rhi implementation.
 // It is a common scenario where objects created from an `IDevice` implementation needs to hold
@@ -373,11 +378,17 @@ protected:
     /// `UnsizedArray`, this shader object represents a collection instead of a single object.
     ShaderObjectContainerType m_containerType = ShaderObjectContainerType::None;
 
+    /// Whether objects of this layout can contribute specialization arguments, i.e. whether the element type
+    /// is an interface or has existential or specializable fields, directly or in nested sub-objects.
+    bool m_mayHaveSpecializationArgs = false;
+
 public:
     ComPtr<slang::ISession> m_slangSession;
 
     ShaderObjectContainerType getContainerType() { return m_containerType; }
 
+    bool mayHaveSpecializationArgs() { return m_mayHaveSpecializationArgs; }
+
     static slang::TypeLayoutReflection* _unwrapParameterGroups(
         slang::TypeLayoutReflection* typeLayout,
         ShaderObjectContainerType& outContainerType
@@ -464,6 +475,8 @@ public:
         return nullptr;
     }
 
+    friend class Device;
+
 protected:
     // A strong reference to `IDevice` to make sure the weak device reference in
     // `ShaderObjectLayout`s are valid whenever they might be used.
@@ -475,10 +488,41 @@ protected:
     // The specialized shader object type.
     ExtendedShaderObjectType shaderObjectType = {nullptr, kInvalidComponentID};
 
+    // Specialization version at which `shaderObjectType` was computed.
+    uint64_t m_specializedTypeVersion = 0;
+
+    // Pipeline specialized for this object by `Device::maybeSpecializePipeline`, reused while the
+    // unspecialized pipeline and the specialization signature are unchanged.
+    ComPtr<IPipeline> m_specializationSourcePipeline;
+    RefPtr<Pipeline> m_specializedPipeline;
+    uint64_t m_specializedPipelineSignature = 0;
+
+    // Version of the last change of this object or of its sub-objects that may have changed the collected
+    // specialization arguments. Versions are unique across objects, so the newest version of a set of objects
+    // identifies their state.
+    uint64_t m_specializationVersion = 0;
+
+    // Objects this object is bound into as a sub-object, which collect specialization arguments from it.
+    // Parents hold a strong reference to their sub-objects and remove themselves before releasing it.
+    // A sub-object can be shared between objects recorded on different threads, so the links are only
+    // accessed under the device's `m_slangMutex`.
+    std::vector<ShaderObjectBase*> m_specializationParents;
+
     Result _getSpecializedShaderObjectType(ExtendedShaderObjectType* outType);
     slang::TypeLayoutReflection* _getElementTypeLayout() { return m_layout->getElementTypeLayout(); }
 
+    /// Record a change that may affect the specialization arguments of this object and of its parents.
+    void markSpecializationDirty();
+    void propagateSpecializationVersion(uint64_t version);
+
+    /// Move the link to this object from `oldObject` to `newObject` when replacing a bound sub-object.
+    void relinkSpecializationParent(ShaderObjectBase* oldObject, ShaderObjectBase* newObject);
+
 public:
+    /// The newest specialization version of this object and of its entry points. Cached specializations of a
+    /// root object are valid as long as its signature is unchanged.
+    uint64_t getSpecializationSignature();
+
     void breakStrongReferenceToDevice() { m_device.breakStrongReference(); }
 
 public:
@@ -510,6 +554,9 @@ public:
         return SLANG_OK;
     }
 
+    /// Entry point `index` of a root object, without adding a reference.
+    virtual ShaderObjectBase* getEntryPointObject(GfxIndex index) { return nullptr; }
+
     SLANG_NO_THROW slang::TypeLayoutReflection* SLANG_MCALL getElementTypeLayout() SLANG_OVERRIDE
     {
         return m_layout->getElementTypeLayout();
@@ -548,7 +595,28 @@ protected:
     // Specialization args for a StructuredBuffer object.
     ExtendedShaderObjectTypeList m_structuredBufferSpecializationArgs;
 
+    /// Bind `object` at `objectIndex`, linking it to this object so that its specialization changes are
+    /// propagated here. Returns whether the bound object changed.
+    bool setSubObject(Index objectIndex, TShaderObjectImpl* object)
+    {
+        TShaderObjectImpl* oldObject = m_objects[objectIndex];
+        if (oldObject == object)
+            return false;
+        relinkSpecializationParent(oldObject, object);
+        m_objects[objectIndex] = object;
+        return true;
+    }
+
 public:
+    ~ShaderObjectBaseImpl()
+    {
+        for (auto& object : m_objects)
+        {
+            if (object)
+                relinkSpecializationParent(object, nullptr);
+        }
+    }
+
     TShaderObjectLayoutImpl* getLayout() { return checked_cast<TShaderObjectLayoutImpl*>(m_layout.Ptr()); }
 
     void* getBuffer() { return m_data.getBuffer(); }
@@ -571,6 +639,11 @@ public:
 
     void setSpecializationArgsForContainerElement(ExtendedShaderObjectTypeList& specializationArgs);
 
+    static bool mayHaveSpecializationArgs(TShaderObjectImpl* object)
+    {
+        return object && object->getLayout()->mayHaveSpecializationArgs();
+    }
+
     GfxIndex getSubObjectIndex(ShaderOffset offset)
     {
         auto layout = getLayout();
@@ -604,7 +677,8 @@ public:
                 auto stride = layout->getElementTypeLayout()->getStride();
                 m_data.setCount(m_objects.size() * stride);
             }
-            m_objects[offset.bindingArrayIndex] = subObject;
+            if (setSubObject(offset.bindingArrayIndex, subObject) && layout->mayHaveSpecializationArgs())
+                markSpecializationDirty();
 
             ExtendedShaderObjectTypeList specializationArgs;
 
@@ -654,7 +728,17 @@ public:
         auto bindingRangeIndex = offset.bindingRangeIndex;
         auto bindingRange = layout->getBindingRange(bindingRangeIndex);
 
-        m_objects[bindingRange.subObjectIndex + offset.bindingArrayIndex] = subObject;
+        // Only replacing an object that can affect the collected specialization arguments invalidates cached
+        // specializations. Later changes of the bound object are propagated through the link to this object.
+        Index objectIndex = bindingRange.subObjectIndex + offset.bindingArrayIndex;
+        bool affectsSpecialization = bindingRange.bindingType == slang::BindingType::ExistentialValue ||
+                                     bindingRange.isSpecializable ||
+                                     (objectIndex < m_userProvidedSpecializationArgs.size() &&
+                                      m_userProvidedSpecializationArgs[objectIndex]) ||
+                                     mayHaveSpecializationArgs(m_objects[objectIndex]) ||
+                                     mayHaveSpecializationArgs(subObject);
+        if (setSubObject(objectIndex, subObject) && affectsSpecialization)
+            markSpecializationDirty();
 
         switch (bindingRange.bindingType)
         {
@@ -749,6 +833,7 @@ public:
     setSpecializationArgs(ShaderOffset const& offset, const slang::SpecializationArg* args, GfxCount count) override
     {
         auto layout = getLayout();
+        markSpecializationDirty();
 
         // If the shader object is a container, delegate the processing to
         // `setSpecializationArgsForContainerElements`.
@@ -1040,6 +1125,8 @@ protected:
         std::size_t operator()(const PipelineKey& k) const { return k.hash; }
     };
 
+    // Component IDs are looked up while shader objects are filled, which may happen on several threads.
+    std::mutex componentIdsMutex;
     std::unordered_map<ComponentKey, ShaderComponentID, ComponentKeyHasher> componentIds;
     std::unordered_map<PipelineKey, RefPtr<Pipeline>, PipelineKeyHasher> specializedPipelines;
 };
@@ -1049,9 +1136,9 @@ class TransientResourceHeap : public ITransientResourceHeap, public ComObject
 public:
     uint64_t m_version = 0;
     uint64_t getVersion() { return m_version; }
-    uint64_t& getVersionCounter()
+    std::atomic<uint64_t>& getVersionCounter()
     {
-        static uint64_t version = 1;
+        static std::atomic<uint64_t> version = 1;
         return version;
     }
     TransientResourceHeap() { m_version = getVersionCounter()++; }
@@ -1322,6 +1409,12 @@ public:
     ComPtr<IPersistentShaderCache> persistentShaderCache;
 
     std::map<slang::TypeLayoutReflection*, RefPtr<ShaderObjectLayout>> m_shaderObjectLayoutCache;
+
+    /// Serializes access to the Slang session, `m_shaderObjectLayoutCache` and `shaderCache`, which are used by
+    /// every thread recording commands, including the shader object specialization in `setObject`, and by a
+    /// thread executing them.
+    std::recursive_mutex m_slangMutex;
+
     ComPtr<IPipelineCreationAPIDispatcher> m_pipelineCreationAPIDispatcher;
 
     IDebugCallback* m_debugCallback = nullptr;
@@ -1351,6 +1444,7 @@ void ShaderObjectBaseImpl<TShaderObjectImpl, TShaderObjectLayoutImpl, TShaderObj
         // buffer type if the element types are not the same.
         SLANG_RHI_ASSERT(m_structuredBufferSpecializationArgs.getCount() == specializationArgs.getCount());
         auto device = getDevice();
+        std::lock_guard<std::recursive_mutex> lock(device->m_slangMutex);
         for (Index i = 0; i < m_structuredBufferSpecializationArgs.getCount(); i++)
         {
             if (m_structuredBufferSpecializationArgs[i].componentID != specializationArgs[i].componentID)
@@ -1373,6 +1467,7 @@ Result ShaderObjectBaseImpl<TShaderObjectImpl, TShaderObjectLayoutImpl, TShaderO
     )
 {
     auto device = getDevice();
+    std::lock_guard<std::recursive_mutex> lock(device->m_slangMutex);
     for (uint32_t i = 0; i < count; i++)
     {
         ExtendedShaderObjectType extendedType;
@@ -1404,6 +1499,8 @@ Result ShaderObjectBaseImpl<TShaderObjectImpl, TShaderObjectLayoutImpl, TShaderO
     }
 
     auto device = getDevice();
+    // Collecting the arguments of sub-objects specializes their types through the Slang session.
+    std::lock_guard<std::recursive_mutex> lock(device->m_slangMutex);
     auto& subObjectRanges = getLayout()->getSubObjectRanges();
     // The following logic is built on the assumption that all fields that involve
     // existential types (and therefore require specialization) will results in a sub-object
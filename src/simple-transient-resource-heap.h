@@ -14,12 +14,14 @@ class SimpleTransientResourceHeap : public TransientResourceHeap
 {
 public:
     RefPtr<TDevice> m_device;
+    ITransientResourceHeap::Desc m_desc;
     ComPtr<IBuffer> m_constantBuffer;
 
 public:
     Result init(TDevice* device, const ITransientResourceHeap::Desc& desc)
     {
         m_device = device;
+        m_desc = desc;
         BufferDesc bufferDesc = {};
         bufferDesc.usage = BufferUsage::ConstantBuffer | BufferUsage::CopyDestination;
         bufferDesc.defaultState = ResourceState::ConstantBuffer;
@@ -31,7 +33,7 @@ public:
     virtual SLANG_NO_THROW Result SLANG_MCALL createCommandBuffer(ICommandBuffer** outCommandBuffer) override
     {
         RefPtr<TCommandBuffer> newCmdBuffer = new TCommandBuffer();
-        newCmdBuffer->init(m_device, this);
+        newCmdBuffer->init(m_device, this, m_desc.flags);
         returnComPtr(outCommandBuffer, newCmdBuffer);
         return SLANG_OK;
     }
@@ -1086,6 +1086,9 @@ Result DeviceImpl::createTransientResourceHeap(
     ITransientResourceHeap** outHeap
 )
 {
+    // Command buffers cannot be resubmitted.
+    if (desc.flags & ITransientResourceHeap::Flags::ReusableCommandBuffers)
+        return SLANG_E_NOT_AVAILABLE;
     RefPtr<TransientResourceHeapImpl> result = new TransientResourceHeapImpl();
     SLANG_RETURN_ON_FAIL(result->init(desc, this));
     returnComPtr(outHeap, result);
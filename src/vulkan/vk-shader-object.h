@@ -263,6 +263,7 @@ public:
 
     virtual GfxCount SLANG_MCALL getEntryPointCount() override;
     virtual Result SLANG_MCALL getEntryPoint(GfxIndex index, IShaderObject** outEntryPoint) override;
+    virtual ShaderObjectBase* getEntryPointObject(GfxIndex index) override { return m_entryPoints[index]; }
 
     virtual SLANG_NO_THROW Result SLANG_MCALL
     copyFrom(IShaderObject* object, ITransientResourceHeap* transientHeap) override;
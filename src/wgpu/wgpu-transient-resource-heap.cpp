@@ -46,6 +46,9 @@ Result DeviceImpl::createTransientResourceHeap(
     ITransientResourceHeap** outHeap
 )
 {
+    // Command buffers cannot be resubmitted.
+    if (desc.flags & ITransientResourceHeap::Flags::ReusableCommandBuffers)
+        return SLANG_E_NOT_AVAILABLE;
     RefPtr<TransientResourceHeapImpl> heap = new TransientResourceHeapImpl();
     SLANG_RETURN_ON_FAIL(heap->init(desc, this));
     returnComPtr(outHeap, heap);
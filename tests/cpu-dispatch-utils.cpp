@@ -0,0 +1,84 @@
+#include "cpu-dispatch-utils.h"
+
+namespace rhi::testing {
+
+const char* kCullShaderSource = R"(
+    [shader("compute")]
+    [numthreads(16, 1, 1)]
+    void computeMain(
+        uint3 tid : SV_DispatchThreadID,
+        uniform RWStructuredBuffer<uint> survivors,
+        uniform RWByteAddressBuffer counter,
+        uniform uint count)
+    {
+        if (tid.x >= count || tid.x % 3 != 0)
+            return;
+        uint index;
+        counter.InterlockedAdd(0, 1, index);
+        survivors[index] = tid.x;
+    }
+)";
+
+const char* kAccumulateShaderSource = R"(
+    [shader("compute")]
+    [numthreads(16, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID, uniform RWStructuredBuffer<uint> values, uniform uint delta)
+    {
+        values[tid.x] += delta;
+    }
+)";
+
+ComPtr<IDevice> createCPUDevice(GpuTestContext* ctx, DeviceType deviceType, uint32_t workerThreadCount)
+{
+    CPUDeviceExtendedDesc cpuExtDesc = {};
+    cpuExtDesc.workerThreadCount = workerThreadCount;
+    return createCPUDevice(ctx, deviceType, cpuExtDesc);
+}
+
+ComPtr<IDevice> createCPUDevice(GpuTestContext* ctx, DeviceType deviceType, CPUDeviceExtendedDesc cpuExtDesc)
+{
+    ComPtr<IDevice> device;
+    REQUIRE_CALL(tryCreateTestingDevice(ctx, deviceType, {&cpuExtDesc}, device));
+    return device;
+}
+
+ComPtr<IPipeline> createComputePipeline(IDevice* device, const char* source)
+{
+    ComPtr<IShaderProgram> shaderProgram;
+    REQUIRE_CALL(loadComputeProgramFromSource(device, shaderProgram, source));
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+    return pipeline;
+}
+
+ComPtr<IBuffer> createUIntBuffer(IDevice* device, uint32_t elementCount, BufferUsage extraUsage, const void* initData)
+{
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = elementCount * sizeof(uint32_t);
+    bufferDesc.elementSize = sizeof(uint32_t);
+    bufferDesc.usage =
+        BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopySource | extraUsage;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    std::vector<uint32_t> zeroData;
+    if (!initData)
+    {
+        zeroData.resize(elementCount, 0);
+        initData = zeroData.data();
+    }
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, initData, buffer.writeRef()));
+    return buffer;
+}
+
+std::vector<uint32_t> readUIntBuffer(IDevice* device, IBuffer* buffer)
+{
+    ComPtr<ISlangBlob> blob;
+    REQUIRE_CALL(device->readBuffer(buffer, 0, buffer->getDesc().size, blob.writeRef()));
+    const uint32_t* data = (const uint32_t*)blob->getBufferPointer();
+    return std::vector<uint32_t>(data, data + blob->getBufferSize() / sizeof(uint32_t));
+}
+
+} // namespace rhi::testing
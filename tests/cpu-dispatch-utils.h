@@ -0,0 +1,31 @@
+#pragma once
+
+#include "testing.h"
+
+#include <vector>
+
+namespace rhi::testing {
+
+/// Appends the indices below `count` that are multiples of 3 to `survivors`, counting them in `counter`.
+extern const char* kCullShaderSource;
+
+/// Accumulates `delta` into 16 elements of `values`.
+extern const char* kAccumulateShaderSource;
+
+ComPtr<IDevice> createCPUDevice(GpuTestContext* ctx, DeviceType deviceType, uint32_t workerThreadCount);
+
+ComPtr<IDevice> createCPUDevice(GpuTestContext* ctx, DeviceType deviceType, CPUDeviceExtendedDesc cpuExtDesc);
+
+ComPtr<IPipeline> createComputePipeline(IDevice* device, const char* source);
+
+/// Creates a buffer of 32-bit elements, zero initialized unless `initData` is given.
+ComPtr<IBuffer> createUIntBuffer(
+    IDevice* device,
+    uint32_t elementCount,
+    BufferUsage extraUsage = BufferUsage::None,
+    const void* initData = nullptr
+);
+
+std::vector<uint32_t> readUIntBuffer(IDevice* device, IBuffer* buffer);
+
+} // namespace rhi::testing
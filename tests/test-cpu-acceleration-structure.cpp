@@ -0,0 +1,253 @@
+#include "testing.h"
+
+#include <slang-rhi/acceleration-structure-utils.h>
+
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+struct AccelerationStructureTest
+{
+    IDevice* device;
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ComPtr<ICommandQueue> queue;
+    ComPtr<IQueryPool> sizeQueryPool;
+
+    void init(IDevice* inDevice)
+    {
+        device = inDevice;
+        queue = device->getQueue(QueueType::Graphics);
+
+        ITransientResourceHeap::Desc transientHeapDesc = {};
+        transientHeapDesc.constantBufferSize = 4096;
+        REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+        QueryPoolDesc queryPoolDesc = {};
+        queryPoolDesc.count = 1;
+        queryPoolDesc.type = QueryType::AccelerationStructureCurrentSize;
+        REQUIRE_CALL(device->createQueryPool(queryPoolDesc, sizeQueryPool.writeRef()));
+    }
+
+    ComPtr<IBuffer> createBuffer(const void* data, Size size)
+    {
+        BufferDesc bufferDesc = {};
+        bufferDesc.size = size;
+        bufferDesc.usage = BufferUsage::ShaderResource;
+        bufferDesc.defaultState = ResourceState::ShaderResource;
+        ComPtr<IBuffer> buffer;
+        REQUIRE_CALL(device->createBuffer(bufferDesc, data, buffer.writeRef()));
+        return buffer;
+    }
+
+    // Builds `dst` from `buildDesc` and returns the size reported by the current size query.
+    uint64_t build(
+        const AccelerationStructureBuildDesc& buildDesc,
+        IAccelerationStructure* dst,
+        IAccelerationStructure* src
+    )
+    {
+        AccelerationStructureQueryDesc queryDesc = {};
+        queryDesc.queryPool = sizeQueryPool;
+        queryDesc.queryType = QueryType::AccelerationStructureCurrentSize;
+
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginRayTracingPass();
+        REQUIRE(passEncoder != nullptr);
+        passEncoder->buildAccelerationStructure(buildDesc, dst, src, BufferWithOffset(), 1, &queryDesc);
+        passEncoder->end();
+        commandBuffer->close();
+        queue->submit(commandBuffer);
+        queue->waitOnHost();
+
+        uint64_t size = 0;
+        REQUIRE_CALL(sizeQueryPool->getResult(0, 1, &size));
+        return size;
+    }
+
+    ComPtr<IAccelerationStructure> create(const AccelerationStructureBuildDesc& buildDesc)
+    {
+        AccelerationStructureSizes sizes;
+        REQUIRE_CALL(device->getAccelerationStructureSizes(buildDesc, &sizes));
+        CHECK(sizes.accelerationStructureSize > 0);
+        CHECK(sizes.scratchSize > 0);
+
+        AccelerationStructureDesc createDesc = {};
+        createDesc.size = sizes.accelerationStructureSize;
+        ComPtr<IAccelerationStructure> accelerationStructure;
+        REQUIRE_CALL(device->createAccelerationStructure(createDesc, accelerationStructure.writeRef()));
+        return accelerationStructure;
+    }
+};
+
+void testCPUAccelerationStructure(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    CHECK(device->hasFeature("acceleration-structure"));
+
+    AccelerationStructureTest test;
+    test.init(device);
+
+    // A grid of quads, large enough to produce a multi-level tree.
+    const uint32_t kGridSize = 32;
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y <= kGridSize; y++)
+    {
+        for (uint32_t x = 0; x <= kGridSize; x++)
+        {
+            vertices.push_back(float(x));
+            vertices.push_back(float(y));
+            vertices.push_back(0.f);
+        }
+    }
+    for (uint32_t y = 0; y < kGridSize; y++)
+    {
+        for (uint32_t x = 0; x < kGridSize; x++)
+        {
+            uint32_t i = y * (kGridSize + 1) + x;
+            uint32_t quad[] = {i, i + 1, i + kGridSize + 1, i + 1, i + kGridSize + 2, i + kGridSize + 1};
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+    ComPtr<IBuffer> vertexBuffer = test.createBuffer(vertices.data(), vertices.size() * sizeof(float));
+    ComPtr<IBuffer> indexBuffer = test.createBuffer(indices.data(), indices.size() * sizeof(uint32_t));
+
+    AccelerationStructureBuildInputTriangles triangles = {};
+    BufferWithOffset vertexBufferWithOffset = vertexBuffer;
+    triangles.vertexBuffers = &vertexBufferWithOffset;
+    triangles.vertexBufferCount = 1;
+    triangles.vertexFormat = Format::R32G32B32_FLOAT;
+    triangles.vertexCount = GfxCount(vertices.size() / 3);
+    triangles.vertexStride = 3 * sizeof(float);
+    triangles.indexBuffer = indexBuffer;
+    triangles.indexFormat = IndexFormat::UInt32;
+    triangles.indexCount = GfxCount(indices.size());
+    triangles.flags = AccelerationStructureGeometryFlags::Opaque;
+
+    AccelerationStructureBuildDesc blasBuildDesc = {};
+    blasBuildDesc.inputs = &triangles;
+    blasBuildDesc.inputCount = 1;
+
+    ComPtr<IAccelerationStructure> BLAS;
+    for (auto flags :
+         {AccelerationStructureBuildFlags::PreferFastBuild,
+          AccelerationStructureBuildFlags::PreferFastTrace,
+          AccelerationStructureBuildFlags::AllowUpdate})
+    {
+        CAPTURE(int(flags));
+        blasBuildDesc.flags = flags;
+        BLAS = test.create(blasBuildDesc);
+        CHECK(test.build(blasBuildDesc, BLAS, nullptr) > 0);
+        CHECK(BLAS->getHandle().value != 0);
+    }
+
+    // Refit the updatable BLAS after moving the vertices, in place and into a new structure.
+    {
+        for (size_t i = 2; i < vertices.size(); i += 3)
+            vertices[i] = float(i % 7);
+        vertexBuffer = test.createBuffer(vertices.data(), vertices.size() * sizeof(float));
+        vertexBufferWithOffset = vertexBuffer;
+        blasBuildDesc.mode = AccelerationStructureBuildMode::Update;
+        uint64_t size = test.build(blasBuildDesc, BLAS, BLAS);
+        CHECK(size > 0);
+
+        ComPtr<IAccelerationStructure> updatedBLAS = test.create(blasBuildDesc);
+        CHECK(test.build(blasBuildDesc, updatedBLAS, BLAS) == size);
+    }
+
+    // Compact the BLAS.
+    {
+        ComPtr<IAccelerationStructure> compactedBLAS = test.create(blasBuildDesc);
+        auto commandBuffer = test.transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginRayTracingPass();
+        passEncoder->copyAccelerationStructure(compactedBLAS, BLAS, AccelerationStructureCopyMode::Compact);
+        AccelerationStructureQueryDesc queryDesc = {};
+        queryDesc.queryPool = test.sizeQueryPool;
+        queryDesc.queryType = QueryType::AccelerationStructureCurrentSize;
+        IAccelerationStructure* compacted = compactedBLAS;
+        passEncoder->queryAccelerationStructureProperties(1, &compacted, 1, &queryDesc);
+        passEncoder->end();
+        commandBuffer->close();
+        test.queue->submit(commandBuffer);
+        test.queue->waitOnHost();
+
+        uint64_t size = 0;
+        REQUIRE_CALL(test.sizeQueryPool->getResult(0, 1, &size));
+        CHECK(size > 0);
+        BLAS = compactedBLAS;
+    }
+
+    // Build a TLAS with a row of instances of the BLAS.
+    {
+        AccelerationStructureInstanceDescType instanceDescType = getAccelerationStructureInstanceDescType(device);
+        Size instanceDescSize = getAccelerationStructureInstanceDescSize(instanceDescType);
+        const GfxCount kInstanceCount = 16;
+        std::vector<AccelerationStructureInstanceDescGeneric> genericInstanceDescs(kInstanceCount);
+        for (GfxIndex i = 0; i < kInstanceCount; i++)
+        {
+            auto& instanceDesc = genericInstanceDescs[i];
+            float transform[] = {1.f, 0.f, 0.f, float(i) * 40.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+            memcpy(&instanceDesc.transform[0][0], transform, sizeof(transform));
+            instanceDesc.instanceID = i;
+            instanceDesc.instanceMask = 0xff;
+            instanceDesc.instanceContributionToHitGroupIndex = 0;
+            instanceDesc.flags = AccelerationStructureInstanceFlags::None;
+            instanceDesc.accelerationStructure = BLAS->getHandle();
+        }
+        std::vector<uint8_t> instanceDescs(kInstanceCount * instanceDescSize);
+        convertAccelerationStructureInstanceDescs(
+            kInstanceCount,
+            instanceDescType,
+            instanceDescs.data(),
+            instanceDescSize,
+            genericInstanceDescs.data(),
+            sizeof(AccelerationStructureInstanceDescGeneric)
+        );
+        ComPtr<IBuffer> instanceBuffer = test.createBuffer(instanceDescs.data(), instanceDescs.size());
+
+        AccelerationStructureBuildInputInstances instances = {};
+        instances.instanceBuffer = instanceBuffer;
+        instances.instanceCount = kInstanceCount;
+        instances.instanceStride = instanceDescSize;
+        AccelerationStructureBuildDesc tlasBuildDesc = {};
+        tlasBuildDesc.inputs = &instances;
+        tlasBuildDesc.inputCount = 1;
+
+        ComPtr<IAccelerationStructure> TLAS = test.create(tlasBuildDesc);
+        CHECK(test.build(tlasBuildDesc, TLAS, nullptr) > 0);
+    }
+
+    // Build from procedural primitives.
+    {
+        std::vector<AccelerationStructureAABB> aabbs;
+        for (uint32_t i = 0; i < 100; i++)
+            aabbs.push_back({float(i), 0.f, 0.f, float(i) + 0.5f, 1.f, 1.f});
+        ComPtr<IBuffer> aabbBuffer = test.createBuffer(aabbs.data(), aabbs.size() * sizeof(AccelerationStructureAABB));
+
+        AccelerationStructureBuildInputProceduralPrimitives proceduralPrimitives = {};
+        BufferWithOffset aabbBufferWithOffset = aabbBuffer;
+        proceduralPrimitives.aabbBuffers = &aabbBufferWithOffset;
+        proceduralPrimitives.aabbBufferCount = 1;
+        proceduralPrimitives.aabbStride = sizeof(AccelerationStructureAABB);
+        proceduralPrimitives.primitiveCount = GfxCount(aabbs.size());
+        AccelerationStructureBuildDesc buildDesc = {};
+        buildDesc.inputs = &proceduralPrimitives;
+        buildDesc.inputCount = 1;
+
+        ComPtr<IAccelerationStructure> accelerationStructure = test.create(buildDesc);
+        CHECK(test.build(buildDesc, accelerationStructure, nullptr) > 0);
+    }
+
+    // A build without inputs is invalid.
+    {
+        AccelerationStructureSizes sizes;
+        AccelerationStructureBuildDesc buildDesc = {};
+        CHECK(device->getAccelerationStructureSizes(buildDesc, &sizes) == SLANG_E_INVALID_ARG);
+    }
+}
+
+TEST_CASE("cpu-acceleration-structure")
+{
+    runGpuTests(testCPUAccelerationStructure, {DeviceType::CPU});
+}
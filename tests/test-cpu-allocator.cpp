@@ -0,0 +1,132 @@
+#include "testing.h"
+
+#include <new>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static ComPtr<IBuffer> createBuffer(IDevice* device, size_t size)
+{
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = size;
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, nullptr, buffer.writeRef()));
+    return buffer;
+}
+
+void testCPUAllocator(GpuTestContext* ctx, DeviceType deviceType)
+{
+    const size_t kLargeSize = 8 * 1024 * 1024;
+
+    CPUDeviceExtendedDesc extDesc = {};
+    extDesc.workerThreadCount = 4;
+    ComPtr<IDevice> device;
+    REQUIRE_CALL(tryCreateTestingDevice(ctx, deviceType, {&extDesc}, device));
+    ComPtr<ICPUDevice> cpuDevice;
+    REQUIRE_CALL(device->queryInterface(ICPUDevice::getTypeGuid(), (void**)cpuDevice.writeRef()));
+
+    DeviceMemoryStats stats;
+    REQUIRE_CALL(cpuDevice->getMemoryStats(&stats));
+    CHECK(stats.allocationCount == 0);
+    CHECK(stats.allocatedBytes == 0);
+
+    {
+        ComPtr<IBuffer> smallBuffer = createBuffer(device, 100);
+        ComPtr<IBuffer> largeBuffer = createBuffer(device, kLargeSize);
+        CHECK(smallBuffer->getDeviceAddress() % 64 == 0);
+        CHECK(largeBuffer->getDeviceAddress() % 64 == 0);
+
+        // Large buffers are committed lazily and can be used right away.
+        uint8_t* data = (uint8_t*)largeBuffer->getDeviceAddress();
+        data[0] = 1;
+        data[kLargeSize - 1] = 2;
+
+        TextureDesc textureDesc = {};
+        textureDesc.type = TextureType::Texture2D;
+        textureDesc.size = {64, 64, 1};
+        textureDesc.mipLevelCount = 1;
+        textureDesc.format = Format::R32G32B32A32_FLOAT;
+        textureDesc.usage = TextureUsage::ShaderResource;
+        ComPtr<ITexture> texture;
+        REQUIRE_CALL(device->createTexture(textureDesc, nullptr, texture.writeRef()));
+
+        REQUIRE_CALL(cpuDevice->getMemoryStats(&stats));
+        CHECK(stats.allocationCount == 3);
+        CHECK(stats.totalAllocationCount == 3);
+        CHECK(stats.allocatedBytes == 100 + kLargeSize + 64 * 64 * 16);
+        CHECK(stats.peakAllocatedBytes == stats.allocatedBytes);
+#if SLANG_LINUX_FAMILY
+        CHECK(stats.hugePageBytes == kLargeSize);
+#endif
+    }
+
+    REQUIRE_CALL(cpuDevice->getMemoryStats(&stats));
+    CHECK(stats.allocationCount == 0);
+    CHECK(stats.allocatedBytes == 0);
+    CHECK(stats.hugePageBytes == 0);
+    CHECK(stats.peakAllocatedBytes == 100 + kLargeSize + 64 * 64 * 16);
+    CHECK(stats.totalAllocationCount == 3);
+
+    // Opting into first touch commits large buffers on the workers when they are created.
+    extDesc.firstTouchLargeResources = true;
+    REQUIRE_CALL(tryCreateTestingDevice(ctx, deviceType, {&extDesc}, device));
+    ComPtr<IBuffer> touchedBuffer = createBuffer(device, kLargeSize);
+    uint8_t* touchedData = (uint8_t*)touchedBuffer->getDeviceAddress();
+    CHECK(touchedData[0] == 0);
+    CHECK(touchedData[kLargeSize - 1] == 0);
+}
+
+TEST_CASE("cpu-allocator")
+{
+    runGpuTests(testCPUAllocator, {DeviceType::CPU});
+}
+
+struct CustomAllocatorState
+{
+    int allocateCount = 0;
+    int freeCount = 0;
+    size_t alignment = 0;
+};
+
+void testCPUCustomAllocator(GpuTestContext* ctx, DeviceType deviceType)
+{
+    CustomAllocatorState state;
+    CPUDeviceExtendedDesc extDesc = {};
+    extDesc.allocatorUserData = &state;
+    extDesc.allocateFunc = [](void* userData, size_t size, size_t alignment) -> void*
+    {
+        auto state = static_cast<CustomAllocatorState*>(userData);
+        state->allocateCount++;
+        state->alignment = alignment;
+        return ::operator new(size, std::align_val_t(alignment));
+    };
+    extDesc.freeFunc = [](void* userData, void* data, size_t size)
+    {
+        SLANG_UNUSED(size);
+        auto state = static_cast<CustomAllocatorState*>(userData);
+        state->freeCount++;
+        ::operator delete(data, std::align_val_t(state->alignment));
+    };
+    ComPtr<IDevice> device;
+    REQUIRE_CALL(tryCreateTestingDevice(ctx, deviceType, {&extDesc}, device));
+    ComPtr<ICPUDevice> cpuDevice;
+    REQUIRE_CALL(device->queryInterface(ICPUDevice::getTypeGuid(), (void**)cpuDevice.writeRef()));
+
+    {
+        ComPtr<IBuffer> buffer = createBuffer(device, 256);
+        CHECK(state.allocateCount == 1);
+        CHECK(state.alignment >= 64);
+        CHECK(buffer->getDeviceAddress() % 64 == 0);
+        DeviceMemoryStats stats;
+        REQUIRE_CALL(cpuDevice->getMemoryStats(&stats));
+        CHECK(stats.allocatedBytes == 256);
+    }
+    CHECK(state.freeCount == 1);
+}
+
+TEST_CASE("cpu-custom-allocator")
+{
+    runGpuTests(testCPUCustomAllocator, {DeviceType::CPU});
+}
@@ -0,0 +1,298 @@
+#include "testing.h"
+
+#define SLANG_PRELUDE_NAMESPACE slang_prelude
+#include "../src/prelude/slang-cpp-types.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace slang_prelude;
+
+static const uint32_t kBinCount = 256;
+
+// Counts the values of `input` into `histogram`, the way a compute kernel with one bin per value would.
+static void histogramKernel(
+    StructuredBuffer<uint32_t> input,
+    RWByteAddressBuffer histogram,
+    size_t start,
+    size_t end
+)
+{
+    for (size_t i = start; i < end; i++)
+        histogram.InterlockedAdd((input[i] % kBinCount) * 4, 1u);
+}
+
+static double runHistogram(
+    uint32_t threadCount,
+    const std::vector<uint32_t>& input,
+    std::vector<uint32_t>& histogram
+)
+{
+    std::fill(histogram.begin(), histogram.end(), 0);
+    StructuredBuffer<uint32_t> inputBuffer = {const_cast<uint32_t*>(input.data()), input.size()};
+    RWByteAddressBuffer histogramBuffer = {histogram.data(), histogram.size() * 4};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    size_t chunkSize = (input.size() + threadCount - 1) / threadCount;
+    for (uint32_t i = 0; i < threadCount; i++)
+    {
+        size_t chunkStart = std::min(input.size(), i * chunkSize);
+        size_t chunkEnd = std::min(input.size(), chunkStart + chunkSize);
+        threads.emplace_back(histogramKernel, inputBuffer, histogramBuffer, chunkStart, chunkEnd);
+    }
+    for (auto& thread : threads)
+        thread.join();
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+TEST_CASE("cpu-atomics-histogram")
+{
+    const size_t kValueCount = 1 << 22;
+    std::vector<uint32_t> input(kValueCount);
+    uint32_t state = 1;
+    for (auto& value : input)
+    {
+        state = state * 1664525u + 1013904223u;
+        // Skewed towards the low bins to get contention.
+        value = (state >> 8) % (state & 0x100 ? kBinCount : 8);
+    }
+    std::vector<uint32_t> expected(kBinCount, 0);
+    for (uint32_t value : input)
+        expected[value]++;
+
+    uint32_t maxThreadCount = std::max(2u, std::min(16u, std::thread::hardware_concurrency()));
+    std::vector<uint32_t> histogram(kBinCount);
+    double singleThreadSeconds = 0.0;
+    for (uint32_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+    {
+        CAPTURE(threadCount);
+        double seconds = runHistogram(threadCount, input, histogram);
+        CHECK(histogram == expected);
+        if (threadCount == 1)
+            singleThreadSeconds = seconds;
+        MESSAGE(
+            "histogram threads: ",
+            threadCount,
+            ", ",
+            kValueCount / seconds * 1e-6,
+            " M atomics/s, speedup ",
+            singleThreadSeconds / seconds
+        );
+    }
+}
+
+TEST_CASE("cpu-atomics")
+{
+    // Byte address buffer operations on 32 bit signed and unsigned values.
+    {
+        uint32_t data[4] = {10, 0xf0, 5, 0};
+        RWByteAddressBuffer buffer = {data, sizeof(data)};
+        uint32_t original = 0;
+        buffer.InterlockedAdd(0, 5u, &original);
+        CHECK(original == 10);
+        CHECK(data[0] == 15);
+        buffer.InterlockedAnd(4, 0x3cu);
+        CHECK(data[1] == 0x30);
+        buffer.InterlockedOr(4, 0x1u);
+        buffer.InterlockedXor(4, 0x10u);
+        CHECK(data[1] == 0x21);
+        buffer.InterlockedMin(8, 3u);
+        buffer.InterlockedMax(8, 2u);
+        CHECK(data[2] == 3);
+        // Signed comparison, -1 is smaller than 3.
+        buffer.InterlockedMin(8, -1);
+        CHECK(int32_t(data[2]) == -1);
+        buffer.InterlockedMax(8, 7);
+        CHECK(data[2] == 7);
+        buffer.InterlockedExchange(12, 42u, &original);
+        CHECK(original == 0);
+        buffer.InterlockedCompareExchange(12, 1u, 2u, &original);
+        CHECK(original == 42);
+        CHECK(data[3] == 42);
+        buffer.InterlockedCompareStore(12, 42u, 2u);
+        CHECK(data[3] == 2);
+
+        float floatData[1] = {1.0f};
+        RWByteAddressBuffer floatBuffer = {reinterpret_cast<uint32_t*>(floatData), sizeof(floatData)};
+        float originalFloat = 0.0f;
+        floatBuffer.InterlockedAddF32(0, 0.5f, &originalFloat);
+        CHECK(originalFloat == 1.0f);
+        CHECK(floatData[0] == 1.5f);
+    }
+
+    // 64 bit operations.
+    {
+        uint64_t data[2] = {0xffffffffull, 1};
+        RWByteAddressBuffer buffer = {reinterpret_cast<uint32_t*>(data), sizeof(data)};
+        uint64_t original = 0;
+        buffer.InterlockedAdd64(0, uint64_t(1), &original);
+        CHECK(original == 0xffffffffull);
+        CHECK(data[0] == 0x100000000ull);
+        buffer.InterlockedMax64(8, int64_t(-5));
+        CHECK(data[1] == 1);
+        buffer.InterlockedMin64(8, int64_t(-5));
+        CHECK(int64_t(data[1]) == -5);
+        buffer.InterlockedCompareExchange64(0, uint64_t(0x100000000ull), uint64_t(7), &original);
+        CHECK(data[0] == 7);
+    }
+
+    // Float add and the free functions on plain memory, from multiple threads.
+    {
+        float sum = 0.0f;
+        int64_t minValue = 0;
+        uint32_t maxValue = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++)
+        {
+            threads.emplace_back(
+                [&, t]()
+                {
+                    for (int i = 0; i < 10000; i++)
+                    {
+                        InterlockedAdd(sum, 0.25f);
+                        InterlockedMin(minValue, int64_t(-(t * 10000 + i)));
+                        InterlockedMax(maxValue, uint32_t(t * 10000 + i));
+                    }
+                }
+            );
+        }
+        for (auto& thread : threads)
+            thread.join();
+        CHECK(sum == 10000.0f);
+        CHECK(minValue == -39999);
+        CHECK(maxValue == 39999);
+
+        double value = 1.0;
+        double original = 0.0;
+        InterlockedAdd(value, 2.0, &original);
+        CHECK(original == 1.0);
+        CHECK(value == 3.0);
+        float exchanged = 0.0f;
+        InterlockedExchange(sum, 1.5f, &exchanged);
+        CHECK(exchanged == 10000.0f);
+        CHECK(sum == 1.5f);
+    }
+
+    // Append from multiple threads, then consume everything.
+    {
+        const uint32_t kCount = 4096;
+        std::vector<uint32_t> elements(kCount, 0);
+        uint32_t counter = 0;
+        AppendStructuredBuffer<uint32_t> appendBuffer = {elements.data(), elements.size(), &counter};
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < 4; t++)
+        {
+            threads.emplace_back(
+                [=]()
+                {
+                    for (uint32_t i = t; i < kCount; i += 4)
+                        appendBuffer.Append(i + 1);
+                }
+            );
+        }
+        for (auto& thread : threads)
+            thread.join();
+        REQUIRE(counter == kCount);
+        std::vector<uint32_t> sorted = elements;
+        std::sort(sorted.begin(), sorted.end());
+        for (uint32_t i = 0; i < kCount; i++)
+            CHECK(sorted[i] == i + 1);
+
+        ConsumeStructuredBuffer<uint32_t> consumeBuffer = {elements.data(), elements.size(), &counter};
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < kCount; i++)
+            sum += consumeBuffer.Consume();
+        CHECK(counter == 0);
+        CHECK(sum == uint64_t(kCount) * (kCount + 1) / 2);
+    }
+}
+
+static const char* kHistogramShaderSource = R"(
+    [shader("compute")]
+    [numthreads(64, 1, 1)]
+    void computeMain(
+        uint3 tid : SV_DispatchThreadID,
+        uniform StructuredBuffer<uint> input,
+        uniform RWStructuredBuffer<uint> histogram,
+        uniform uint count)
+    {
+        if (tid.x >= count)
+            return;
+        uint previous;
+        InterlockedAdd(histogram[input[tid.x] % 256], 1, previous);
+    }
+)";
+
+// Counts values with a Slang kernel dispatched on several worker threads, all contending for the same bins.
+void testCPUAtomicsSlangHistogram(rhi::testing::GpuTestContext* ctx, rhi::DeviceType deviceType)
+{
+    using namespace rhi;
+    using namespace rhi::testing;
+
+    CPUDeviceExtendedDesc cpuExtDesc = {};
+    cpuExtDesc.workerThreadCount = 4;
+    ComPtr<IDevice> device;
+    REQUIRE_CALL(tryCreateTestingDevice(ctx, deviceType, {&cpuExtDesc}, device));
+
+    const uint32_t kValueCount = 1 << 16;
+    std::vector<uint32_t> input(kValueCount);
+    std::vector<uint32_t> expected(kBinCount, 0);
+    uint32_t state = 1;
+    for (auto& value : input)
+    {
+        state = state * 1664525u + 1013904223u;
+        value = (state >> 8) % (state & 0x100 ? kBinCount : 8);
+        expected[value]++;
+    }
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    REQUIRE_CALL(loadComputeProgramFromSource(device, shaderProgram, kHistogramShaderSource));
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    BufferDesc bufferDesc = {};
+    bufferDesc.elementSize = sizeof(uint32_t);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.size = kValueCount * sizeof(uint32_t);
+    ComPtr<IBuffer> inputBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, input.data(), inputBuffer.writeRef()));
+    std::vector<uint32_t> zeros(kBinCount, 0);
+    bufferDesc.size = kBinCount * sizeof(uint32_t);
+    ComPtr<IBuffer> histogramBuffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, zeros.data(), histogramBuffer.writeRef()));
+
+    auto queue = device->getQueue(QueueType::Graphics);
+    auto commandBuffer = transientHeap->createCommandBuffer();
+    auto passEncoder = commandBuffer->beginComputePass();
+    auto rootObject = passEncoder->bindPipeline(pipeline);
+    ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+    entryPointCursor["input"].setBinding(inputBuffer);
+    entryPointCursor["histogram"].setBinding(histogramBuffer);
+    entryPointCursor["count"].setData(kValueCount);
+    passEncoder->dispatchCompute(kValueCount / 64, 1, 1);
+    passEncoder->end();
+    commandBuffer->close();
+    queue->submit(commandBuffer);
+    queue->waitOnHost();
+
+    ComPtr<ISlangBlob> histogramBlob;
+    REQUIRE_CALL(device->readBuffer(histogramBuffer, 0, kBinCount * sizeof(uint32_t), histogramBlob.writeRef()));
+    const uint32_t* histogram = static_cast<const uint32_t*>(histogramBlob->getBufferPointer());
+    CHECK(std::vector<uint32_t>(histogram, histogram + kBinCount) == expected);
+}
+
+TEST_CASE("cpu-atomics-slang-histogram")
+{
+    rhi::testing::runGpuTests(testCPUAtomicsSlangHistogram, {rhi::DeviceType::CPU});
+}
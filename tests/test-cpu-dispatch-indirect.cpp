@@ -0,0 +1,103 @@
+#include "cpu-dispatch-utils.h"
+
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static const char* kWriteArgsShaderSource = R"(
+    [shader("compute")]
+    [numthreads(1, 1, 1)]
+    void computeMain(uniform RWByteAddressBuffer counter, uniform RWStructuredBuffer<uint> args)
+    {
+        args[1] = (counter.Load(0) + 15) / 16;
+        args[2] = 1;
+        args[3] = 1;
+    }
+)";
+
+static const char* kProcessShaderSource = R"(
+    [shader("compute")]
+    [numthreads(16, 1, 1)]
+    void computeMain(
+        uint3 tid : SV_DispatchThreadID,
+        uniform RWStructuredBuffer<uint> survivors,
+        uniform RWByteAddressBuffer counter,
+        uniform RWStructuredBuffer<uint> output)
+    {
+        if (tid.x >= counter.Load(0))
+            return;
+        uint value = survivors[tid.x];
+        output[value] = value + 1;
+    }
+)";
+
+// Culls a set of items, then processes the survivors with a dispatch sized by the number of
+// survivors, all within one command buffer.
+void testCPUDispatchIndirect(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, 4);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IPipeline> cullPipeline = createComputePipeline(device, kCullShaderSource);
+    ComPtr<IPipeline> writeArgsPipeline = createComputePipeline(device, kWriteArgsShaderSource);
+    ComPtr<IPipeline> processPipeline = createComputePipeline(device, kProcessShaderSource);
+
+    const uint32_t kCount = 1000;
+    ComPtr<IBuffer> survivors = createUIntBuffer(device, kCount);
+    ComPtr<IBuffer> counter = createUIntBuffer(device, 1);
+    ComPtr<IBuffer> output = createUIntBuffer(device, kCount);
+    // The arguments follow a padding element to exercise the offset.
+    ComPtr<IBuffer> args = createUIntBuffer(device, 4, BufferUsage::IndirectArgument);
+
+    {
+        auto queue = device->getQueue(QueueType::Graphics);
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+
+        ShaderCursor cursor(passEncoder->bindPipeline(cullPipeline)->getEntryPoint(0));
+        cursor["survivors"].setBinding(survivors);
+        cursor["counter"].setBinding(counter);
+        cursor["count"].setData(&kCount, sizeof(kCount));
+        passEncoder->dispatchCompute((kCount + 15) / 16, 1, 1);
+
+        cursor = ShaderCursor(passEncoder->bindPipeline(writeArgsPipeline)->getEntryPoint(0));
+        cursor["counter"].setBinding(counter);
+        cursor["args"].setBinding(args);
+        passEncoder->dispatchCompute(1, 1, 1);
+
+        cursor = ShaderCursor(passEncoder->bindPipeline(processPipeline)->getEntryPoint(0));
+        cursor["survivors"].setBinding(survivors);
+        cursor["counter"].setBinding(counter);
+        cursor["output"].setBinding(output);
+        passEncoder->dispatchComputeIndirect(args, sizeof(uint32_t));
+
+        passEncoder->end();
+        commandBuffer->close();
+        queue->submit(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    const uint32_t survivorCount = (kCount + 2) / 3;
+    CHECK(readUIntBuffer(device, counter)[0] == survivorCount);
+    std::vector<uint32_t> argsData = readUIntBuffer(device, args);
+    CHECK(argsData[0] == 0);
+    CHECK(argsData[1] == (survivorCount + 15) / 16);
+    CHECK(argsData[2] == 1);
+    CHECK(argsData[3] == 1);
+    std::vector<uint32_t> result = readUIntBuffer(device, output);
+    for (uint32_t i = 0; i < kCount; i++)
+    {
+        CAPTURE(i);
+        CHECK(result[i] == (i % 3 == 0 ? i + 1 : 0));
+    }
+}
+
+TEST_CASE("cpu-dispatch-indirect")
+{
+    runGpuTests(testCPUDispatchIndirect, {DeviceType::CPU});
+}
@@ -0,0 +1,235 @@
+#include "cpu-dispatch-utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static const char* kDispatchShaderSource = R"(
+    [shader("compute")]
+    [numthreads(4, 4, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID, uniform RWStructuredBuffer<uint> buffer, uniform uint3 size)
+    {
+        uint index = (tid.z * size.y + tid.y) * size.x + tid.x;
+        uint value = index * 2654435761u;
+        value ^= value >> 13;
+        buffer[index] = value + 1;
+    }
+)";
+
+static std::vector<uint32_t> runDispatch(
+    IDevice* device,
+    uint32_t groupCountX,
+    uint32_t groupCountY,
+    uint32_t groupCountZ
+)
+{
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    REQUIRE_CALL(loadComputeProgramFromSource(device, shaderProgram, kDispatchShaderSource));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    uint32_t size[3] = {groupCountX * 4, groupCountY * 4, groupCountZ};
+    uint32_t elementCount = size[0] * size[1] * size[2];
+
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = elementCount * sizeof(uint32_t);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(uint32_t);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopyDestination |
+                       BufferUsage::CopySource;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+
+    std::vector<uint32_t> initialData(elementCount, 0);
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, initialData.data(), buffer.writeRef()));
+
+    {
+        auto queue = device->getQueue(QueueType::Graphics);
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+        auto rootObject = passEncoder->bindPipeline(pipeline);
+        ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+        entryPointCursor["buffer"].setBinding(buffer);
+        entryPointCursor["size"].setData(size, sizeof(size));
+        passEncoder->dispatchCompute(groupCountX, groupCountY, groupCountZ);
+        passEncoder->end();
+        commandBuffer->close();
+        queue->submit(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    ComPtr<ISlangBlob> blob;
+    REQUIRE_CALL(device->readBuffer(buffer, 0, bufferDesc.size, blob.writeRef()));
+    std::vector<uint32_t> result(elementCount);
+    ::memcpy(result.data(), blob->getBufferPointer(), bufferDesc.size);
+    return result;
+}
+
+void testCPUDispatchMultithreaded(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> singleThreadedDevice = createCPUDevice(ctx, deviceType, 1);
+    ComPtr<IDevice> multiThreadedDevice = createCPUDevice(ctx, deviceType, 8);
+
+    // Use odd grid sizes so that chunks do not divide the grid evenly.
+    uint32_t gridSizes[][3] = {{1, 1, 1}, {37, 1, 1}, {13, 7, 5}, {3, 2, 29}};
+    for (const auto& gridSize : gridSizes)
+    {
+        CAPTURE(gridSize[0]);
+        CAPTURE(gridSize[1]);
+        CAPTURE(gridSize[2]);
+        auto expected = runDispatch(singleThreadedDevice, gridSize[0], gridSize[1], gridSize[2]);
+        auto result = runDispatch(multiThreadedDevice, gridSize[0], gridSize[1], gridSize[2]);
+        CHECK(std::find(expected.begin(), expected.end(), 0u) == expected.end());
+        CHECK(result == expected);
+    }
+}
+
+TEST_CASE("cpu-dispatch-multithreaded")
+{
+    runGpuTests(testCPUDispatchMultithreaded, {DeviceType::CPU});
+}
+
+/// Link a compute entry point of a module, independently of the programs created by the device.
+static ComPtr<slang::IComponentType> linkComputeProgram(
+    IDevice* device,
+    const char* moduleName,
+    const char* entryPointName
+)
+{
+    ComPtr<slang::ISession> slangSession;
+    REQUIRE_CALL(device->getSlangSession(slangSession.writeRef()));
+    ComPtr<slang::IBlob> diagnosticsBlob;
+    slang::IModule* module = slangSession->loadModule(moduleName, diagnosticsBlob.writeRef());
+    diagnoseIfNeeded(diagnosticsBlob);
+    REQUIRE(module);
+    ComPtr<slang::IEntryPoint> entryPoint;
+    REQUIRE_CALL(module->findEntryPointByName(entryPointName, entryPoint.writeRef()));
+    slang::IComponentType* componentTypes[] = {module, entryPoint};
+    ComPtr<slang::IComponentType> composedProgram;
+    REQUIRE_CALL(slangSession->createCompositeComponentType(
+        componentTypes,
+        2,
+        composedProgram.writeRef(),
+        diagnosticsBlob.writeRef()
+    ));
+    ComPtr<slang::IComponentType> linkedProgram;
+    REQUIRE_CALL(composedProgram->link(linkedProgram.writeRef(), diagnosticsBlob.writeRef()));
+    return linkedProgram;
+}
+
+// Measures the host overhead of repeatedly dispatching the same pipeline.
+// Dispatches use the kernel cached on the program, which is compared against resolving the kernel
+// through Slang and the shared library on every dispatch, as was done without the cache.
+void testCPUDispatchOverhead(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, 1);
+    ComPtr<IImmediateDevice> immediateDevice;
+    REQUIRE_CALL(device->queryInterface(IImmediateDevice::getTypeGuid(), (void**)immediateDevice.writeRef()));
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-trivial", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopyDestination |
+                       BufferUsage::CopySource;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+
+    auto queue = device->getQueue(QueueType::Graphics);
+    auto runDispatches = [&](uint32_t dispatchCount)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+        for (uint32_t i = 0; i < dispatchCount; i++)
+        {
+            auto rootObject = passEncoder->bindPipeline(pipeline);
+            ShaderCursor(rootObject).getPath("buffer").setBinding(buffer);
+            passEncoder->dispatchCompute(1, 1, 1);
+        }
+        passEncoder->end();
+        commandBuffer->close();
+        queue->submit(commandBuffer);
+        queue->waitOnHost();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / dispatchCount;
+    };
+
+    const uint32_t kDispatchCount = 1000;
+    double firstDispatchTime = runDispatches(1);
+    CommandStats statsBefore;
+    REQUIRE_CALL(immediateDevice->getCommandStats(&statsBefore));
+    double steadyDispatchTime = runDispatches(kDispatchCount);
+    MESSAGE("first dispatch: ", firstDispatchTime, " us, subsequent dispatches: ", steadyDispatchTime, " us");
+
+    // The uncached lookup path, the first call compiles the kernel and is not measured.
+    ComPtr<slang::IComponentType> linkedProgram = linkComputeProgram(device, "test-compute-trivial", "computeMain");
+    auto lookupKernel = [&]()
+    {
+        ComPtr<ISlangSharedLibrary> library;
+        REQUIRE_CALL(linkedProgram->getEntryPointHostCallable(0, 0, library.writeRef()));
+        return library->findSymbolAddressByName("computeMain");
+    };
+    CHECK(lookupKernel() != nullptr);
+    auto lookupStart = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < kDispatchCount; i++)
+        lookupKernel();
+    auto lookupEnd = std::chrono::high_resolution_clock::now();
+    double uncachedLookupTime =
+        std::chrono::duration<double, std::micro>(lookupEnd - lookupStart).count() / kDispatchCount;
+    MESSAGE(
+        "dispatch with cached kernel: ",
+        steadyDispatchTime,
+        " us, uncached kernel lookup adds: ",
+        uncachedLookupTime,
+        " us per dispatch"
+    );
+
+    // Each dispatch binds a new root object, but the pipeline is only set once.
+    CommandStats stats;
+    REQUIRE_CALL(immediateDevice->getCommandStats(&stats));
+    CHECK(stats.recordedCommandCount - statsBefore.recordedCommandCount == 2 * kDispatchCount + 1);
+    CHECK(stats.elidedPipelineCount - statsBefore.elidedPipelineCount == kDispatchCount - 1);
+    CHECK(stats.elidedRootObjectCount == statsBefore.elidedRootObjectCount);
+
+    float expected = float(kDispatchCount + 1);
+    compareComputeResult(
+        device,
+        buffer,
+        makeArray<float>(expected + 0.0f, expected + 1.0f, expected + 2.0f, expected + 3.0f)
+    );
+}
+
+TEST_CASE("cpu-dispatch-overhead")
+{
+    runGpuTests(testCPUDispatchOverhead, {DeviceType::CPU});
+}
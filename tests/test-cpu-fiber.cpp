@@ -0,0 +1,168 @@
+#include "testing.h"
+
+#include "../src/cpu/cpu-fiber.h"
+
+#include <chrono>
+#include <vector>
+
+using namespace rhi::cpu;
+
+struct TestThreadGroup;
+
+using TestThreadFunc = void (*)(TestThreadGroup* group, uint32_t threadIndex);
+
+// Runs a kernel on the threads of several groups, each group sharing the scheduler's groupshared memory.
+struct TestThreadGroup
+{
+    ThreadGroupScheduler* scheduler;
+    TestThreadFunc func;
+    void* params;
+    uint32_t groupIndex;
+
+    uint32_t* getSharedMemory() const { return static_cast<uint32_t*>(scheduler->getGroupSharedMemory()); }
+
+    static void runThread(void* userData, uint32_t threadIndex)
+    {
+        TestThreadGroup* group = static_cast<TestThreadGroup*>(userData);
+        group->func(group, threadIndex);
+    }
+
+    void run(ThreadGroupScheduler& inScheduler, TestThreadFunc inFunc, void* inParams, uint32_t groupCount)
+    {
+        scheduler = &inScheduler;
+        func = inFunc;
+        params = inParams;
+        for (groupIndex = 0; groupIndex < groupCount; groupIndex++)
+            scheduler->run(runThread, this);
+    }
+};
+
+static const uint32_t kGroupSize = 64;
+
+struct ScanParams
+{
+    const uint32_t* input;
+    uint32_t* output;
+};
+
+// Inclusive prefix sum over each group (Hillis-Steele), with a barrier between every step.
+static void prefixSumThread(TestThreadGroup* group, uint32_t threadIndex)
+{
+    auto params = static_cast<ScanParams*>(group->params);
+    uint32_t* shared = group->getSharedMemory();
+    uint32_t globalIndex = group->groupIndex * kGroupSize + threadIndex;
+
+    shared[threadIndex] = params->input[globalIndex];
+    group->scheduler->barrier();
+    for (uint32_t offset = 1; offset < kGroupSize; offset *= 2)
+    {
+        uint32_t value = threadIndex >= offset ? shared[threadIndex - offset] : 0;
+        group->scheduler->barrier();
+        shared[threadIndex] += value;
+        group->scheduler->barrier();
+    }
+    params->output[globalIndex] = shared[threadIndex];
+}
+
+// Threads of the upper half return early, the lower half keeps synchronizing.
+static void divergentThread(TestThreadGroup* group, uint32_t threadIndex)
+{
+    auto counts = static_cast<uint32_t*>(group->params);
+    if (threadIndex >= kGroupSize / 2)
+        return;
+    for (int i = 0; i < 4; i++)
+    {
+        counts[threadIndex]++;
+        group->scheduler->barrier();
+    }
+}
+
+TEST_CASE("cpu-fiber")
+{
+    ThreadGroupScheduler scheduler(kGroupSize, kGroupSize * sizeof(uint32_t));
+    CHECK(scheduler.getThreadCount() == kGroupSize);
+    REQUIRE(scheduler.getGroupSharedMemory() != nullptr);
+
+    // Threads run in order up to the barrier before any thread continues past it.
+    {
+        struct OrderState
+        {
+            ThreadGroupScheduler* scheduler;
+            std::vector<uint32_t> order;
+        } state = {&scheduler, {}};
+        scheduler.run(
+            [](void* userData, uint32_t threadIndex)
+            {
+                auto state = static_cast<OrderState*>(userData);
+                state->order.push_back(threadIndex);
+                state->scheduler->barrier();
+                state->order.push_back(kGroupSize + threadIndex);
+            },
+            &state
+        );
+        REQUIRE(state.order.size() == 2 * kGroupSize);
+        for (uint32_t i = 0; i < 2 * kGroupSize; i++)
+            CHECK(state.order[i] == i);
+    }
+
+    // Prefix sums over several groups reuse the fibers and the groupshared memory.
+    {
+        const uint32_t kGroupCount = 16;
+        std::vector<uint32_t> input(kGroupCount * kGroupSize);
+        for (uint32_t i = 0; i < input.size(); i++)
+            input[i] = (i * 7) % 13;
+        std::vector<uint32_t> output(input.size());
+        ScanParams params = {input.data(), output.data()};
+        TestThreadGroup group;
+        group.run(scheduler, prefixSumThread, &params, kGroupCount);
+
+        for (uint32_t groupIndex = 0; groupIndex < kGroupCount; groupIndex++)
+        {
+            uint32_t sum = 0;
+            for (uint32_t i = 0; i < kGroupSize; i++)
+            {
+                sum += input[groupIndex * kGroupSize + i];
+                CHECK(output[groupIndex * kGroupSize + i] == sum);
+            }
+        }
+    }
+
+    // Barriers in divergent control flow do not deadlock.
+    {
+        std::vector<uint32_t> counts(kGroupSize, 0);
+        TestThreadGroup group;
+        group.run(scheduler, divergentThread, counts.data(), 2);
+        for (uint32_t i = 0; i < kGroupSize; i++)
+            CHECK(counts[i] == (i < kGroupSize / 2 ? 8 : 0));
+    }
+}
+
+TEST_CASE("cpu-fiber-benchmark" * doctest::skip())
+{
+    const uint32_t kGroupCount = 1000;
+    ThreadGroupScheduler scheduler(256, 0);
+
+    struct BarrierParams
+    {
+        ThreadGroupScheduler* scheduler;
+        uint32_t barrierCount;
+    } barrierParams = {&scheduler, 16};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < kGroupCount; i++)
+    {
+        scheduler.run(
+            [](void* userData, uint32_t)
+            {
+                auto barrierParams = static_cast<BarrierParams*>(userData);
+                for (uint32_t j = 0; j < barrierParams->barrierCount; j++)
+                    barrierParams->scheduler->barrier();
+            },
+            &barrierParams
+        );
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    double switchCount = double(kGroupCount) * 256 * (barrierParams.barrierCount + 1);
+    MESSAGE("fiber switch: ", seconds * 1e9 / switchCount, " ns");
+    CHECK(seconds > 0.0);
+}
@@ -0,0 +1,135 @@
+#include "testing.h"
+
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static const char* kLoadFloatShaderSource = R"(
+    [shader("compute")]
+    [numthreads(2, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID, uniform Texture2D<float4> tex, uniform RWStructuredBuffer<float4> buffer)
+    {
+        buffer[tid.x] = tex.Load(int3(tid.x, 0, 0));
+    }
+)";
+
+static const char* kLoadIntShaderSource = R"(
+    [shader("compute")]
+    [numthreads(2, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID, uniform Texture2D<int4> tex, uniform RWStructuredBuffer<int4> buffer)
+    {
+        buffer[tid.x] = tex.Load(int3(tid.x, 0, 0));
+    }
+)";
+
+struct FormatTestCase
+{
+    Format format;
+    std::vector<uint8_t> data;
+    std::vector<float> expected;
+};
+
+static ComPtr<IBuffer> loadTexels(IDevice* device, ITexture* texture, const char* shaderSource)
+{
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    REQUIRE_CALL(loadComputeProgramFromSource(device, shaderProgram, shaderSource));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = 2 * 4 * sizeof(float);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = 4 * sizeof(float);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopySource;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, nullptr, buffer.writeRef()));
+
+    auto queue = device->getQueue(QueueType::Graphics);
+    auto commandBuffer = transientHeap->createCommandBuffer();
+    auto passEncoder = commandBuffer->beginComputePass();
+    auto rootObject = passEncoder->bindPipeline(pipeline);
+    ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+    entryPointCursor["tex"].setBinding(texture);
+    entryPointCursor["buffer"].setBinding(buffer);
+    passEncoder->dispatchCompute(1, 1, 1);
+    passEncoder->end();
+    commandBuffer->close();
+    queue->submit(commandBuffer);
+    queue->waitOnHost();
+
+    return buffer;
+}
+
+static ComPtr<ITexture> createTexture(IDevice* device, Format format, const std::vector<uint8_t>& data)
+{
+    TextureDesc texDesc = {};
+    texDesc.type = TextureType::Texture2D;
+    texDesc.mipLevelCount = 1;
+    texDesc.size = {2, 1, 1};
+    texDesc.usage = TextureUsage::ShaderResource;
+    texDesc.defaultState = ResourceState::ShaderResource;
+    texDesc.format = format;
+    SubresourceData subData = {data.data(), data.size(), 0};
+    ComPtr<ITexture> texture;
+    REQUIRE_CALL(device->createTexture(texDesc, &subData, texture.writeRef()));
+    return texture;
+}
+
+void testCPUFormats(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    // clang-format off
+    FormatTestCase testCases[] = {
+        {Format::R8G8B8A8_SNORM, {127, 129, 0, 128, 0, 0, 0, 127}, {1, -1, 0, -1, 0, 0, 0, 1}},
+        {Format::B8G8R8A8_UNORM, {255, 0, 0, 255, 0, 0, 255, 0}, {0, 0, 1, 1, 1, 0, 0, 0}},
+        {Format::B8G8R8X8_UNORM, {255, 0, 0, 0, 0, 0, 255, 0}, {0, 0, 1, 1, 1, 0, 0, 1}},
+        {Format::R8G8B8A8_UNORM_SRGB, {0, 255, 0, 255, 0, 0, 0, 0}, {0, 1, 0, 1, 0, 0, 0, 0}},
+        {Format::R16G16_UNORM, {0xff, 0xff, 0, 0, 0, 0, 0xff, 0xff}, {1, 0, 0, 1, 0, 1, 0, 1}},
+        {Format::B5G6R5_UNORM, {0x00, 0xf8, 0x1f, 0x00}, {1, 0, 0, 1, 0, 0, 1, 1}},
+        {Format::R10G10B10A2_UNORM, {0xff, 0x03, 0x00, 0xc0, 0x00, 0x00, 0xf0, 0x3f}, {1, 0, 0, 1, 0, 0, 1, 0}},
+        {Format::R11G11B10_FLOAT, {0xc0, 0x03, 0x20, 0x70, 0, 0, 0, 0}, {1, 2, 0.5f, 1, 0, 0, 0, 1}},
+        {Format::R9G9B9E5_SHAREDEXP, {0x00, 0x01, 0x00, 0x80, 0x00, 0x00, 0x01, 0x80}, {1, 0, 0, 1, 0, 0.5f, 0, 1}},
+    };
+    // clang-format on
+
+    for (auto& testCase : testCases)
+    {
+        CAPTURE(getFormatInfo(testCase.format).name);
+        ComPtr<ITexture> texture = createTexture(device, testCase.format, testCase.data);
+
+        ComPtr<IBuffer> buffer = loadTexels(device, texture, kLoadFloatShaderSource);
+        compareComputeResultFuzzy(
+            device,
+            buffer,
+            testCase.expected.data(),
+            testCase.expected.size() * sizeof(float)
+        );
+
+        // Readback returns the texels in their storage format.
+        compareComputeResult(device, texture, testCase.data.data(), testCase.data.size(), 1);
+    }
+
+    {
+        std::vector<uint8_t> data = {0xff, 5, 0x80, 0x7f};
+        ComPtr<ITexture> texture = createTexture(device, Format::R8G8_SINT, data);
+        ComPtr<IBuffer> buffer = loadTexels(device, texture, kLoadIntShaderSource);
+        compareComputeResult(device, buffer, makeArray<int32_t>(-1, 5, 0, 1, -128, 127, 0, 1));
+    }
+}
+
+TEST_CASE("cpu-formats")
+{
+    runGpuTests(testCPUFormats, {DeviceType::CPU});
+}
@@ -0,0 +1,192 @@
+#include "testing.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static BufferDesc makeBufferDesc(size_t size)
+{
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = size;
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopyDestination |
+                       BufferUsage::CopySource;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    return bufferDesc;
+}
+
+// Adds 1 to each element of `buffer` with the trivial compute kernel.
+static void runTrivialCompute(IDevice* device, IBuffer* buffer)
+{
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-trivial", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    auto queue = device->getQueue(QueueType::Graphics);
+    auto commandBuffer = transientHeap->createCommandBuffer();
+    auto passEncoder = commandBuffer->beginComputePass();
+    auto rootObject = passEncoder->bindPipeline(pipeline);
+    ShaderCursor(rootObject).getPath("buffer").setBinding(buffer);
+    passEncoder->dispatchCompute(1, 1, 1);
+    passEncoder->end();
+    commandBuffer->close();
+    queue->submit(commandBuffer);
+    queue->waitOnHost();
+}
+
+void testCPUHostMemoryBuffer(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    ComPtr<ICPUDevice> cpuDevice;
+    REQUIRE_CALL(device->queryInterface(ICPUDevice::getTypeGuid(), (void**)cpuDevice.writeRef()));
+
+    float data[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    int releaseCount = 0;
+    {
+        ComPtr<IBuffer> buffer;
+        REQUIRE_CALL(cpuDevice->createBufferFromHostMemory(
+            makeBufferDesc(sizeof(data)),
+            data,
+            [](void* userData) { (*static_cast<int*>(userData))++; },
+            &releaseCount,
+            buffer.writeRef()
+        ));
+        CHECK(buffer->getDeviceAddress() == DeviceAddress(data));
+
+        // The kernel writes directly to the host memory.
+        runTrivialCompute(device, buffer);
+        CHECK(data[0] == 1.0f);
+        CHECK(data[3] == 4.0f);
+        compareComputeResult(device, buffer, makeArray<float>(1.0f, 2.0f, 3.0f, 4.0f));
+        CHECK(releaseCount == 0);
+    }
+    CHECK(releaseCount == 1);
+}
+
+TEST_CASE("cpu-host-memory-buffer")
+{
+    runGpuTests(testCPUHostMemoryBuffer, {DeviceType::CPU});
+}
+
+void testCPUFileBuffer(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    ComPtr<ICPUDevice> cpuDevice;
+    REQUIRE_CALL(device->queryInterface(ICPUDevice::getTypeGuid(), (void**)cpuDevice.writeRef()));
+
+    // Place the data behind a header that is not a multiple of the page size.
+    const size_t kHeaderSize = 12;
+    const size_t kValueCount = 4096;
+    std::vector<float> values(kValueCount);
+    for (size_t i = 0; i < kValueCount; i++)
+        values[i] = float(i);
+    std::string path = (std::filesystem::path(getCaseTempDirectory()) / "data.bin").string();
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        REQUIRE(file);
+        char header[kHeaderSize] = {};
+        fwrite(header, 1, kHeaderSize, file);
+        fwrite(values.data(), sizeof(float), kValueCount, file);
+        fclose(file);
+    }
+
+    // Read-only mapping of the rest of the file.
+    BufferDesc readOnlyDesc = makeBufferDesc(0);
+    readOnlyDesc.usage = BufferUsage::ShaderResource | BufferUsage::CopySource;
+    readOnlyDesc.defaultState = ResourceState::ShaderResource;
+    {
+        ComPtr<IBuffer> buffer;
+        REQUIRE_CALL(cpuDevice->createBufferFromFile(
+            readOnlyDesc,
+            path.c_str(),
+            kHeaderSize,
+            FileMappingMode::ReadOnly,
+            buffer.writeRef()
+        ));
+        CHECK(buffer->getDesc().size == kValueCount * sizeof(float));
+        ComPtr<ISlangBlob> blob;
+        REQUIRE_CALL(device->readBuffer(buffer, 0, kValueCount * sizeof(float), blob.writeRef()));
+        CHECK(memcmp(blob->getBufferPointer(), values.data(), kValueCount * sizeof(float)) == 0);
+    }
+
+    // Copy-on-write mapping can be written by kernels without modifying the file.
+    {
+        ComPtr<IBuffer> buffer;
+        REQUIRE_CALL(cpuDevice->createBufferFromFile(
+            makeBufferDesc(4 * sizeof(float)),
+            path.c_str(),
+            kHeaderSize,
+            FileMappingMode::CopyOnWrite,
+            buffer.writeRef()
+        ));
+        runTrivialCompute(device, buffer);
+        compareComputeResult(device, buffer, makeArray<float>(1.0f, 2.0f, 3.0f, 4.0f));
+
+        FILE* file = fopen(path.c_str(), "rb");
+        REQUIRE(file);
+        float fileValues[4] = {};
+        fseek(file, long(kHeaderSize), SEEK_SET);
+        CHECK(fread(fileValues, sizeof(float), 4, file) == 4);
+        fclose(file);
+        CHECK(fileValues[0] == 0.0f);
+        CHECK(fileValues[3] == 3.0f);
+    }
+
+    // Writable usages of read-only mappings are rejected.
+    {
+        ComPtr<IBuffer> buffer;
+        CHECK(
+            cpuDevice->createBufferFromFile(
+                makeBufferDesc(0),
+                path.c_str(),
+                kHeaderSize,
+                FileMappingMode::ReadOnly,
+                buffer.writeRef()
+            ) == SLANG_E_INVALID_ARG
+        );
+        BufferDesc uploadDesc = readOnlyDesc;
+        uploadDesc.memoryType = MemoryType::Upload;
+        CHECK(
+            cpuDevice->createBufferFromFile(
+                uploadDesc,
+                path.c_str(),
+                kHeaderSize,
+                FileMappingMode::ReadOnly,
+                buffer.writeRef()
+            ) == SLANG_E_INVALID_ARG
+        );
+    }
+
+    // Ranges past the end of the file are rejected.
+    {
+        ComPtr<IBuffer> buffer;
+        readOnlyDesc.size = kValueCount * sizeof(float) + 4;
+        CHECK(SLANG_FAILED(cpuDevice->createBufferFromFile(
+            readOnlyDesc,
+            path.c_str(),
+            kHeaderSize,
+            FileMappingMode::ReadOnly,
+            buffer.writeRef()
+        )));
+    }
+}
+
+TEST_CASE("cpu-file-buffer")
+{
+    runGpuTests(testCPUFileBuffer, {DeviceType::CPU});
+}
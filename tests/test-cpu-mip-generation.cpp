@@ -0,0 +1,252 @@
+#include "testing.h"
+#include "texture-utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static ComPtr<ITexture> createTexture(
+    IDevice* device,
+    TextureType type,
+    Extents size,
+    GfxCount arrayLength,
+    GfxCount mipLevelCount,
+    Format format,
+    const SubresourceData* initData
+)
+{
+    TextureDesc textureDesc = {};
+    textureDesc.type = type;
+    textureDesc.size = size;
+    textureDesc.arrayLength = arrayLength;
+    textureDesc.mipLevelCount = mipLevelCount;
+    textureDesc.format = format;
+    textureDesc.usage = TextureUsage::ShaderResource | TextureUsage::CopySource | TextureUsage::CopyDestination;
+    ComPtr<ITexture> texture;
+    REQUIRE_CALL(device->createTexture(textureDesc, initData, texture.writeRef()));
+    return texture;
+}
+
+/// Read back the texels of one mip level and array layer, by copying them into a texture of their own.
+static std::vector<uint8_t> readSubresource(IDevice* device, ITexture* texture, GfxIndex mipLevel, GfxIndex layer)
+{
+    const TextureDesc& desc = texture->getDesc();
+    Extents size = {
+        std::max(desc.size.width >> mipLevel, 1),
+        std::max(desc.size.height >> mipLevel, 1),
+        std::max(desc.size.depth >> mipLevel, 1),
+    };
+    TextureType type = desc.type == TextureType::TextureCube ? TextureType::Texture2D : desc.type;
+    ComPtr<ITexture> dst = createTexture(device, type, size, 1, 1, desc.format, nullptr);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+    auto queue = device->getQueue(QueueType::Graphics);
+    auto commandBuffer = transientHeap->createCommandBuffer();
+    auto passEncoder = commandBuffer->beginResourcePass();
+    passEncoder->copyTexture(dst, {0, 1, 0, 1}, {0, 0, 0}, texture, {mipLevel, 1, layer, 1}, {0, 0, 0}, size);
+    passEncoder->end();
+    commandBuffer->close();
+    queue->submit(commandBuffer);
+    queue->waitOnHost();
+
+    ComPtr<ISlangBlob> blob;
+    Size rowPitch = 0;
+    Size pixelSize = 0;
+    REQUIRE_CALL(device->readTexture(dst, blob.writeRef(), &rowPitch, &pixelSize));
+    const uint8_t* data = (const uint8_t*)blob->getBufferPointer();
+    return std::vector<uint8_t>(data, data + blob->getBufferSize());
+}
+
+void testCPUMipGenerationBox(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    ComPtr<ICPUDevice> cpuDevice;
+    REQUIRE_CALL(device->queryInterface(ICPUDevice::getTypeGuid(), (void**)cpuDevice.writeRef()));
+
+    // Fill every level with the validation pattern, generated levels must replace it.
+    RefPtr<TextureInfo> textureInfo = new TextureInfo();
+    textureInfo->format = Format::R32G32B32A32_FLOAT;
+    textureInfo->textureType = TextureType::Texture2D;
+    textureInfo->extents = {32, 16, 1};
+    textureInfo->mipLevelCount = 6;
+    textureInfo->arrayLayerCount = 2;
+    generateTextureData(textureInfo, getValidationTextureFormat(textureInfo->format));
+    ComPtr<ITexture> texture = createTexture(
+        device,
+        TextureType::Texture2D,
+        textureInfo->extents,
+        textureInfo->arrayLayerCount,
+        textureInfo->mipLevelCount,
+        textureInfo->format,
+        textureInfo->subresourceDatas.data()
+    );
+
+    GenerateMipsDesc generateMipsDesc = {};
+    generateMipsDesc.filter = MipFilter::Box;
+    REQUIRE_CALL(cpuDevice->generateMips(texture, generateMipsDesc));
+
+    for (GfxIndex layer = 0; layer < textureInfo->arrayLayerCount; layer++)
+    {
+        // Reference levels, each averaging 2x2 texels of the previous level.
+        const ValidationTextureData* baseLevel =
+            textureInfo->subresourceObjects[getSubresourceIndex(0, textureInfo->mipLevelCount, layer)];
+        int32_t width = textureInfo->extents.width;
+        int32_t height = textureInfo->extents.height;
+        std::vector<float> expected(baseLevel->extents.width * baseLevel->extents.height * 4);
+        memcpy(expected.data(), baseLevel->textureData, expected.size() * sizeof(float));
+
+        for (GfxIndex mipLevel = 1; mipLevel < textureInfo->mipLevelCount; mipLevel++)
+        {
+            int32_t nextWidth = std::max(width / 2, 1);
+            int32_t nextHeight = std::max(height / 2, 1);
+            std::vector<float> next(nextWidth * nextHeight * 4);
+            for (int32_t y = 0; y < nextHeight; y++)
+            {
+                for (int32_t x = 0; x < nextWidth; x++)
+                {
+                    for (int32_t c = 0; c < 4; c++)
+                    {
+                        float sum = 0.0f;
+                        for (int32_t i = 0; i < 4; i++)
+                        {
+                            int32_t sx = std::min(2 * x + (i & 1), width - 1);
+                            int32_t sy = std::min(2 * y + (i >> 1), height - 1);
+                            sum += expected[(sy * width + sx) * 4 + c];
+                        }
+                        next[(y * nextWidth + x) * 4 + c] = sum * 0.25f;
+                    }
+                }
+            }
+            expected = next;
+            width = nextWidth;
+            height = nextHeight;
+
+            CAPTURE(layer);
+            CAPTURE(mipLevel);
+            std::vector<uint8_t> result = readSubresource(device, texture, mipLevel, layer);
+            REQUIRE(result.size() == expected.size() * sizeof(float));
+            const float* resultTexels = (const float*)result.data();
+            for (size_t i = 0; i < expected.size(); i++)
+                CHECK(resultTexels[i] == doctest::Approx(expected[i]));
+        }
+    }
+}
+
+TEST_CASE("cpu-mip-generation-box")
+{
+    runGpuTests(testCPUMipGenerationBox, {DeviceType::CPU});
+}
+
+void testCPUMipGenerationSrgb(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    ComPtr<ICPUDevice> cpuDevice;
+    REQUIRE_CALL(device->queryInterface(ICPUDevice::getTypeGuid(), (void**)cpuDevice.writeRef()));
+
+    // Black and white checkerboard, which averages to 50% linear intensity.
+    const int32_t kSize = 8;
+    std::vector<uint32_t> texels(kSize * kSize);
+    for (int32_t y = 0; y < kSize; y++)
+        for (int32_t x = 0; x < kSize; x++)
+            texels[y * kSize + x] = (x + y) % 2 ? 0xffffffff : 0xff000000;
+    SubresourceData initData = {texels.data(), kSize * sizeof(uint32_t), kSize * kSize * sizeof(uint32_t)};
+    ComPtr<ITexture> texture = createTexture(
+        device,
+        TextureType::Texture2D,
+        {kSize, kSize, 1},
+        1,
+        2,
+        Format::R8G8B8A8_UNORM_SRGB,
+        &initData
+    );
+    REQUIRE_CALL(cpuDevice->generateMips(texture, {}));
+
+    std::vector<uint8_t> result = readSubresource(device, texture, 1, 0);
+    REQUIRE(result.size() == (kSize / 2) * (kSize / 2) * 4);
+    // Averaging the encoded values would give 128.
+    uint8_t expected = uint8_t(std::lround(255.0 * (1.055 * std::pow(0.5, 1.0 / 2.4) - 0.055)));
+    for (size_t i = 0; i < result.size(); i += 4)
+    {
+        CAPTURE(i);
+        CHECK(std::abs(int(result[i]) - int(expected)) <= 1);
+        CHECK(std::abs(int(result[i + 1]) - int(expected)) <= 1);
+        CHECK(std::abs(int(result[i + 2]) - int(expected)) <= 1);
+        CHECK(result[i + 3] == 255);
+    }
+}
+
+TEST_CASE("cpu-mip-generation-srgb")
+{
+    runGpuTests(testCPUMipGenerationSrgb, {DeviceType::CPU});
+}
+
+void testCPUMipGenerationKaiser(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    ComPtr<ICPUDevice> cpuDevice;
+    REQUIRE_CALL(device->queryInterface(ICPUDevice::getTypeGuid(), (void**)cpuDevice.writeRef()));
+
+    // Each cube face has a constant color, which the normalized filter must preserve.
+    const int32_t kSize = 16;
+    const GfxCount kMipLevelCount = 5;
+    std::vector<std::vector<uint32_t>> faceTexels;
+    std::vector<SubresourceData> initData;
+    for (GfxIndex face = 0; face < 6; face++)
+    {
+        for (GfxIndex mipLevel = 0; mipLevel < kMipLevelCount; mipLevel++)
+        {
+            int32_t size = kSize >> mipLevel;
+            faceTexels.emplace_back(size * size, mipLevel == 0 ? 0xff000000 | (face * 40) : 0);
+        }
+    }
+    for (size_t i = 0; i < faceTexels.size(); i++)
+    {
+        int32_t size = kSize >> (i % kMipLevelCount);
+        initData.push_back({faceTexels[i].data(), size * sizeof(uint32_t), size * size * sizeof(uint32_t)});
+    }
+    ComPtr<ITexture> texture = createTexture(
+        device,
+        TextureType::TextureCube,
+        {kSize, kSize, 1},
+        1,
+        kMipLevelCount,
+        Format::R8G8B8A8_UNORM,
+        initData.data()
+    );
+
+    GenerateMipsDesc generateMipsDesc = {};
+    generateMipsDesc.filter = MipFilter::Kaiser;
+    REQUIRE_CALL(cpuDevice->generateMips(texture, generateMipsDesc));
+
+    for (GfxIndex face = 0; face < 6; face++)
+    {
+        for (GfxIndex mipLevel = 1; mipLevel < kMipLevelCount; mipLevel++)
+        {
+            CAPTURE(face);
+            CAPTURE(mipLevel);
+            std::vector<uint8_t> result = readSubresource(device, texture, mipLevel, face);
+            for (size_t i = 0; i < result.size(); i += 4)
+            {
+                CHECK(result[i] == face * 40);
+                CHECK(result[i + 3] == 255);
+            }
+        }
+    }
+
+    // Integer formats cannot be filtered.
+    ComPtr<ITexture> integerTexture =
+        createTexture(device, TextureType::Texture2D, {4, 4, 1}, 1, 0, Format::R32_UINT, nullptr);
+    CHECK(cpuDevice->generateMips(integerTexture, {}) == SLANG_E_INVALID_ARG);
+}
+
+TEST_CASE("cpu-mip-generation-kaiser")
+{
+    runGpuTests(testCPUMipGenerationKaiser, {DeviceType::CPU});
+}
@@ -0,0 +1,103 @@
+#include "cpu-dispatch-utils.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Records command buffers on several threads, each with its own transient heap, and submits them together.
+// Reports the recording throughput for an increasing number of threads.
+void testCPUDispatchParallelRecording(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, 4);
+
+    ComPtr<IPipeline> pipeline = createComputePipeline(device, kAccumulateShaderSource);
+    const uint32_t kCount = 16;
+    ComPtr<IBuffer> values = createUIntBuffer(device, kCount);
+
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+
+    ShaderOffset valuesOffset;
+    ShaderOffset deltaOffset;
+    {
+        ComPtr<ITransientResourceHeap> transientHeap;
+        REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+        ShaderCursor cursor(passEncoder->bindPipeline(pipeline)->getEntryPoint(0));
+        valuesOffset = cursor["values"].m_offset;
+        deltaOffset = cursor["delta"].m_offset;
+        passEncoder->end();
+    }
+
+    const uint32_t kDispatchCount = 4096;
+    const uint32_t kMaxThreadCount = 4;
+    auto queue = device->getQueue(QueueType::Graphics);
+    uint32_t expected = 0;
+    for (uint32_t threadCount = 1; threadCount <= kMaxThreadCount; threadCount *= 2)
+    {
+        std::vector<ComPtr<ITransientResourceHeap>> transientHeaps(threadCount);
+        for (auto& transientHeap : transientHeaps)
+            REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+        // Each thread records its share of the dispatches into its own command buffer.
+        std::vector<ComPtr<ICommandBuffer>> commandBuffers(threadCount);
+        auto record = [&](uint32_t threadIndex)
+        {
+            ComPtr<ICommandBuffer> commandBuffer;
+            if (SLANG_FAILED(transientHeaps[threadIndex]->createCommandBuffer(commandBuffer.writeRef())))
+                return;
+            auto passEncoder = commandBuffer->beginComputePass();
+            uint32_t delta = threadIndex + 1;
+            for (uint32_t i = 0; i < kDispatchCount / threadCount; i++)
+            {
+                ComPtr<IShaderObject> entryPoint = passEncoder->bindPipeline(pipeline)->getEntryPoint(0);
+                entryPoint->setBinding(valuesOffset, values);
+                entryPoint->setData(deltaOffset, &delta, sizeof(delta));
+                passEncoder->dispatchCompute(1, 1, 1);
+            }
+            passEncoder->end();
+            commandBuffer->close();
+            commandBuffers[threadIndex] = commandBuffer;
+        };
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (uint32_t threadIndex = 1; threadIndex < threadCount; threadIndex++)
+            threads.emplace_back(record, threadIndex);
+        record(0);
+        for (auto& thread : threads)
+            thread.join();
+        auto end = std::chrono::high_resolution_clock::now();
+        double recordTime = std::chrono::duration<double, std::micro>(end - start).count();
+        MESSAGE(threadCount, " recording threads: ", kDispatchCount / recordTime, " dispatches/us");
+
+        // All command buffers are submitted at once and executed in the order they are passed.
+        std::vector<ICommandBuffer*> submitted;
+        for (auto& commandBuffer : commandBuffers)
+        {
+            REQUIRE(commandBuffer);
+            submitted.push_back(commandBuffer.get());
+        }
+        queue->submit((GfxCount)submitted.size(), submitted.data(), nullptr, 0);
+        queue->waitOnHost();
+
+        for (uint32_t threadIndex = 0; threadIndex < threadCount; threadIndex++)
+            expected += (threadIndex + 1) * (kDispatchCount / threadCount);
+        std::vector<uint32_t> result = readUIntBuffer(device, values);
+        for (uint32_t i = 0; i < kCount; i++)
+        {
+            CAPTURE(threadCount);
+            CAPTURE(i);
+            CHECK(result[i] == expected);
+        }
+    }
+}
+
+TEST_CASE("cpu-dispatch-parallel-recording")
+{
+    runGpuTests(testCPUDispatchParallelRecording, {DeviceType::CPU});
+}
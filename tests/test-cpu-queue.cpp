@@ -0,0 +1,193 @@
+#include "cpu-dispatch-utils.h"
+
+#include <chrono>
+#include <future>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static ComPtr<IBuffer> createFloatBuffer(IDevice* device, const float* initialData, size_t count)
+{
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = count * sizeof(float);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopyDestination |
+                       BufferUsage::CopySource;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+    return buffer;
+}
+
+void testCPUQueueFence(GpuTestContext* ctx, DeviceType deviceType)
+{
+    CPUDeviceExtendedDesc cpuExtDesc = {};
+    cpuExtDesc.asynchronousSubmit = true;
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, cpuExtDesc);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-trivial", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    ComPtr<IBuffer> buffer = createFloatBuffer(device, initialData, 4);
+
+    ComPtr<IFence> hostFence;
+    ComPtr<IFence> queueFence;
+    FenceDesc fenceDesc = {};
+    REQUIRE_CALL(device->createFence(fenceDesc, hostFence.writeRef()));
+    REQUIRE_CALL(device->createFence(fenceDesc, queueFence.writeRef()));
+
+    auto queue = device->getQueue(QueueType::Graphics);
+
+    // Block the queue until the host signals `hostFence`.
+    IFence* waitFences[] = {hostFence.get()};
+    uint64_t waitValues[] = {1};
+    REQUIRE_CALL(queue->waitForFenceValuesOnDevice(1, waitFences, waitValues));
+
+    for (uint64_t i = 1; i <= 2; i++)
+    {
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+        auto rootObject = passEncoder->bindPipeline(pipeline);
+        ShaderCursor(rootObject).getPath("buffer").setBinding(buffer);
+        passEncoder->dispatchCompute(1, 1, 1);
+        passEncoder->end();
+        commandBuffer->close();
+        queue->submit(commandBuffer, queueFence, i);
+    }
+
+    // Recorded work must not have started yet.
+    uint64_t value = 0;
+    IFence* queueFences[] = {queueFence.get()};
+    uint64_t queueValues[] = {2};
+    CHECK(device->waitForFences(1, queueFences, queueValues, true, 1000000) == SLANG_E_TIME_OUT);
+    CHECK_CALL(queueFence->getCurrentValue(&value));
+    CHECK(value == 0);
+
+    REQUIRE_CALL(hostFence->setCurrentValue(1));
+    REQUIRE_CALL(device->waitForFences(1, queueFences, queueValues, true, kTimeoutInfinite));
+    CHECK_CALL(queueFence->getCurrentValue(&value));
+    CHECK(value == 2);
+
+    queue->waitOnHost();
+    compareComputeResult(device, buffer, makeArray<float>(2.0f, 3.0f, 4.0f, 5.0f));
+}
+
+TEST_CASE("cpu-queue-fence")
+{
+    runGpuTests(testCPUQueueFence, {DeviceType::CPU});
+}
+
+void testCPUQueueSyncFenceWait(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<IFence> fence;
+    FenceDesc fenceDesc = {};
+    REQUIRE_CALL(device->createFence(fenceDesc, fence.writeRef()));
+
+    // Waiting on the submitting thread could never be satisfied by the same thread signalling the fence.
+    auto queue = device->getQueue(QueueType::Graphics);
+    IFence* waitFences[] = {fence.get()};
+    uint64_t waitValues[] = {1};
+    CHECK(queue->waitForFenceValuesOnDevice(1, waitFences, waitValues) == SLANG_E_NOT_AVAILABLE);
+}
+
+TEST_CASE("cpu-queue-sync-fence-wait")
+{
+    runGpuTests(testCPUQueueSyncFenceWait, {DeviceType::CPU});
+}
+
+// Releases every reference to the device while submitted work is still blocked on a fence. The executed
+// command buffer then holds the last reference and the device must be destroyed once it is released.
+void testCPUQueueReleaseDeviceAfterSubmit(GpuTestContext* ctx, DeviceType deviceType)
+{
+    CPUDeviceExtendedDesc cpuExtDesc = {};
+    cpuExtDesc.asynchronousSubmit = true;
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, cpuExtDesc);
+    ComPtr<ICPUDevice> cpuDevice;
+    REQUIRE_CALL(device->queryInterface(ICPUDevice::getTypeGuid(), (void**)cpuDevice.writeRef()));
+
+    // Reusable command buffers keep their bindings, so the buffer lives as long as the command buffer.
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.flags = ITransientResourceHeap::Flags::ReusableCommandBuffers;
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-trivial", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float data[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    std::promise<void> released;
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(data);
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(cpuDevice->createBufferFromHostMemory(
+        bufferDesc,
+        data,
+        [](void* userData) { static_cast<std::promise<void>*>(userData)->set_value(); },
+        &released,
+        buffer.writeRef()
+    ));
+
+    ComPtr<IFence> hostFence;
+    FenceDesc fenceDesc = {};
+    REQUIRE_CALL(device->createFence(fenceDesc, hostFence.writeRef()));
+
+    ComPtr<ICommandQueue> queue = device->getQueue(QueueType::Graphics);
+    IFence* waitFences[] = {hostFence.get()};
+    uint64_t waitValues[] = {1};
+    REQUIRE_CALL(queue->waitForFenceValuesOnDevice(1, waitFences, waitValues));
+
+    ComPtr<ICommandBuffer> commandBuffer = transientHeap->createCommandBuffer();
+    auto passEncoder = commandBuffer->beginComputePass();
+    auto rootObject = passEncoder->bindPipeline(pipeline);
+    ShaderCursor(rootObject).getPath("buffer").setBinding(buffer);
+    passEncoder->dispatchCompute(1, 1, 1);
+    passEncoder->end();
+    commandBuffer->close();
+    queue->submit(commandBuffer);
+
+    commandBuffer = nullptr;
+    queue = nullptr;
+    buffer = nullptr;
+    pipeline = nullptr;
+    shaderProgram = nullptr;
+    transientHeap = nullptr;
+    device = nullptr;
+
+    REQUIRE_CALL(hostFence->setCurrentValue(1));
+    hostFence = nullptr;
+
+    auto future = released.get_future();
+    REQUIRE(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    CHECK(data[0] == 1.0f);
+    CHECK(data[3] == 4.0f);
+}
+
+TEST_CASE("cpu-queue-release-device-after-submit")
+{
+    runGpuTests(testCPUQueueReleaseDeviceAfterSubmit, {DeviceType::CPU});
+}
@@ -0,0 +1,486 @@
+#include "testing.h"
+
+#include <slang-rhi/acceleration-structure-utils.h>
+
+#define SLANG_PRELUDE_NAMESPACE slang_prelude
+#include "../src/prelude/slang-cpp-types.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+using slang_prelude::IRaytracingAccelerationStructure;
+using slang_prelude::RayDesc;
+using slang_prelude::RayHit;
+
+struct RayTracingScene
+{
+    IDevice* device;
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ComPtr<ICommandQueue> queue;
+
+    void init(IDevice* inDevice)
+    {
+        device = inDevice;
+        queue = device->getQueue(QueueType::Graphics);
+
+        ITransientResourceHeap::Desc transientHeapDesc = {};
+        transientHeapDesc.constantBufferSize = 4096;
+        REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+    }
+
+    ComPtr<IBuffer> createBuffer(const void* data, Size size)
+    {
+        BufferDesc bufferDesc = {};
+        bufferDesc.size = size;
+        bufferDesc.usage = BufferUsage::ShaderResource;
+        bufferDesc.defaultState = ResourceState::ShaderResource;
+        ComPtr<IBuffer> buffer;
+        REQUIRE_CALL(device->createBuffer(bufferDesc, data, buffer.writeRef()));
+        return buffer;
+    }
+
+    ComPtr<IAccelerationStructure> build(const AccelerationStructureBuildDesc& buildDesc)
+    {
+        AccelerationStructureSizes sizes;
+        REQUIRE_CALL(device->getAccelerationStructureSizes(buildDesc, &sizes));
+        AccelerationStructureDesc createDesc = {};
+        createDesc.size = sizes.accelerationStructureSize;
+        ComPtr<IAccelerationStructure> accelerationStructure;
+        REQUIRE_CALL(device->createAccelerationStructure(createDesc, accelerationStructure.writeRef()));
+
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginRayTracingPass();
+        passEncoder
+            ->buildAccelerationStructure(buildDesc, accelerationStructure, nullptr, BufferWithOffset(), 0, nullptr);
+        passEncoder->end();
+        commandBuffer->close();
+        queue->submit(commandBuffer);
+        queue->waitOnHost();
+        return accelerationStructure;
+    }
+
+    ComPtr<IAccelerationStructure> buildTriangles(
+        const std::vector<float>& vertices,
+        const std::vector<uint32_t>& indices
+    )
+    {
+        ComPtr<IBuffer> vertexBuffer = createBuffer(vertices.data(), vertices.size() * sizeof(float));
+        ComPtr<IBuffer> indexBuffer = createBuffer(indices.data(), indices.size() * sizeof(uint32_t));
+
+        AccelerationStructureBuildInputTriangles triangles = {};
+        BufferWithOffset vertexBufferWithOffset = vertexBuffer;
+        triangles.vertexBuffers = &vertexBufferWithOffset;
+        triangles.vertexBufferCount = 1;
+        triangles.vertexFormat = Format::R32G32B32_FLOAT;
+        triangles.vertexCount = GfxCount(vertices.size() / 3);
+        triangles.vertexStride = 3 * sizeof(float);
+        triangles.indexBuffer = indexBuffer;
+        triangles.indexFormat = IndexFormat::UInt32;
+        triangles.indexCount = GfxCount(indices.size());
+        triangles.flags = AccelerationStructureGeometryFlags::Opaque;
+
+        AccelerationStructureBuildDesc buildDesc = {};
+        buildDesc.inputs = &triangles;
+        buildDesc.inputCount = 1;
+        buildDesc.flags = AccelerationStructureBuildFlags::PreferFastTrace;
+        return build(buildDesc);
+    }
+
+    ComPtr<IAccelerationStructure> buildInstances(
+        std::vector<AccelerationStructureInstanceDescGeneric>& genericInstanceDescs
+    )
+    {
+        AccelerationStructureInstanceDescType instanceDescType = getAccelerationStructureInstanceDescType(device);
+        Size instanceDescSize = getAccelerationStructureInstanceDescSize(instanceDescType);
+        GfxCount instanceCount = GfxCount(genericInstanceDescs.size());
+        std::vector<uint8_t> instanceDescs(instanceCount * instanceDescSize);
+        convertAccelerationStructureInstanceDescs(
+            instanceCount,
+            instanceDescType,
+            instanceDescs.data(),
+            instanceDescSize,
+            genericInstanceDescs.data(),
+            sizeof(AccelerationStructureInstanceDescGeneric)
+        );
+        ComPtr<IBuffer> instanceBuffer = createBuffer(instanceDescs.data(), instanceDescs.size());
+
+        AccelerationStructureBuildInputInstances instances = {};
+        instances.instanceBuffer = instanceBuffer;
+        instances.instanceCount = instanceCount;
+        instances.instanceStride = instanceDescSize;
+        AccelerationStructureBuildDesc buildDesc = {};
+        buildDesc.inputs = &instances;
+        buildDesc.inputCount = 1;
+        return build(buildDesc);
+    }
+};
+
+// Kernels reach acceleration structures through the prelude interface stored at their device address.
+static IRaytracingAccelerationStructure* getTraversal(IAccelerationStructure* accelerationStructure)
+{
+    return (IRaytracingAccelerationStructure*)accelerationStructure->getDeviceAddress();
+}
+
+static RayDesc makeRay(float ox, float oy, float oz, float dx, float dy, float dz, float tMax = 1000.f)
+{
+    RayDesc ray;
+    ray.Origin = slang_prelude::float3(ox, oy, oz);
+    ray.TMin = 0.f;
+    ray.Direction = slang_prelude::float3(dx, dy, dz);
+    ray.TMax = tMax;
+    return ray;
+}
+
+static AccelerationStructureInstanceDescGeneric makeInstance(
+    IAccelerationStructure* blas,
+    float tx,
+    uint32_t instanceID,
+    uint32_t instanceMask,
+    uint32_t instanceContributionToHitGroupIndex,
+    AccelerationStructureInstanceFlags flags
+)
+{
+    AccelerationStructureInstanceDescGeneric instanceDesc = {};
+    float transform[] = {1.f, 0.f, 0.f, tx, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+    memcpy(&instanceDesc.transform[0][0], transform, sizeof(transform));
+    instanceDesc.instanceID = instanceID;
+    instanceDesc.instanceMask = instanceMask;
+    instanceDesc.instanceContributionToHitGroupIndex = instanceContributionToHitGroupIndex;
+    instanceDesc.flags = flags;
+    instanceDesc.accelerationStructure = blas->getHandle();
+    return instanceDesc;
+}
+
+void testCPURayTracing(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    CHECK(device->hasFeature("acceleration-structure"));
+
+    RayTracingScene scene;
+    scene.init(device);
+
+    // A grid of quads in the z = 0 plane, facing +z.
+    const uint32_t kGridSize = 16;
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y <= kGridSize; y++)
+    {
+        for (uint32_t x = 0; x <= kGridSize; x++)
+        {
+            vertices.insert(vertices.end(), {float(x), float(y), 0.f});
+        }
+    }
+    for (uint32_t y = 0; y < kGridSize; y++)
+    {
+        for (uint32_t x = 0; x < kGridSize; x++)
+        {
+            uint32_t i = y * (kGridSize + 1) + x;
+            indices.insert(indices.end(), {i, i + 1, i + kGridSize + 1, i + 1, i + kGridSize + 2, i + kGridSize + 1});
+        }
+    }
+    ComPtr<IAccelerationStructure> BLAS = scene.buildTriangles(vertices, indices);
+    IRaytracingAccelerationStructure* blasTraversal = getTraversal(BLAS);
+    REQUIRE(blasTraversal != nullptr);
+
+    // Every quad is hit from above at the expected triangle and barycentrics.
+    for (uint32_t y = 0; y < kGridSize; y++)
+    {
+        for (uint32_t x = 0; x < kGridSize; x++)
+        {
+            CAPTURE(x);
+            CAPTURE(y);
+            uint32_t quad = y * kGridSize + x;
+            RayHit hit;
+            REQUIRE(blasTraversal->TraceRay(makeRay(x + 0.25f, y + 0.25f, 1.f, 0.f, 0.f, -1.f), 0, 0xff, &hit));
+            CHECK(hit.primitiveIndex == 2 * quad);
+            CHECK(hit.geometryIndex == 0);
+            CHECK(hit.t == doctest::Approx(1.f));
+            CHECK(hit.barycentrics.x == doctest::Approx(0.25f));
+            CHECK(hit.barycentrics.y == doctest::Approx(0.25f));
+            CHECK(hit.hitKind == slang_prelude::HIT_KIND_TRIANGLE_FRONT_FACE);
+
+            REQUIRE(blasTraversal->TraceRay(makeRay(x + 0.75f, y + 0.75f, 1.f, 0.f, 0.f, -1.f), 0, 0xff, &hit));
+            CHECK(hit.primitiveIndex == 2 * quad + 1);
+        }
+    }
+
+    // Misses, back faces and ray flags.
+    {
+        RayHit hit;
+        CHECK_FALSE(blasTraversal->TraceRay(makeRay(-1.f, 0.5f, 1.f, 0.f, 0.f, -1.f), 0, 0xff, &hit));
+        CHECK_FALSE(blasTraversal->TraceRay(makeRay(0.5f, 0.5f, 1.f, 0.f, 0.f, 1.f), 0, 0xff, &hit));
+        CHECK_FALSE(blasTraversal->TraceRay(makeRay(0.5f, 0.5f, 1.f, 0.f, 0.f, -1.f, 0.5f), 0, 0xff, &hit));
+
+        RayDesc fromBelow = makeRay(3.25f, 5.25f, -2.f, 0.f, 0.f, 1.f);
+        REQUIRE(blasTraversal->TraceRay(fromBelow, 0, 0xff, &hit));
+        CHECK(hit.t == doctest::Approx(2.f));
+        CHECK(hit.hitKind == slang_prelude::HIT_KIND_TRIANGLE_BACK_FACE);
+        CHECK_FALSE(
+            blasTraversal->TraceRay(fromBelow, slang_prelude::RAY_FLAG_CULL_BACK_FACING_TRIANGLES, 0xff, &hit)
+        );
+        CHECK_FALSE(blasTraversal->TraceRay(fromBelow, slang_prelude::RAY_FLAG_CULL_OPAQUE, 0xff, &hit));
+        CHECK_FALSE(blasTraversal->TraceRay(fromBelow, slang_prelude::RAY_FLAG_SKIP_TRIANGLES, 0xff, &hit));
+
+        // A grazing ray crossing many triangles' bounds hits the nearest triangle first.
+        RayDesc diagonal = makeRay(-0.75f, -1.5f, 1.f, 1.f, 1.f, -0.1f);
+        REQUIRE(blasTraversal->TraceRay(diagonal, 0, 0xff, &hit));
+        CHECK(hit.t == doctest::Approx(10.f));
+        CHECK(blasTraversal->TraceRay(diagonal, slang_prelude::RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH, 0xff, &hit));
+    }
+
+    // Instances with different masks, offsets and flags.
+    {
+        std::vector<AccelerationStructureInstanceDescGeneric> instanceDescs = {
+            makeInstance(BLAS, 0.f, 10, 0x1, 3, AccelerationStructureInstanceFlags::None),
+            makeInstance(BLAS, 100.f, 20, 0x2, 7, AccelerationStructureInstanceFlags::None),
+            makeInstance(BLAS, 200.f, 30, 0x1, 0, AccelerationStructureInstanceFlags::TriangleFrontCounterClockwise),
+            makeInstance(BLAS, 300.f, 40, 0x1, 0, AccelerationStructureInstanceFlags::TriangleFacingCullDisable),
+        };
+        ComPtr<IAccelerationStructure> TLAS = scene.buildInstances(instanceDescs);
+        IRaytracingAccelerationStructure* tlasTraversal = getTraversal(TLAS);
+
+        RayHit hit;
+        REQUIRE(tlasTraversal->TraceRay(makeRay(1.25f, 1.25f, 1.f, 0.f, 0.f, -1.f), 0, 0xff, &hit));
+        CHECK(hit.instanceIndex == 0);
+        CHECK(hit.instanceID == 10);
+        CHECK(hit.instanceContributionToHitGroupIndex == 3);
+        CHECK(hit.primitiveIndex == 2 * (kGridSize + 1));
+
+        REQUIRE(tlasTraversal->TraceRay(makeRay(101.25f, 1.25f, 1.f, 0.f, 0.f, -1.f), 0, 0xff, &hit));
+        CHECK(hit.instanceIndex == 1);
+        CHECK(hit.instanceID == 20);
+        CHECK(hit.instanceContributionToHitGroupIndex == 7);
+        CHECK(hit.objectRayOrigin.x == doctest::Approx(1.25f));
+        CHECK(hit.objectToWorld[0][3] == 100.f);
+        CHECK(hit.worldToObject[0][3] == doctest::Approx(-100.f));
+        CHECK_FALSE(tlasTraversal->TraceRay(makeRay(101.25f, 1.25f, 1.f, 0.f, 0.f, -1.f), 0, 0x1, &hit));
+
+        REQUIRE(tlasTraversal->TraceRay(makeRay(201.25f, 1.25f, 1.f, 0.f, 0.f, -1.f), 0, 0xff, &hit));
+        CHECK(hit.hitKind == slang_prelude::HIT_KIND_TRIANGLE_BACK_FACE);
+
+        RayDesc fromBelow = makeRay(301.25f, 1.25f, -1.f, 0.f, 0.f, 1.f);
+        CHECK(tlasTraversal->TraceRay(fromBelow, slang_prelude::RAY_FLAG_CULL_BACK_FACING_TRIANGLES, 0xff, &hit));
+        CHECK(hit.instanceID == 40);
+
+        CHECK_FALSE(tlasTraversal->TraceRay(makeRay(50.f, 1.25f, 1.f, 0.f, 0.f, -1.f), 0, 0xff, &hit));
+    }
+
+    // Procedural primitives are hit where the ray enters their bounds.
+    {
+        std::vector<AccelerationStructureAABB> aabbs;
+        for (uint32_t i = 0; i < 100; i++)
+            aabbs.push_back({float(i), 0.f, 0.f, float(i) + 0.5f, 1.f, 1.f});
+        ComPtr<IBuffer> aabbBuffer =
+            scene.createBuffer(aabbs.data(), aabbs.size() * sizeof(AccelerationStructureAABB));
+
+        AccelerationStructureBuildInputProceduralPrimitives proceduralPrimitives = {};
+        BufferWithOffset aabbBufferWithOffset = aabbBuffer;
+        proceduralPrimitives.aabbBuffers = &aabbBufferWithOffset;
+        proceduralPrimitives.aabbBufferCount = 1;
+        proceduralPrimitives.aabbStride = sizeof(AccelerationStructureAABB);
+        proceduralPrimitives.primitiveCount = GfxCount(aabbs.size());
+        AccelerationStructureBuildDesc buildDesc = {};
+        buildDesc.inputs = &proceduralPrimitives;
+        buildDesc.inputCount = 1;
+        ComPtr<IAccelerationStructure> accelerationStructure = scene.build(buildDesc);
+        IRaytracingAccelerationStructure* traversal = getTraversal(accelerationStructure);
+
+        RayHit hit;
+        REQUIRE(traversal->TraceRay(makeRay(-1.f, 0.5f, 0.5f, 1.f, 0.f, 0.f), 0, 0xff, &hit));
+        CHECK(hit.primitiveIndex == 0);
+        CHECK(hit.t == doctest::Approx(1.f));
+        CHECK(hit.hitKind == 0);
+        REQUIRE(traversal->TraceRay(makeRay(42.25f, 0.5f, -1.f, 0.f, 0.f, 1.f), 0, 0xff, &hit));
+        CHECK(hit.primitiveIndex == 42);
+        CHECK_FALSE(traversal->TraceRay(makeRay(42.75f, 0.5f, -1.f, 0.f, 0.f, 1.f), 0, 0xff, &hit));
+        RayDesc ray = makeRay(-1.f, 0.5f, 0.5f, 1.f, 0.f, 0.f);
+        CHECK_FALSE(traversal->TraceRay(ray, slang_prelude::RAY_FLAG_CULL_NON_OPAQUE, 0xff, &hit));
+    }
+}
+
+TEST_CASE("cpu-ray-tracing")
+{
+    runGpuTests(testCPURayTracing, {DeviceType::CPU});
+}
+
+static const char* kRayQueryShaderSource = R"(
+    [shader("compute")]
+    [numthreads(1, 1, 1)]
+    void computeMain(
+        uint3 tid : SV_DispatchThreadID,
+        uniform RaytracingAccelerationStructure scene,
+        uniform RWStructuredBuffer<float> buffer)
+    {
+        RayDesc ray;
+        ray.Origin = float3(float(tid.x) + 0.5, 0.5, -1.0);
+        ray.Direction = float3(0.0, 0.0, 1.0);
+        ray.TMin = 0.0;
+        ray.TMax = 100.0;
+        RayQuery<RAY_FLAG_NONE> query;
+        query.TraceRayInline(scene, RAY_FLAG_NONE, 0xff, ray);
+        query.Proceed();
+        buffer[tid.x] = query.CommittedStatus() == COMMITTED_TRIANGLE_HIT ? query.CommittedRayT() : -1.0;
+    }
+)";
+
+// The device must only advertise "ray-query" if Slang can compile a RayQuery kernel for it.
+void testCPURayQueryFeature(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    ComPtr<ISlangSharedLibrary> kernelLibrary;
+    Result compileResult = compileHostCallableFromSource(device, kRayQueryShaderSource, kernelLibrary);
+    CHECK(SLANG_SUCCEEDED(compileResult) == device->hasFeature("ray-query"));
+}
+
+TEST_CASE("cpu-ray-query-feature")
+{
+    runGpuTests(testCPURayQueryFeature, {DeviceType::CPU});
+}
+
+// Traces `rayCount` rays generated by `generateRay(index)` on all hardware threads,
+// returns the number of hits and writes the throughput in rays per second.
+template<typename F>
+static uint64_t traceRays(
+    IRaytracingAccelerationStructure* traversal,
+    uint32_t rayCount,
+    const F& generateRay,
+    double& outRaysPerSecond
+)
+{
+    uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<uint64_t> hitCount = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t threadIndex = 0; threadIndex < threadCount; threadIndex++)
+    {
+        threads.emplace_back(
+            [&, threadIndex]()
+            {
+                uint64_t hits = 0;
+                uint32_t begin = uint32_t(uint64_t(rayCount) * threadIndex / threadCount);
+                uint32_t end = uint32_t(uint64_t(rayCount) * (threadIndex + 1) / threadCount);
+                for (uint32_t i = begin; i < end; i++)
+                {
+                    RayHit hit;
+                    if (traversal->TraceRay(generateRay(i), 0, 0xff, &hit))
+                        hits++;
+                }
+                hitCount += hits;
+            }
+        );
+    }
+    for (auto& thread : threads)
+        thread.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    outRaysPerSecond = rayCount / std::chrono::duration<double>(end - start).count();
+    return hitCount;
+}
+
+// Reports rays per second for primary and random rays on an 8x8 grid of tessellated spheres.
+void testCPURayTracingBenchmark(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    RayTracingScene scene;
+    scene.init(device);
+
+    const uint32_t kStacks = 64;
+    const uint32_t kSlices = 128;
+    const float kPi = 3.14159265f;
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i <= kStacks; i++)
+    {
+        float theta = kPi * i / kStacks;
+        for (uint32_t j = 0; j <= kSlices; j++)
+        {
+            float phi = 2.f * kPi * j / kSlices;
+            vertices.insert(
+                vertices.end(),
+                {std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)}
+            );
+        }
+    }
+    for (uint32_t i = 0; i < kStacks; i++)
+    {
+        for (uint32_t j = 0; j < kSlices; j++)
+        {
+            uint32_t v = i * (kSlices + 1) + j;
+            indices.insert(indices.end(), {v, v + kSlices + 1, v + 1, v + 1, v + kSlices + 1, v + kSlices + 2});
+        }
+    }
+    ComPtr<IAccelerationStructure> BLAS = scene.buildTriangles(vertices, indices);
+
+    const uint32_t kInstanceGridSize = 8;
+    const float kSpacing = 3.f;
+    std::vector<AccelerationStructureInstanceDescGeneric> instanceDescs;
+    for (uint32_t y = 0; y < kInstanceGridSize; y++)
+    {
+        for (uint32_t x = 0; x < kInstanceGridSize; x++)
+        {
+            AccelerationStructureInstanceDescGeneric instanceDesc = makeInstance(
+                BLAS,
+                x * kSpacing,
+                y * kInstanceGridSize + x,
+                0xff,
+                0,
+                AccelerationStructureInstanceFlags::None
+            );
+            instanceDesc.transform[1][3] = y * kSpacing;
+            instanceDescs.push_back(instanceDesc);
+        }
+    }
+    ComPtr<IAccelerationStructure> TLAS = scene.buildInstances(instanceDescs);
+    IRaytracingAccelerationStructure* traversal = getTraversal(TLAS);
+
+    const uint32_t kImageSize = 1024;
+    float center = (kInstanceGridSize - 1) * kSpacing * 0.5f;
+    auto primaryRay = [&](uint32_t i)
+    {
+        float u = (float(i % kImageSize) + 0.5f) / kImageSize * 2.f - 1.f;
+        float v = (float(i / kImageSize) + 0.5f) / kImageSize * 2.f - 1.f;
+        return makeRay(center, center, -20.f, u * 0.6f, v * 0.6f, 1.f);
+    };
+    double primaryRaysPerSecond;
+    uint64_t primaryHits = traceRays(traversal, kImageSize * kImageSize, primaryRay, primaryRaysPerSecond);
+    CHECK(primaryHits > 0);
+
+    // Incoherent rays starting inside the scene bounds.
+    const uint32_t kRandomRayCount = 1 << 20;
+    std::vector<RayDesc> randomRays(kRandomRayCount);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-1.f, (kInstanceGridSize - 1) * kSpacing + 1.f);
+    std::normal_distribution<float> direction;
+    for (RayDesc& ray : randomRays)
+    {
+        float ox = position(rng);
+        float oy = position(rng);
+        float oz = position(rng) * 0.1f;
+        ray = makeRay(ox, oy, oz, direction(rng), direction(rng), direction(rng));
+    }
+    double randomRaysPerSecond;
+    uint64_t randomHits =
+        traceRays(traversal, kRandomRayCount, [&](uint32_t i) { return randomRays[i]; }, randomRaysPerSecond);
+    CHECK(randomHits > 0);
+
+    MESSAGE(
+        indices.size() / 3 * instanceDescs.size(),
+        " triangles: primary ",
+        primaryRaysPerSecond / 1e6,
+        " Mrays/s, random ",
+        randomRaysPerSecond / 1e6,
+        " Mrays/s"
+    );
+}
+
+TEST_CASE("cpu-ray-tracing-benchmark" * doctest::skip())
+{
+    runGpuTests(testCPURayTracingBenchmark, {DeviceType::CPU});
+}
@@ -0,0 +1,276 @@
+#include "cpu-dispatch-utils.h"
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static ComPtr<IBuffer> createBuffer(IDevice* device, size_t size, const void* initData = nullptr)
+{
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = size;
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopyDestination |
+                       BufferUsage::CopySource;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, initData, buffer.writeRef()));
+    return buffer;
+}
+
+static ComPtr<ITexture> createTexture(IDevice* device, uint32_t width, uint32_t height, const uint32_t* initData)
+{
+    TextureDesc textureDesc = {};
+    textureDesc.type = TextureType::Texture2D;
+    textureDesc.size = {int32_t(width), int32_t(height), 1};
+    textureDesc.mipLevelCount = 1;
+    textureDesc.format = Format::R32_UINT;
+    textureDesc.usage = TextureUsage::ShaderResource | TextureUsage::CopySource | TextureUsage::CopyDestination;
+    SubresourceData subresourceData = {initData, width * sizeof(uint32_t), width * height * sizeof(uint32_t)};
+    ComPtr<ITexture> texture;
+    REQUIRE_CALL(device->createTexture(textureDesc, initData ? &subresourceData : nullptr, texture.writeRef()));
+    return texture;
+}
+
+static std::vector<uint32_t> readTexels(IDevice* device, ITexture* texture)
+{
+    ComPtr<ISlangBlob> blob;
+    Size rowPitch = 0;
+    Size pixelSize = 0;
+    REQUIRE_CALL(device->readTexture(texture, blob.writeRef(), &rowPitch, &pixelSize));
+    const uint32_t* data = (const uint32_t*)blob->getBufferPointer();
+    return std::vector<uint32_t>(data, data + blob->getBufferSize() / sizeof(uint32_t));
+}
+
+template<typename Func>
+static void record(IDevice* device, Func func)
+{
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+    auto queue = device->getQueue(QueueType::Graphics);
+    auto commandBuffer = transientHeap->createCommandBuffer();
+    auto passEncoder = commandBuffer->beginResourcePass();
+    func(passEncoder);
+    passEncoder->end();
+    commandBuffer->close();
+    queue->submit(commandBuffer);
+    queue->waitOnHost();
+}
+
+void testCPUResourcePass(GpuTestContext* ctx, DeviceType deviceType)
+{
+    // Textures of at least 16x16 texels are tiled, smaller ones are linear.
+    CPUDeviceExtendedDesc cpuExtDesc = {};
+    cpuExtDesc.textureTilingThreshold = 16;
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, cpuExtDesc);
+
+    const uint32_t kSize = 32;
+    std::vector<uint32_t> texels(kSize * kSize);
+    for (uint32_t i = 0; i < texels.size(); i++)
+        texels[i] = i;
+    ComPtr<ITexture> tiledSrc = createTexture(device, kSize, kSize, texels.data());
+    ComPtr<ITexture> tiledDst = createTexture(device, kSize, kSize, nullptr);
+    ComPtr<ITexture> linearDst = createTexture(device, 8, 8, nullptr);
+
+    SubresourceRange subresource = {0, 1, 0, 1};
+    std::vector<uint32_t> upload(5 * 3);
+    for (uint32_t i = 0; i < upload.size(); i++)
+        upload[i] = 1000 + i;
+    SubresourceData uploadData = {upload.data(), 5 * sizeof(uint32_t), upload.size() * sizeof(uint32_t)};
+
+    record(
+        device,
+        [&](IResourcePassEncoder* passEncoder)
+        {
+            ClearValue clearValue = {};
+            clearValue.color.uintValues[0] = 7;
+            passEncoder->clearTexture(tiledDst, clearValue, nullptr, false, false);
+            // Region crossing tile boundaries, between tiled textures.
+            passEncoder->copyTexture(tiledDst, subresource, {3, 5, 0}, tiledSrc, subresource, {6, 2, 0}, {20, 11, 1});
+            // Tiled to linear, with the remaining size of the destination.
+            passEncoder->copyTexture(
+                linearDst,
+                subresource,
+                {0, 0, 0},
+                tiledSrc,
+                subresource,
+                {9, 9, 0},
+                {kRemainingTextureSize, kRemainingTextureSize, 1}
+            );
+            passEncoder->uploadTextureData(tiledDst, subresource, {25, 20, 0}, {5, 3, 1}, &uploadData, 1);
+        }
+    );
+    std::vector<uint32_t> result = readTexels(device, tiledDst);
+    REQUIRE(result.size() == texels.size());
+    for (uint32_t y = 0; y < kSize; y++)
+    {
+        for (uint32_t x = 0; x < kSize; x++)
+        {
+            CAPTURE(x);
+            CAPTURE(y);
+            uint32_t expected = 7;
+            if (x >= 3 && x < 23 && y >= 5 && y < 16)
+                expected = texels[(y - 5 + 2) * kSize + (x - 3 + 6)];
+            if (x >= 25 && x < 30 && y >= 20 && y < 23)
+                expected = 1000 + (y - 20) * 5 + (x - 25);
+            CHECK(result[y * kSize + x] == expected);
+        }
+    }
+
+    result = readTexels(device, linearDst);
+    REQUIRE(result.size() == 64);
+    for (uint32_t y = 0; y < 8; y++)
+        for (uint32_t x = 0; x < 8; x++)
+            CHECK(result[y * 8 + x] == texels[(y + 9) * kSize + (x + 9)]);
+
+    // Buffer clears and query resolves.
+    std::vector<uint8_t> bufferData(1000, 0xff);
+    ComPtr<IBuffer> buffer = createBuffer(device, bufferData.size(), bufferData.data());
+    QueryPoolDesc queryPoolDesc = {};
+    queryPoolDesc.count = 2;
+    queryPoolDesc.type = QueryType::Timestamp;
+    ComPtr<IQueryPool> queryPool;
+    REQUIRE_CALL(device->createQueryPool(queryPoolDesc, queryPool.writeRef()));
+    record(
+        device,
+        [&](IResourcePassEncoder* passEncoder)
+        {
+            BufferRange range = {3, 500};
+            passEncoder->clearBuffer(buffer, &range);
+            passEncoder->writeTimestamp(queryPool, 0);
+            passEncoder->writeTimestamp(queryPool, 1);
+            passEncoder->resolveQuery(queryPool, 0, 2, buffer, 600);
+        }
+    );
+    const uint8_t* data = (const uint8_t*)buffer->getDeviceAddress();
+    for (size_t i = 0; i < 600; i++)
+        CHECK(data[i] == (i >= 3 && i < 503 ? 0 : 0xff));
+    uint64_t timestamps[2];
+    memcpy(timestamps, data + 600, sizeof(timestamps));
+    CHECK(timestamps[1] >= timestamps[0]);
+    CHECK(data[616] == 0xff);
+}
+
+TEST_CASE("cpu-resource-pass")
+{
+    runGpuTests(testCPUResourcePass, {DeviceType::CPU});
+}
+
+static double measureBandwidth(size_t size, int iterations, const std::function<void()>& func)
+{
+    func();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+        func();
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    return double(size) * iterations / seconds * 1e-9;
+}
+
+void testCPUResourcePassBandwidth(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, CPUDeviceExtendedDesc{});
+
+    const size_t kSize = 64 * 1024 * 1024;
+    const int kIterations = 8;
+    std::vector<uint8_t> initData(kSize);
+    for (size_t i = 0; i < kSize; i++)
+        initData[i] = uint8_t(i * 31);
+    ComPtr<IBuffer> src = createBuffer(device, kSize, initData.data());
+    ComPtr<IBuffer> dst = createBuffer(device, kSize);
+    uint8_t* srcData = (uint8_t*)src->getDeviceAddress();
+    uint8_t* dstData = (uint8_t*)dst->getDeviceAddress();
+
+    double memcpyBandwidth = measureBandwidth(kSize, kIterations, [&]() { memcpy(dstData, srcData, kSize); });
+    auto copyBuffer = [&](IResourcePassEncoder* passEncoder) { passEncoder->copyBuffer(dst, 0, src, 0, kSize); };
+    double copyBandwidth = measureBandwidth(kSize, kIterations, [&]() { record(device, copyBuffer); });
+    CHECK(memcmp(dstData, initData.data(), kSize) == 0);
+
+    double memsetBandwidth = measureBandwidth(kSize, kIterations, [&]() { memset(dstData, 0, kSize); });
+    auto clearBuffer = [&](IResourcePassEncoder* passEncoder) { passEncoder->clearBuffer(dst, nullptr); };
+    double clearBandwidth = measureBandwidth(kSize, kIterations, [&]() { record(device, clearBuffer); });
+    CHECK(dstData[0] == 0);
+    CHECK(dstData[kSize / 2 + 1] == 0);
+    CHECK(dstData[kSize - 1] == 0);
+
+    MESSAGE("copyBuffer: ", copyBandwidth, " GB/s, memcpy: ", memcpyBandwidth, " GB/s");
+    MESSAGE("clearBuffer: ", clearBandwidth, " GB/s, memset: ", memsetBandwidth, " GB/s");
+}
+
+TEST_CASE("cpu-resource-pass-bandwidth" * doctest::skip())
+{
+    runGpuTests(testCPUResourcePassBandwidth, {DeviceType::CPU});
+}
+
+void testCPUResourcePassCommandOverhead(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, CPUDeviceExtendedDesc{});
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.flags = ITransientResourceHeap::Flags::ReusableCommandBuffers;
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    // Small commands between a few buffers, so the cost is dominated by recording and replaying the commands.
+    const uint32_t kCommandCount = 100000;
+    const int kIterations = 8;
+    const size_t kBufferSize = 1024;
+    std::vector<ComPtr<IBuffer>> buffers;
+    for (int i = 0; i < 4; i++)
+        buffers.push_back(createBuffer(device, kBufferSize));
+    uint32_t value = 0;
+
+    auto queue = device->getQueue(QueueType::Graphics);
+    auto commandBuffer = transientHeap->createCommandBuffer();
+    auto recordCommands = [&]()
+    {
+        auto passEncoder = commandBuffer->beginResourcePass();
+        for (uint32_t i = 0; i < kCommandCount; i += 4)
+        {
+            value = i;
+            Offset offset = (i / 4) % (kBufferSize / sizeof(uint32_t)) * sizeof(uint32_t);
+            passEncoder->uploadBufferData(buffers[0], offset, sizeof(value), &value);
+            passEncoder->copyBuffer(buffers[1], offset, buffers[0], offset, sizeof(value));
+            BufferRange range = {offset, sizeof(value)};
+            passEncoder->clearBuffer(buffers[2], &range);
+            passEncoder->copyBuffer(buffers[3], offset, buffers[1], offset, sizeof(value));
+        }
+        passEncoder->end();
+        commandBuffer->close();
+    };
+
+    recordCommands();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < kIterations; i++)
+        recordCommands();
+    double recordTime =
+        std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < kIterations; i++)
+        queue->submit(commandBuffer);
+    queue->waitOnHost();
+    double replayTime =
+        std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+    // Each element holds the value of the last upload to it.
+    const uint32_t* data = (const uint32_t*)buffers[3]->getDeviceAddress();
+    const uint32_t kElementCount = kBufferSize / sizeof(uint32_t);
+    for (uint32_t i = 0; i < kElementCount; i++)
+    {
+        uint32_t lastUpload = (kCommandCount / 4 - 1 - i) / kElementCount * kElementCount + i;
+        CHECK(data[i] == lastUpload * 4);
+    }
+
+    MESSAGE("record: ", recordTime / (double(kCommandCount) * kIterations), " ns/command");
+    MESSAGE("replay: ", replayTime / (double(kCommandCount) * kIterations), " ns/command");
+}
+
+TEST_CASE("cpu-resource-pass-command-overhead" * doctest::skip())
+{
+    runGpuTests(testCPUResourcePassCommandOverhead, {DeviceType::CPU});
+}
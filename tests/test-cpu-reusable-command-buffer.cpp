@@ -0,0 +1,75 @@
+#include "cpu-dispatch-utils.h"
+
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Records a command buffer once and submits it several times, patching the root object in between.
+void testCPUDispatchReusableCommandBuffer(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, 4);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.flags = ITransientResourceHeap::Flags::ReusableCommandBuffers;
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IPipeline> pipeline = createComputePipeline(device, kAccumulateShaderSource);
+    const uint32_t kCount = 256;
+    ComPtr<IBuffer> values = createUIntBuffer(device, kCount);
+
+    auto queue = device->getQueue(QueueType::Graphics);
+    auto commandBuffer = transientHeap->createCommandBuffer();
+    auto passEncoder = commandBuffer->beginComputePass();
+    IShaderObject* rootObject = passEncoder->bindPipeline(pipeline);
+    ShaderCursor cursor(rootObject->getEntryPoint(0));
+    cursor["values"].setBinding(values);
+    uint32_t delta = 1;
+    cursor["delta"].setData(&delta, sizeof(delta));
+    passEncoder->dispatchCompute(kCount / 16, 1, 1);
+    passEncoder->end();
+    commandBuffer->close();
+
+    auto checkValues = [&](uint32_t expected)
+    {
+        std::vector<uint32_t> result = readUIntBuffer(device, values);
+        for (uint32_t i = 0; i < kCount; i++)
+        {
+            CAPTURE(i);
+            CHECK(result[i] == expected);
+        }
+    };
+
+    for (int i = 0; i < 3; i++)
+        queue->submit(commandBuffer);
+    queue->waitOnHost();
+    checkValues(3);
+
+    // The recorded commands read the root object when they are executed.
+    delta = 10;
+    cursor["delta"].setData(&delta, sizeof(delta));
+    queue->submit(commandBuffer);
+    queue->submit(commandBuffer);
+    queue->waitOnHost();
+    checkValues(23);
+
+    // Recording again replaces the previous commands.
+    passEncoder = commandBuffer->beginComputePass();
+    cursor = ShaderCursor(passEncoder->bindPipeline(pipeline)->getEntryPoint(0));
+    cursor["values"].setBinding(values);
+    delta = 100;
+    cursor["delta"].setData(&delta, sizeof(delta));
+    passEncoder->dispatchCompute(kCount / 16, 1, 1);
+    passEncoder->end();
+    commandBuffer->close();
+    queue->submit(commandBuffer);
+    queue->waitOnHost();
+    checkValues(123);
+}
+
+TEST_CASE("cpu-dispatch-reusable-command-buffer")
+{
+    runGpuTests(testCPUDispatchReusableCommandBuffer, {DeviceType::CPU});
+}
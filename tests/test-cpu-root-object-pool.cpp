@@ -0,0 +1,84 @@
+#include "cpu-dispatch-utils.h"
+
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Records frames of many small dispatches, each binding the pipeline again. After the first frame,
+// root objects are recycled from the transient heap instead of being created for every dispatch.
+void testCPUDispatchRootObjectPool(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, 1);
+    ComPtr<IImmediateDevice> immediateDevice;
+    REQUIRE_CALL(device->queryInterface(IImmediateDevice::getTypeGuid(), (void**)immediateDevice.writeRef()));
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IPipeline> pipeline = createComputePipeline(device, kAccumulateShaderSource);
+    const uint32_t kCount = 16;
+    ComPtr<IBuffer> values = createUIntBuffer(device, kCount);
+
+    // Parameter offsets are looked up once, outside of the recorded frames.
+    ShaderOffset valuesOffset;
+    ShaderOffset deltaOffset;
+    {
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+        ShaderCursor cursor(passEncoder->bindPipeline(pipeline)->getEntryPoint(0));
+        valuesOffset = cursor["values"].m_offset;
+        deltaOffset = cursor["delta"].m_offset;
+        passEncoder->end();
+    }
+
+    const uint32_t kDispatchCount = 256;
+    const uint32_t kFrameCount = 4;
+    auto queue = device->getQueue(QueueType::Graphics);
+    std::vector<uint64_t> frameCreatedCounts;
+    for (uint32_t frame = 0; frame < kFrameCount; frame++)
+    {
+        CommandStats statsBefore;
+        REQUIRE_CALL(immediateDevice->getCommandStats(&statsBefore));
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+        for (uint32_t i = 0; i < kDispatchCount; i++)
+        {
+            ComPtr<IShaderObject> entryPoint = passEncoder->bindPipeline(pipeline)->getEntryPoint(0);
+            entryPoint->setBinding(valuesOffset, values);
+            uint32_t delta = 1;
+            entryPoint->setData(deltaOffset, &delta, sizeof(delta));
+            passEncoder->dispatchCompute(1, 1, 1);
+        }
+        passEncoder->end();
+        commandBuffer->close();
+        CommandStats stats;
+        REQUIRE_CALL(immediateDevice->getCommandStats(&stats));
+        frameCreatedCounts.push_back(stats.createdRootObjectCount - statsBefore.createdRootObjectCount);
+        queue->submit(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    // Every dispatch of the first frame holds its own root object until the command buffer is released, only the
+    // one bound for the offset lookup can be recycled. Later frames recycle the objects of the previous frame.
+    CHECK(frameCreatedCounts[0] == kDispatchCount - 1);
+    for (uint32_t frame = 1; frame < kFrameCount; frame++)
+    {
+        CAPTURE(frame);
+        CHECK(frameCreatedCounts[frame] == 0);
+    }
+
+    std::vector<uint32_t> result = readUIntBuffer(device, values);
+    for (uint32_t i = 0; i < kCount; i++)
+    {
+        CAPTURE(i);
+        CHECK(result[i] == kFrameCount * kDispatchCount);
+    }
+}
+
+TEST_CASE("cpu-dispatch-root-object-pool")
+{
+    runGpuTests(testCPUDispatchRootObjectPool, {DeviceType::CPU});
+}
@@ -0,0 +1,106 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static const char* kSamplerShaderSource = R"(
+    [shader("compute")]
+    [numthreads(1, 1, 1)]
+    void computeMain(
+        uniform Texture2D<float> tex,
+        uniform SamplerState linearSampler,
+        uniform SamplerState borderSampler,
+        uniform RWStructuredBuffer<float> buffer)
+    {
+        buffer[0] = tex.SampleLevel(linearSampler, float2(0.5, 0.5), 0);
+        buffer[1] = tex.SampleLevel(linearSampler, float2(0.25, 0.25), 0);
+        buffer[2] = tex.SampleLevel(linearSampler, float2(0.0, 0.25), 0);
+        buffer[3] = tex.SampleLevel(linearSampler, float2(0.5, 0.5), 1);
+        buffer[4] = tex.SampleLevel(linearSampler, float2(0.5, 0.5), 0.5);
+        buffer[5] = tex.SampleLevel(borderSampler, float2(0.75, 0.25), 0);
+        buffer[6] = tex.SampleLevel(borderSampler, float2(1.5, 0.25), 0);
+    }
+)";
+
+void testCPUSampler(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    REQUIRE_CALL(loadComputeProgramFromSource(device, shaderProgram, kSamplerShaderSource));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float mip0Data[] = {1.0f, 2.0f, 3.0f, 4.0f};
+    float mip1Data[] = {10.0f};
+    SubresourceData subData[] = {{mip0Data, 8, 0}, {mip1Data, 4, 0}};
+
+    TextureDesc texDesc = {};
+    texDesc.type = TextureType::Texture2D;
+    texDesc.mipLevelCount = 2;
+    texDesc.size = {2, 2, 1};
+    texDesc.usage = TextureUsage::ShaderResource;
+    texDesc.defaultState = ResourceState::ShaderResource;
+    texDesc.format = Format::R32_FLOAT;
+    ComPtr<ITexture> texture;
+    REQUIRE_CALL(device->createTexture(texDesc, subData, texture.writeRef()));
+
+    SamplerDesc linearSamplerDesc = {};
+    ComPtr<ISampler> linearSampler;
+    REQUIRE_CALL(device->createSampler(linearSamplerDesc, linearSampler.writeRef()));
+
+    SamplerDesc borderSamplerDesc = {};
+    borderSamplerDesc.minFilter = TextureFilteringMode::Point;
+    borderSamplerDesc.magFilter = TextureFilteringMode::Point;
+    borderSamplerDesc.mipFilter = TextureFilteringMode::Point;
+    borderSamplerDesc.addressU = TextureAddressingMode::ClampToBorder;
+    borderSamplerDesc.addressV = TextureAddressingMode::ClampToBorder;
+    borderSamplerDesc.borderColor[0] = 5.0f;
+    ComPtr<ISampler> borderSampler;
+    REQUIRE_CALL(device->createSampler(borderSamplerDesc, borderSampler.writeRef()));
+
+    float initialData[7] = {};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopyDestination |
+                       BufferUsage::CopySource;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+
+    {
+        auto queue = device->getQueue(QueueType::Graphics);
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+        auto rootObject = passEncoder->bindPipeline(pipeline);
+        ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+        entryPointCursor["tex"].setBinding(texture);
+        entryPointCursor["linearSampler"].setBinding(linearSampler);
+        entryPointCursor["borderSampler"].setBinding(borderSampler);
+        entryPointCursor["buffer"].setBinding(buffer);
+        passEncoder->dispatchCompute(1, 1, 1);
+        passEncoder->end();
+        commandBuffer->close();
+        queue->submit(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    // Bilinear filtering, texel centers, wrap addressing, mip selection, trilinear filtering and border color.
+    compareComputeResult(device, buffer, makeArray<float>(2.5f, 1.0f, 1.5f, 10.0f, 6.25f, 2.0f, 5.0f));
+}
+
+TEST_CASE("cpu-sampler")
+{
+    runGpuTests(testCPUSampler, {DeviceType::CPU});
+}
@@ -0,0 +1,172 @@
+#include "cpu-dispatch-utils.h"
+
+#include <chrono>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+// Submits a command buffer dispatching a pipeline specialized for an existential parameter several times.
+// The specialized pipeline is reused while the bound transformer is unchanged and must be replaced once a
+// transformer of another type is set.
+void testCPUDispatchSpecializationCache(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, 1);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.flags = ITransientResourceHeap::Flags::ReusableCommandBuffers;
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-smoke", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopyDestination |
+                       BufferUsage::CopySource;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+
+    auto createTransformer = [&](const char* typeName, float c)
+    {
+        ComPtr<IShaderObject> transformer;
+        REQUIRE_CALL(device->createShaderObject(
+            slangReflection->findTypeByName(typeName),
+            ShaderObjectContainerType::None,
+            transformer.writeRef()
+        ));
+        ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+        return transformer;
+    };
+    ComPtr<IShaderObject> addTransformer = createTransformer("AddTransformer", 1.0f);
+    ComPtr<IShaderObject> mulTransformer = createTransformer("MulTransformer", 2.0f);
+
+    auto queue = device->getQueue(QueueType::Graphics);
+    auto commandBuffer = transientHeap->createCommandBuffer();
+    auto passEncoder = commandBuffer->beginComputePass();
+    ShaderCursor entryPointCursor(passEncoder->bindPipeline(pipeline)->getEntryPoint(0));
+    entryPointCursor.getPath("buffer").setBinding(buffer);
+    entryPointCursor.getPath("transformer").setObject(addTransformer);
+    passEncoder->dispatchCompute(1, 1, 1);
+    passEncoder->end();
+    commandBuffer->close();
+
+    // The first submission specializes the pipeline, the second one reuses it.
+    queue->submit(commandBuffer);
+    queue->submit(commandBuffer);
+    queue->waitOnHost();
+    compareComputeResult(device, buffer, makeArray<float>(22.0f, 23.0f, 24.0f, 25.0f));
+
+    entryPointCursor.getPath("transformer").setObject(mulTransformer);
+    queue->submit(commandBuffer);
+    queue->waitOnHost();
+    compareComputeResult(device, buffer, makeArray<float>(44.0f, 46.0f, 48.0f, 50.0f));
+
+    entryPointCursor.getPath("transformer").setObject(addTransformer);
+    const uint32_t kSubmitCount = 1000;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < kSubmitCount; i++)
+        queue->submit(commandBuffer);
+    queue->waitOnHost();
+    auto end = std::chrono::high_resolution_clock::now();
+    MESSAGE(
+        "specialized dispatch: ",
+        std::chrono::duration<double, std::micro>(end - start).count() / kSubmitCount,
+        " us"
+    );
+    float expected = 11.0f * kSubmitCount;
+    compareComputeResult(
+        device,
+        buffer,
+        makeArray<float>(expected + 44.0f, expected + 46.0f, expected + 48.0f, expected + 50.0f)
+    );
+}
+
+TEST_CASE("cpu-dispatch-specialization-cache")
+{
+    runGpuTests(testCPUDispatchSpecializationCache, {DeviceType::CPU});
+}
+
+// Records a frame per transformer, alternating between two types. Root objects are recycled between frames and
+// keep their cached specialization, which must not be reused once a transformer of another type is bound.
+void testCPUDispatchSpecializationCacheRecycledRoot(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, 1);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    slang::ProgramLayout* slangReflection;
+    REQUIRE_CALL(loadComputeProgram(device, shaderProgram, "test-compute-smoke", "computeMain", slangReflection));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    float initialData[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = sizeof(initialData);
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopyDestination |
+                       BufferUsage::CopySource;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, (void*)initialData, buffer.writeRef()));
+
+    auto createTransformer = [&](const char* typeName, float c)
+    {
+        ComPtr<IShaderObject> transformer;
+        REQUIRE_CALL(device->createShaderObject(
+            slangReflection->findTypeByName(typeName),
+            ShaderObjectContainerType::None,
+            transformer.writeRef()
+        ));
+        ShaderCursor(transformer).getPath("c").setData(&c, sizeof(float));
+        return transformer;
+    };
+    ComPtr<IShaderObject> transformers[] = {
+        createTransformer("AddTransformer", 1.0f),
+        createTransformer("MulTransformer", 2.0f),
+    };
+
+    auto queue = device->getQueue(QueueType::Graphics);
+    float expected[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    for (uint32_t frame = 0; frame < 4; frame++)
+    {
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+        ShaderCursor entryPointCursor(passEncoder->bindPipeline(pipeline)->getEntryPoint(0));
+        entryPointCursor.getPath("buffer").setBinding(buffer);
+        entryPointCursor.getPath("transformer").setObject(transformers[frame % 2]);
+        passEncoder->dispatchCompute(1, 1, 1);
+        passEncoder->end();
+        commandBuffer->close();
+        queue->submit(commandBuffer);
+        queue->waitOnHost();
+
+        for (float& value : expected)
+            value = frame % 2 == 0 ? value + 11.0f : value * 2.0f;
+        CAPTURE(frame);
+        compareComputeResult(device, buffer, makeArray<float>(expected[0], expected[1], expected[2], expected[3]));
+    }
+}
+
+TEST_CASE("cpu-dispatch-specialization-cache-recycled-root")
+{
+    runGpuTests(testCPUDispatchSpecializationCacheRecycledRoot, {DeviceType::CPU});
+}
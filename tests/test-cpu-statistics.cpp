@@ -0,0 +1,107 @@
+#include "cpu-dispatch-utils.h"
+
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+void testCPUDispatchStatistics(GpuTestContext* ctx, DeviceType deviceType)
+{
+    const uint32_t kThreadCount = 4;
+    ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, kThreadCount);
+
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IPipeline> pipeline = createComputePipeline(device, kCullShaderSource);
+    const uint32_t kCount = 1000;
+    const uint32_t kGroupCount = (kCount + 15) / 16;
+    ComPtr<IBuffer> survivors = createUIntBuffer(device, kCount);
+    ComPtr<IBuffer> counter = createUIntBuffer(device, 1);
+    ComPtr<IBuffer> results = createUIntBuffer(device, 4);
+
+    QueryType queryTypes[] = {
+        QueryType::ComputeShaderInvocations,
+        QueryType::ComputeThreadGroups,
+        QueryType::ComputeDispatchTime,
+        QueryType::WorkerBusyTime,
+        QueryType::WorkerIdleTime,
+    };
+    std::vector<ComPtr<IQueryPool>> queryPools;
+    for (QueryType queryType : queryTypes)
+    {
+        QueryPoolDesc queryPoolDesc = {};
+        queryPoolDesc.type = queryType;
+        queryPoolDesc.count = 2 * kThreadCount;
+        ComPtr<IQueryPool> queryPool;
+        REQUIRE_CALL(device->createQueryPool(queryPoolDesc, queryPool.writeRef()));
+        queryPools.push_back(queryPool);
+    }
+
+    {
+        auto queue = device->getQueue(QueueType::Graphics);
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+        ShaderCursor cursor(passEncoder->bindPipeline(pipeline)->getEntryPoint(0));
+        cursor["survivors"].setBinding(survivors);
+        cursor["counter"].setBinding(counter);
+        cursor["count"].setData(&kCount, sizeof(kCount));
+        for (auto& queryPool : queryPools)
+            passEncoder->writeTimestamp(queryPool, 0);
+        passEncoder->dispatchCompute(kGroupCount, 1, 1);
+        for (auto& queryPool : queryPools)
+            passEncoder->writeTimestamp(queryPool, kThreadCount);
+        passEncoder->end();
+        auto resourcePassEncoder = commandBuffer->beginResourcePass();
+        resourcePassEncoder->resolveQuery(queryPools[0], 0, 1, results, 0);
+        resourcePassEncoder->resolveQuery(queryPools[0], kThreadCount, 1, results, sizeof(uint64_t));
+        resourcePassEncoder->end();
+        commandBuffer->close();
+        queue->submit(commandBuffer);
+        queue->waitOnHost();
+    }
+
+    std::vector<uint64_t> values[std::size(queryTypes)];
+    for (size_t i = 0; i < std::size(queryTypes); i++)
+    {
+        values[i].resize(2 * kThreadCount);
+        REQUIRE_CALL(queryPools[i]->getResult(0, 2 * kThreadCount, values[i].data()));
+    }
+    // Ranges past the end of the pool are rejected.
+    CHECK(queryPools[0]->getResult(1, 2 * kThreadCount, values[0].data()) == SLANG_E_INVALID_ARG);
+
+    CHECK(values[0][kThreadCount] - values[0][0] == kGroupCount * 16);
+    CHECK(values[1][kThreadCount] - values[1][0] == kGroupCount);
+    CHECK(values[2][kThreadCount] > values[2][0]);
+    uint64_t busyTime = 0;
+    for (uint32_t i = 0; i < kThreadCount; i++)
+    {
+        CAPTURE(i);
+        CHECK(values[3][kThreadCount + i] >= values[3][i]);
+        CHECK(values[4][kThreadCount + i] >= values[4][i]);
+        busyTime += values[3][kThreadCount + i] - values[3][i];
+    }
+    CHECK(busyTime > 0);
+
+    // Resolved statistics match the results read back on the host.
+    std::vector<uint32_t> resolved = readUIntBuffer(device, results);
+    uint64_t resolvedInvocations[2];
+    memcpy(resolvedInvocations, resolved.data(), sizeof(resolvedInvocations));
+    CHECK(resolvedInvocations[0] == values[0][0]);
+    CHECK(resolvedInvocations[1] == values[0][kThreadCount]);
+
+    MESSAGE("dispatch time: ", values[2][kThreadCount] - values[2][0], " ns");
+    for (uint32_t i = 0; i < kThreadCount; i++)
+    {
+        uint64_t busy = values[3][kThreadCount + i] - values[3][i];
+        uint64_t idle = values[4][kThreadCount + i] - values[4][i];
+        MESSAGE("worker ", i, " busy: ", busy, " ns, idle: ", idle, " ns");
+    }
+}
+
+TEST_CASE("cpu-dispatch-statistics")
+{
+    runGpuTests(testCPUDispatchStatistics, {DeviceType::CPU});
+}
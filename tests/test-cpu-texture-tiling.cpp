@@ -0,0 +1,193 @@
+#include "cpu-dispatch-utils.h"
+
+#include <chrono>
+#include <vector>
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static const char* kCopyShaderSource = R"(
+    [shader("compute")]
+    [numthreads(4, 4, 4)]
+    void computeMain(uint3 tid : SV_DispatchThreadID, uniform Texture3D<float> tex, uniform RWStructuredBuffer<float> buffer, uniform uint3 size)
+    {
+        if (any(tid >= size))
+            return;
+        buffer[(tid.z * size.y + tid.y) * size.x + tid.x] = tex.Load(int4(tid, 0));
+    }
+)";
+
+// 5x5 box filter, each texel reads a neighbourhood spanning several rows.
+static const char* kStencilShaderSource = R"(
+    [shader("compute")]
+    [numthreads(8, 8, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID, uniform Texture2D<float> tex, uniform RWStructuredBuffer<float> buffer, uniform uint3 size)
+    {
+        if (any(tid.xy >= size.xy))
+            return;
+        int2 maxCoord = int2(size.xy) - 1;
+        float sum = 0;
+        for (int dy = -2; dy <= 2; dy++)
+            for (int dx = -2; dx <= 2; dx++)
+                sum += tex.Load(int3(clamp(int2(tid.xy) + int2(dx, dy), int2(0), maxCoord), 0));
+        buffer[tid.y * size.x + tid.x] = sum;
+    }
+)";
+
+static ComPtr<ITexture> createFloatTexture(IDevice* device, TextureType type, Extents size, const float* data)
+{
+    TextureDesc texDesc = {};
+    texDesc.type = type;
+    texDesc.mipLevelCount = 1;
+    texDesc.size = size;
+    texDesc.usage = TextureUsage::ShaderResource;
+    texDesc.defaultState = ResourceState::ShaderResource;
+    texDesc.format = Format::R32_FLOAT;
+    SubresourceData subData = {data, size.width * sizeof(float), size.width * size.height * sizeof(float)};
+    ComPtr<ITexture> texture;
+    REQUIRE_CALL(device->createTexture(texDesc, &subData, texture.writeRef()));
+    return texture;
+}
+
+// Runs a kernel writing one float per texel and returns the elapsed time in milliseconds.
+// The kernel is run once before timing so that kernel compilation is not included.
+static double runKernel(
+    IDevice* device,
+    const char* shaderSource,
+    ITexture* texture,
+    const uint32_t size[3],
+    const uint32_t groupSize[3],
+    std::vector<float>& outResult
+)
+{
+    ComPtr<ITransientResourceHeap> transientHeap;
+    ITransientResourceHeap::Desc transientHeapDesc = {};
+    transientHeapDesc.constantBufferSize = 4096;
+    REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+    ComPtr<IShaderProgram> shaderProgram;
+    REQUIRE_CALL(loadComputeProgramFromSource(device, shaderProgram, shaderSource));
+
+    ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.program = shaderProgram.get();
+    ComPtr<IPipeline> pipeline;
+    REQUIRE_CALL(device->createComputePipeline(pipelineDesc, pipeline.writeRef()));
+
+    size_t elementCount = size_t(size[0]) * size[1] * size[2];
+    BufferDesc bufferDesc = {};
+    bufferDesc.size = elementCount * sizeof(float);
+    bufferDesc.format = Format::Unknown;
+    bufferDesc.elementSize = sizeof(float);
+    bufferDesc.usage = BufferUsage::ShaderResource | BufferUsage::UnorderedAccess | BufferUsage::CopySource;
+    bufferDesc.defaultState = ResourceState::UnorderedAccess;
+    bufferDesc.memoryType = MemoryType::DeviceLocal;
+    ComPtr<IBuffer> buffer;
+    REQUIRE_CALL(device->createBuffer(bufferDesc, nullptr, buffer.writeRef()));
+
+    auto queue = device->getQueue(QueueType::Graphics);
+    auto run = [&]()
+    {
+        auto commandBuffer = transientHeap->createCommandBuffer();
+        auto passEncoder = commandBuffer->beginComputePass();
+        auto rootObject = passEncoder->bindPipeline(pipeline);
+        ShaderCursor entryPointCursor(rootObject->getEntryPoint(0));
+        entryPointCursor["tex"].setBinding(texture);
+        entryPointCursor["buffer"].setBinding(buffer);
+        entryPointCursor["size"].setData(size, sizeof(uint32_t) * 3);
+        passEncoder->dispatchCompute(
+            (size[0] + groupSize[0] - 1) / groupSize[0],
+            (size[1] + groupSize[1] - 1) / groupSize[1],
+            (size[2] + groupSize[2] - 1) / groupSize[2]
+        );
+        passEncoder->end();
+        commandBuffer->close();
+        queue->submit(commandBuffer);
+        queue->waitOnHost();
+    };
+
+    run();
+    auto start = std::chrono::high_resolution_clock::now();
+    run();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    ComPtr<ISlangBlob> blob;
+    REQUIRE_CALL(device->readBuffer(buffer, 0, bufferDesc.size, blob.writeRef()));
+    outResult.resize(elementCount);
+    ::memcpy(outResult.data(), blob->getBufferPointer(), bufferDesc.size);
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void testCPUTextureTiling(GpuTestContext* ctx, DeviceType deviceType)
+{
+    CPUDeviceExtendedDesc tiledDesc = {};
+    tiledDesc.textureTilingThreshold = 1;
+    ComPtr<IDevice> tiledDevice = createCPUDevice(ctx, deviceType, tiledDesc);
+
+    // Odd sizes so that the edge tiles are only partially covered.
+    uint32_t size[3] = {13, 11, 7};
+    std::vector<float> data(size[0] * size[1] * size[2]);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = float(i);
+
+    {
+        ComPtr<ITexture> texture =
+            createFloatTexture(tiledDevice, TextureType::Texture2D, {int(size[0]), int(size[1]), 1}, data.data());
+        compareComputeResult(tiledDevice, texture, data.data(), size[0] * sizeof(float), size[1]);
+    }
+
+    {
+        ComPtr<ITexture> texture = createFloatTexture(
+            tiledDevice,
+            TextureType::Texture3D,
+            {int(size[0]), int(size[1]), int(size[2])},
+            data.data()
+        );
+        compareComputeResult(tiledDevice, texture, data.data(), size[0] * sizeof(float), size[1] * size[2]);
+
+        uint32_t groupSize[3] = {4, 4, 4};
+        std::vector<float> result;
+        runKernel(tiledDevice, kCopyShaderSource, texture, size, groupSize, result);
+        CHECK(result == data);
+    }
+}
+
+TEST_CASE("cpu-texture-tiling")
+{
+    runGpuTests(testCPUTextureTiling, {DeviceType::CPU});
+}
+
+// Compares a stencil kernel on a large texture stored in the linear and the tiled layout.
+void testCPUTextureTilingBenchmark(GpuTestContext* ctx, DeviceType deviceType)
+{
+    CPUDeviceExtendedDesc linearDesc = {};
+    linearDesc.textureTilingThreshold = 0;
+    CPUDeviceExtendedDesc tiledDesc = {};
+    tiledDesc.textureTilingThreshold = 1;
+    ComPtr<IDevice> linearDevice = createCPUDevice(ctx, deviceType, linearDesc);
+    ComPtr<IDevice> tiledDevice = createCPUDevice(ctx, deviceType, tiledDesc);
+
+    const uint32_t kSize = 2048;
+    uint32_t size[3] = {kSize, kSize, 1};
+    uint32_t groupSize[3] = {8, 8, 1};
+    std::vector<float> data(kSize * kSize);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = float(i % 251);
+
+    ComPtr<ITexture> linearTexture =
+        createFloatTexture(linearDevice, TextureType::Texture2D, {int(kSize), int(kSize), 1}, data.data());
+    ComPtr<ITexture> tiledTexture =
+        createFloatTexture(tiledDevice, TextureType::Texture2D, {int(kSize), int(kSize), 1}, data.data());
+
+    std::vector<float> linearResult;
+    std::vector<float> tiledResult;
+    double linearTime = runKernel(linearDevice, kStencilShaderSource, linearTexture, size, groupSize, linearResult);
+    double tiledTime = runKernel(tiledDevice, kStencilShaderSource, tiledTexture, size, groupSize, tiledResult);
+    MESSAGE("5x5 stencil on ", kSize, "x", kSize, ": linear ", linearTime, " ms, tiled ", tiledTime, " ms");
+
+    CHECK(linearResult == tiledResult);
+}
+
+TEST_CASE("cpu-texture-tiling-benchmark" * doctest::skip())
+{
+    runGpuTests(testCPUTextureTilingBenchmark, {DeviceType::CPU});
+}
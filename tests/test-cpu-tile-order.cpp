@@ -0,0 +1,191 @@
+#include "cpu-dispatch-utils.h"
+
+#include <chrono>
+#include <vector>
+
+#if SLANG_LINUX_FAMILY
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static const char* kConvolutionShaderSource = R"(
+    [shader("compute")]
+    [numthreads(8, 8, 1)]
+    void computeMain(
+        uint3 tid : SV_DispatchThreadID,
+        uniform RWStructuredBuffer<float> input,
+        uniform RWStructuredBuffer<float> output,
+        uniform uint2 size)
+    {
+        if (tid.x >= size.x || tid.y >= size.y)
+            return;
+        float sum = 0;
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                int2 p = clamp(int2(tid.xy) + int2(dx, dy), int2(0), int2(size) - 1);
+                sum += input[p.y * size.x + p.x];
+            }
+        }
+        output[tid.y * size.x + tid.x] = sum / 9;
+    }
+)";
+
+/// Hardware counter of the last level cache misses of the calling thread and of the threads it creates afterwards.
+/// Only available on Linux where performance counters are accessible.
+class CacheMissCounter
+{
+public:
+    CacheMissCounter()
+    {
+#if SLANG_LINUX_FAMILY
+        perf_event_attr attr = {};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter()
+    {
+#if SLANG_LINUX_FAMILY
+        if (m_fd >= 0)
+            close(m_fd);
+#endif
+    }
+
+    bool isAvailable() const { return m_fd >= 0; }
+
+    void start()
+    {
+#if SLANG_LINUX_FAMILY
+        ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    uint64_t stop()
+    {
+        uint64_t value = 0;
+#if SLANG_LINUX_FAMILY
+        ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(m_fd, &value, sizeof(value)) != sizeof(value))
+            value = 0;
+#endif
+        return value;
+    }
+
+private:
+    int m_fd = -1;
+};
+
+// Compares the group visiting orders on a 3x3 convolution over a large image.
+void testCPUDispatchTileOrder(GpuTestContext* ctx, DeviceType deviceType)
+{
+    const uint32_t kSize[2] = {4096, 1024};
+    const uint32_t kElementCount = kSize[0] * kSize[1];
+    const uint32_t kIterations = 8;
+    std::vector<float> inputData(kElementCount);
+    uint32_t state = 1;
+    for (float& value : inputData)
+    {
+        state = state * 1664525u + 1013904223u;
+        value = float(state >> 8) / float(1 << 24);
+    }
+
+    struct Config
+    {
+        const char* name;
+        uint32_t tileSize;
+        CPUDispatchTileOrder tileOrder;
+    };
+    Config configs[] = {
+        {"x-major", 0, CPUDispatchTileOrder::Morton},
+        {"morton", 8, CPUDispatchTileOrder::Morton},
+        {"hilbert", 8, CPUDispatchTileOrder::Hilbert},
+    };
+    std::vector<uint32_t> expected;
+    for (const Config& config : configs)
+    {
+        CAPTURE(config.name);
+        // Created before the device, so that the worker threads are counted.
+        CacheMissCounter cacheMissCounter;
+
+        CPUDeviceExtendedDesc cpuExtDesc = {};
+        cpuExtDesc.dispatchTileSize = config.tileSize;
+        cpuExtDesc.dispatchTileOrder = config.tileOrder;
+        ComPtr<IDevice> device = createCPUDevice(ctx, deviceType, cpuExtDesc);
+
+        ComPtr<ITransientResourceHeap> transientHeap;
+        ITransientResourceHeap::Desc transientHeapDesc = {};
+        transientHeapDesc.constantBufferSize = 4096;
+        REQUIRE_CALL(device->createTransientResourceHeap(transientHeapDesc, transientHeap.writeRef()));
+
+        ComPtr<IPipeline> pipeline = createComputePipeline(device, kConvolutionShaderSource);
+        ComPtr<IBuffer> input = createUIntBuffer(device, kElementCount, BufferUsage::None, inputData.data());
+        ComPtr<IBuffer> output = createUIntBuffer(device, kElementCount);
+
+        auto queue = device->getQueue(QueueType::Graphics);
+        auto runDispatches = [&](uint32_t dispatchCount)
+        {
+            auto commandBuffer = transientHeap->createCommandBuffer();
+            auto passEncoder = commandBuffer->beginComputePass();
+            for (uint32_t i = 0; i < dispatchCount; i++)
+            {
+                ShaderCursor cursor(passEncoder->bindPipeline(pipeline)->getEntryPoint(0));
+                cursor["input"].setBinding(input);
+                cursor["output"].setBinding(output);
+                cursor["size"].setData(kSize, sizeof(kSize));
+                passEncoder->dispatchCompute(kSize[0] / 8, kSize[1] / 8, 1);
+            }
+            passEncoder->end();
+            commandBuffer->close();
+            queue->submit(commandBuffer);
+            queue->waitOnHost();
+        };
+
+        runDispatches(1);
+        cacheMissCounter.start();
+        auto start = std::chrono::high_resolution_clock::now();
+        runDispatches(kIterations);
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        uint64_t cacheMisses = cacheMissCounter.stop();
+
+        std::vector<uint32_t> result = readUIntBuffer(device, output);
+        if (expected.empty())
+            expected = result;
+        CHECK(result == expected);
+
+        if (cacheMissCounter.isAvailable())
+        {
+            MESSAGE(
+                config.name,
+                ": ",
+                seconds * 1e3 / kIterations,
+                " ms, ",
+                cacheMisses / kIterations,
+                " cache misses per dispatch"
+            );
+        }
+        else
+        {
+            MESSAGE(config.name, ": ", seconds * 1e3 / kIterations, " ms (cache miss counter not available)");
+        }
+    }
+}
+
+TEST_CASE("cpu-dispatch-tile-order" * doctest::skip())
+{
+    runGpuTests(testCPUDispatchTileOrder, {DeviceType::CPU});
+}
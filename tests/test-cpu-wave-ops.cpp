@@ -0,0 +1,27 @@
+#include "testing.h"
+
+using namespace rhi;
+using namespace rhi::testing;
+
+static const char* kWaveShaderSource = R"(
+    [shader("compute")]
+    [numthreads(8, 1, 1)]
+    void computeMain(uint3 tid : SV_DispatchThreadID, uniform RWStructuredBuffer<uint> buffer)
+    {
+        buffer[tid.x] = WaveActiveSum(tid.x);
+    }
+)";
+
+// The device must only advertise "wave-ops" if Slang can compile wave operations for it.
+void testCPUDispatchWaveFeatures(GpuTestContext* ctx, DeviceType deviceType)
+{
+    ComPtr<IDevice> device = createTestingDevice(ctx, deviceType);
+    ComPtr<ISlangSharedLibrary> kernelLibrary;
+    Result compileResult = compileHostCallableFromSource(device, kWaveShaderSource, kernelLibrary);
+    CHECK(SLANG_SUCCEEDED(compileResult) == device->hasFeature("wave-ops"));
+}
+
+TEST_CASE("cpu-dispatch-wave-features")
+{
+    runGpuTests(testCPUDispatchWaveFeatures, {DeviceType::CPU});
+}
@@ -284,21 +284,50 @@ struct DrawIndexedInstancedTest : BaseDrawTest
         viewport.maxZ = 1.0f;
         viewport.extentX = kWidth;
         viewport.extentY = kHeight;
-        passEncoder->setViewportAndScissor(viewport);
 
         uint32_t startIndex = 0;
         int32_t startVertex = 0;
         uint32_t startInstanceLocation = 0;
 
-        passEncoder->setVertexBuffer(0, vertexBuffer);
-        passEncoder->setVertexBuffer(1, instanceBuffer);
-        passEncoder->setIndexBuffer(indexBuffer, IndexFormat::UInt32);
+        // Devices recording their own command lists report which redundant state changes were elided.
+        ComPtr<IImmediateDevice> immediateDevice;
+        CommandStats statsBefore;
+        device->queryInterface(IImmediateDevice::getTypeGuid(), (void**)immediateDevice.writeRef());
+        bool hasCommandStats = immediateDevice != nullptr;
+        if (hasCommandStats)
+            REQUIRE_CALL(immediateDevice->getCommandStats(&statsBefore));
 
-        passEncoder->drawIndexedInstanced(kIndexCount, kInstanceCount, startIndex, startVertex, startInstanceLocation);
+        // Setting the same state again before the second draw must not change the result.
+        for (int i = 0; i < 2; i++)
+        {
+            passEncoder->setViewportAndScissor(viewport);
+            passEncoder->setVertexBuffer(0, vertexBuffer);
+            passEncoder->setVertexBuffer(1, instanceBuffer);
+            passEncoder->setIndexBuffer(indexBuffer, IndexFormat::UInt32);
+
+            passEncoder->drawIndexedInstanced(
+                kIndexCount,
+                kInstanceCount,
+                startIndex,
+                startVertex,
+                startInstanceLocation
+            );
+        }
         passEncoder->end();
         commandBuffer->close();
         queue->submit(commandBuffer);
         queue->waitOnHost();
+
+        if (hasCommandStats)
+        {
+            CommandStats stats;
+            REQUIRE_CALL(immediateDevice->getCommandStats(&stats));
+            CHECK(stats.elidedViewportsCount - statsBefore.elidedViewportsCount == 1);
+            CHECK(stats.elidedScissorRectsCount - statsBefore.elidedScissorRectsCount == 1);
+            CHECK(stats.elidedVertexBuffersCount - statsBefore.elidedVertexBuffersCount == 2);
+            CHECK(stats.elidedIndexBufferCount - statsBefore.elidedIndexBufferCount == 1);
+            CHECK(stats.elidedRootObjectCount - statsBefore.elidedRootObjectCount == 1);
+        }
     }
 
     void run()
@@ -943,6 +943,7 @@ TEST_CASE("shader-cache-source-file")
         {
             DeviceType::D3D12,
             DeviceType::Vulkan,
+            DeviceType::CPU,
         }
     );
 }
@@ -954,6 +955,7 @@ TEST_CASE("shader-cache-source-string")
         {
             DeviceType::D3D12,
             DeviceType::Vulkan,
+            DeviceType::CPU,
         }
     );
 }
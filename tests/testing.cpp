@@ -230,6 +230,38 @@ Result loadComputeProgramFromSource(IDevice* device, ComPtr<IShaderProgram>& out
     return outShaderProgram ? SLANG_OK : SLANG_FAIL;
 }
 
+Result compileHostCallableFromSource(IDevice* device, std::string_view source, ComPtr<ISlangSharedLibrary>& outLibrary)
+{
+    auto slangSession = device->getSlangSession();
+    ComPtr<slang::IBlob> diagnosticsBlob;
+    size_t hash = std::hash<std::string_view>()(source);
+    std::string moduleName = "source_module_" + std::to_string(hash);
+    auto srcBlob = UnownedBlob::create(source.data(), source.size());
+    slang::IModule* module =
+        slangSession->loadModuleFromSource(moduleName.data(), moduleName.data(), srcBlob, diagnosticsBlob.writeRef());
+    if (!module)
+        return SLANG_FAIL;
+
+    std::vector<slang::IComponentType*> componentTypes = {module};
+    std::vector<ComPtr<slang::IEntryPoint>> entryPoints;
+    for (SlangInt32 i = 0; i < module->getDefinedEntryPointCount(); i++)
+    {
+        ComPtr<slang::IEntryPoint> entryPoint;
+        SLANG_RETURN_ON_FAIL(module->getDefinedEntryPoint(i, entryPoint.writeRef()));
+        componentTypes.push_back(entryPoint.get());
+        entryPoints.push_back(entryPoint);
+    }
+
+    ComPtr<slang::IComponentType> linkedProgram;
+    SLANG_RETURN_ON_FAIL(slangSession->createCompositeComponentType(
+        componentTypes.data(),
+        componentTypes.size(),
+        linkedProgram.writeRef(),
+        diagnosticsBlob.writeRef()
+    ));
+    return linkedProgram->getEntryPointHostCallable(0, 0, outLibrary.writeRef(), diagnosticsBlob.writeRef());
+}
+
 Result loadGraphicsProgram(
     IDevice* device,
     ComPtr<IShaderProgram>& outShaderProgram,
@@ -340,23 +372,14 @@ void compareComputeResultFuzzy(IDevice* device, IBuffer* buffer, float* expected
     compareComputeResultFuzzy(result, expectedResult, expectedBufferSize);
 }
 
-ComPtr<IDevice> createTestingDevice(
+Result tryCreateTestingDevice(
     GpuTestContext* ctx,
     DeviceType deviceType,
-    bool useCachedDevice,
+    const std::vector<void*>& extendedDescs,
+    ComPtr<IDevice>& outDevice,
     std::vector<const char*> additionalSearchPaths
 )
 {
-    if (useCachedDevice)
-    {
-        auto it = gCachedDevices.find(deviceType);
-        if (it != gCachedDevices.end())
-        {
-            return it->second;
-        }
-    }
-
-    ComPtr<IDevice> device;
     DeviceDesc deviceDesc = {};
     deviceDesc.deviceType = deviceType;
     deviceDesc.slang.slangGlobalSession = ctx->slangGlobalSession;
@@ -387,9 +410,10 @@ ComPtr<IDevice> createTestingDevice(
     slangExtDesc.compilerOptionEntries = entries.data();
     slangExtDesc.compilerOptionEntryCount = entries.size();
 
-    deviceDesc.extendedDescCount = 2;
-    void* extDescPtrs[2] = {&extDesc, &slangExtDesc};
-    deviceDesc.extendedDescs = extDescPtrs;
+    std::vector<void*> extDescPtrs = {&extDesc, &slangExtDesc};
+    extDescPtrs.insert(extDescPtrs.end(), extendedDescs.begin(), extendedDescs.end());
+    deviceDesc.extendedDescCount = (GfxCount)extDescPtrs.size();
+    deviceDesc.extendedDescs = extDescPtrs.data();
 
     // TODO: We should also set the debug callback
     // (And in general reduce the differences (and duplication) between
@@ -400,7 +424,27 @@ ComPtr<IDevice> createTestingDevice(
     deviceDesc.debugCallback = &sDebugCallback;
 #endif
 
-    REQUIRE_CALL(getRHI()->createDevice(deviceDesc, device.writeRef()));
+    return getRHI()->createDevice(deviceDesc, outDevice.writeRef());
+}
+
+ComPtr<IDevice> createTestingDevice(
+    GpuTestContext* ctx,
+    DeviceType deviceType,
+    bool useCachedDevice,
+    std::vector<const char*> additionalSearchPaths
+)
+{
+    if (useCachedDevice)
+    {
+        auto it = gCachedDevices.find(deviceType);
+        if (it != gCachedDevices.end())
+        {
+            return it->second;
+        }
+    }
+
+    ComPtr<IDevice> device;
+    REQUIRE_CALL(tryCreateTestingDevice(ctx, deviceType, {}, device, additionalSearchPaths));
 
     if (useCachedDevice)
     {
@@ -59,6 +59,9 @@ Result loadComputeProgram(
 
 Result loadComputeProgramFromSource(IDevice* device, ComPtr<IShaderProgram>& outShaderProgram, std::string_view source);
 
+/// Compiles the entry points of `source` to host callable code, as the CPU device does on first dispatch.
+Result compileHostCallableFromSource(IDevice* device, std::string_view source, ComPtr<ISlangSharedLibrary>& outLibrary);
+
 Result loadGraphicsProgram(
     IDevice* device,
     ComPtr<IShaderProgram>& outShaderProgram,
@@ -107,6 +110,15 @@ ComPtr<IDevice> createTestingDevice(
     std::vector<const char*> additionalSearchPaths = {}
 );
 
+/// Create a new (uncached) testing device, passing `extendedDescs` (e.g. `CPUDeviceExtendedDesc`) to the backend.
+Result tryCreateTestingDevice(
+    GpuTestContext* ctx,
+    DeviceType deviceType,
+    const std::vector<void*>& extendedDescs,
+    ComPtr<IDevice>& outDevice,
+    std::vector<const char*> additionalSearchPaths = {}
+);
+
 void releaseCachedDevices();
 
 ComPtr<slang::ISession> createTestingSession(